@@ -0,0 +1,94 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: bench_util.h
+// desc: timing helpers shared by the micro-benchmarks
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#ifndef __BENCH_UTIL_H__
+#define __BENCH_UTIL_H__
+
+#include "chuck_def.h"
+#include <stdio.h>
+
+#if defined(__PLATFORM_WIN32__)
+  #include <windows.h>
+#else
+  #include <sys/time.h>
+#endif
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: bench_now()
+// desc: wall-clock time in seconds
+//-----------------------------------------------------------------------------
+static inline t_CKFLOAT bench_now()
+{
+#if defined(__PLATFORM_WIN32__)
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter( &count );
+    QueryPerformanceFrequency( &freq );
+    return (t_CKFLOAT)count.QuadPart / (t_CKFLOAT)freq.QuadPart;
+#else
+    struct timeval t;
+    gettimeofday( &t, NULL );
+    return t.tv_sec + (t_CKFLOAT)t.tv_usec / 1000000;
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: bench_report()
+// desc: print one result line: label, work done, seconds, and rate
+//-----------------------------------------------------------------------------
+static inline void bench_report( const char * label, t_CKUINT ops,
+                                 t_CKFLOAT seconds, const char * unit = "ops" )
+{
+    fprintf( stdout, "  %-36s %12lu %s  %8.3f sec  %12.0f %s/sec\n",
+             label, ops, unit, seconds, seconds > 0 ? ops / seconds : 0, unit );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: bench_rand()
+// desc: small deterministic generator, so runs are comparable
+//-----------------------------------------------------------------------------
+static inline t_CKUINT bench_rand( t_CKUINT & state )
+{
+    state = state * 1103515245 + 12345;
+    return (state >> 16) & 0x7fff;
+}
+
+
+
+
+#endif
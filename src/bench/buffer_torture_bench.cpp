@@ -0,0 +1,311 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: buffer_torture_bench.cpp
+// desc: the lock-free buffers under real threads, checked and timed
+//
+//       CBufferSimple: one writer thread, one reader; every element must
+//         arrive, in order
+//       CBufferMPSC: several writer threads, one reader; every element
+//         must arrive, each writer's in order
+//       CBufferAdvance: one writer thread, one reader thread with several
+//         read offsets; elements may be skipped ( a reader that falls a
+//         buffer behind loses the oldest ), but never torn or reordered
+//
+//       small buffers, so writers run into full buffers and wrap often.
+//       exits non-zero on the first failure.
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "util_buffers.h"
+#include "util_thread.h"
+#include "bench_util.h"
+
+#include <stdlib.h>
+#if !defined(__PLATFORM_WIN32__)
+  #include <sched.h>
+#endif
+
+// elements per writer
+#define BENCH_NUM_ELEMS 2000000
+// writers on the MPSC buffer
+#define BENCH_NUM_WRITERS 4
+// read offsets on the advance buffer
+#define BENCH_NUM_READERS 3
+
+
+// an element: a writer id and a count, twice (to catch torn copies)
+struct Elem
+{
+    t_CKUINT writer;
+    t_CKUINT count;
+    t_CKUINT check;
+    t_CKUINT pad;
+};
+
+// what a writer thread is given
+struct Writer
+{
+    void * buffer;
+    t_CKUINT id;
+    t_CKUINT full;
+};
+
+static volatile t_CKUINT g_go = 0;
+static t_CKUINT g_failures = 0;
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: yield()
+// desc: let the other side run (the machine may have only one core)
+//-----------------------------------------------------------------------------
+static void yield()
+{
+#if defined(__PLATFORM_WIN32__)
+    Sleep( 0 );
+#else
+    sched_yield();
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: fail()
+// desc: report a failed check
+//-----------------------------------------------------------------------------
+static void fail( const char * what, const Elem & e, t_CKUINT expected )
+{
+    if( g_failures++ < 10 )
+        fprintf( stdout, "  FAILED %s: writer %lu count %lu check %lu (expected %lu)\n",
+                 what, e.writer, e.count, e.check, expected );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: *_writer()
+// desc: writer threads: put BENCH_NUM_ELEMS elements, retrying when full
+//-----------------------------------------------------------------------------
+static THREAD_RETURN (THREAD_TYPE simple_writer)( void * data )
+{
+    Writer * w = (Writer *)data;
+    CBufferSimple * buffer = (CBufferSimple *)w->buffer;
+    while( !xatomic_load( &g_go ) ) yield();
+    for( t_CKUINT i = 0; i < BENCH_NUM_ELEMS; i++ )
+    {
+        Elem e = { w->id, i, i * 7 + w->id, 0 };
+        while( !buffer->put( &e, 1 ) ) { w->full++; yield(); }
+    }
+    return 0;
+}
+
+static THREAD_RETURN (THREAD_TYPE mpsc_writer)( void * data )
+{
+    Writer * w = (Writer *)data;
+    CBufferMPSC * buffer = (CBufferMPSC *)w->buffer;
+    while( !xatomic_load( &g_go ) ) yield();
+    for( t_CKUINT i = 0; i < BENCH_NUM_ELEMS; i++ )
+    {
+        Elem e = { w->id, i, i * 7 + w->id, 0 };
+        while( !buffer->put( &e, 1 ) ) { w->full++; yield(); }
+    }
+    return 0;
+}
+
+static THREAD_RETURN (THREAD_TYPE advance_writer)( void * data )
+{
+    Writer * w = (Writer *)data;
+    CBufferAdvance * buffer = (CBufferAdvance *)w->buffer;
+    while( !xatomic_load( &g_go ) ) yield();
+    for( t_CKUINT i = 0; i < BENCH_NUM_ELEMS; i++ )
+    {
+        Elem e = { w->id, i, i * 7 + w->id, 0 };
+        buffer->put( &e, 1 );
+        // give the reader a chance, now and then
+        if( i % 16 == 0 ) yield();
+    }
+    return 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: torture_simple()
+// desc: one writer, one reader
+//-----------------------------------------------------------------------------
+static void torture_simple()
+{
+    CBufferSimple buffer;
+    buffer.initialize( 64, sizeof(Elem) );
+    Writer w = { &buffer, 1, 0 };
+    XThread thread;
+    Elem e[16];
+    t_CKUINT next = 0, n;
+
+    g_go = 0;
+    thread.start( simple_writer, &w );
+    t_CKFLOAT start = bench_now();
+    xatomic_store( &g_go, 1 );
+    while( next < BENCH_NUM_ELEMS )
+    {
+        if( !( n = buffer.get( e, 16 ) ) ) yield();
+        for( t_CKUINT i = 0; i < n; i++, next++ )
+            if( e[i].count != next || e[i].check != next * 7 + 1 ) fail( "simple", e[i], next );
+    }
+    t_CKFLOAT seconds = bench_now() - start;
+    thread.wait( -1, false );
+
+    bench_report( "CBufferSimple 1 -> 1", next, seconds, "elems" );
+    fprintf( stdout, "  %-36s %12lu\n", "  writer found it full", w.full );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: torture_mpsc()
+// desc: several writers, one reader
+//-----------------------------------------------------------------------------
+static void torture_mpsc()
+{
+    CBufferMPSC buffer;
+    buffer.initialize( 64, sizeof(Elem) );
+    Writer w[BENCH_NUM_WRITERS];
+    XThread thread[BENCH_NUM_WRITERS];
+    t_CKUINT next[BENCH_NUM_WRITERS] = { 0 };
+    t_CKUINT total = 0, full = 0, n;
+    Elem e[16];
+
+    g_go = 0;
+    for( t_CKUINT i = 0; i < BENCH_NUM_WRITERS; i++ )
+    {
+        w[i].buffer = &buffer; w[i].id = i; w[i].full = 0;
+        thread[i].start( mpsc_writer, &w[i] );
+    }
+    t_CKFLOAT start = bench_now();
+    xatomic_store( &g_go, 1 );
+    while( total < BENCH_NUM_ELEMS * BENCH_NUM_WRITERS )
+    {
+        if( !( n = buffer.get( e, 16 ) ) ) yield();
+        for( t_CKUINT i = 0; i < n; i++, total++ )
+        {
+            t_CKUINT id = e[i].writer;
+            if( id >= BENCH_NUM_WRITERS ) { fail( "mpsc writer", e[i], 0 ); continue; }
+            if( e[i].count != next[id] || e[i].check != next[id] * 7 + id ) fail( "mpsc", e[i], next[id] );
+            next[id] = e[i].count + 1;
+        }
+    }
+    t_CKFLOAT seconds = bench_now() - start;
+    for( t_CKUINT i = 0; i < BENCH_NUM_WRITERS; i++ )
+    {
+        thread[i].wait( -1, false );
+        full += w[i].full;
+    }
+    // nothing extra
+    if( buffer.get( e, 1 ) ) fail( "mpsc extra", e[0], 0 );
+
+    bench_report( "CBufferMPSC 4 -> 1", total, seconds, "elems" );
+    fprintf( stdout, "  %-36s %12lu\n", "  writers found it full", full );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: torture_advance()
+// desc: one writer, several read offsets on one reader thread
+//-----------------------------------------------------------------------------
+static void torture_advance()
+{
+    CBufferAdvance buffer;
+    buffer.initialize( 64, sizeof(Elem) );
+    Writer w = { &buffer, 2, 0 };
+    XThread thread;
+    t_CKUINT index[BENCH_NUM_READERS], next[BENCH_NUM_READERS], got = 0, n;
+    Elem e[16];
+
+    for( t_CKUINT r = 0; r < BENCH_NUM_READERS; r++ )
+    {
+        index[r] = buffer.join();
+        next[r] = 0;
+    }
+
+    g_go = 0;
+    thread.start( advance_writer, &w );
+    t_CKFLOAT start = bench_now();
+    xatomic_store( &g_go, 1 );
+    // until the last element reaches the slowest reader
+    t_CKBOOL done = FALSE;
+    while( !done )
+    {
+        done = TRUE;
+        t_CKBOOL got_any = FALSE;
+        for( t_CKUINT r = 0; r < BENCH_NUM_READERS; r++ )
+        {
+            // read offsets take different-sized bites
+            n = buffer.get( e, r * 5 + 1, index[r] );
+            if( n ) got_any = TRUE;
+            for( t_CKUINT i = 0; i < n; i++, got++ )
+            {
+                if( e[i].count < next[r] || e[i].check != e[i].count * 7 + 2 ) fail( "advance", e[i], next[r] );
+                next[r] = e[i].count + 1;
+            }
+            if( next[r] < BENCH_NUM_ELEMS ) done = FALSE;
+        }
+        if( !got_any ) yield();
+    }
+    t_CKFLOAT seconds = bench_now() - start;
+    thread.wait( -1, false );
+    for( t_CKUINT r = 0; r < BENCH_NUM_READERS; r++ )
+        if( !buffer.empty( index[r] ) ) fail( "advance not empty", e[0], r );
+
+    bench_report( "CBufferAdvance 1 -> 3 (read)", got, seconds, "elems" );
+    fprintf( stdout, "  %-36s %12lu\n", "  skipped (reader lapped)", BENCH_NUM_ELEMS * BENCH_NUM_READERS - got );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    fprintf( stdout, "[buffer_torture_bench]: %d elements per writer\n", BENCH_NUM_ELEMS );
+
+    torture_simple();
+    torture_mpsc();
+    torture_advance();
+
+    fprintf( stdout, g_failures ? "FAILED (%lu)\n" : "ok\n", g_failures );
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: event_broadcast_bench.cpp
+// desc: Event.broadcast() to N waiting shreds: one batched wake vs. the
+//       previous loop of signal(), each taking the queue lock and
+//       shreduling one shred
+//
+//       wake latency is the time from the broadcast until every waiter is
+//       in the run queue; running the woken shreds is not counted.
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "chuck_oo.h"
+#include "chuck_instr.h"
+#include "chuck_compile.h"
+#include "chuck_globals.h"
+#include "bench_util.h"
+
+#include <vector>
+using namespace std;
+
+// broadcasts timed per size
+#define BENCH_NUM_ROUNDS 50
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: run_rounds()
+// desc: wait all shreds on the event, wake them, take them off the run
+//       queue; repeat.  seconds spent waking
+//-----------------------------------------------------------------------------
+static t_CKFLOAT run_rounds( Chuck_Event * event, vector<Chuck_VM_Shred *> & shreds,
+                             t_CKBOOL batched, t_CKFLOAT * worst )
+{
+    Chuck_VM_Shreduler * shreduler = g_vm->shreduler();
+    t_CKFLOAT total = 0, start, elapsed;
+
+    *worst = 0;
+    for( t_CKUINT r = 0; r < BENCH_NUM_ROUNDS; r++ )
+    {
+        for( t_CKUINT i = 0; i < shreds.size(); i++ )
+        {
+            shreds[i]->reg->sp = shreds[i]->reg->stack;
+            event->wait( shreds[i], g_vm );
+        }
+
+        start = bench_now();
+        if( batched ) event->broadcast();
+        else for( t_CKUINT i = 0; i < shreds.size(); i++ ) event->signal();
+        elapsed = bench_now() - start;
+
+        total += elapsed;
+        if( elapsed > *worst ) *worst = elapsed;
+
+        // everyone is due now
+        while( shreduler->get() );
+    }
+
+    return total;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    std::list<std::string> paths, dls;
+    t_CKUINT sizes[] = { 100, 1000, 2000, 10000 };
+    t_CKFLOAT seconds, worst;
+    char label[128];
+
+    // vm and type system (for Event)
+    g_vm = new Chuck_VM;
+    if( !g_vm->initialize( 44100, 2, 2, 0, TRUE ) ) return 1;
+    g_compiler = new Chuck_Compiler;
+    if( !g_compiler->initialize( g_vm, paths, dls ) ) return 1;
+
+    // the waiters never run; any code will do
+    Chuck_VM_Code * code = new Chuck_VM_Code;
+    code->instr = new Chuck_Instr *[1];
+    code->instr[0] = new Chuck_Instr_EOC;
+    code->num_instr = 1;
+    // held here, so it outlives every batch of shreds
+    code->add_ref();
+
+    Chuck_Event * event = new Chuck_Event;
+    initialize_object( event, &t_event );
+
+    fprintf( stdout, "[event_broadcast_bench]: %d broadcasts per size\n", BENCH_NUM_ROUNDS );
+
+    for( t_CKUINT n = 0; n < sizeof(sizes)/sizeof(t_CKUINT); n++ )
+    {
+        t_CKUINT N = sizes[n];
+        vector<Chuck_VM_Shred *> shreds( N );
+
+        for( t_CKUINT i = 0; i < N; i++ )
+        {
+            shreds[i] = new Chuck_VM_Shred;
+            shreds[i]->initialize( code );
+            shreds[i]->vm_ref = g_vm;
+            shreds[i]->xid = i + 1;
+        }
+
+        fprintf( stdout, "waiters: %lu\n", N );
+
+        for( t_CKUINT b = 0; b < 2; b++ )
+        {
+            seconds = run_rounds( event, shreds, b == 1, &worst );
+            sprintf( label, b ? "batched broadcast" : "signal() per waiter" );
+            bench_report( label, N * BENCH_NUM_ROUNDS, seconds, "wakes" );
+            fprintf( stdout, "  %-36s %8.1f usec mean  %8.1f usec worst\n", "  wake latency",
+                     seconds / BENCH_NUM_ROUNDS * 1000000, worst * 1000000 );
+        }
+
+        for( t_CKUINT i = 0; i < N; i++ )
+            delete shreds[i];
+    }
+
+    return 0;
+}
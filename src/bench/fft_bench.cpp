@@ -0,0 +1,116 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: fft_bench.cpp
+// desc: the CARL rfft() against the planned rfft_plan(), forward and
+//       inverse, at the sizes FFT/IFFT UAnae commonly run at; also checks
+//       that the two agree
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "util_xforms.h"
+#include "bench_util.h"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+using namespace std;
+
+// samples transformed per size and mode
+#define BENCH_NUM_SAMPLES (1 << 24)
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: fill()
+// desc: deterministic noise
+//-----------------------------------------------------------------------------
+static void fill( SAMPLE * x, t_CKUINT n, t_CKUINT & seed )
+{
+    for( t_CKUINT i = 0; i < n; i++ )
+        x[i] = (SAMPLE)bench_rand( seed ) / 0x7fff - (SAMPLE).5;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    t_CKUINT sizes[] = { 512, 1024, 2048, 4096, 8192 };
+    t_CKUINT seed = 1;
+    char label[64];
+    t_CKFLOAT start;
+
+    fprintf( stdout, "[fft_bench]: %d samples per size and mode\n", BENCH_NUM_SAMPLES );
+
+    for( t_CKUINT s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++ )
+    {
+        t_CKUINT size = sizes[s];
+        t_CKUINT reps = BENCH_NUM_SAMPLES / size;
+        vector<SAMPLE> a( size ), b( size ), in( size );
+        fft_plan * plan = fft_plan_get( size/2 );
+        t_CKFLOAT err = 0;
+
+        // agreement, forward and back
+        fill( &in[0], size, seed );
+        a = in; b = in;
+        rfft( &a[0], size/2, FFT_FORWARD );
+        rfft_plan( plan, &b[0], FFT_FORWARD );
+        for( t_CKUINT i = 0; i < size; i++ )
+            err = ck_max( err, fabs( a[i] - b[i] ) );
+        rfft( &a[0], size/2, FFT_INVERSE );
+        rfft_plan( plan, &b[0], FFT_INVERSE );
+        for( t_CKUINT i = 0; i < size; i++ )
+            err = ck_max( err, fabs( a[i] - b[i] ) );
+        fprintf( stdout, "  size %lu: max difference %g\n", size, err );
+
+        // the CARL transform
+        start = bench_now();
+        for( t_CKUINT r = 0; r < reps; r++ )
+        {
+            rfft( &a[0], size/2, FFT_FORWARD );
+            rfft( &a[0], size/2, FFT_INVERSE );
+        }
+        sprintf( label, "rfft %lu, forward+inverse", size );
+        bench_report( label, reps * size, bench_now() - start, "samples" );
+
+        // planned
+        start = bench_now();
+        for( t_CKUINT r = 0; r < reps; r++ )
+        {
+            rfft_plan( plan, &b[0], FFT_FORWARD );
+            rfft_plan( plan, &b[0], FFT_INVERSE );
+        }
+        sprintf( label, "rfft_plan %lu, forward+inverse", size );
+        bench_report( label, reps * size, bench_now() - start, "samples" );
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+//-----------------------------------------------------------------------------
+// file: lisa_bench.cpp
+// desc: per-sample vs. block rendering of a many-voice LiSa
+//
+//       a one-second buffer is played back by N looping voices at mixed
+//       rates and directions; the same patch is ticked one sample at a
+//       time, a block at a time through the scalar tick, and a block at
+//       a time through the block tick (tickv).  each mode starts from a
+//       fresh LiSa and prints the sum of its output, which should agree.
+//
+//       usage: lisa_bench [voices ...] (default: 10 50 200)
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "chuck_compile.h"
+#include "chuck_ugen.h"
+#include "chuck_globals.h"
+#include "bench_util.h"
+
+#include <string>
+#include <stdlib.h>
+using namespace std;
+
+// samples per block
+#define BENCH_BLOCK_SIZE 256
+// samples rendered per mode (about 10 seconds, whole blocks)
+#define BENCH_NUM_FRAMES (BENCH_BLOCK_SIZE * 1723)
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: make_lisa()
+// desc: run a program that sets up a LiSa with the given voices on
+//       blackhole and holds it there; returns the LiSa
+//-----------------------------------------------------------------------------
+static Chuck_UGen * make_lisa( t_CKUINT voices )
+{
+    SAMPLE input[2] = { 0 };
+    SAMPLE output[2];
+    char buf[2048];
+
+    sprintf( buf,
+        "%lu => int N;\n"
+        "LiSa l => blackhole; 1::second => l.duration; N => l.maxVoices;\n"
+        "for( 0 => int i; i < 44100; i++ )\n"
+        "    l.valueAt( Math.sin( i * .0371 ) * .5, i::samp );\n"
+        "for( 0 => int v; v < N; v++ )\n"
+        "{\n"
+        "    ( .5 + ( v %% 7 ) * .25 ) * ( v %% 2 ? -1 : 1 ) => float r;\n"
+        "    l.rate( v, r ); l.playPos( v, ( 1000 + v * 37 )::samp );\n"
+        "    l.loopStart( v, 1000::samp ); l.loopEnd( v, 40000::samp );\n"
+        "    l.loop( v, 1 ); l.bi( v, v %% 3 == 0 ); l.voiceGain( v, 1.0 / N );\n"
+        "    l.play( v, 1 );\n"
+        "}\n"
+        "1::week => now;\n",
+        voices );
+
+    if( !g_compiler->go( "lisa", NULL, buf, "lisa" ) ) return NULL;
+    Chuck_VM_Code * code = g_compiler->output();
+    code->name += "lisa";
+    g_vm->spork( code, NULL );
+    // one sample: the shred runs up to its wait
+    g_vm->run( 1, input, output );
+
+    Chuck_UGen * hole = g_vm->m_bunghole;
+    return hole->m_num_src ? hole->m_src_list[hole->m_num_src - 1] : NULL;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    std::list<std::string> paths, dls;
+    const char * defaults[] = { "10", "50", "200" };
+    t_CKUINT num_counts = argc > 1 ? argc - 1 : 3;
+    // well past anything the vm has reached
+    t_CKTIME now = 1e9;
+    t_CKFLOAT start, sum;
+    t_CKUINT i, j;
+
+    // vm, type system and synthesis
+    g_vm = new Chuck_VM;
+    if( !g_vm->initialize( 44100, 2, 2, BENCH_BLOCK_SIZE, FALSE ) ) return 1;
+    g_compiler = new Chuck_Compiler;
+    if( !g_compiler->initialize( g_vm, paths, dls ) ) return 1;
+    if( !g_vm->initialize_synthesis() ) return 1;
+    g_vm->start();
+
+    for( t_CKUINT c = 0; c < num_counts; c++ )
+    {
+        t_CKUINT voices = atoi( argc > 1 ? argv[c + 1] : defaults[c] );
+        if( voices < 1 ) voices = 1;
+
+        fprintf( stdout, "[lisa_bench]: %lu voices, block size %d\n",
+                 voices, BENCH_BLOCK_SIZE );
+
+        // one sample at a time (non-adaptive synthesis)
+        Chuck_UGen * lisa = make_lisa( voices );
+        if( !lisa ) { fprintf( stdout, "  cannot set up LiSa\n" ); return 1; }
+        sum = 0;
+        start = bench_now();
+        for( i = 0; i < BENCH_NUM_FRAMES; i++ )
+        {
+            lisa->system_tick( ++now );
+            sum += lisa->m_current;
+        }
+        bench_report( "per-sample system_tick", BENCH_NUM_FRAMES, bench_now() - start, "samples" );
+        fprintf( stdout, "  %-36s %12.6f\n", "output sum", sum );
+
+        // blocks, scalar tick per sample
+        lisa = make_lisa( voices );
+        if( !lisa ) { fprintf( stdout, "  cannot set up LiSa\n" ); return 1; }
+        f_tickv tickv = lisa->tickv;
+        lisa->tickv = NULL;
+        sum = 0;
+        start = bench_now();
+        for( i = 0; i < BENCH_NUM_FRAMES; i += BENCH_BLOCK_SIZE )
+        {
+            lisa->system_tick_v( now += BENCH_BLOCK_SIZE, BENCH_BLOCK_SIZE );
+            for( j = 0; j < BENCH_BLOCK_SIZE; j++ ) sum += lisa->m_current_v[j];
+        }
+        bench_report( "block system_tick_v, scalar tick", BENCH_NUM_FRAMES, bench_now() - start, "samples" );
+        fprintf( stdout, "  %-36s %12.6f\n", "output sum", sum );
+
+        // blocks, block tick
+        lisa = make_lisa( voices );
+        if( !lisa ) { fprintf( stdout, "  cannot set up LiSa\n" ); return 1; }
+        lisa->tickv = tickv;
+        sum = 0;
+        start = bench_now();
+        for( i = 0; i < BENCH_NUM_FRAMES; i += BENCH_BLOCK_SIZE )
+        {
+            lisa->system_tick_v( now += BENCH_BLOCK_SIZE, BENCH_BLOCK_SIZE );
+            for( j = 0; j < BENCH_BLOCK_SIZE; j++ ) sum += lisa->m_current_v[j];
+        }
+        bench_report( "block system_tick_v, block tick", BENCH_NUM_FRAMES, bench_now() - start, "samples" );
+        fprintf( stdout, "  %-36s %12.6f\n", "output sum", sum );
+    }
+
+    return 0;
+}
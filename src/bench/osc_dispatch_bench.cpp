@@ -0,0 +1,247 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: osc_dispatch_bench.cpp
+// desc: OscRecv message dispatch to N address spaces ( OscEvents ):
+//       exact addresses, a wildcard pattern, a string message fanned out
+//       to several listeners, and end-to-end over loopback UDP
+//
+//       the in-process cases hand packets straight to the receiver, as
+//       its socket thread would; listeners are drained as they fill.
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "chuck_oo.h"
+#include "chuck_type.h"
+#include "chuck_instr.h"
+#include "chuck_compile.h"
+#include "chuck_globals.h"
+#include "util_opsc.h"
+#include "bench_util.h"
+
+#include <vector>
+#include <unistd.h>
+using namespace std;
+
+// messages dispatched per in-process case
+#define BENCH_NUM_MESGS 200000
+// messages sent over UDP, and per burst
+#define BENCH_NUM_UDP 50000
+#define BENCH_UDP_BURST 250
+#define BENCH_UDP_PORT 16449
+
+
+// an OSC packet
+struct Packet
+{
+    char bytes[256];
+    int len;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: make_packet()
+// desc: address, type tag, and one float or string argument
+//-----------------------------------------------------------------------------
+static void make_packet( Packet & p, const char * addr, const char * str )
+{
+    OSCbuf buf;
+    OSC_initBuffer( &buf, sizeof(p.bytes), p.bytes );
+    OSC_writeAddressAndTypes( &buf, (char *)addr, (char *)( str ? ",s" : ",f" ) );
+    if( str ) OSC_writeStringArg( &buf, (char *)str );
+    else OSC_writeFloatArg( &buf, 0.5f );
+    p.len = OSC_packetSize( &buf );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: make_listener()
+// desc: an address space with an event to broadcast, like OscRecv.event()
+//-----------------------------------------------------------------------------
+static OSC_Address_Space * make_listener( OSC_Receiver * recv, const char * spec )
+{
+    OSC_Address_Space * space = new OSC_Address_Space( spec );
+    Chuck_Event * event = new Chuck_Event;
+    initialize_object( event, &t_event );
+    space->SELF = event;
+    recv->add_address( space );
+    return space;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: drain()
+// desc: read everything queued on the listeners; messages read
+//-----------------------------------------------------------------------------
+static t_CKUINT drain( vector<OSC_Address_Space *> & spaces, t_CKBOOL strings )
+{
+    t_CKUINT n = 0;
+    for( t_CKUINT i = 0; i < spaces.size(); i++ )
+        while( spaces[i]->next_mesg() )
+        {
+            if( strings ) spaces[i]->next_string();
+            else spaces[i]->next_float();
+            n++;
+        }
+    return n;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: dispatch()
+// desc: hand the packets to the receiver round robin; seconds taken
+//-----------------------------------------------------------------------------
+static t_CKFLOAT dispatch( OSC_Receiver * recv, vector<Packet> & packets, t_CKUINT count,
+                           vector<OSC_Address_Space *> & spaces, t_CKBOOL strings,
+                           t_CKUINT * delivered )
+{
+    t_CKFLOAT start = bench_now();
+    *delivered = 0;
+    for( t_CKUINT i = 0; i < count; i++ )
+    {
+        Packet & p = packets[i % packets.size()];
+        recv->handle_mesg( p.bytes, p.len );
+        if( i % 256 == 255 ) *delivered += drain( spaces, strings );
+    }
+    *delivered += drain( spaces, strings );
+    return bench_now() - start;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    std::list<std::string> paths, dls;
+    t_CKUINT sizes[] = { 10, 100, 1000 };
+    t_CKUINT delivered;
+    t_CKFLOAT seconds;
+    char buf[256];
+
+    // vm and type system (for Event, and the receiver's event buffer)
+    g_vm = new Chuck_VM;
+    if( !g_vm->initialize( 44100, 2, 2, 0, TRUE ) ) return 1;
+    g_compiler = new Chuck_Compiler;
+    if( !g_compiler->initialize( g_vm, paths, dls ) ) return 1;
+
+    fprintf( stdout, "[osc_dispatch_bench]:\n" );
+
+    for( t_CKUINT n = 0; n < sizeof(sizes)/sizeof(t_CKUINT); n++ )
+    {
+        t_CKUINT N = sizes[n];
+        OSC_Receiver * recv = new OSC_Receiver;
+        vector<OSC_Address_Space *> spaces;
+        vector<Packet> exact( N ), pattern( 1 );
+
+        for( t_CKUINT i = 0; i < N; i++ )
+        {
+            sprintf( buf, "/ctl/%lu/value, f", i );
+            spaces.push_back( make_listener( recv, buf ) );
+            sprintf( buf, "/ctl/%lu/value", i );
+            make_packet( exact[i], buf, NULL );
+        }
+        make_packet( pattern[0], "/ctl/*/value", NULL );
+
+        fprintf( stdout, "listeners: %lu\n", N );
+
+        seconds = dispatch( recv, exact, BENCH_NUM_MESGS, spaces, FALSE, &delivered );
+        bench_report( "exact address", BENCH_NUM_MESGS, seconds, "mesgs" );
+
+        seconds = dispatch( recv, pattern, BENCH_NUM_MESGS / N, spaces, FALSE, &delivered );
+        bench_report( "/ctl/*/value (deliveries)", delivered, seconds, "mesgs" );
+
+        for( t_CKUINT i = 0; i < N; i++ )
+            recv->remove_address( spaces[i] );
+        delete recv;
+    }
+
+    // one string message, eight listeners
+    {
+        OSC_Receiver * recv = new OSC_Receiver;
+        vector<OSC_Address_Space *> spaces;
+        vector<Packet> packets( 1 );
+        for( t_CKUINT i = 0; i < 8; i++ )
+            spaces.push_back( make_listener( recv, "/text, s" ) );
+        make_packet( packets[0], "/text", "the quick brown fox jumps over the lazy dog, again and again" );
+
+        fprintf( stdout, "string fan-out: 8 listeners\n" );
+        seconds = dispatch( recv, packets, BENCH_NUM_MESGS / 8, spaces, TRUE, &delivered );
+        bench_report( "/text s (deliveries)", delivered, seconds, "mesgs" );
+        delete recv;
+    }
+
+    // end to end: loopback UDP, 100 listeners
+    {
+        OSC_Receiver * recv = new OSC_Receiver;
+        vector<OSC_Address_Space *> spaces;
+        vector<Packet> packets( 100 );
+        for( t_CKUINT i = 0; i < 100; i++ )
+        {
+            sprintf( buf, "/ctl/%lu/value, f", i );
+            spaces.push_back( make_listener( recv, buf ) );
+            sprintf( buf, "/ctl/%lu/value", i );
+            make_packet( packets[i], buf, NULL );
+        }
+        recv->listen( BENCH_UDP_PORT );
+
+        OSC_Transmitter * out = new OSC_Transmitter;
+        out->setHost( (char *)"localhost", BENCH_UDP_PORT );
+        usleep( 100000 );
+
+        fprintf( stdout, "loopback UDP: 100 listeners\n" );
+        t_CKUINT sent = 0;
+        delivered = 0;
+        t_CKFLOAT start = bench_now();
+        while( sent < BENCH_NUM_UDP )
+        {
+            for( t_CKUINT i = 0; i < BENCH_UDP_BURST; i++, sent++ )
+                out->presend( packets[sent % packets.size()].bytes, packets[sent % packets.size()].len );
+            // wait for the burst ( or give up on it: UDP may drop )
+            t_CKFLOAT deadline = bench_now() + .1;
+            while( ( delivered += drain( spaces, FALSE ) ) < sent && bench_now() < deadline );
+        }
+        seconds = bench_now() - start;
+        bench_report( "sent", sent, seconds, "mesgs" );
+        bench_report( "delivered", delivered, seconds, "mesgs" );
+
+        recv->stopListening();
+        delete out;
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: render_scaling_bench.cpp
+// desc: block rendering of a polyphonic patch on 1 .. N render threads
+//
+//       each voice is an oscillator into two BiQuads and a JCRev, summed
+//       by a master Gain; the graph is ticked a block at a time through
+//       Chuck_UGen_Schedule with an XWorkPool of each size, and the output
+//       is checked against the single-threaded render.
+//
+//       usage: render_scaling_bench [max threads] (default: 8)
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "chuck_compile.h"
+#include "chuck_instr.h"
+#include "chuck_ugen.h"
+#include "chuck_globals.h"
+#include "util_thread.h"
+#include "bench_util.h"
+
+#include <vector>
+#include <stdlib.h>
+using namespace std;
+
+// voices in the patch
+#define BENCH_NUM_VOICES 64
+// samples per block
+#define BENCH_BLOCK_SIZE 256
+// samples rendered per thread count
+#define BENCH_NUM_FRAMES (44100 * 2)
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: construct()
+// desc: run native pre-constructors, parent first, as the VM would
+//-----------------------------------------------------------------------------
+static void construct( Chuck_Object * obj, Chuck_Type * type )
+{
+    if( type->parent ) construct( obj, type->parent );
+    if( type->info && type->info->pre_ctor && type->info->pre_ctor->native_func )
+        ((f_ctor)type->info->pre_ctor->native_func)( obj, NULL, NULL, Chuck_DL_Api::Api::instance() );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: make_ugen()
+// desc: instantiate a built-in ugen by type name
+//-----------------------------------------------------------------------------
+static Chuck_UGen * make_ugen( const char * name )
+{
+    Chuck_Type * type = Chuck_Env::instance()->global()->lookup_type( name );
+    assert( type != NULL );
+    Chuck_UGen * ugen = (Chuck_UGen *)instantiate_and_initialize_object( type, NULL );
+    construct( ugen, type );
+    ugen->add_ref();
+    ugen->alloc_v( BENCH_BLOCK_SIZE );
+    return ugen;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    std::list<std::string> paths, dls;
+    const char * oscs[] = { "SinOsc", "TriOsc", "PulseOsc" };
+    t_CKUINT max_threads = argc > 1 ? atoi( argv[1] ) : 8;
+    vector<SAMPLE> reference;
+    t_CKFLOAT start, base = 0;
+    t_CKUINT i, n;
+    char label[64];
+
+    // vm, type system and synthesis
+    g_vm = new Chuck_VM;
+    if( !g_vm->initialize( 44100, 2, 2, BENCH_BLOCK_SIZE, FALSE ) ) return 1;
+    g_compiler = new Chuck_Compiler;
+    if( !g_compiler->initialize( g_vm, paths, dls ) ) return 1;
+    if( !g_vm->initialize_synthesis() ) return 1;
+
+    fprintf( stdout, "[render_scaling_bench]: %d voices, block size %d\n",
+             BENCH_NUM_VOICES, BENCH_BLOCK_SIZE );
+
+    for( n = 1; n <= max_threads; n++ )
+    {
+        XWorkPool pool;
+        Chuck_UGen_Schedule schedule;
+        t_CKTIME now = 0;
+        t_CKUINT mismatch = 0;
+
+        // a fresh patch, so every run starts from the same state
+        Chuck_UGen * master = make_ugen( "Gain" );
+        for( i = 0; i < BENCH_NUM_VOICES; i++ )
+        {
+            Chuck_UGen * osc = make_ugen( oscs[i % 3] );
+            Chuck_UGen * lo = make_ugen( "BiQuad" );
+            Chuck_UGen * hi = make_ugen( "BiQuad" );
+            Chuck_UGen * rev = make_ugen( "JCRev" );
+            lo->add( osc, FALSE );
+            hi->add( lo, FALSE );
+            rev->add( hi, FALSE );
+            master->add( rev, FALSE );
+        }
+
+        pool.initialize( n );
+        schedule.set_roots( &master, 1, NULL );
+        schedule.set_pool( &pool, 1 );
+        schedule.compile();
+
+        start = bench_now();
+        for( i = 0; i < BENCH_NUM_FRAMES; i += BENCH_BLOCK_SIZE )
+        {
+            schedule.tick_v( now += BENCH_BLOCK_SIZE, BENCH_BLOCK_SIZE );
+            // same output whatever the thread count
+            if( n == 1 ) reference.push_back( master->m_current_v[BENCH_BLOCK_SIZE-1] );
+            else if( reference[i / BENCH_BLOCK_SIZE] != master->m_current_v[BENCH_BLOCK_SIZE-1] ) mismatch++;
+        }
+        t_CKFLOAT elapsed = bench_now() - start;
+        if( n == 1 ) base = elapsed;
+
+        sprintf( label, "%lu thread(s), %lu parts", n, schedule.num_parts() );
+        bench_report( label, BENCH_NUM_FRAMES, elapsed, "samples" );
+        fprintf( stdout, "  %-36s %12.2fx  (%lu steals)\n", "  speedup", base / elapsed, pool.steals() );
+        if( mismatch )
+            fprintf( stdout, "  MISMATCH: %lu blocks differ from 1 thread\n", mismatch );
+    }
+
+    return 0;
+}
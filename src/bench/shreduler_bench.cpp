@@ -0,0 +1,220 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: shreduler_bench.cpp
+// desc: shreduler wake queue vs. the previous sorted linked list
+//
+//       N shreds sleep for pseudo-random periods and are re-shreduled each
+//       time they wake, the way '=> now' loops behave; timing covers the
+//       shredule() + get() pairs only.
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "bench_util.h"
+
+#include <vector>
+using namespace std;
+
+// shredule + get pairs timed per size
+#define BENCH_NUM_WAKES 200000
+// longest sleep, in samples
+#define BENCH_MAX_PERIOD 2048
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Legacy_Shreduler
+// desc: the sorted list insert/pop the shreduler used before the wake queue
+//-----------------------------------------------------------------------------
+struct Legacy_Shreduler
+{
+    Chuck_VM_Shred * shred_list;
+    t_CKTIME now_system;
+
+    Legacy_Shreduler() : shred_list( NULL ), now_system( 0 ) { }
+
+    void shredule( Chuck_VM_Shred * shred, t_CKTIME wake_time )
+    {
+        shred->wake_time = wake_time;
+
+        Chuck_VM_Shred * curr = shred_list;
+        Chuck_VM_Shred * prev = NULL;
+        // linear search for the insertion point
+        while( curr )
+        {
+            if( curr->wake_time > wake_time ) break;
+            prev = curr;
+            curr = curr->next;
+        }
+
+        if( !prev )
+        {
+            shred->next = shred_list;
+            if( shred_list ) shred_list->prev = shred;
+            shred_list = shred;
+        }
+        else
+        {
+            shred->next = prev->next;
+            shred->prev = prev;
+            if( prev->next ) prev->next->prev = shred;
+            prev->next = shred;
+        }
+    }
+
+    Chuck_VM_Shred * get()
+    {
+        Chuck_VM_Shred * shred = shred_list;
+        if( !shred || shred->wake_time > now_system + .5 ) return NULL;
+
+        shred_list = shred->next;
+        shred->next = shred->prev = NULL;
+        if( shred_list ) shred_list->prev = NULL;
+        return shred;
+    }
+
+    t_CKTIME next_wake() const
+    { return shred_list ? shred_list->wake_time : now_system; }
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Queue_Shreduler
+// desc: adapter so both backends run the same driver
+//-----------------------------------------------------------------------------
+struct Queue_Shreduler
+{
+    Chuck_VM_Shreduler * shreduler;
+    t_CKTIME & now_system;
+
+    Queue_Shreduler( Chuck_VM_Shreduler * s )
+        : shreduler( s ), now_system( s->now_system ) { }
+
+    void shredule( Chuck_VM_Shred * shred, t_CKTIME wake_time )
+    { shreduler->shredule( shred, wake_time ); }
+
+    Chuck_VM_Shred * get()
+    { return shreduler->get(); }
+
+    t_CKTIME next_wake() const
+    { return now_system + ( shreduler->m_samps_until_next > 0 ?
+                            shreduler->m_samps_until_next : 0 ); }
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: run_wakes()
+// desc: drive a shreduler through num_wakes wake/re-shredule cycles
+//-----------------------------------------------------------------------------
+template <typename S>
+static t_CKFLOAT run_wakes( S & s, vector<Chuck_VM_Shred *> & shreds,
+                            const vector<t_CKUINT> & periods, t_CKUINT num_wakes )
+{
+    Chuck_VM_Shred * shred = NULL;
+    t_CKUINT woken = 0;
+
+    t_CKFLOAT start = bench_now();
+
+    // everyone starts now
+    for( t_CKUINT i = 0; i < shreds.size(); i++ )
+        s.shredule( shreds[i], s.now_system + periods[i] );
+
+    while( woken < num_wakes )
+    {
+        // jump to the next wake time
+        s.now_system = s.next_wake();
+        // run everything that is due, and put it back to sleep
+        while( woken < num_wakes && ( shred = s.get() ) )
+        {
+            s.shredule( shred, s.now_system + periods[shred->xid] );
+            woken++;
+        }
+    }
+
+    t_CKFLOAT elapsed = bench_now() - start;
+
+    // drain
+    s.now_system += BENCH_MAX_PERIOD + 1;
+    while( s.get() );
+
+    return elapsed;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    t_CKUINT sizes[] = { 10, 100, 1000, 10000 };
+    t_CKUINT seed = 9001;
+    char label[128];
+
+    fprintf( stdout, "[shreduler_bench]: %d wakes per size\n", BENCH_NUM_WAKES );
+
+    for( t_CKUINT n = 0; n < sizeof(sizes)/sizeof(t_CKUINT); n++ )
+    {
+        t_CKUINT N = sizes[n];
+        vector<Chuck_VM_Shred *> shreds( N );
+        vector<t_CKUINT> periods( N );
+
+        for( t_CKUINT i = 0; i < N; i++ )
+        {
+            shreds[i] = new Chuck_VM_Shred;
+            shreds[i]->xid = i;
+            periods[i] = 1 + bench_rand( seed ) % BENCH_MAX_PERIOD;
+        }
+
+        fprintf( stdout, "shreds: %lu\n", N );
+
+        // previous sorted list
+        Legacy_Shreduler legacy;
+        sprintf( label, "sorted list" );
+        bench_report( label, BENCH_NUM_WAKES,
+                      run_wakes( legacy, shreds, periods, BENCH_NUM_WAKES ), "wakes" );
+
+        // current wake queue
+        Chuck_VM_Shreduler * shreduler = new Chuck_VM_Shreduler;
+        Queue_Shreduler queue( shreduler );
+        sprintf( label, "wake queue" );
+        bench_report( label, BENCH_NUM_WAKES,
+                      run_wakes( queue, shreds, periods, BENCH_NUM_WAKES ), "wakes" );
+        delete shreduler;
+
+        for( t_CKUINT i = 0; i < N; i++ )
+            delete shreds[i];
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+//-----------------------------------------------------------------------------
+// file: uana_hop_bench.cpp
+// desc: hop-driven analysis chains: one controlling shred per chain that
+//       upchucks and advances time by the hop, vs. the same chains with
+//       hop and autoTock set and no shreds at all
+//
+//       each chain is SinOsc => FFT =^ Centroid => blackhole, with a small
+//       FFT by default so the driving dominates; both programs print the
+//       sum of the final centroids, which should read the same.
+//
+//       usage: uana_hop_bench [chains] [hop] [FFT size] (default: 64 32 32)
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "chuck_compile.h"
+#include "chuck_globals.h"
+#include "bench_util.h"
+
+#include <string>
+#include <stdlib.h>
+using namespace std;
+
+// samples per vm run() call
+#define BENCH_BLOCK_SIZE 256
+// seconds of audio per program
+#define BENCH_SECONDS 10
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: make_program()
+// desc: the chains, driven by shreds or by autoTock
+//-----------------------------------------------------------------------------
+static string make_program( t_CKUINT chains, t_CKUINT hop, t_CKUINT size,
+                            t_CKBOOL auto_tock )
+{
+    char buf[2048];
+
+    sprintf( buf,
+        "%lu => int N; %lu::samp => dur H;\n"
+        "SinOsc s[N]; FFT f[N]; Centroid c[N];\n"
+        "for( 0 => int i; i < N; i++ )\n"
+        "{\n"
+        "    s[i] => f[i] =^ c[i] => blackhole;\n"
+        "    110 + i * 13 => s[i].freq; %lu => f[i].size;\n"
+        "    %s\n"
+        "}\n"
+        "fun void drive( int i ) { while( true ) { c[i].upchuck(); H => now; } }\n"
+        "%s\n"
+        "%d::second => now;\n"
+        "0.0 => float sum;\n"
+        "for( 0 => int i; i < N; i++ ) c[i].fval(0) +=> sum;\n"
+        "<<< \"centroid sum\", sum >>>;\n",
+        chains, hop, size,
+        auto_tock ? "H => c[i].hop; 1 => c[i].autoTock;" : "",
+        auto_tock ? "" : "for( 0 => int i; i < N; i++ ) spork ~ drive( i );",
+        BENCH_SECONDS );
+
+    return buf;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: run_program()
+// desc: compile, spork, and run until the vm halts; seconds, or < 0 on error
+//-----------------------------------------------------------------------------
+static t_CKFLOAT run_program( const string & name, const string & src )
+{
+    SAMPLE input[BENCH_BLOCK_SIZE * 2] = { 0 };
+    SAMPLE output[BENCH_BLOCK_SIZE * 2];
+
+    if( !g_compiler->go( name, NULL, src.c_str(), name ) ) return -1;
+    Chuck_VM_Code * code = g_compiler->output();
+    code->name += name;
+
+    g_vm->start();
+    g_vm->spork( code, NULL );
+
+    t_CKFLOAT start = bench_now();
+    // run() is TRUE once the last shred is done; the driving shreds,
+    // if any, are children of the main shred and go with it
+    while( !g_vm->run( BENCH_BLOCK_SIZE, input, output ) );
+
+    return bench_now() - start;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    std::list<std::string> paths, dls;
+    t_CKUINT chains = argc > 1 ? atoi( argv[1] ) : 64;
+    t_CKUINT hop = argc > 2 ? atoi( argv[2] ) : 32;
+    t_CKUINT size = argc > 3 ? atoi( argv[3] ) : 32;
+    if( chains < 1 ) chains = 1;
+    if( hop < 1 ) hop = 1;
+
+    // vm, type system and synthesis
+    g_vm = new Chuck_VM;
+    if( !g_vm->initialize( 44100, 2, 2, 0, TRUE ) ) return 1;
+    g_compiler = new Chuck_Compiler;
+    if( !g_compiler->initialize( g_vm, paths, dls ) ) return 1;
+    if( !g_vm->initialize_synthesis() ) return 1;
+
+    fprintf( stdout, "[uana_hop_bench]: %lu chains, hop %lu, FFT size %lu, %d seconds\n",
+             chains, hop, size, BENCH_SECONDS );
+
+    t_CKFLOAT shreds = run_program( "shreds", make_program( chains, hop, size, FALSE ) );
+    t_CKFLOAT autos = run_program( "autoTock", make_program( chains, hop, size, TRUE ) );
+    if( shreds < 0 || autos < 0 )
+    {
+        fprintf( stdout, "  cannot compile\n" );
+        return 1;
+    }
+
+    t_CKUINT tocks = chains * ( BENCH_SECONDS * 44100 / hop + 1 );
+    bench_report( "shred per chain", tocks, shreds, "tocks" );
+    bench_report( "hop + autoTock", tocks, autos, "tocks" );
+    fprintf( stdout, "  %-36s %8.2fx\n", "speedup", shreds / autos );
+
+    return 0;
+}
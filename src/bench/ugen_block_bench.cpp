@@ -0,0 +1,149 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: ugen_block_bench.cpp
+// desc: per-sample vs. block ticking of a many-voice patch
+//
+//       each voice is an oscillator (SinOsc/TriOsc/PulseOsc in turn) into a
+//       BiQuad, summed by a Gain; the patch is ticked one sample at a time,
+//       a block at a time through the scalar tick, and a block at a time
+//       through the block tick (tickv).
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "chuck_compile.h"
+#include "chuck_instr.h"
+#include "chuck_ugen.h"
+#include "chuck_globals.h"
+#include "bench_util.h"
+
+#include <vector>
+using namespace std;
+
+// voices in the patch
+#define BENCH_NUM_VOICES 200
+// samples per block
+#define BENCH_BLOCK_SIZE 256
+// samples rendered per mode
+#define BENCH_NUM_FRAMES (44100 * 4)
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: construct()
+// desc: run native pre-constructors, parent first, as the VM would
+//-----------------------------------------------------------------------------
+static void construct( Chuck_Object * obj, Chuck_Type * type )
+{
+    if( type->parent ) construct( obj, type->parent );
+    if( type->info && type->info->pre_ctor && type->info->pre_ctor->native_func )
+        ((f_ctor)type->info->pre_ctor->native_func)( obj, NULL, NULL, Chuck_DL_Api::Api::instance() );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: make_ugen()
+// desc: instantiate a built-in ugen by type name
+//-----------------------------------------------------------------------------
+static Chuck_UGen * make_ugen( const char * name )
+{
+    Chuck_Type * type = Chuck_Env::instance()->global()->lookup_type( name );
+    assert( type != NULL );
+    Chuck_UGen * ugen = (Chuck_UGen *)instantiate_and_initialize_object( type, NULL );
+    construct( ugen, type );
+    ugen->add_ref();
+    return ugen;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    std::list<std::string> paths, dls;
+    const char * oscs[] = { "SinOsc", "TriOsc", "PulseOsc" };
+    vector<Chuck_UGen *> ugens;
+    vector<f_tickv> tickvs;
+    t_CKTIME now = 0;
+    t_CKFLOAT start;
+    t_CKUINT i;
+
+    // vm, type system and synthesis
+    g_vm = new Chuck_VM;
+    if( !g_vm->initialize( 44100, 2, 2, BENCH_BLOCK_SIZE, FALSE ) ) return 1;
+    g_compiler = new Chuck_Compiler;
+    if( !g_compiler->initialize( g_vm, paths, dls ) ) return 1;
+    if( !g_vm->initialize_synthesis() ) return 1;
+
+    // the patch
+    Chuck_UGen * mix = make_ugen( "Gain" );
+    ugens.push_back( mix );
+    for( i = 0; i < BENCH_NUM_VOICES; i++ )
+    {
+        Chuck_UGen * osc = make_ugen( oscs[i % 3] );
+        Chuck_UGen * filter = make_ugen( "BiQuad" );
+        filter->add( osc, FALSE );
+        mix->add( filter, FALSE );
+        ugens.push_back( osc );
+        ugens.push_back( filter );
+    }
+    for( i = 0; i < ugens.size(); i++ )
+        tickvs.push_back( ugens[i]->tickv );
+
+    fprintf( stdout, "[ugen_block_bench]: %d voices, block size %d\n",
+             BENCH_NUM_VOICES, BENCH_BLOCK_SIZE );
+
+    // one sample at a time (non-adaptive synthesis)
+    start = bench_now();
+    for( i = 0; i < BENCH_NUM_FRAMES; i++ )
+        mix->system_tick( ++now );
+    bench_report( "per-sample system_tick", BENCH_NUM_FRAMES, bench_now() - start, "samples" );
+
+    // blocks, scalar tick per sample
+    for( i = 0; i < ugens.size(); i++ )
+        ugens[i]->tickv = NULL;
+    start = bench_now();
+    for( i = 0; i < BENCH_NUM_FRAMES; i += BENCH_BLOCK_SIZE )
+        mix->system_tick_v( now += BENCH_BLOCK_SIZE, BENCH_BLOCK_SIZE );
+    bench_report( "block system_tick_v, scalar tick", BENCH_NUM_FRAMES, bench_now() - start, "samples" );
+
+    // blocks, block tick
+    for( i = 0; i < ugens.size(); i++ )
+        ugens[i]->tickv = tickvs[i];
+    start = bench_now();
+    for( i = 0; i < BENCH_NUM_FRAMES; i += BENCH_BLOCK_SIZE )
+        mix->system_tick_v( now += BENCH_BLOCK_SIZE, BENCH_BLOCK_SIZE );
+    bench_report( "block system_tick_v, block tick", BENCH_NUM_FRAMES, bench_now() - start, "samples" );
+
+    return 0;
+}
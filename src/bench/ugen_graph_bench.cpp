@@ -0,0 +1,183 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+// file: ugen_graph_bench.cpp
+// desc: recursive system_tick() vs. the flattened Chuck_UGen_Schedule
+//
+//       each graph is a random DAG of Gains under one root, with extra
+//       cross edges (fan-out) and a feedback edge from the root back into
+//       every 32nd node.  two identical copies are built; one is ticked
+//       recursively and the other through the schedule, one sample at a
+//       time, and their outputs are checked to match before timing.
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "chuck_compile.h"
+#include "chuck_instr.h"
+#include "chuck_ugen.h"
+#include "chuck_globals.h"
+#include "bench_util.h"
+
+#include <vector>
+using namespace std;
+
+// node ticks per measurement (frames = this / graph size)
+#define BENCH_NODE_TICKS (20000000)
+// samples compared before timing
+#define BENCH_CHECK_FRAMES 1000
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: construct()
+// desc: run native pre-constructors, parent first, as the VM would
+//-----------------------------------------------------------------------------
+static void construct( Chuck_Object * obj, Chuck_Type * type )
+{
+    if( type->parent ) construct( obj, type->parent );
+    if( type->info && type->info->pre_ctor && type->info->pre_ctor->native_func )
+        ((f_ctor)type->info->pre_ctor->native_func)( obj, NULL, NULL, Chuck_DL_Api::Api::instance() );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: make_ugen()
+// desc: instantiate a built-in ugen by type name
+//-----------------------------------------------------------------------------
+static Chuck_UGen * make_ugen( const char * name )
+{
+    Chuck_Type * type = Chuck_Env::instance()->global()->lookup_type( name );
+    assert( type != NULL );
+    Chuck_UGen * ugen = (Chuck_UGen *)instantiate_and_initialize_object( type, NULL );
+    construct( ugen, type );
+    ugen->add_ref();
+    return ugen;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: make_graph()
+// desc: a random graph of num_nodes ugens; nodes[0] is the root
+//-----------------------------------------------------------------------------
+static void make_graph( vector<Chuck_UGen *> & nodes, t_CKUINT num_nodes )
+{
+    t_CKUINT seed = 1, i;
+
+    // keep the feedback loops stable
+    nodes.push_back( make_ugen( "Gain" ) );
+    nodes[0]->m_gain = .5f / num_nodes;
+    for( i = 1; i < num_nodes; i++ )
+    {
+        // leaves produce signal
+        Chuck_UGen * node = make_ugen( i % 4 == 3 ? "SinOsc" : "Gain" );
+        nodes[bench_rand( seed ) % i]->add( node, FALSE );
+        // fan-out
+        if( i % 4 == 0 )
+            nodes[bench_rand( seed ) % i]->add( node, FALSE );
+        // feedback
+        if( i % 32 == 0 )
+            node->add( nodes[0], FALSE );
+        nodes.push_back( node );
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    std::list<std::string> paths, dls;
+    t_CKUINT sizes[] = { 100, 1000, 10000 };
+    t_CKTIME now = 0;
+    t_CKFLOAT start;
+    t_CKUINT i, j;
+    char label[64];
+
+    // vm, type system and synthesis
+    g_vm = new Chuck_VM;
+    if( !g_vm->initialize( 44100, 2, 2, 256, FALSE ) ) return 1;
+    g_compiler = new Chuck_Compiler;
+    if( !g_compiler->initialize( g_vm, paths, dls ) ) return 1;
+    if( !g_vm->initialize_synthesis() ) return 1;
+
+    fprintf( stdout, "[ugen_graph_bench]: %d node ticks per run\n", BENCH_NODE_TICKS );
+
+    for( j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++ )
+    {
+        vector<Chuck_UGen *> a, b;
+        Chuck_UGen_Schedule schedule;
+        t_CKUINT frames = BENCH_NODE_TICKS / sizes[j];
+        t_CKUINT mismatch = 0;
+
+        // two identical graphs
+        make_graph( a, sizes[j] );
+        make_graph( b, sizes[j] );
+        Chuck_UGen * root_a = a[0];
+        Chuck_UGen * root_b = b[0];
+        schedule.set_roots( &root_b, 1, NULL );
+
+        // compile
+        start = bench_now();
+        schedule.compile();
+        sprintf( label, "compile, %lu nodes", sizes[j] );
+        bench_report( label, schedule.size(), bench_now() - start, "steps" );
+
+        // check
+        for( i = 0; i < BENCH_CHECK_FRAMES; i++ )
+        {
+            root_a->system_tick( ++now );
+            schedule.tick( now );
+            if( root_a->m_current != root_b->m_current ) mismatch++;
+        }
+        if( mismatch )
+            fprintf( stdout, "  MISMATCH: %lu of %d samples differ\n", mismatch, BENCH_CHECK_FRAMES );
+
+        // recursive
+        start = bench_now();
+        for( i = 0; i < frames; i++ )
+            root_a->system_tick( ++now );
+        sprintf( label, "recursive, %lu nodes", sizes[j] );
+        bench_report( label, frames, bench_now() - start, "samples" );
+
+        // flattened
+        start = bench_now();
+        for( i = 0; i < frames; i++ )
+            schedule.tick( ++now );
+        sprintf( label, "schedule, %lu nodes", sizes[j] );
+        bench_report( label, frames, bench_now() - start, "samples" );
+    }
+
+    return 0;
+}
@@ -0,0 +1,7 @@
+// interpreter-bound: recursive function calls
+fun int fib( int n )
+{
+    if( n < 2 ) return n;
+    return fib( n - 1 ) + fib( n - 2 );
+}
+<<< "fib", fib( 30 ) >>>;
@@ -0,0 +1,13 @@
+// interpreter-bound: nested int/float loops, locals and arithmetic
+0 => int sum;
+0.0 => float acc;
+for( 0 => int i; i < 2000; i++ )
+{
+    for( 0 => int j; j < 1000; j++ )
+    {
+        ( i * j ) % 7 +=> sum;
+        if( j % 3 == 0 ) 0.5 * j +=> acc;
+        else acc - 1.0 => acc;
+    }
+}
+<<< "loops", sum, acc >>>;
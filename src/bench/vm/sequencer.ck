@@ -0,0 +1,27 @@
+// interpreter-bound: many shreds running control logic every few samples,
+// the way sequencers and algorithmic pieces do
+64 => int VOICES;
+0 => int notes;
+
+fun void voice( int id )
+{
+    id => int state;
+    0 => int pitch;
+    for( 0 => int step; step < 2000; step++ )
+    {
+        // linear congruential pattern
+        ( state * 1103515245 + 12345 ) % 2147483648 => state;
+        if( state < 0 ) -state => state;
+        // scale degree, octave, and a little voice leading
+        [ 0, 2, 4, 5, 7, 9, 11 ] @=> int scale[];
+        48 + scale[( state / 7 ) % 7] + 12 * ( ( state / 49 ) % 3 ) => int next;
+        if( next - pitch > 7 ) next - 12 => next;
+        next => pitch;
+        notes++;
+        ( 1 + state % 4 )::samp => now;
+    }
+}
+
+for( 0 => int i; i < VOICES; i++ ) spork ~ voice( i );
+while( notes < VOICES * 2000 ) 1::ms => now;
+<<< "sequencer", notes >>>;
@@ -0,0 +1,12 @@
+// interpreter-bound: array access in tight loops
+1000000 => int N;
+int composite[N + 1];
+0 => int count;
+for( 2 => int i; i <= N; i++ )
+{
+    if( composite[i] ) continue;
+    count++;
+    for( i * i => int j; j <= N; i +=> j )
+        1 => composite[j];
+}
+<<< "sieve", count >>>;
@@ -0,0 +1,17 @@
+// interpreter-bound: lots of short-lived shreds
+0 => int done;
+
+fun void work( int n )
+{
+    0 => int x;
+    for( 0 => int i; i < n; i++ ) i ^ x => x;
+    done++;
+}
+
+for( 0 => int round; round < 30; round++ )
+{
+    for( 0 => int i; i < 300; i++ ) spork ~ work( 100 + i );
+    1::samp => now;
+}
+while( done < 9000 ) 1::samp => now;
+<<< "sporks", done >>>;
@@ -0,0 +1,128 @@
+/*----------------------------------------------------------------------------
+  ChucK Concurrent, On-the-fly Audio Programming Language
+    Compiler and Virtual Machine
+
+  Copyright (c) 2004 Ge Wang and Perry R. Cook.  All rights reserved.
+    http://chuck.stanford.edu/
+    http://chuck.cs.princeton.edu/
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+  U.S.A.
+-----------------------------------------------------------------------------*/
+
+
+//-----------------------------------------------------------------------------
+// file: vm_dispatch_bench.cpp
+// desc: interpreter-bound programs on the threaded interpreter vs. one
+//       virtual execute() per instruction, and on the threaded interpreter
+//       after the emitter's peephole pass (--optimize)
+//
+//       each program is compiled once per run and timed from spork until
+//       the vm halts, so compile time is not counted; the programs print
+//       a result line, which should read the same under all three.
+//
+//       usage: vm_dispatch_bench [file.ck ...] (default: vm/*.ck)
+//
+// date: Autumn 2026
+//-----------------------------------------------------------------------------
+#include "chuck_vm.h"
+#include "chuck_compile.h"
+#include "chuck_globals.h"
+#include "bench_util.h"
+
+#include <vector>
+#include <string>
+using namespace std;
+
+// samples per vm run() call
+#define BENCH_BLOCK_SIZE 256
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: run_program()
+// desc: compile, spork, and run until the vm halts; seconds, or < 0 on error
+//-----------------------------------------------------------------------------
+static t_CKFLOAT run_program( const string & filename, t_CKBOOL threaded,
+                              t_CKBOOL optimize )
+{
+    SAMPLE input[BENCH_BLOCK_SIZE * 2] = { 0 };
+    SAMPLE output[BENCH_BLOCK_SIZE * 2];
+
+    g_compiler->emitter->optimize = optimize;
+    if( !g_compiler->go( filename, NULL, NULL, filename ) ) return -1;
+    Chuck_VM_Code * code = g_compiler->output();
+    code->name += filename;
+
+    g_vm->m_threaded = threaded;
+    g_vm->start();
+    g_vm->spork( code, NULL );
+
+    t_CKFLOAT start = bench_now();
+    // run() is TRUE once the last shred is done
+    while( !g_vm->run( BENCH_BLOCK_SIZE, input, output ) );
+
+    return bench_now() - start;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: main()
+// desc: ...
+//-----------------------------------------------------------------------------
+int main( int argc, const char ** argv )
+{
+    std::list<std::string> paths, dls;
+    const char * defaults[] = { "vm/loops.ck", "vm/fib.ck", "vm/sieve.ck",
+                                "vm/sequencer.ck", "vm/sporks.ck" };
+    vector<string> files;
+
+    for( int i = 1; i < argc; i++ ) files.push_back( argv[i] );
+    if( files.empty() )
+        files.assign( defaults, defaults + sizeof(defaults)/sizeof(char *) );
+
+    // vm (halts when out of shreds), type system and synthesis
+    g_vm = new Chuck_VM;
+    if( !g_vm->initialize( 44100, 2, 2, 0, TRUE ) ) return 1;
+    g_compiler = new Chuck_Compiler;
+    if( !g_compiler->initialize( g_vm, paths, dls ) ) return 1;
+    if( !g_vm->initialize_synthesis() ) return 1;
+
+    fprintf( stdout, "[vm_dispatch_bench]: %lu programs\n", files.size() );
+
+    for( t_CKUINT i = 0; i < files.size(); i++ )
+    {
+        t_CKFLOAT base = run_program( files[i], FALSE, FALSE );
+        t_CKFLOAT threaded = run_program( files[i], TRUE, FALSE );
+        t_CKFLOAT optimized = run_program( files[i], TRUE, TRUE );
+        if( base < 0 || threaded < 0 || optimized < 0 )
+        {
+            fprintf( stdout, "  %s: cannot compile\n", files[i].c_str() );
+            continue;
+        }
+
+        fprintf( stdout, "%s\n", files[i].c_str() );
+        fprintf( stdout, "  %-36s %8.3f sec\n", "  virtual execute()", base );
+        fprintf( stdout, "  %-36s %8.3f sec\n", "  threaded", threaded );
+        fprintf( stdout, "  %-36s %8.2fx\n", "  speedup", base / threaded );
+        fprintf( stdout, "  %-36s %8.3f sec\n", "  threaded + optimize", optimized );
+        fprintf( stdout, "  %-36s %8.2fx\n", "  speedup", base / optimized );
+    }
+
+    return 0;
+}
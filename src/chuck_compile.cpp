@@ -46,6 +46,7 @@
 #include "ulib_opsc.h"
 #include "ulib_regex.h"
 #include "chuck_io.h"
+#include "util_string.h"
 
 #if defined(__PLATFORM_WIN32__)
 #include "dirent_win32.h"
@@ -79,6 +80,7 @@ Chuck_Compiler::Chuck_Compiler()
     env = NULL;
     emitter = NULL;
     code = NULL;
+    worker = NULL;
 }
 
 
@@ -159,6 +161,9 @@ void Chuck_Compiler::shutdown()
     // push indent
     EM_pushlog();
 
+    // the worker compiles with us; stop it first
+    stop_worker();
+
     // TODO: free
     type_engine_shutdown( env );
     // emit_engine_shutdown( emitter );
@@ -184,6 +189,51 @@ void Chuck_Compiler::shutdown()
 
 
 
+//-----------------------------------------------------------------------------
+// name: start_worker()
+// desc: compile add/replace requests on a separate thread from here on
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Compiler::start_worker( Chuck_VM * vm )
+{
+    // already running
+    if( worker ) return TRUE;
+
+    // log
+    EM_log( CK_LOG_SYSTEM, "starting compile worker..." );
+
+    // allocate and start
+    worker = new Chuck_Compile_Worker;
+    if( !worker->start( vm, this ) )
+    {
+        EM_log( CK_LOG_SYSTEM, "cannot start compile worker; compiling in place..." );
+        SAFE_DELETE( worker );
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: stop_worker()
+// desc: finish the current request and stop the worker
+//-----------------------------------------------------------------------------
+void Chuck_Compiler::stop_worker()
+{
+    if( !worker ) return;
+
+    // log
+    EM_log( CK_LOG_SYSTEM, "stopping compile worker..." );
+
+    worker->stop();
+    SAFE_DELETE( worker );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: bind()
 // desc: bind a new type system module, via query function
@@ -365,6 +415,10 @@ t_CKBOOL Chuck_Compiler::do_entire_file( Chuck_Context * context )
     if( !type_engine_check_context( env, context, te_do_all ) )
         return FALSE;
 
+    // fold constants, prune dead branches
+    if( !type_engine_fold_context( env, context, te_do_all ) )
+        return FALSE;
+
     // emit (pass 4)
     if( !emit_engine_emit_prog( emitter, g_program ) )
         return FALSE;
@@ -400,6 +454,10 @@ t_CKBOOL Chuck_Compiler::do_only_classes( Chuck_Context * context )
     if( !type_engine_check_context( env, context, te_do_classes_only ) )
         return FALSE;
 
+    // fold constants, prune dead branches
+    if( !type_engine_fold_context( env, context, te_do_classes_only ) )
+        return FALSE;
+
     // emit (pass 4)
     if( !(code = emit_engine_emit_prog( emitter, g_program , te_do_classes_only )) )
         return FALSE;
@@ -433,6 +491,10 @@ t_CKBOOL Chuck_Compiler::do_all_except_classes( Chuck_Context * context )
     if( !type_engine_check_context( env, context, te_do_no_classes ) )
         return FALSE;
 
+    // fold constants, prune dead branches
+    if( !type_engine_fold_context( env, context, te_do_no_classes ) )
+        return FALSE;
+
     // emit (pass 4)
     if( !(code = emit_engine_emit_prog( emitter, g_program, te_do_no_classes )) )
         return FALSE;
@@ -452,15 +514,51 @@ t_CKBOOL Chuck_Compiler::do_all_except_classes( Chuck_Context * context )
 //-----------------------------------------------------------------------------
 t_CKBOOL Chuck_Compiler::do_normal( const string & filename, FILE * fd, const char * str_src, const string & full_path )
 {
-    t_CKBOOL ret = TRUE;
-    Chuck_Context * context = NULL;
+    a_Program prog = NULL;
 
+    // parse the code
+    if( !this->parse( filename, fd, str_src, &prog ) )
+        return FALSE;
+
+    // type-check and emit
+    return this->check( prog, filename, full_path );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: parse()
+// desc: parse a program, without touching the type system or the vm
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Compiler::parse( const string & filename, FILE * fd, const char * str_src,
+                                a_Program * prog )
+{
     // parse the code
     if( !chuck_parse( filename.c_str(), fd, str_src ) )
         return FALSE;
 
+    // hand it over
+    *prog = g_program;
+    g_program = NULL;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: check()
+// desc: type-check and emit a parsed program
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Compiler::check( a_Program prog, const string & filename, const string & full_path )
+{
+    t_CKBOOL ret = TRUE;
+    Chuck_Context * context = NULL;
+
     // make the context
-    context = type_engine_make_context( g_program, filename );
+    context = type_engine_make_context( prog, filename );
     if( !context ) return FALSE;
     
     // remember full path (added 1.3.0.0)
@@ -474,23 +572,27 @@ t_CKBOOL Chuck_Compiler::do_normal( const string & filename, FILE * fd, const ch
         return FALSE;
 
     // 0th-scan (pass 0)
-    if( !type_engine_scan0_prog( env, g_program, te_do_all ) )
+    if( !type_engine_scan0_prog( env, prog, te_do_all ) )
     { ret = FALSE; goto cleanup; }
 
     // 1st-scan (pass 1)
-    if( !type_engine_scan1_prog( env, g_program, te_do_all ) )
+    if( !type_engine_scan1_prog( env, prog, te_do_all ) )
     { ret = FALSE; goto cleanup; }
 
     // 2nd-scan (pass 2)
-    if( !type_engine_scan2_prog( env, g_program, te_do_all ) )
+    if( !type_engine_scan2_prog( env, prog, te_do_all ) )
     { ret = FALSE; goto cleanup; }
 
     // check the program (pass 3)
     if( !type_engine_check_context( env, context, te_do_all ) )
     { ret = FALSE; goto cleanup; }
 
+    // fold constants, prune dead branches
+    if( !type_engine_fold_context( env, context, te_do_all ) )
+    { ret = FALSE; goto cleanup; }
+
     // emit (pass 4)
-    if( !(code = emit_engine_emit_prog( emitter, g_program, te_do_all )) )
+    if( !(code = emit_engine_emit_prog( emitter, prog, te_do_all )) )
     { ret = FALSE; goto cleanup; }
 
 cleanup:
@@ -897,3 +999,287 @@ error:
 	*/
 }
 
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: Chuck_Compile_Worker()
+// desc: constructor
+//-----------------------------------------------------------------------------
+Chuck_Compile_Worker::Chuck_Compile_Worker()
+{
+    m_vm = NULL;
+    m_compiler = NULL;
+    m_checked = 0;
+    m_running = FALSE;
+    m_quit = FALSE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~Chuck_Compile_Worker()
+// desc: destructor
+//-----------------------------------------------------------------------------
+Chuck_Compile_Worker::~Chuck_Compile_Worker()
+{
+    this->stop();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: start()
+// desc: start the worker thread
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Compile_Worker::start( Chuck_VM * vm, Chuck_Compiler * compiler )
+{
+    if( m_running ) return TRUE;
+
+    m_vm = vm;
+    m_compiler = compiler;
+    m_quit = FALSE;
+
+    if( !m_thread.start( worker_cb, this ) )
+        return FALSE;
+
+    m_running = TRUE;
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: stop()
+// desc: finish the current request, drop the rest, and join
+//-----------------------------------------------------------------------------
+void Chuck_Compile_Worker::stop()
+{
+    if( !m_running ) return;
+
+    m_lock.acquire();
+    m_quit = TRUE;
+    m_wake.signal_all();
+    // (also stop waiting on the vm)
+    m_done.signal_all();
+    m_lock.release();
+
+    m_thread.wait( -1, false );
+    m_running = FALSE;
+
+    // drop what was never compiled, releasing anyone waiting on it
+    m_lock.acquire();
+    while( !m_queue.empty() )
+    {
+        Request & request = m_queue.front();
+        if( request.fd ) fclose( request.fd );
+        if( request.status ) *request.status = -1;
+        SAFE_DELETE( request.cmd );
+        m_queue.pop_front();
+    }
+    m_done.signal_all();
+    m_lock.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: submit()
+// desc: queue a request for the worker
+//-----------------------------------------------------------------------------
+void Chuck_Compile_Worker::submit( Chuck_Msg * cmd, const std::string & filename,
+                                   FILE * fd, t_CKINT * status )
+{
+    Request request;
+    request.cmd = cmd;
+    request.filename = filename;
+    request.fd = fd;
+    request.status = status;
+
+    m_lock.acquire();
+    m_queue.push_back( request );
+    m_wake.signal_all();
+    m_lock.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: wait()
+// desc: block until a submitted status is set
+//-----------------------------------------------------------------------------
+void Chuck_Compile_Worker::wait( t_CKINT * status )
+{
+    m_lock.acquire();
+    while( *status == 0 )
+        m_done.wait( m_lock );
+    m_lock.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: compile()
+// desc: compile one request, returning TRUE on success
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Compile_Worker::compile( Request & request )
+{
+    Chuck_Msg * cmd = request.cmd;
+    a_Program prog = NULL;
+
+    // parse
+    EM_reset_msg();
+    t_CKBOOL ok = m_compiler->parse( request.filename, request.fd, NULL, &prog );
+    // close file handle
+    if( request.fd ) fclose( request.fd );
+    request.fd = NULL;
+
+    if( !ok )
+    {
+        // answer a waiting shred with 0
+        if( cmd->waiting ) m_vm->queue_msg( cmd, 1 );
+        else SAFE_DELETE( cmd );
+        request.cmd = NULL;
+        return FALSE;
+    }
+
+    // the vm type-checks and emits it, then sporks it (or answers a
+    // waiting shred with 0) at its next block
+    Check * check = new Check;
+    check->prog = prog;
+    check->filename = request.filename;
+    // construct full path to be associated with the file so me.sourceDir() works
+    check->full_path = get_full_path( request.filename );
+    check->worker = this;
+    check->refs = 2;
+    cmd->compile = check_cb;
+    cmd->compile_data = check;
+
+    m_lock.acquire();
+    m_checked = 0;
+    m_lock.release();
+
+    m_vm->queue_msg( cmd, 1 );
+    request.cmd = NULL;
+
+    // wait for it (unless stopping)
+    m_lock.acquire();
+    while( !m_quit && !m_checked )
+        m_done.wait( m_lock );
+    ok = m_checked > 0;
+    m_lock.release();
+
+    // the vm no longer reports to us
+    check->lock.acquire();
+    check->worker = NULL;
+    check->lock.release();
+    release( check );
+
+    return ok;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: release()
+// desc: drop a reference to check
+//-----------------------------------------------------------------------------
+void Chuck_Compile_Worker::release( Check * check )
+{
+    check->lock.acquire();
+    t_CKINT refs = --check->refs;
+    check->lock.release();
+
+    if( !refs ) delete check;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: check_cb()
+// desc: type-check and emit a msg's program, on the vm thread, and report
+//       to the worker if it still waits
+//-----------------------------------------------------------------------------
+void Chuck_Compile_Worker::check_cb( Chuck_Msg * msg )
+{
+    Check * check = (Check *)msg->compile_data;
+    msg->compile = NULL;
+    msg->compile_data = NULL;
+
+    // (the worker cannot stop waiting while this is held)
+    check->lock.acquire();
+    Chuck_Compile_Worker * worker = check->worker;
+    if( worker )
+    {
+        Chuck_Compiler * compiler = worker->m_compiler;
+        // type-check and emit
+        t_CKBOOL ok = compiler->check( check->prog, check->filename, check->full_path );
+        if( ok )
+        {
+            // get the code
+            msg->code = compiler->output();
+            // name it
+            msg->code->name += check->filename;
+        }
+
+        // report back
+        worker->m_lock.acquire();
+        worker->m_checked = ok ? 1 : -1;
+        worker->m_done.signal_all();
+        worker->m_lock.release();
+    }
+    check->lock.release();
+
+    release( check );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: worker_cb()
+// desc: thread function
+//-----------------------------------------------------------------------------
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+void * Chuck_Compile_Worker::worker_cb( void * _worker )
+#elif defined(__PLATFORM_WIN32__)
+unsigned Chuck_Compile_Worker::worker_cb( void * _worker )
+#endif
+{
+    Chuck_Compile_Worker * worker = (Chuck_Compile_Worker *)_worker;
+
+    worker->m_lock.acquire();
+    while( TRUE )
+    {
+        // wait for a request
+        while( !worker->m_quit && worker->m_queue.empty() )
+            worker->m_wake.wait( worker->m_lock );
+        if( worker->m_quit ) break;
+
+        Request request = worker->m_queue.front();
+        worker->m_queue.pop_front();
+
+        worker->m_lock.release();
+        t_CKBOOL ok = worker->compile( request );
+        worker->m_lock.acquire();
+
+        // report back
+        if( request.status )
+        {
+            *request.status = ok ? 1 : -1;
+            worker->m_done.signal_all();
+        }
+    }
+    worker->m_lock.release();
+
+    return 0;
+}
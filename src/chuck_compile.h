@@ -38,11 +38,14 @@
 #include "chuck_type.h"
 #include "chuck_emit.h"
 #include "chuck_vm.h"
+#include "util_thread.h"
 #include <list>
+#include <deque>
 
 
 // forward reference
 struct Chuck_DLL;
+struct Chuck_Compile_Worker;
 
 
 
@@ -68,6 +71,9 @@ public: // data
     
     std::list<Chuck_DLL *> m_dlls;
     std::list<std::string> m_cklibs_to_preload;
+
+    // compile worker (NULL until start_worker())
+    Chuck_Compile_Worker * worker;
     
 public: // to all
     // contructor
@@ -82,6 +88,12 @@ public: // to all
     // shutdown
     void shutdown();
 
+public: // compile worker
+    // compile add/replace requests on a separate thread from here on
+    t_CKBOOL start_worker( Chuck_VM * vm );
+    // finish the current request and stop the worker
+    void stop_worker();
+
 public: // additional binding
     // bind a new type system module, via query function
     t_CKBOOL bind( f_ck_query query_func, const std::string & name,
@@ -93,6 +105,12 @@ public: // compile
     // parse, type-check, and emit a program
     t_CKBOOL go( const std::string & filename, FILE * fd = NULL, 
                  const char * str_src = NULL, const std::string & full_path = "" );
+    // parse a program only (as go() does first), handing it to prog
+    t_CKBOOL parse( const std::string & filename, FILE * fd, const char * str_src,
+                    a_Program * prog );
+    // type-check and emit a parsed program (the rest of go())
+    t_CKBOOL check( a_Program prog, const std::string & filename,
+                    const std::string & full_path = "" );
     // resolve a type automatically, if auto_depend is on
     t_CKBOOL resolve( const std::string & type );
     // get the code generated from the last go()
@@ -117,6 +135,90 @@ protected: // internal
 };
 
 
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Compile_Worker
+// desc: parses add/replace requests, in order, on its own thread, so that
+//       neither the audio thread nor the otf listener parses.  type-checking
+//       and emitting change the type system and vm objects, so each parsed
+//       program is queued to the vm as a message, checked and emitted there
+//       (see Chuck_Msg::compile) and sporked; the worker waits for that
+//       before parsing the next request
+//-----------------------------------------------------------------------------
+struct Chuck_Compile_Worker
+{
+public:
+    Chuck_Compile_Worker();
+    ~Chuck_Compile_Worker();
+
+public:
+    // start the worker thread
+    t_CKBOOL start( Chuck_VM * vm, Chuck_Compiler * compiler );
+    // finish the current request, drop the rest, and join
+    void stop();
+    // is the thread running?
+    t_CKBOOL running() const { return m_running; }
+
+public:
+    // parse filename (read from fd instead, if not NULL; the worker
+    // closes it) and queue cmd to the vm to compile into cmd->code; a cmd
+    // that fails to parse is only queued if a shred waits on it.  if status
+    // is not NULL, it is set to 1 (compiled) or -1 (failed) when done
+    void submit( Chuck_Msg * cmd, const std::string & filename, FILE * fd,
+                 t_CKINT * status );
+    // block until a submitted status is set
+    void wait( t_CKINT * status );
+
+protected:
+    // a pending request
+    struct Request
+    {
+        Chuck_Msg * cmd;
+        std::string filename;
+        FILE * fd;
+        t_CKINT * status;
+    };
+
+    // a parsed program, for the vm to check and emit
+    struct Check
+    {
+        a_Program prog;
+        std::string filename;
+        std::string full_path;
+        // NULL once the worker no longer waits on it
+        Chuck_Compile_Worker * worker;
+        // held by the worker and the msg
+        t_CKINT refs;
+        XMutex lock;
+    };
+
+    // compile one request, returning TRUE on success
+    t_CKBOOL compile( Request & request );
+    // drop a reference to check
+    static void release( Check * check );
+    // type-check and emit a msg's program (on the vm thread)
+    static void check_cb( Chuck_Msg * msg );
+    // thread function
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    static void * worker_cb( void * _worker );
+#elif defined(__PLATFORM_WIN32__)
+    static unsigned THREAD_TYPE worker_cb( void * _worker );
+#endif
+
+protected:
+    Chuck_VM * m_vm;
+    Chuck_Compiler * m_compiler;
+    XThread m_thread;
+    XMutex m_lock;
+    XCondition m_wake;
+    XCondition m_done;
+    std::deque<Request> m_queue;
+    // the vm's result for the program in flight (1 or -1; 0 while waiting)
+    t_CKINT m_checked;
+    t_CKBOOL m_running;
+    t_CKBOOL m_quit;
+};
+
+
 // call this to detach all open files
 extern "C" void all_detach();
 
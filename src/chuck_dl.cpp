@@ -473,6 +473,37 @@ void CK_DLL_CALL ck_add_ugen_funcf( Chuck_DL_Query * query, f_tickf ugen_tickf,
 
 
 
+//-----------------------------------------------------------------------------
+// name: ck_add_ugen_funcv()
+// desc: (ugen only) add block tick function; the per-sample tick is still
+//       required, the block tick is used when a whole buffer is ticked at once
+//-----------------------------------------------------------------------------
+void CK_DLL_CALL ck_add_ugen_funcv( Chuck_DL_Query * query, f_tickv ugen_tickv )
+{
+    // make sure there is class
+    if( !query->curr_class )
+    {
+        // error
+        EM_error2( 0, "class import: add_ugen_funcv invoked without begin_class..." );
+        return;
+    }
+    
+    // make sure tickv not defined already
+    if( query->curr_class->ugen_tickv && ugen_tickv )
+    {
+        // error
+        EM_error2( 0, "class import: ugen_tickv already defined..." );
+        return;
+    }
+    
+    // set
+    query->curr_class->ugen_tickv = ugen_tickv;
+    query->curr_func = NULL;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: ck_add_ugen_ctrl()
 // desc: (ugen only) add ctrl parameters
@@ -932,6 +963,7 @@ Chuck_DL_Query::Chuck_DL_Query( )
     add_arg = ck_add_arg;
     add_ugen_func = ck_add_ugen_func;
     add_ugen_funcf = ck_add_ugen_funcf;
+    add_ugen_funcv = ck_add_ugen_funcv;
     add_ugen_ctrl = ck_add_ugen_ctrl;
     end_class = ck_end_class;
     create_main_thread_hook = ck_create_main_thread_hook;
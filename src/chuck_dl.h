@@ -204,6 +204,9 @@ typedef const Chuck_DL_Api::Api *CK_DL_API;
 // macro for defining ChucK DLL export ugen multi-channel tick functions
 // example: CK_DLL_TICKF(foo)
 #define CK_DLL_TICKF(name) CK_DLL_EXPORT(t_CKBOOL) name( Chuck_Object * SELF, SAMPLE * in, SAMPLE * out, t_CKUINT nframes, Chuck_VM_Shred * SHRED, CK_DL_API API )
+// macro for defining ChucK DLL export ugen block tick functions
+// example: CK_DLL_TICKV(foo)
+#define CK_DLL_TICKV(name) CK_DLL_EXPORT(t_CKBOOL) name( Chuck_Object * SELF, SAMPLE * in, SAMPLE * out, t_CKUINT nframes, Chuck_VM_Shred * SHRED, CK_DL_API API )
 // macro for defining ChucK DLL export ugen ctrl functions
 // example: CK_DLL_CTRL(foo)
 #define CK_DLL_CTRL(name) CK_DLL_EXPORT(void) name( Chuck_Object * SELF, void * ARGS, Chuck_DL_Return * RETURN, Chuck_VM_Shred * SHRED, CK_DL_API API )
@@ -216,6 +219,9 @@ typedef const Chuck_DL_Api::Api *CK_DL_API;
 // macro for defining ChucK DLL export uana tock functions
 // example: CK_DLL_TOCK(foo)
 #define CK_DLL_TOCK(name) CK_DLL_EXPORT(t_CKBOOL) name( Chuck_Object * SELF, Chuck_UAna * UANA, Chuck_UAnaBlobProxy * BLOB, Chuck_VM_Shred * SHRED, CK_DL_API API )
+// macro for defining ChucK DLL export uana snap functions
+// example: CK_DLL_SNAP(foo)
+#define CK_DLL_SNAP(name) CK_DLL_EXPORT(t_CKVOID) name( Chuck_Object * SELF, Chuck_UAna * UANA, CK_DL_API API )
 
 
 // macros for DLL exports
@@ -249,11 +255,16 @@ typedef t_CKVOID (CK_DLL_CALL * f_sfun)( void * ARGS, Chuck_DL_Return * RETURN,
 // ugen specific
 typedef t_CKBOOL (CK_DLL_CALL * f_tick)( Chuck_Object * SELF, SAMPLE in, SAMPLE * out, Chuck_VM_Shred * SHRED, CK_DL_API API );
 typedef t_CKBOOL (CK_DLL_CALL * f_tickf)( Chuck_Object * SELF, SAMPLE * in, SAMPLE * out, t_CKUINT nframes, Chuck_VM_Shred * SHRED, CK_DL_API API );
+// single-channel block tick: in/out are nframes mono samples
+typedef t_CKBOOL (CK_DLL_CALL * f_tickv)( Chuck_Object * SELF, SAMPLE * in, SAMPLE * out, t_CKUINT nframes, Chuck_VM_Shred * SHRED, CK_DL_API API );
 typedef t_CKVOID (CK_DLL_CALL * f_ctrl)( Chuck_Object * SELF, void * ARGS, Chuck_DL_Return * RETURN, Chuck_VM_Shred * SHRED, CK_DL_API API );
 typedef t_CKVOID (CK_DLL_CALL * f_cget)( Chuck_Object * SELF, void * ARGS, Chuck_DL_Return * RETURN, Chuck_VM_Shred * SHRED, CK_DL_API API );
 typedef t_CKBOOL (CK_DLL_CALL * f_pmsg)( Chuck_Object * SELF, const char * MSG, void * ARGS, Chuck_VM_Shred * SHRED, CK_DL_API API );
 // uana specific
 typedef t_CKBOOL (CK_DLL_CALL * f_tock)( Chuck_Object * SELF, Chuck_UAna * UANA, Chuck_UAnaBlobProxy * BLOB, Chuck_VM_Shred * SHRED, CK_DL_API API );
+// before an async tock, on the audio thread: copy what tock reads that tick
+// keeps writing
+typedef t_CKVOID (CK_DLL_CALL * f_snap)( Chuck_Object * SELF, Chuck_UAna * UANA, CK_DL_API API );
 // "main thread" hook
 typedef t_CKBOOL (CK_DLL_CALL * f_mainthreadhook)( void * bindle );
 // "main thread" quit (stop running hook)
@@ -298,6 +309,8 @@ typedef void (CK_DLL_CALL * f_add_arg)( Chuck_DL_Query * query, const char * typ
 // ** functions for adding unit generators, must extend ugen
 typedef void (CK_DLL_CALL * f_add_ugen_func)( Chuck_DL_Query * query, f_tick tick, f_pmsg pmsg, t_CKUINT num_in, t_CKUINT num_out );
 typedef void (CK_DLL_CALL * f_add_ugen_funcf)( Chuck_DL_Query * query, f_tickf tickf, f_pmsg pmsg, t_CKUINT num_in, t_CKUINT num_out );
+// ** add a block tick alongside the per-sample tick (used when ticking a whole buffer)
+typedef void (CK_DLL_CALL * f_add_ugen_funcv)( Chuck_DL_Query * query, f_tickv tickv );
 // ** add a ugen control
 typedef void (CK_DLL_CALL * f_add_ugen_ctrl)( Chuck_DL_Query * query, f_ctrl ctrl, f_cget cget, 
                                               const char * type, const char * name );
@@ -388,6 +401,9 @@ struct Chuck_DL_Query
     f_doc_var doc_var;
     f_add_example add_ex;
     
+    // (ugen only) add block tick function
+    f_add_ugen_funcv add_ugen_funcv;
+    
     // constructor
     Chuck_DL_Query();
     // desctructor
@@ -423,6 +439,8 @@ struct Chuck_DL_Class
     f_tick ugen_tick;
     // ugen_tickf
     f_tickf ugen_tickf;
+    // ugen_tickv
+    f_tickv ugen_tickv;
     // ugen_pmsg
     f_pmsg ugen_pmsg;
     // ugen_ctrl/cget
@@ -440,7 +458,7 @@ struct Chuck_DL_Class
     std::vector<std::string> examples;
     
     // constructor
-    Chuck_DL_Class() { dtor = NULL; ugen_tick = NULL; ugen_tickf = NULL; ugen_pmsg = NULL; uana_tock = NULL; ugen_pmsg = NULL; current_mvar_offset = 0; ugen_num_in = ugen_num_out = 0; }
+    Chuck_DL_Class() { dtor = NULL; ugen_tick = NULL; ugen_tickf = NULL; ugen_tickv = NULL; ugen_pmsg = NULL; uana_tock = NULL; ugen_pmsg = NULL; current_mvar_offset = 0; ugen_num_in = ugen_num_out = 0; }
     // destructor
     ~Chuck_DL_Class();
 };
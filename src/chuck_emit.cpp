@@ -234,7 +234,7 @@ Chuck_VM_Code * emit_engine_emit_prog( Chuck_Emitter * emit, a_Program prog,
         // make sure
         assert( emit->context->nspc->pre_ctor == NULL );
         // converted to virtual machine code
-        emit->context->nspc->pre_ctor = emit_to_code( emit->code, NULL, emit->dump );
+        emit->context->nspc->pre_ctor = emit_to_code( emit->code, NULL, emit->dump, emit->optimize );
         // add reference
         emit->context->nspc->pre_ctor->add_ref();
     }
@@ -259,8 +259,14 @@ Chuck_VM_Code * emit_engine_emit_prog( Chuck_Emitter * emit, a_Program prog,
 //-----------------------------------------------------------------------------
 Chuck_VM_Code * emit_to_code( Chuck_Code * in,
                               Chuck_VM_Code * out,
-                              t_CKBOOL dump )
+                              t_CKBOOL dump,
+                              t_CKBOOL optimize )
 {
+    // instructions as emitted
+    t_CKUINT emitted = in->code.size();
+    // peephole pass
+    if( optimize ) emit_engine_optimize( in );
+
     // log
     EM_log( CK_LOG_FINER, "emitting code: %d VM instructions...",
             in->code.size() );
@@ -290,6 +296,10 @@ Chuck_VM_Code * emit_to_code( Chuck_Code * in,
     {
         // name of what we are dumping
         EM_error2( 0, "dumping %s:", in->name.c_str() );
+        // before and after the peephole pass
+        if( optimize )
+            EM_error2( 0, "(optimized: %lu -> %lu instructions)",
+                       emitted, code->num_instr );
 
         // uh
         EM_error2( 0, "-------" );
@@ -305,6 +315,325 @@ Chuck_VM_Code * emit_to_code( Chuck_Code * in,
 
 
 
+//-----------------------------------------------------------------------------
+// name: opt_decode()
+// desc: opcode and operands of an instruction, as translated for the
+//       threaded interpreter (CK_OP_FALLBACK if it has none)
+//-----------------------------------------------------------------------------
+static Chuck_Instr_Op opt_decode( Chuck_Instr * instr )
+{
+    Chuck_Instr_Op op;
+    op.handler = NULL;
+    op.a.u = 0;
+    op.b = 0;
+    op.instr = instr;
+    if( !instr->translate( op ) ) op.code = CK_OP_FALLBACK;
+    return op;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: opt_jump() / opt_set_jump()
+// desc: instructions that carry an instruction index
+//-----------------------------------------------------------------------------
+static t_CKBOOL opt_jump( Chuck_Instr * instr, t_CKUINT * target )
+{
+    Chuck_Instr_Branch_Op * branch = dynamic_cast<Chuck_Instr_Branch_Op *>( instr );
+    if( branch ) { *target = branch->get(); return TRUE; }
+    // array pre-constructor loop
+    Chuck_Instr_Unary_Op * loop = dynamic_cast<Chuck_Instr_Pre_Ctor_Array_Top *>( instr );
+    if( !loop ) loop = dynamic_cast<Chuck_Instr_Pre_Ctor_Array_Bottom *>( instr );
+    if( loop ) { *target = loop->get(); return TRUE; }
+    return FALSE;
+}
+
+static void opt_set_jump( Chuck_Instr * instr, t_CKUINT target )
+{
+    Chuck_Instr_Branch_Op * branch = dynamic_cast<Chuck_Instr_Branch_Op *>( instr );
+    if( branch ) { branch->set( target ); return; }
+    ((Chuck_Instr_Unary_Op *)instr)->set( target );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: opt_compact()
+// desc: drop removed (NULL) instructions and renumber jumps; a jump to a
+//       removed instruction lands on the one after it
+//-----------------------------------------------------------------------------
+static void opt_compact( std::vector<Chuck_Instr *> & code )
+{
+    std::vector<t_CKUINT> where( code.size() + 1 );
+    t_CKUINT i, n = 0, target;
+
+    for( i = 0; i < code.size(); i++ )
+    {
+        where[i] = n;
+        if( code[i] ) code[n++] = code[i];
+    }
+    where[i] = n;
+    code.resize( n );
+
+    for( i = 0; i < code.size(); i++ )
+        if( opt_jump( code[i], &target ) && target < where.size() )
+            opt_set_jump( code[i], where[target] );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: opt_replace()
+// desc: replace code[i .. i+count-1] by instr (NULL to just remove them)
+//-----------------------------------------------------------------------------
+static void opt_replace( std::vector<Chuck_Instr *> & code, t_CKUINT i,
+                         t_CKUINT count, Chuck_Instr * instr )
+{
+    // errors report the line of the last one
+    if( instr ) instr->set_linepos( code[i+count-1]->m_linepos );
+    for( t_CKUINT j = i; j < i + count; j++ )
+    {
+        delete code[j];
+        code[j] = NULL;
+    }
+    code[i] = instr;
+}
+
+
+
+
+// compare opcode to its negation, and branch opcode to compare opcode
+static t_CKUINT opt_negate( t_CKUINT cmp )
+{
+    switch( cmp )
+    {
+    case CK_OP_LT_INT: return CK_OP_GE_INT;
+    case CK_OP_GT_INT: return CK_OP_LE_INT;
+    case CK_OP_LE_INT: return CK_OP_GT_INT;
+    case CK_OP_GE_INT: return CK_OP_LT_INT;
+    case CK_OP_EQ_INT: return CK_OP_NEQ_INT;
+    case CK_OP_NEQ_INT: return CK_OP_EQ_INT;
+    }
+    return CK_OP_FALLBACK;
+}
+
+static t_CKUINT opt_branch_cmp( t_CKUINT branch )
+{
+    switch( branch )
+    {
+    case CK_OP_BRANCH_LT_INT: return CK_OP_LT_INT;
+    case CK_OP_BRANCH_GT_INT: return CK_OP_GT_INT;
+    case CK_OP_BRANCH_LE_INT: return CK_OP_LE_INT;
+    case CK_OP_BRANCH_GE_INT: return CK_OP_GE_INT;
+    case CK_OP_BRANCH_EQ_INT: return CK_OP_EQ_INT;
+    case CK_OP_BRANCH_NEQ_INT: return CK_OP_NEQ_INT;
+    }
+    return CK_OP_FALLBACK;
+}
+
+static Chuck_Instr * opt_new_branch( t_CKUINT cmp, t_CKUINT jmp )
+{
+    switch( cmp )
+    {
+    case CK_OP_LT_INT: return new Chuck_Instr_Branch_Lt_int( jmp );
+    case CK_OP_GT_INT: return new Chuck_Instr_Branch_Gt_int( jmp );
+    case CK_OP_LE_INT: return new Chuck_Instr_Branch_Le_int( jmp );
+    case CK_OP_GE_INT: return new Chuck_Instr_Branch_Ge_int( jmp );
+    case CK_OP_EQ_INT: return new Chuck_Instr_Branch_Eq_int( jmp );
+    case CK_OP_NEQ_INT: return new Chuck_Instr_Branch_Neq_int( jmp );
+    }
+    return NULL;
+}
+
+// pops exactly one int
+static t_CKBOOL opt_pops_int( const Chuck_Instr_Op & op )
+{
+    return op.code == CK_OP_REG_POP_WORD ||
+         ( op.code == CK_OP_REG_POP_WORD4 && op.a.u * sz_WORD == sz_INT );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: emit_engine_optimize()
+// desc: peephole pass over emitted code, before it becomes VM code:
+//       threads jumps to jumps, turns compare + test + branch into one
+//       branch, fuses load-op, store, increment and compare-and-branch on
+//       locals into superinstructions, and drops pushes that are popped
+//       right away; returns the number of instructions removed
+//-----------------------------------------------------------------------------
+t_CKUINT emit_engine_optimize( Chuck_Code * code )
+{
+    std::vector<Chuck_Instr *> & c = code->code;
+    std::vector<t_CKBOOL> is_target;
+    std::vector<Chuck_Instr_Op> op;
+    t_CKUINT before = c.size();
+    t_CKUINT changes = 1;
+    t_CKUINT i, n, target, hops;
+
+    // the jumps these hold may be fused away
+    code->stack_cont.clear();
+    code->stack_break.clear();
+    code->stack_return.clear();
+
+    while( changes )
+    {
+        changes = 0;
+        n = c.size();
+
+        // decode, and find where jumps land
+        op.resize( n + 3 );
+        is_target.assign( n + 1, FALSE );
+        for( i = 0; i < n; i++ )
+        {
+            op[i] = opt_decode( c[i] );
+            if( opt_jump( c[i], &target ) && target <= n ) is_target[target] = TRUE;
+        }
+        // pad, so patterns can look past the end
+        for( i = n; i < n + 3; i++ ) op[i].code = CK_OP_FALLBACK;
+
+        // jumps and branches
+        for( i = 0; i < n; i++ )
+        {
+            if( !c[i] || !dynamic_cast<Chuck_Instr_Branch_Op *>( c[i] ) ) continue;
+
+            // to a goto: go where it goes
+            target = op[i].a.u; hops = 0;
+            while( target < n && op[target].code == CK_OP_GOTO && hops++ < n )
+                target = op[target].a.u;
+            if( target != op[i].a.u )
+            { opt_set_jump( c[i], target ); op[i].a.u = target; changes++; }
+
+            // goto the next instruction
+            if( op[i].code == CK_OP_GOTO && target == i + 1 )
+            { opt_replace( c, i, 1, NULL ); changes++; }
+        }
+
+        // compare, push 0, branch on (not) equal: one branch
+        for( i = 0; i + 2 < n; i++ )
+        {
+            if( !c[i] || !c[i+1] || !c[i+2] || is_target[i+1] || is_target[i+2] ) continue;
+            if( opt_negate( op[i].code ) == CK_OP_FALLBACK ) continue;
+            if( op[i+1].code != CK_OP_REG_PUSH_IMM || op[i+1].a.u != 0 ) continue;
+            if( op[i+2].code == CK_OP_BRANCH_EQ_INT )
+                opt_replace( c, i, 3, opt_new_branch( opt_negate( op[i].code ), op[i+2].a.u ) );
+            else if( op[i+2].code == CK_OP_BRANCH_NEQ_INT )
+                opt_replace( c, i, 3, opt_new_branch( op[i].code, op[i+2].a.u ) );
+            else continue;
+            changes++; i += 2;
+        }
+
+        // re-decode after the above
+        if( changes ) { opt_compact( c ); continue; }
+
+        // superinstructions
+        for( i = 0; i < n; i++ )
+        {
+            Chuck_Instr_Op & a = op[i];
+            Chuck_Instr_Op & b = op[i+1];
+            Chuck_Instr_Op & d = op[i+2];
+            Chuck_Instr_Op & e = op[i+3 <= n ? i+3 : n];
+            // can't fuse across a jump target
+            t_CKBOOL two = i + 1 < n && !is_target[i+1];
+            t_CKBOOL three = two && i + 2 < n && !is_target[i+2];
+            t_CKBOOL four = three && i + 3 < n && !is_target[i+3];
+
+            // local compared to constant, branch
+            if( three && a.code == CK_OP_REG_PUSH_MEM && b.code == CK_OP_REG_PUSH_IMM &&
+                opt_branch_cmp( d.code ) != CK_OP_FALLBACK )
+            {
+                opt_replace( c, i, 3, new Chuck_Instr_Branch_Mem_Imm( a.a.u, a.b,
+                             opt_branch_cmp( d.code ), b.a.i, d.a.u ) );
+                i += 2;
+            }
+            // local op constant
+            else if( three && a.code == CK_OP_REG_PUSH_MEM && b.code == CK_OP_REG_PUSH_IMM &&
+                     ( d.code == CK_OP_ADD_INT || d.code == CK_OP_MINUS_INT ||
+                       d.code == CK_OP_TIMES_INT || opt_negate( d.code ) != CK_OP_FALLBACK ||
+                       ( d.code == CK_OP_MOD_INT && b.a.i != 0 ) ) )
+            {
+                opt_replace( c, i, 3, new Chuck_Instr_Reg_Push_Mem_Op_Imm( a.a.u, a.b, d.code, b.a.i ) );
+                i += 2;
+            }
+            // constant +=> / -=> local, unused
+            else if( four && a.code == CK_OP_REG_PUSH_IMM && b.code == CK_OP_REG_PUSH_MEM_ADDR &&
+                     ( d.code == CK_OP_ADD_INT_ASSIGN || d.code == CK_OP_MINUS_INT_ASSIGN ) &&
+                     opt_pops_int( e ) )
+            {
+                opt_replace( c, i, 4, new Chuck_Instr_Inc_int_Mem( b.a.u, b.b,
+                             d.code == CK_OP_ADD_INT_ASSIGN ? a.a.i : -a.a.i ) );
+                i += 3;
+            }
+            // ++ / -- on a local, unused
+            else if( three && a.code == CK_OP_REG_PUSH_MEM_ADDR && opt_pops_int( d ) &&
+                     ( b.code == CK_OP_PREINC_INT || b.code == CK_OP_POSTINC_INT ||
+                       b.code == CK_OP_PREDEC_INT || b.code == CK_OP_POSTDEC_INT ) )
+            {
+                opt_replace( c, i, 3, new Chuck_Instr_Inc_int_Mem( a.a.u, a.b,
+                             b.code == CK_OP_PREINC_INT || b.code == CK_OP_POSTINC_INT ? 1 : -1 ) );
+                i += 2;
+            }
+            // store to a local (or a new one), unused
+            else if( three && ( a.code == CK_OP_REG_PUSH_MEM_ADDR || a.code == CK_OP_ALLOC_WORD ) &&
+                     b.code == CK_OP_ASSIGN_PRIMITIVE && d.code == CK_OP_REG_POP_WORD )
+            {
+                opt_replace( c, i, 3, new Chuck_Instr_Reg_Pop_To_Mem( a.a.u, a.b ) );
+                i += 2;
+            }
+            else if( three && ( a.code == CK_OP_REG_PUSH_MEM_ADDR || a.code == CK_OP_ALLOC_WORD2 ) &&
+                     b.code == CK_OP_ASSIGN_PRIMITIVE2 && d.code == CK_OP_REG_POP_WORD2 )
+            {
+                opt_replace( c, i, 3, new Chuck_Instr_Reg_Pop_To_Mem2( a.a.u, a.b ) );
+                i += 2;
+            }
+            // assign, unused
+            else if( two && a.code == CK_OP_ASSIGN_PRIMITIVE && b.code == CK_OP_REG_POP_WORD )
+            {
+                opt_replace( c, i, 2, new Chuck_Instr_Assign_Primitive_Pop );
+                i += 1;
+            }
+            else if( two && a.code == CK_OP_ASSIGN_PRIMITIVE2 && b.code == CK_OP_REG_POP_WORD2 )
+            {
+                opt_replace( c, i, 2, new Chuck_Instr_Assign_Primitive2_Pop );
+                i += 1;
+            }
+            // pushed, then popped
+            else if( two && opt_pops_int( b ) &&
+                     ( a.code == CK_OP_REG_PUSH_IMM || a.code == CK_OP_REG_PUSH_MEM ||
+                       a.code == CK_OP_REG_PUSH_MEM_ADDR || a.code == CK_OP_REG_DUP_LAST ||
+                       a.code == CK_OP_REG_PUSH_MEM_OP_IMM ) )
+            {
+                opt_replace( c, i, 2, NULL );
+                i += 1;
+            }
+            else if( two && b.code == CK_OP_REG_POP_WORD2 &&
+                     ( a.code == CK_OP_REG_PUSH_IMM2 || a.code == CK_OP_REG_PUSH_MEM2 ) )
+            {
+                opt_replace( c, i, 2, NULL );
+                i += 1;
+            }
+            else continue;
+
+            changes++;
+        }
+
+        if( changes ) opt_compact( c );
+    }
+
+    // log
+    EM_log( CK_LOG_FINE, "optimized '%s': %lu -> %lu instructions",
+            code->name.c_str(), before, c.size() );
+
+    return before - c.size();
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name:
 // desc: ...
@@ -491,10 +820,28 @@ t_CKBOOL emit_engine_emit_if( Chuck_Emitter * emit, a_Stmt_If stmt )
 {
     t_CKBOOL ret = TRUE;
     Chuck_Instr_Branch_Op * op = NULL, * op2 = NULL;
+    t_CKBOOL truth = FALSE;
 
     // push the stack, allowing for new local variables
     emit->push_scope();
 
+    // condition folded to a constant: the dead body is already gone
+    if( type_engine_fold_cond( stmt->cond, &truth ) )
+    {
+        // push the stack, allowing for new local variables
+        emit->push_scope();
+        // emit the live body
+        ret = emit_engine_emit_stmt( emit, truth ? stmt->if_body : stmt->else_body );
+        if( !ret )
+            return FALSE;
+        // pop stack
+        emit->pop_scope();
+        // pop stack
+        emit->pop_scope();
+
+        return ret;
+    }
+
     // emit the condition
     ret = emit_engine_emit_exp( emit, stmt->cond );
     if( !ret )
@@ -587,6 +934,7 @@ t_CKBOOL emit_engine_emit_for( Chuck_Emitter * emit, a_Stmt_For stmt )
 {
     t_CKBOOL ret = TRUE;
     Chuck_Instr_Branch_Op * op = NULL;
+    t_CKBOOL truth = FALSE;
 
     // push the stack
     emit->push_scope();
@@ -604,11 +952,16 @@ t_CKBOOL emit_engine_emit_for( Chuck_Emitter * emit, a_Stmt_For stmt )
     // mark the stack of break
     emit->code->stack_break.push_back( NULL );
 
+    // condition folded to true: no test, as if there were none
+    a_Stmt c2 = stmt->c2;
+    if( c2 && type_engine_fold_cond( c2->stmt_exp, &truth ) && truth )
+        c2 = NULL;
+
     // emit the cond - keep the result on the stack
-    emit_engine_emit_stmt( emit, stmt->c2, FALSE );
+    emit_engine_emit_stmt( emit, c2, FALSE );
 
     // could be NULL
-    if( stmt->c2 )
+    if( c2 )
     {
         switch( stmt->c2->stmt_exp->type->xid )
         {
@@ -697,7 +1050,7 @@ t_CKBOOL emit_engine_emit_for( Chuck_Emitter * emit, a_Stmt_For stmt )
     emit->append( new Chuck_Instr_Goto( start_index ) );
 
     // could be NULL
-    if( stmt->c2 )
+    if( c2 )
         // set the op's target
         op->set( emit->next_index() );
 
@@ -736,6 +1089,7 @@ t_CKBOOL emit_engine_emit_while( Chuck_Emitter * emit, a_Stmt_While stmt )
 {
     t_CKBOOL ret = TRUE;
     Chuck_Instr_Branch_Op * op = NULL;
+    t_CKBOOL truth = FALSE;
 
     // push stack
     emit->push_scope();
@@ -747,45 +1101,49 @@ t_CKBOOL emit_engine_emit_while( Chuck_Emitter * emit, a_Stmt_While stmt )
     // mark the stack of break
     emit->code->stack_break.push_back( NULL );
 
-    // emit the cond
-    ret = emit_engine_emit_exp( emit, stmt->cond );
-    if( !ret )
-        return FALSE;
-    
-    // the condition
-    switch( stmt->cond->type->xid )
+    // condition folded to true: no test, only break leaves the loop
+    if( !type_engine_fold_cond( stmt->cond, &truth ) || !truth )
     {
-    case te_int:
-        // push 0
-        emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
-        op = new Chuck_Instr_Branch_Eq_int( 0 );
-        break;
-    case te_float:
-    case te_dur:
-    case te_time:
-        // push 0
-        emit->append( new Chuck_Instr_Reg_Push_Imm2( 0.0 ) );
-        op = new Chuck_Instr_Branch_Eq_double( 0 );
-        break;
-        
-    default:
-        // check for IO
-        if( isa( stmt->cond->type, &t_io ) )
+        // emit the cond
+        ret = emit_engine_emit_exp( emit, stmt->cond );
+        if( !ret )
+            return FALSE;
+    
+        // the condition
+        switch( stmt->cond->type->xid )
         {
+        case te_int:
             // push 0
             emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
-            op = new Chuck_Instr_Branch_Eq_int_IO_good( 0 );
+            op = new Chuck_Instr_Branch_Eq_int( 0 );
             break;
-        }
+        case te_float:
+        case te_dur:
+        case te_time:
+            // push 0
+            emit->append( new Chuck_Instr_Reg_Push_Imm2( 0.0 ) );
+            op = new Chuck_Instr_Branch_Eq_double( 0 );
+            break;
+        
+        default:
+            // check for IO
+            if( isa( stmt->cond->type, &t_io ) )
+            {
+                // push 0
+                emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
+                op = new Chuck_Instr_Branch_Eq_int_IO_good( 0 );
+                break;
+            }
 
-        EM_error2( stmt->cond->linepos,
-            "(emit): internal error: unhandled type '%s' in while conditional",
-            stmt->cond->type->name.c_str() );
-        return FALSE;
-    }
+            EM_error2( stmt->cond->linepos,
+                "(emit): internal error: unhandled type '%s' in while conditional",
+                stmt->cond->type->name.c_str() );
+            return FALSE;
+        }
     
-    // append the op
-    emit->append( op );
+        // append the op
+        emit->append( op );
+    }
 
     // added 1.3.1.1: new scope just for loop body
     emit->push_scope();
@@ -802,7 +1160,7 @@ t_CKBOOL emit_engine_emit_while( Chuck_Emitter * emit, a_Stmt_While stmt )
     emit->append( new Chuck_Instr_Goto( start_index ) );
     
     // set the op's target
-    op->set( emit->next_index() );
+    if( op ) op->set( emit->next_index() );
 
     // stack of continue
     while( emit->code->stack_cont.size() && emit->code->stack_cont.back() )
@@ -839,6 +1197,7 @@ t_CKBOOL emit_engine_emit_do_while( Chuck_Emitter * emit, a_Stmt_While stmt )
 {
     t_CKBOOL ret = TRUE;
     Chuck_Instr_Branch_Op * op = NULL;
+    t_CKBOOL truth = FALSE;
     t_CKUINT start_index = emit->next_index();
     
     // push stack
@@ -860,48 +1219,56 @@ t_CKBOOL emit_engine_emit_do_while( Chuck_Emitter * emit, a_Stmt_While stmt )
     // added 1.3.1.1: pop scope for loop body
     emit->pop_scope();
 
-    // emit the cond
-    ret = emit_engine_emit_exp( emit, stmt->cond );
-    if( !ret )
-        return FALSE;
-    
-    // the condition
-    switch( stmt->cond->type->xid )
+    // test the condition, unless it folded to a constant
+    if( !type_engine_fold_cond( stmt->cond, &truth ) )
     {
-    case te_int:
-        // push 0
-        emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
-        op = new Chuck_Instr_Branch_Neq_int( 0 );
-        break;
-    case te_float:
-    case te_dur:
-    case te_time:
-        // push 0
-        emit->append( new Chuck_Instr_Reg_Push_Imm2( 0.0 ) );
-        op = new Chuck_Instr_Branch_Neq_double( 0 );
-        break;
-        
-    default:
-        // check for IO
-        if( isa( stmt->cond->type, &t_io ) )
+        // emit the cond
+        ret = emit_engine_emit_exp( emit, stmt->cond );
+        if( !ret )
+            return FALSE;
+    
+        // the condition
+        switch( stmt->cond->type->xid )
         {
+        case te_int:
             // push 0
             emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
-            op = new Chuck_Instr_Branch_Eq_int_IO_good( 0 );
+            op = new Chuck_Instr_Branch_Neq_int( 0 );
             break;
-        }
+        case te_float:
+        case te_dur:
+        case te_time:
+            // push 0
+            emit->append( new Chuck_Instr_Reg_Push_Imm2( 0.0 ) );
+            op = new Chuck_Instr_Branch_Neq_double( 0 );
+            break;
+        
+        default:
+            // check for IO
+            if( isa( stmt->cond->type, &t_io ) )
+            {
+                // push 0
+                emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
+                op = new Chuck_Instr_Branch_Eq_int_IO_good( 0 );
+                break;
+            }
 
-        EM_error2( stmt->cond->linepos,
-            "(emit): internal error: unhandled type '%s' in do/while conditional",
-            stmt->cond->type->c_name() );
-        return FALSE;
-    }
+            EM_error2( stmt->cond->linepos,
+                "(emit): internal error: unhandled type '%s' in do/while conditional",
+                stmt->cond->type->c_name() );
+            return FALSE;
+        }
     
-    // append the op
-    emit->append( op );
+        // append the op
+        emit->append( op );
+    }
+    // folded to true: jump back without a test
+    else if( truth )
+        emit->append( op = new Chuck_Instr_Goto( 0 ) );
+    // folded to false: fall through
 
     // set the op's target
-    op->set( start_index );
+    if( op ) op->set( start_index );
 
     // stack of continue
     while( emit->code->stack_cont.size() && emit->code->stack_cont.back() )
@@ -938,6 +1305,7 @@ t_CKBOOL emit_engine_emit_until( Chuck_Emitter * emit, a_Stmt_Until stmt )
 {
     t_CKBOOL ret = TRUE;
     Chuck_Instr_Branch_Op * op = NULL;
+    t_CKBOOL truth = FALSE;
 
     // push stack
     emit->push_scope();
@@ -949,45 +1317,49 @@ t_CKBOOL emit_engine_emit_until( Chuck_Emitter * emit, a_Stmt_Until stmt )
     // mark the stack of break
     emit->code->stack_break.push_back( NULL );
 
-    // emit the cond
-    ret = emit_engine_emit_exp( emit, stmt->cond );
-    if( !ret )
-        return FALSE;
-
-    // condition
-    switch( stmt->cond->type->xid )
+    // condition folded to false: no test, only break leaves the loop
+    if( !type_engine_fold_cond( stmt->cond, &truth ) || truth )
     {
-    case te_int:
-        // push 0
-        emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
-        op = new Chuck_Instr_Branch_Neq_int( 0 );
-        break;
-    case te_float:
-    case te_dur:
-    case te_time:
-        // push 0
-        emit->append( new Chuck_Instr_Reg_Push_Imm2( 0.0 ) );
-        op = new Chuck_Instr_Branch_Neq_double( 0 );
-        break;
-        
-    default:
-        // check for IO
-        if( isa( stmt->cond->type, &t_io ) )
+        // emit the cond
+        ret = emit_engine_emit_exp( emit, stmt->cond );
+        if( !ret )
+            return FALSE;
+
+        // condition
+        switch( stmt->cond->type->xid )
         {
+        case te_int:
             // push 0
             emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
-            op = new Chuck_Instr_Branch_Neq_int_IO_good( 0 );
+            op = new Chuck_Instr_Branch_Neq_int( 0 );
             break;
-        }
+        case te_float:
+        case te_dur:
+        case te_time:
+            // push 0
+            emit->append( new Chuck_Instr_Reg_Push_Imm2( 0.0 ) );
+            op = new Chuck_Instr_Branch_Neq_double( 0 );
+            break;
+        
+        default:
+            // check for IO
+            if( isa( stmt->cond->type, &t_io ) )
+            {
+                // push 0
+                emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
+                op = new Chuck_Instr_Branch_Neq_int_IO_good( 0 );
+                break;
+            }
 
-        EM_error2( stmt->cond->linepos,
-            "(emit): internal error: unhandled type '%s' in until conditional",
-            stmt->cond->type->name.c_str() );
-        return FALSE;
-    }
+            EM_error2( stmt->cond->linepos,
+                "(emit): internal error: unhandled type '%s' in until conditional",
+                stmt->cond->type->name.c_str() );
+            return FALSE;
+        }
     
-    // append the op
-    emit->append( op );
+        // append the op
+        emit->append( op );
+    }
 
     // added 1.3.1.1: new scope just for loop body
     emit->push_scope();
@@ -1002,7 +1374,7 @@ t_CKBOOL emit_engine_emit_until( Chuck_Emitter * emit, a_Stmt_Until stmt )
     emit->append( new Chuck_Instr_Goto( start_index ) );
     
     // set the op's target
-    op->set( emit->next_index() );
+    if( op ) op->set( emit->next_index() );
 
     // stack of continue
     while( emit->code->stack_cont.size() && emit->code->stack_cont.back() )
@@ -1039,6 +1411,7 @@ t_CKBOOL emit_engine_emit_do_until( Chuck_Emitter * emit, a_Stmt_Until stmt )
 {
     t_CKBOOL ret = TRUE;
     Chuck_Instr_Branch_Op * op = NULL;
+    t_CKBOOL truth = FALSE;
 
     // push stack
     emit->push_scope();
@@ -1061,39 +1434,47 @@ t_CKBOOL emit_engine_emit_do_until( Chuck_Emitter * emit, a_Stmt_Until stmt )
     // added 1.3.1.1: pop scope for loop body
     emit->pop_scope();
 
-    // emit the cond
-    ret = emit_engine_emit_exp( emit, stmt->cond );
-    if( !ret )
-        return FALSE;
-
-    // condition
-    switch( stmt->cond->type->xid )
+    // test the condition, unless it folded to a constant
+    if( !type_engine_fold_cond( stmt->cond, &truth ) )
     {
-    case te_int:
-        // push 0
-        emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
-        op = new Chuck_Instr_Branch_Eq_int( 0 );
-        break;
-    case te_float:
-    case te_dur:
-    case te_time:
-        // push 0
-        emit->append( new Chuck_Instr_Reg_Push_Imm2( 0.0 ) );
-        op = new Chuck_Instr_Branch_Eq_double( 0 );
-        break;
+        // emit the cond
+        ret = emit_engine_emit_exp( emit, stmt->cond );
+        if( !ret )
+            return FALSE;
 
-    default:
-        EM_error2( stmt->cond->linepos,
-             "(emit): internal error: unhandled type '%s' in do/until conditional",
-             stmt->cond->type->name.c_str() );
-        return FALSE;
-    }
+        // condition
+        switch( stmt->cond->type->xid )
+        {
+        case te_int:
+            // push 0
+            emit->append( new Chuck_Instr_Reg_Push_Imm( 0 ) );
+            op = new Chuck_Instr_Branch_Eq_int( 0 );
+            break;
+        case te_float:
+        case te_dur:
+        case te_time:
+            // push 0
+            emit->append( new Chuck_Instr_Reg_Push_Imm2( 0.0 ) );
+            op = new Chuck_Instr_Branch_Eq_double( 0 );
+            break;
 
-    // append the op
-    emit->append( op );
+        default:
+            EM_error2( stmt->cond->linepos,
+                 "(emit): internal error: unhandled type '%s' in do/until conditional",
+                 stmt->cond->type->name.c_str() );
+            return FALSE;
+        }
+
+        // append the op
+        emit->append( op );
+    }
+    // folded to false: jump back without a test
+    else if( !truth )
+        emit->append( op = new Chuck_Instr_Goto( 0 ) );
+    // folded to true: fall through
 
     // set the op's target
-    op->set( start_index );
+    if( op ) op->set( start_index );
 
     // stack of continue
     while( emit->code->stack_cont.size() && emit->code->stack_cont.back() )
@@ -1312,6 +1693,15 @@ t_CKBOOL emit_engine_emit_exp( Chuck_Emitter * emit, a_Exp exp, t_CKBOOL doAddRe
     // loop over 
     while( exp )
     {
+        // int literal with an implicit cast to float: push the float
+        if( exp->s_type == ae_exp_primary && exp->primary.s_type == ae_primary_num &&
+            exp->cast_to && equals( exp->cast_to, &t_float ) )
+        {
+            emit->append( new Chuck_Instr_Reg_Push_Imm2( (t_CKFLOAT)exp->primary.num ) );
+            exp = exp->next;
+            continue;
+        }
+
         switch( exp->s_type )
         {
         case ae_exp_binary:
@@ -4398,7 +4788,7 @@ t_CKBOOL emit_engine_emit_func_def( Chuck_Emitter * emit, a_Func_Def func_def )
     emit->append( new Chuck_Instr_Func_Return );
 
     // vm code
-    func->code = emit_to_code( emit->code, NULL, emit->dump );
+    func->code = emit_to_code( emit->code, NULL, emit->dump, emit->optimize );
     // add reference
     func->code->add_ref();
     
@@ -4507,7 +4897,7 @@ t_CKBOOL emit_engine_emit_class_def( Chuck_Emitter * emit, a_Class_Def class_def
         // emit return statement
         emit->append( new Chuck_Instr_Func_Return );
         // vm code
-        type->info->pre_ctor = emit_to_code( emit->code, type->info->pre_ctor, emit->dump );
+        type->info->pre_ctor = emit_to_code( emit->code, type->info->pre_ctor, emit->dump, emit->optimize );
         // add reference
         type->info->pre_ctor->add_ref();
         // allocate static
@@ -4615,7 +5005,7 @@ t_CKBOOL emit_engine_emit_spork( Chuck_Emitter * emit, a_Exp_Func_Call exp )
     op->set( emit->code->stack_depth );
     
     // emit it
-    Chuck_VM_Code * code = emit_to_code( emit->code, NULL, emit->dump );
+    Chuck_VM_Code * code = emit_to_code( emit->code, NULL, emit->dump, emit->optimize );
     // remember it
     exp->ck_vm_code = code;
     // add reference
@@ -118,11 +118,14 @@ struct Chuck_Emitter : public Chuck_VM_Object
 
     // dump
     t_CKBOOL dump;
+    // run the peephole pass on emitted code
+    t_CKBOOL optimize;
 
     // constructor
     Chuck_Emitter()
     { env = NULL; vm = NULL; code = NULL; context = NULL; 
-      nspc = NULL; func = NULL; dump = FALSE; }
+      nspc = NULL; func = NULL; dump = FALSE;
+      optimize = FALSE; }
 
     // destructor
     ~Chuck_Emitter()
@@ -164,7 +167,10 @@ Chuck_VM_Code * emit_engine_emit_prog( Chuck_Emitter * emit,
 // helper function to emit code
 Chuck_VM_Code * emit_to_code( Chuck_Code * in,
                               Chuck_VM_Code * out = NULL,
-                              t_CKBOOL dump = FALSE );
+                              t_CKBOOL dump = FALSE,
+                              t_CKBOOL optimize = FALSE );
+// peephole pass over emitted code; returns number of instructions removed
+t_CKUINT emit_engine_optimize( Chuck_Code * code );
 
 // NOT USED: ...
 t_CKBOOL emit_engine_addr_map( Chuck_Emitter * emit, Chuck_VM_Shred * shred );
@@ -3522,11 +3522,8 @@ t_CKBOOL initialize_object( Chuck_Object * object, Chuck_Type * type )
     assert( type != NULL );
     assert( type->info != NULL );
 
-    // allocate virtual table
-    object->vtable = new Chuck_VTable;
-    if( !object->vtable ) goto out_of_memory;
-    // copy the object's virtual table
-    object->vtable->funcs = type->info->obj_v_table.funcs;
+    // share the type's virtual table
+    object->vtable = &type->info->obj_v_table;
     // set the type reference
     // TODO: reference count
     object->type_ref = type;
@@ -3536,11 +3533,9 @@ t_CKBOOL initialize_object( Chuck_Object * object, Chuck_Type * type )
     // allocate memory
     if( object->size )
     {
-        // check to ensure enough memory
-        object->data = new t_CKBYTE[object->size];
+        // zeroed, from the vm allocator
+        object->data = Chuck_VM_Alloc::instance()->alloc_data( object->size );
         if( !object->data ) goto out_of_memory;
-        // zero it out
-        memset( object->data, 0, object->size );
     }
     else object->data = NULL;
 
@@ -3552,9 +3547,16 @@ t_CKBOOL initialize_object( Chuck_Object * object, Chuck_Type * type )
         if( type->ugen_info->tick ) ugen->tick = type->ugen_info->tick;
         // added 1.3.0.0 -- tickf for multi-channel tick
         if( type->ugen_info->tickf ) ugen->tickf = type->ugen_info->tickf;
+        // block tick, used by system_tick_v()
+        if( type->ugen_info->tickv ) ugen->tickv = type->ugen_info->tickv;
         if( type->ugen_info->pmsg ) ugen->pmsg = type->ugen_info->pmsg;
         // TODO: another hack!
-        if( type->ugen_info->tock ) ((Chuck_UAna *)ugen)->tock = type->ugen_info->tock;
+        if( type->ugen_info->tock )
+        {
+            ((Chuck_UAna *)ugen)->tock = type->ugen_info->tock;
+            ((Chuck_UAna *)ugen)->snap = type->ugen_info->snap;
+            ((Chuck_UAna *)ugen)->m_async_ok = type->ugen_info->async;
+        }
         // allocate multi chan
         ugen->alloc_multi_chan( type->ugen_info->num_ins, 
                                 type->ugen_info->num_outs );
@@ -3586,8 +3588,8 @@ out_of_memory:
         "[chuck](VM): OutOfMemory: while instantiating object '%s'\n",
         type->c_name() );
 
-    // delete
-    if( object ) SAFE_DELETE( object->vtable );
+    // (the vtable is the type's)
+    if( object ) object->vtable = NULL;
 
     // return FALSE
     return FALSE;
@@ -4509,6 +4511,8 @@ void Chuck_Instr_Spork::execute( Chuck_VM * vm, Chuck_VM_Shred * shred )
         // add to shred so it's ref counted, and released when shred done (1.3.1.2)
         sh->add_parent_ref( (Chuck_Object *)this_ptr );
     }
+    // the child's stack now holds data, even if it never runs
+    sh->reg->m_is_dirty = TRUE;
     // copy args
     if( m_val )
     {
@@ -6403,6 +6407,120 @@ done:
 
 
 
+#pragma mark === Superinstructions ===
+
+
+//-----------------------------------------------------------------------------
+// name: execute()
+// desc: ...
+//-----------------------------------------------------------------------------
+void Chuck_Instr_Reg_Pop_To_Mem::execute( Chuck_VM * vm, Chuck_VM_Shred * shred )
+{
+    t_CKBYTE * mem_sp = base ? shred->base_ref->stack : shred->mem->sp;
+    t_CKUINT *& reg_sp = (t_CKUINT *&)shred->reg->sp;
+
+    // pop word from reg stack into mem
+    pop_( reg_sp, 1 );
+    *((t_CKUINT *)(mem_sp + m_val)) = *reg_sp;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: execute()
+// desc: ...
+//-----------------------------------------------------------------------------
+void Chuck_Instr_Reg_Pop_To_Mem2::execute( Chuck_VM * vm, Chuck_VM_Shred * shred )
+{
+    t_CKBYTE * mem_sp = base ? shred->base_ref->stack : shred->mem->sp;
+    t_CKFLOAT *& reg_sp = (t_CKFLOAT *&)shred->reg->sp;
+
+    // pop float from reg stack into mem
+    pop_( reg_sp, 1 );
+    *((t_CKFLOAT *)(mem_sp + m_val)) = *reg_sp;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: execute()
+// desc: ...
+//-----------------------------------------------------------------------------
+void Chuck_Instr_Assign_Primitive_Pop::execute( Chuck_VM * vm, Chuck_VM_Shred * shred )
+{
+    t_CKUINT *& reg_sp = (t_CKUINT *&)shred->reg->sp;
+
+    // pop value and address
+    pop_( reg_sp, 2 );
+    *((t_CKUINT *)(*(reg_sp+1))) = *reg_sp;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: execute()
+// desc: ...
+//-----------------------------------------------------------------------------
+void Chuck_Instr_Assign_Primitive2_Pop::execute( Chuck_VM * vm, Chuck_VM_Shred * shred )
+{
+    t_CKUINT *& reg_sp = (t_CKUINT *&)shred->reg->sp;
+
+    // pop value and address
+    pop_( reg_sp, 1 + (sz_FLOAT / sz_UINT) );
+    *( (t_CKFLOAT *)(*(reg_sp+(sz_FLOAT/sz_UINT))) ) = *(t_CKFLOAT *)reg_sp;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: execute()
+// desc: ...
+//-----------------------------------------------------------------------------
+void Chuck_Instr_Inc_int_Mem::execute( Chuck_VM * vm, Chuck_VM_Shred * shred )
+{
+    t_CKBYTE * mem_sp = base ? shred->base_ref->stack : shred->mem->sp;
+
+    // in place
+    *((t_CKINT *)(mem_sp + m_val)) += delta;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: execute()
+// desc: ...
+//-----------------------------------------------------------------------------
+void Chuck_Instr_Reg_Push_Mem_Op_Imm::execute( Chuck_VM * vm, Chuck_VM_Shred * shred )
+{
+    t_CKBYTE * mem_sp = base ? shred->base_ref->stack : shred->mem->sp;
+    t_CKINT *& reg_sp = (t_CKINT *&)shred->reg->sp;
+
+    // push result
+    push_( reg_sp, ck_int_op( oper, *((t_CKINT *)(mem_sp + m_val)), imm ) );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: execute()
+// desc: ...
+//-----------------------------------------------------------------------------
+void Chuck_Instr_Branch_Mem_Imm::execute( Chuck_VM * vm, Chuck_VM_Shred * shred )
+{
+    t_CKBYTE * mem_sp = base ? shred->base_ref->stack : shred->mem->sp;
+
+    if( ck_int_op( cmp, *((t_CKINT *)(mem_sp + src)), imm ) )
+        shred->next_pc = m_jmp;
+}
+
+
+
 #pragma mark === Builtins ===
 
 
@@ -42,6 +42,63 @@ struct Chuck_VM;
 struct Chuck_VM_Shred;
 struct Chuck_Type;
 struct Chuck_Func;
+struct Chuck_Instr;
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: enum ck_Op
+// desc: opcodes of the threaded interpreter (see Chuck_VM_Shred::run()),
+//       one per instruction with a native handler; everything else runs
+//       as CK_OP_FALLBACK through the instruction's virtual execute()
+//-----------------------------------------------------------------------------
+enum ck_Op
+{
+    CK_OP_FALLBACK = 0,
+    CK_OP_ADD_INT, CK_OP_MINUS_INT, CK_OP_TIMES_INT, CK_OP_DIVIDE_INT,
+    CK_OP_MOD_INT, CK_OP_PREINC_INT, CK_OP_POSTINC_INT, CK_OP_PREDEC_INT,
+    CK_OP_POSTDEC_INT, CK_OP_ADD_INT_ASSIGN, CK_OP_MINUS_INT_ASSIGN,
+    CK_OP_ADD_DOUBLE, CK_OP_MINUS_DOUBLE, CK_OP_TIMES_DOUBLE,
+    CK_OP_DIVIDE_DOUBLE, CK_OP_ADD_DOUBLE_ASSIGN,
+    CK_OP_LT_INT, CK_OP_GT_INT, CK_OP_LE_INT, CK_OP_GE_INT, CK_OP_EQ_INT,
+    CK_OP_NEQ_INT, CK_OP_LT_DOUBLE, CK_OP_GT_DOUBLE, CK_OP_LE_DOUBLE,
+    CK_OP_GE_DOUBLE, CK_OP_NOT_INT, CK_OP_NEGATE_INT, CK_OP_NEGATE_DOUBLE,
+    CK_OP_BRANCH_LT_INT, CK_OP_BRANCH_GT_INT, CK_OP_BRANCH_LE_INT,
+    CK_OP_BRANCH_GE_INT, CK_OP_BRANCH_EQ_INT, CK_OP_BRANCH_NEQ_INT,
+    CK_OP_GOTO, CK_OP_REG_PUSH_IMM, CK_OP_REG_PUSH_IMM2, CK_OP_REG_DUP_LAST,
+    CK_OP_REG_PUSH_MEM, CK_OP_REG_PUSH_MEM2, CK_OP_REG_PUSH_MEM_ADDR,
+    CK_OP_REG_POP_WORD, CK_OP_REG_POP_WORD2, CK_OP_REG_POP_WORD4,
+    CK_OP_MEM_SET_IMM, CK_OP_ALLOC_WORD, CK_OP_ALLOC_WORD2,
+    CK_OP_ASSIGN_PRIMITIVE, CK_OP_ASSIGN_PRIMITIVE2,
+    CK_OP_CAST_DOUBLE2INT, CK_OP_CAST_INT2DOUBLE, CK_OP_FUNC_TO_CODE,
+    // superinstructions (see emit_engine_optimize())
+    CK_OP_REG_POP_TO_MEM, CK_OP_REG_POP_TO_MEM2, CK_OP_ASSIGN_PRIMITIVE_POP,
+    CK_OP_ASSIGN_PRIMITIVE2_POP, CK_OP_INC_INT_MEM, CK_OP_REG_PUSH_MEM_OP_IMM,
+    CK_OP_BRANCH_MEM_IMM,
+    // number of opcodes
+    CK_OP_NUM
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Instr_Op
+// desc: one slot of a translated Chuck_VM_Code, with operands inline
+//-----------------------------------------------------------------------------
+struct Chuck_Instr_Op
+{
+    // handler label (computed goto builds only)
+    const void * handler;
+    // opcode
+    t_CKUINT code;
+    // operands
+    union { t_CKUINT u; t_CKINT i; t_CKFLOAT f; } a;
+    t_CKUINT b;
+    // the instruction, for fallback and error reporting
+    Chuck_Instr * instr;
+};
 
 
 
@@ -58,6 +115,9 @@ public:
 
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred ) = 0;
+    // fill in a threaded op; FALSE if the instruction has no native handler
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { return FALSE; }
 
 public:
     virtual const char * name() const;
@@ -80,6 +140,7 @@ struct Chuck_Instr_Branch_Op : public Chuck_Instr
 {
 public:
     inline void set( t_CKUINT jmp ) { m_jmp = jmp; }
+    inline t_CKUINT get() const { return m_jmp; }
 
 public:
     virtual const char * params() const
@@ -152,6 +213,8 @@ struct Chuck_Instr_Add_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ADD_INT; return TRUE; }
 };
 
 
@@ -165,6 +228,8 @@ struct Chuck_Instr_PreInc_int : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_PREINC_INT; return TRUE; }
 };
 
 
@@ -178,6 +243,8 @@ struct Chuck_Instr_PostInc_int : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_POSTINC_INT; return TRUE; }
 };
 
 
@@ -191,6 +258,8 @@ struct Chuck_Instr_PreDec_int : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_PREDEC_INT; return TRUE; }
 };
 
 
@@ -204,6 +273,8 @@ struct Chuck_Instr_PostDec_int : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_POSTDEC_INT; return TRUE; }
 };
 
 
@@ -247,6 +318,8 @@ struct Chuck_Instr_Mod_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_MOD_INT; return TRUE; }
 };
 
 
@@ -273,6 +346,8 @@ struct Chuck_Instr_Minus_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_MINUS_INT; return TRUE; }
 };
 
 
@@ -299,6 +374,8 @@ struct Chuck_Instr_Times_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_TIMES_INT; return TRUE; }
 };
 
 
@@ -312,6 +389,8 @@ struct Chuck_Instr_Divide_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_DIVIDE_INT; return TRUE; }
 };
 
 
@@ -338,6 +417,8 @@ struct Chuck_Instr_Add_double : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ADD_DOUBLE; return TRUE; }
 };
 
 
@@ -351,6 +432,8 @@ struct Chuck_Instr_Minus_double : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_MINUS_DOUBLE; return TRUE; }
 };
 
 
@@ -377,6 +460,8 @@ struct Chuck_Instr_Times_double : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_TIMES_DOUBLE; return TRUE; }
 };
 
 
@@ -390,6 +475,8 @@ struct Chuck_Instr_Divide_double : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_DIVIDE_DOUBLE; return TRUE; }
 };
 
 
@@ -754,6 +841,8 @@ struct Chuck_Instr_Add_int_Assign : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ADD_INT_ASSIGN; return TRUE; }
 };
 
 
@@ -780,6 +869,8 @@ struct Chuck_Instr_Minus_int_Assign : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_MINUS_INT_ASSIGN; return TRUE; }
 };
 
 
@@ -819,6 +910,8 @@ struct Chuck_Instr_Add_double_Assign : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ADD_DOUBLE_ASSIGN; return TRUE; }
 };
 
 
@@ -1224,6 +1317,8 @@ struct Chuck_Instr_Branch_Lt_int : public Chuck_Instr_Branch_Op
 public:
     Chuck_Instr_Branch_Lt_int( t_CKUINT jmp ) { this->set( jmp ); }
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_BRANCH_LT_INT; op.a.u = m_jmp; return TRUE; }
 };
 
 
@@ -1238,6 +1333,8 @@ struct Chuck_Instr_Branch_Gt_int : public Chuck_Instr_Branch_Op
 public:
     Chuck_Instr_Branch_Gt_int( t_CKUINT jmp ) { this->set( jmp ); }
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_BRANCH_GT_INT; op.a.u = m_jmp; return TRUE; }
 };
 
 
@@ -1252,6 +1349,8 @@ struct Chuck_Instr_Branch_Le_int : public Chuck_Instr_Branch_Op
 public:
     Chuck_Instr_Branch_Le_int( t_CKUINT jmp ) { this->set( jmp ); }
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_BRANCH_LE_INT; op.a.u = m_jmp; return TRUE; }
 };
 
 
@@ -1266,6 +1365,8 @@ struct Chuck_Instr_Branch_Ge_int : public Chuck_Instr_Branch_Op
 public:
     Chuck_Instr_Branch_Ge_int( t_CKUINT jmp ) { this->set( jmp ); }
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_BRANCH_GE_INT; op.a.u = m_jmp; return TRUE; }
 };
 
 
@@ -1280,6 +1381,8 @@ struct Chuck_Instr_Branch_Eq_int : public Chuck_Instr_Branch_Op
 public:
     Chuck_Instr_Branch_Eq_int( t_CKUINT jmp ) { this->set( jmp ); }
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_BRANCH_EQ_INT; op.a.u = m_jmp; return TRUE; }
 };
 
 
@@ -1294,6 +1397,8 @@ struct Chuck_Instr_Branch_Neq_int : public Chuck_Instr_Branch_Op
 public:
     Chuck_Instr_Branch_Neq_int( t_CKUINT jmp ) { this->set( jmp ); }
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_BRANCH_NEQ_INT; op.a.u = m_jmp; return TRUE; }
 };
 
 
@@ -1419,6 +1524,8 @@ struct Chuck_Instr_Lt_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_LT_INT; return TRUE; }
 };
 
 
@@ -1432,6 +1539,8 @@ struct Chuck_Instr_Gt_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_GT_INT; return TRUE; }
 };
 
 
@@ -1445,6 +1554,8 @@ struct Chuck_Instr_Le_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_LE_INT; return TRUE; }
 };
 
 
@@ -1458,6 +1569,8 @@ struct Chuck_Instr_Ge_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_GE_INT; return TRUE; }
 };
 
 
@@ -1471,6 +1584,8 @@ struct Chuck_Instr_Eq_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_EQ_INT; return TRUE; }
 };
 
 
@@ -1484,6 +1599,8 @@ struct Chuck_Instr_Neq_int : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_NEQ_INT; return TRUE; }
 };
 
 
@@ -1497,6 +1614,8 @@ struct Chuck_Instr_Not_int : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_NOT_INT; return TRUE; }
 };
 
 
@@ -1510,6 +1629,8 @@ struct Chuck_Instr_Negate_int : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_NEGATE_INT; return TRUE; }
 };
 
 
@@ -1523,6 +1644,8 @@ struct Chuck_Instr_Negate_double : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_NEGATE_DOUBLE; return TRUE; }
 };
 
 
@@ -1536,6 +1659,8 @@ struct Chuck_Instr_Lt_double : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_LT_DOUBLE; return TRUE; }
 };
 
 
@@ -1549,6 +1674,8 @@ struct Chuck_Instr_Gt_double : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_GT_DOUBLE; return TRUE; }
 };
 
 
@@ -1562,6 +1689,8 @@ struct Chuck_Instr_Le_double : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_LE_DOUBLE; return TRUE; }
 };
 
 
@@ -1575,6 +1704,8 @@ struct Chuck_Instr_Ge_double : public Chuck_Instr_Binary_Op
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_GE_DOUBLE; return TRUE; }
 };
 
 
@@ -1875,6 +2006,8 @@ struct Chuck_Instr_Goto : public Chuck_Instr_Branch_Op
 public:
     Chuck_Instr_Goto( t_CKUINT jmp ) { this->set( jmp ); }
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_GOTO; op.a.u = m_jmp; return TRUE; }
 };
 
 
@@ -1888,6 +2021,8 @@ struct Chuck_Instr_Reg_Pop_Word : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_POP_WORD; return TRUE; }
 };
 
 
@@ -1901,6 +2036,8 @@ struct Chuck_Instr_Reg_Pop_Word2 : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_POP_WORD2; return TRUE; }
 };
 
 
@@ -1928,6 +2065,8 @@ struct Chuck_Instr_Reg_Pop_Word4 : public Chuck_Instr_Unary_Op
 public:
     Chuck_Instr_Reg_Pop_Word4( t_CKUINT num ) { this->set( num ); }
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_POP_WORD4; op.a.u = m_val; return TRUE; }
 };
 
 
@@ -1971,6 +2110,8 @@ public:
 
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_PUSH_IMM; op.a.u = m_val; return TRUE; }
 };
 
 
@@ -1988,6 +2129,8 @@ public:
 
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_PUSH_IMM2; op.a.f = m_val; return TRUE; }
 };
 
 
@@ -2021,6 +2164,8 @@ struct Chuck_Instr_Reg_Dup_Last : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_DUP_LAST; return TRUE; }
 };
 
 
@@ -2131,6 +2276,8 @@ public:
 
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_PUSH_MEM; op.a.u = m_val; op.b = base; return TRUE; }
     virtual const char * params() const
     { static char buffer[256];
       sprintf( buffer, "src=%ld, base=%ld", m_val, base );
@@ -2156,6 +2303,8 @@ public:
 
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_PUSH_MEM2; op.a.u = m_val; op.b = base; return TRUE; }
     virtual const char * params() const
     { static char buffer[256];
       sprintf( buffer, "src=%ld, base=%ld", m_val, base );
@@ -2256,6 +2405,8 @@ public:
 
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_PUSH_MEM_ADDR; op.a.u = m_val; op.b = base; return TRUE; }
     virtual const char * params() const
     { static char buffer[256];
       sprintf( buffer, "src=%ld, base=%ld", m_val, base );
@@ -2315,6 +2466,8 @@ public:
     
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_MEM_SET_IMM; op.a.u = m_val; op.b = m_offset; return TRUE; }
     virtual const char * params() const
     { static char buffer[256];
       sprintf( buffer, "offset=%ld, value=%ld", m_offset, m_val );
@@ -2466,6 +2619,8 @@ public:
     t_CKBOOL m_is_object;
     
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ALLOC_WORD; op.a.u = m_val; return TRUE; }
 };
 
 
@@ -2482,6 +2637,8 @@ public:
     { this->set( offset ); }
 
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ALLOC_WORD2; op.a.u = m_val; return TRUE; }
 };
 
 
@@ -2751,6 +2908,8 @@ struct Chuck_Instr_Assign_Primitive : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ASSIGN_PRIMITIVE; return TRUE; }
 };
 
 
@@ -2764,6 +2923,8 @@ struct Chuck_Instr_Assign_Primitive2 : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ASSIGN_PRIMITIVE2; return TRUE; }
 };
 
 
@@ -2921,6 +3082,8 @@ struct Chuck_Instr_Func_To_Code : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_FUNC_TO_CODE; return TRUE; }
 };
 
 
@@ -3618,6 +3781,8 @@ struct Chuck_Instr_Cast_double2int : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_CAST_DOUBLE2INT; return TRUE; }
 };
 
 
@@ -3631,6 +3796,8 @@ struct Chuck_Instr_Cast_int2double : public Chuck_Instr
 {
 public:
     virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_CAST_INT2DOUBLE; return TRUE; }
 };
 
 
@@ -3937,6 +4104,200 @@ protected:
 
 
 
+//-----------------------------------------------------------------------------
+// name: ck_int_op()
+// desc: integer operator of a superinstruction, named by the opcode of the
+//       instruction it replaces (CK_OP_ADD_INT ... CK_OP_NEQ_INT)
+//-----------------------------------------------------------------------------
+static inline t_CKINT ck_int_op( t_CKUINT op, t_CKINT lhs, t_CKINT rhs )
+{
+    switch( op )
+    {
+    case CK_OP_ADD_INT: return lhs + rhs;
+    case CK_OP_MINUS_INT: return lhs - rhs;
+    case CK_OP_TIMES_INT: return lhs * rhs;
+    case CK_OP_MOD_INT: return lhs % rhs;
+    case CK_OP_LT_INT: return lhs < rhs;
+    case CK_OP_GT_INT: return lhs > rhs;
+    case CK_OP_LE_INT: return lhs <= rhs;
+    case CK_OP_GE_INT: return lhs >= rhs;
+    case CK_OP_EQ_INT: return lhs == rhs;
+    case CK_OP_NEQ_INT: return lhs != rhs;
+    }
+    return 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Instr_Reg_Pop_To_Mem
+// desc: pop int into a local or global (push addr + assign + pop)
+//-----------------------------------------------------------------------------
+struct Chuck_Instr_Reg_Pop_To_Mem : public Chuck_Instr_Unary_Op
+{
+public:
+    Chuck_Instr_Reg_Pop_To_Mem( t_CKUINT dest, t_CKBOOL use_base )
+    { this->set( dest ); base = use_base; }
+
+public:
+    virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_POP_TO_MEM; op.a.u = m_val; op.b = base; return TRUE; }
+    virtual const char * params() const
+    { static char buffer[256];
+      sprintf( buffer, "dest=%ld, base=%ld", m_val, base );
+      return buffer; }
+
+protected:
+    t_CKBOOL base;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Instr_Reg_Pop_To_Mem2
+// desc: pop float into a local or global (push addr + assign + pop)
+//-----------------------------------------------------------------------------
+struct Chuck_Instr_Reg_Pop_To_Mem2 : public Chuck_Instr_Unary_Op
+{
+public:
+    Chuck_Instr_Reg_Pop_To_Mem2( t_CKUINT dest, t_CKBOOL use_base )
+    { this->set( dest ); base = use_base; }
+
+public:
+    virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_POP_TO_MEM2; op.a.u = m_val; op.b = base; return TRUE; }
+    virtual const char * params() const
+    { static char buffer[256];
+      sprintf( buffer, "dest=%ld, base=%ld", m_val, base );
+      return buffer; }
+
+protected:
+    t_CKBOOL base;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Instr_Assign_Primitive_Pop
+// desc: assign primitive (word), result unused
+//-----------------------------------------------------------------------------
+struct Chuck_Instr_Assign_Primitive_Pop : public Chuck_Instr
+{
+public:
+    virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ASSIGN_PRIMITIVE_POP; return TRUE; }
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Instr_Assign_Primitive2_Pop
+// desc: assign primitive (2 word), result unused
+//-----------------------------------------------------------------------------
+struct Chuck_Instr_Assign_Primitive2_Pop : public Chuck_Instr
+{
+public:
+    virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_ASSIGN_PRIMITIVE2_POP; return TRUE; }
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Instr_Inc_int_Mem
+// desc: add a constant to an int local or global (i++, k +=> i, ...)
+//-----------------------------------------------------------------------------
+struct Chuck_Instr_Inc_int_Mem : public Chuck_Instr_Unary_Op
+{
+public:
+    Chuck_Instr_Inc_int_Mem( t_CKUINT dest, t_CKBOOL use_base, t_CKINT amount )
+    { this->set( dest ); base = use_base; delta = amount; }
+
+public:
+    virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_INC_INT_MEM; op.a.u = m_val; op.b = base; return TRUE; }
+    virtual const char * params() const
+    { static char buffer[256];
+      sprintf( buffer, "dest=%ld, base=%ld, delta=%ld", m_val, base, delta );
+      return buffer; }
+
+public:
+    t_CKBOOL base;
+    t_CKINT delta;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Instr_Reg_Push_Mem_Op_Imm
+// desc: push ( int local or global ) op ( constant )
+//-----------------------------------------------------------------------------
+struct Chuck_Instr_Reg_Push_Mem_Op_Imm : public Chuck_Instr_Unary_Op
+{
+public:
+    Chuck_Instr_Reg_Push_Mem_Op_Imm( t_CKUINT src, t_CKBOOL use_base,
+                                     t_CKUINT the_op, t_CKINT val )
+    { this->set( src ); base = use_base; oper = the_op; imm = val; }
+
+public:
+    virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_REG_PUSH_MEM_OP_IMM; op.a.u = m_val; op.b = base; return TRUE; }
+    virtual const char * params() const
+    { static char buffer[256];
+      sprintf( buffer, "src=%ld, base=%ld, op=%lu, imm=%ld", m_val, base, oper, imm );
+      return buffer; }
+
+public:
+    t_CKBOOL base;
+    t_CKUINT oper;
+    t_CKINT imm;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Instr_Branch_Mem_Imm
+// desc: branch on ( int local or global ) compared to ( constant )
+//-----------------------------------------------------------------------------
+struct Chuck_Instr_Branch_Mem_Imm : public Chuck_Instr_Branch_Op
+{
+public:
+    Chuck_Instr_Branch_Mem_Imm( t_CKUINT where, t_CKBOOL use_base,
+                                t_CKUINT the_cmp, t_CKINT val, t_CKUINT jmp )
+    { src = where; base = use_base; cmp = the_cmp; imm = val; this->set( jmp ); }
+
+public:
+    virtual void execute( Chuck_VM * vm, Chuck_VM_Shred * shred );
+    virtual t_CKBOOL translate( Chuck_Instr_Op & op ) const
+    { op.code = CK_OP_BRANCH_MEM_IMM; op.a.u = m_jmp; op.b = base; return TRUE; }
+    virtual const char * params() const
+    { static char buffer[256];
+      sprintf( buffer, "src=%lu, base=%ld, cmp=%lu, imm=%ld, jmp=%lu", src, base, cmp, imm, m_jmp );
+      return buffer; }
+
+public:
+    t_CKUINT src;
+    t_CKBOOL base;
+    t_CKUINT cmp;
+    t_CKINT imm;
+};
+
+
+
+
 // runtime functions
 Chuck_Object * instantiate_and_initialize_object( Chuck_Type * type, Chuck_VM_Shred * shred );
 // initialize object using Type
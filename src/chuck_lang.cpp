@@ -257,6 +257,17 @@ t_CKBOOL init_class_uana( Chuck_Env * env, Chuck_Type * type )
     func->doc = "Get blob's complex value at index.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // add async
+    func = make_new_mfun( "int", "async", uana_async );
+    func->add_arg( "int", "flag" );
+    func->doc = "Set whether .upchuck() analyzes on a separate thread; the upchucking shred waits (one block or more) for the result. Chains through IFFT, IDCT or pilF are always analyzed in place.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add async
+    func = make_new_mfun( "int", "async", uana_cget_async );
+    func->doc = "Get whether .upchuck() analyzes on a separate thread.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // add isUpConnectedTo
     func = make_new_mfun( "int", "isUpConnectedTo", uana_connected );
     func->add_arg( "UAna", "right" );
@@ -267,9 +278,32 @@ t_CKBOOL init_class_uana( Chuck_Env * env, Chuck_Type * type )
     // func = make_new_mfun( "void", "nonchuck", uana_nonchuck );
     // if( !type_engine_import_mfun( env, func ) ) goto error;
 
-    // TODO: add event
-    // func = make_new_mfun( "Event", "event", uana_event );
-    // if( !type_engine_import_mfun( env, func ) ) goto error;
+    // add hop
+    func = make_new_mfun( "dur", "hop", uana_ctrl_hop );
+    func->add_arg( "dur", "hop" );
+    func->doc = "Set the time between automatic analyses (see autoTock); default 512::samp.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add hop
+    func = make_new_mfun( "dur", "hop", uana_cget_hop );
+    func->doc = "Get the time between automatic analyses.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add autoTock
+    func = make_new_mfun( "int", "autoTock", uana_ctrl_autoTock );
+    func->add_arg( "int", "flag" );
+    func->doc = "Set whether the VM upchucks this UAna every hop, starting now, with no shred involved; each result is announced through event().";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add autoTock
+    func = make_new_mfun( "int", "autoTock", uana_cget_autoTock );
+    func->doc = "Get whether the VM upchucks this UAna every hop.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add event
+    func = make_new_mfun( "Event", "event", uana_event );
+    func->doc = "Event broadcast after each automatic analysis (see autoTock), once the blob is filled.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
 
     // end
     type_engine_import_class_end( env );
@@ -291,6 +325,7 @@ error:
 static t_CKINT uanablob_offset_when = 0;
 static t_CKINT uanablob_offset_fvals = 0;
 static t_CKINT uanablob_offset_cvals = 0;
+static t_CKINT uanablob_offset_proxy = 0;
 //-----------------------------------------------------------------------------
 // name: init_class_blob()
 // desc: ...
@@ -317,6 +352,8 @@ t_CKBOOL init_class_blob( Chuck_Env * env, Chuck_Type * type )
     if( uanablob_offset_fvals == CK_INVALID_OFFSET ) goto error;
     uanablob_offset_cvals = type_engine_import_mvar( env, "complex[]", "m_cvals", FALSE );
     if( uanablob_offset_cvals == CK_INVALID_OFFSET ) goto error;
+    uanablob_offset_proxy = type_engine_import_mvar( env, "int", "@proxy", FALSE );
+    if( uanablob_offset_proxy == CK_INVALID_OFFSET ) goto error;
 
     // add when
     func = make_new_mfun( "time", "when", uanablob_when );
@@ -2421,16 +2458,21 @@ CK_DLL_CTOR( uana_ctor )
     // TODO: check out of memory
     assert( blob != NULL );
     // make a blob proxy
-    Chuck_UAnaBlobProxy * proxy = new Chuck_UAnaBlobProxy( blob );
+    Chuck_UAnaBlobProxy * proxy = new Chuck_UAnaBlobProxy( blob, (Chuck_UAna *)SELF );
     // remember it
     OBJ_MEMBER_INT(SELF, uana_offset_blob) = (t_CKINT)proxy;
     // HACK: DANGER: manually call blob's ctor (added 1.3.0.0 -- Chuck_DL_Api::Api::instance())
     uanablob_ctor( blob, NULL, NULL, Chuck_DL_Api::Api::instance() );
+    // the blob reads its values through the proxy
+    OBJ_MEMBER_INT(blob, uanablob_offset_proxy) = (t_CKINT)proxy;
 }
 
 CK_DLL_DTOR( uana_dtor )
 {
-    // TODO: GC should release the blob!
+    // the proxy (the blob goes with it, unless a script still holds it)
+    Chuck_UAnaBlobProxy * proxy = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uana_offset_blob);
+    OBJ_MEMBER_INT(SELF, uana_offset_blob) = 0;
+    SAFE_DELETE( proxy );
 }
 
 CK_DLL_MFUN( uana_upchuck )
@@ -2455,8 +2497,14 @@ CK_DLL_MFUN( uana_upchuck )
         return;
     }
 
+    // through the analysis worker, once there is one
+    if( uana->m_async || vm->uana_worker( FALSE ) )
+    {
+        // (may suspend the shred until the blob is filled)
+        uana->upchuck( vm, derhs, vm->shreduler()->now_system );
+    }
     // check if time
-    if( uana->m_uana_time < vm->shreduler()->now_system )
+    else if( uana->m_uana_time < vm->shreduler()->now_system )
     {
         // for multiple channels
         Chuck_DL_Return ret;
@@ -2481,8 +2529,83 @@ CK_DLL_MFUN( uana_upchuck )
     RETURN->v_object = NULL;
 } */
 
+CK_DLL_MFUN( uana_async )
+{
+    // get as uana
+    Chuck_UAna * uana = (Chuck_UAna *)SELF;
+    // set it
+    uana->m_async = GET_NEXT_INT(ARGS) != 0;
+    // return
+    RETURN->v_int = uana->m_async;
+}
+
+CK_DLL_MFUN( uana_cget_async )
+{
+    // get as uana
+    Chuck_UAna * uana = (Chuck_UAna *)SELF;
+    // return
+    RETURN->v_int = uana->m_async;
+}
+
+CK_DLL_MFUN( uana_ctrl_hop )
+{
+    // get as uana
+    Chuck_UAna * uana = (Chuck_UAna *)SELF;
+    // set it (at least a sample; takes effect after the next tock)
+    t_CKDUR hop = GET_NEXT_DUR(ARGS);
+    uana->m_hop = hop >= 1 ? hop : 1;
+    // return
+    RETURN->v_dur = uana->m_hop;
+}
+
+CK_DLL_MFUN( uana_cget_hop )
+{
+    // get as uana
+    Chuck_UAna * uana = (Chuck_UAna *)SELF;
+    // return
+    RETURN->v_dur = uana->m_hop;
+}
+
+CK_DLL_MFUN( uana_ctrl_autoTock )
+{
+    // get as uana
+    Chuck_UAna * uana = (Chuck_UAna *)SELF;
+    // get the shreduler
+    Chuck_VM_Shreduler * shreduler = SHRED && SHRED->vm_ref ? SHRED->vm_ref->shreduler() : NULL;
+    // set it
+    if( GET_NEXT_INT(ARGS) && shreduler ) shreduler->add_auto_tock( uana );
+    else if( uana->m_auto_sched ) uana->m_auto_sched->remove_auto_tock( uana );
+    // return
+    RETURN->v_int = uana->m_auto_sched != NULL;
+}
+
+CK_DLL_MFUN( uana_cget_autoTock )
+{
+    // get as uana
+    Chuck_UAna * uana = (Chuck_UAna *)SELF;
+    // return
+    RETURN->v_int = uana->m_auto_sched != NULL;
+}
+
+CK_DLL_MFUN( uana_event )
+{
+    // get as uana
+    Chuck_UAna * uana = (Chuck_UAna *)SELF;
+    // allocate on first use
+    if( !uana->m_event )
+    {
+        uana->m_event = new Chuck_Event;
+        initialize_object( uana->m_event, &t_event );
+        uana->m_event->add_ref();
+    }
+    // return
+    RETURN->v_object = uana->m_event;
+}
+
 CK_DLL_MFUN( uana_fvals )
 {
+    // results of an async upchuck
+    ((Chuck_UAna *)SELF)->settle();
     // get the fvals array
     Chuck_UAnaBlobProxy * blob = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uana_offset_blob);
     RETURN->v_object = &blob->fvals();
@@ -2490,6 +2613,8 @@ CK_DLL_MFUN( uana_fvals )
 
 CK_DLL_MFUN( uana_cvals )
 {
+    // results of an async upchuck
+    ((Chuck_UAna *)SELF)->settle();
     // get the fvals array
     Chuck_UAnaBlobProxy * blob = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uana_offset_blob);
     RETURN->v_object = &blob->cvals();
@@ -2499,36 +2624,26 @@ CK_DLL_MFUN( uana_fval )
 {
     // get index
     t_CKINT i = GET_NEXT_INT(ARGS);
-    // get the fvals array
+    // results of an async upchuck
+    ((Chuck_UAna *)SELF)->settle();
+    // get the fvals (without making the array)
     Chuck_UAnaBlobProxy * blob = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uana_offset_blob);
-    Chuck_Array8 & fvals = blob->fvals();
     // check caps
-    if( i < 0 || fvals.size() <= i ) RETURN->v_float = 0;
-    else
-    {
-        // get
-        t_CKFLOAT val;
-        fvals.get( i, &val );
-        RETURN->v_float = val;
-    }
+    if( i < 0 || blob->fvals_size() <= i ) RETURN->v_float = 0;
+    else RETURN->v_float = blob->fvals_data()[i];
 }
 
 CK_DLL_MFUN( uana_cval )
 {
     // get index
     t_CKINT i = GET_NEXT_INT(ARGS);
-    // get the fvals array
+    // results of an async upchuck
+    ((Chuck_UAna *)SELF)->settle();
+    // get the cvals (without making the array)
     Chuck_UAnaBlobProxy * blob = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uana_offset_blob);
-    Chuck_Array16 & cvals = blob->cvals();
     // check caps
-    if( i < 0 || cvals.size() <= i ) RETURN->v_complex.re = RETURN->v_complex.im = 0;
-    else
-    {
-        // get
-        t_CKCOMPLEX val;
-        cvals.get( i, &val );
-        RETURN->v_complex = val;
-    }
+    if( i < 0 || blob->cvals_size() <= i ) RETURN->v_complex.re = RETURN->v_complex.im = 0;
+    else RETURN->v_complex = blob->cvals_data()[i];
 }
 
 CK_DLL_MFUN( uana_connected )
@@ -2553,18 +2668,41 @@ CK_DLL_MFUN( uana_connected )
 
 
 // blob proxy implementation
-Chuck_UAnaBlobProxy::Chuck_UAnaBlobProxy( Chuck_Object * blob )
+Chuck_UAnaBlobProxy::Chuck_UAnaBlobProxy( Chuck_Object * blob, Chuck_UAna * uana )
 {
     m_blob = blob;
+    m_uana = uana;
     assert( m_blob != NULL );
     // add reference
     m_blob->add_ref();
+    // no frames yet
+    m_fvals = NULL; m_cvals = NULL;
+    m_fvals_mem = NULL; m_cvals_mem = NULL;
+    m_num_fvals = m_num_cvals = 0;
+    m_fvals_cap = m_cvals_cap = 0;
+    m_fvals_taken = m_cvals_taken = FALSE;
 }
 
 Chuck_UAnaBlobProxy::~Chuck_UAnaBlobProxy()
 {
+    if( m_blob )
+    {
+        // the blob may outlive its uana: leave it the current frame, in
+        // its arrays, and nothing pointing back here
+        if( OBJ_MEMBER_INT(m_blob, uanablob_offset_fvals) ) fvals();
+        if( OBJ_MEMBER_INT(m_blob, uanablob_offset_cvals) ) cvals();
+        OBJ_MEMBER_INT(m_blob, uanablob_offset_proxy) = 0;
+    }
     // release
     SAFE_RELEASE( m_blob );
+    // the frames
+    if( m_fvals_mem ) free( m_fvals_mem );
+    if( m_cvals_mem ) free( m_cvals_mem );
+}
+
+void Chuck_UAnaBlobProxy::settle()
+{
+    if( m_uana ) m_uana->settle();
 }
 
 t_CKTIME & Chuck_UAnaBlobProxy::when()
@@ -2578,6 +2716,13 @@ Chuck_Array8 & Chuck_UAnaBlobProxy::fvals()
     // TODO: DANGER: is this actually returning correct reference?!
     Chuck_Array8 * arr8 = (Chuck_Array8 *)OBJ_MEMBER_INT(m_blob, uanablob_offset_fvals);
     assert( arr8 != NULL );
+    // first use: the array takes over from the frame
+    if( !m_fvals_taken )
+    {
+        arr8->set_size( m_num_fvals );
+        if( m_num_fvals ) memcpy( &arr8->m_vector[0], m_fvals, m_num_fvals * sizeof(t_CKFLOAT) );
+        m_fvals_taken = TRUE;
+    }
     return *arr8;
 }
 
@@ -2586,9 +2731,103 @@ Chuck_Array16 & Chuck_UAnaBlobProxy::cvals()
     // TODO: DANGER: is this actually returning correct reference?!
     Chuck_Array16 * arr16 = (Chuck_Array16 *)OBJ_MEMBER_INT(m_blob, uanablob_offset_cvals);
     assert( arr16 != NULL );
+    // first use: the array takes over from the frame
+    if( !m_cvals_taken )
+    {
+        arr16->set_size( m_num_cvals );
+        if( m_num_cvals ) memcpy( &arr16->m_vector[0], m_cvals, m_num_cvals * sizeof(t_CKCOMPLEX) );
+        m_cvals_taken = TRUE;
+    }
     return *arr16;
 }
 
+// frame alignment, in bytes
+#define CK_BLOB_FRAME_ALIGN 32
+
+//-----------------------------------------------------------------------------
+// name: blob_frame_alloc()
+// desc: grow an aligned frame to hold bytes; the old contents are dropped
+//-----------------------------------------------------------------------------
+static void * blob_frame_alloc( void * & mem, t_CKUINT bytes )
+{
+    if( mem ) free( mem );
+    mem = malloc( bytes + CK_BLOB_FRAME_ALIGN );
+    if( !mem ) return NULL;
+    return (void *)( ((t_CKUINT)mem + CK_BLOB_FRAME_ALIGN - 1) & ~(t_CKUINT)(CK_BLOB_FRAME_ALIGN - 1) );
+}
+
+t_CKFLOAT * Chuck_UAnaBlobProxy::fvals_frame( t_CKINT size )
+{
+    // once taken, write into the array itself, unless it must resize:
+    // this may be an analysis thread, and a shred may hold the array, so
+    // go back to the frame (the array is resized on its next use)
+    if( m_fvals_taken )
+    {
+        Chuck_Array8 & arr8 = fvals();
+        if( arr8.size() == size ) return size ? &arr8.m_vector[0] : NULL;
+        m_fvals_taken = FALSE;
+    }
+
+    // grow (by doubling, so sizes that wander don't reallocate each time)
+    if( size > m_fvals_cap )
+    {
+        t_CKINT cap = ck_max( size, m_fvals_cap * 2 );
+        m_fvals = (t_CKFLOAT *)blob_frame_alloc( m_fvals_mem, cap * sizeof(t_CKFLOAT) );
+        m_fvals_cap = m_fvals ? cap : 0;
+        if( !m_fvals ) size = 0;
+    }
+    m_num_fvals = size;
+    return m_fvals;
+}
+
+t_CKCOMPLEX * Chuck_UAnaBlobProxy::cvals_frame( t_CKINT size )
+{
+    // once taken, write into the array itself, unless it must resize:
+    // this may be an analysis thread, and a shred may hold the array, so
+    // go back to the frame (the array is resized on its next use)
+    if( m_cvals_taken )
+    {
+        Chuck_Array16 & arr16 = cvals();
+        if( arr16.size() == size ) return size ? &arr16.m_vector[0] : NULL;
+        m_cvals_taken = FALSE;
+    }
+
+    // grow (by doubling, so sizes that wander don't reallocate each time)
+    if( size > m_cvals_cap )
+    {
+        t_CKINT cap = ck_max( size, m_cvals_cap * 2 );
+        m_cvals = (t_CKCOMPLEX *)blob_frame_alloc( m_cvals_mem, cap * sizeof(t_CKCOMPLEX) );
+        m_cvals_cap = m_cvals ? cap : 0;
+        if( !m_cvals ) size = 0;
+    }
+    m_num_cvals = size;
+    return m_cvals;
+}
+
+const t_CKFLOAT * Chuck_UAnaBlobProxy::fvals_data()
+{
+    if( !m_fvals_taken ) return m_fvals;
+    Chuck_Array8 & arr8 = fvals();
+    return arr8.size() ? &arr8.m_vector[0] : NULL;
+}
+
+const t_CKCOMPLEX * Chuck_UAnaBlobProxy::cvals_data()
+{
+    if( !m_cvals_taken ) return m_cvals;
+    Chuck_Array16 & arr16 = cvals();
+    return arr16.size() ? &arr16.m_vector[0] : NULL;
+}
+
+t_CKINT Chuck_UAnaBlobProxy::fvals_size()
+{
+    return m_fvals_taken ? fvals().size() : m_num_fvals;
+}
+
+t_CKINT Chuck_UAnaBlobProxy::cvals_size()
+{
+    return m_cvals_taken ? cvals().size() : m_num_cvals;
+}
+
 // get proxy
 Chuck_UAnaBlobProxy * getBlobProxy( const Chuck_UAna * uana )
 {
@@ -2612,6 +2851,8 @@ CK_DLL_CTOR( uanablob_ctor )
     // TODO: check out of memory
     arr16->add_ref();
     OBJ_MEMBER_INT(SELF, uanablob_offset_cvals) = (t_CKINT)arr16;
+    // no proxy (set by the owning UAna)
+    OBJ_MEMBER_INT(SELF, uanablob_offset_proxy) = 0;
 }
 
 // dtor
@@ -2640,14 +2881,26 @@ CK_DLL_MFUN( uanablob_when )
 
 CK_DLL_MFUN( uanablob_fvals )
 {
+    // the proxy makes the array current
+    Chuck_UAnaBlobProxy * proxy = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uanablob_offset_proxy);
+    if( proxy ) proxy->settle();
     // set return
-    RETURN->v_object = (Chuck_Array8 *)OBJ_MEMBER_INT(SELF, uanablob_offset_fvals);
+    RETURN->v_object = proxy ? &proxy->fvals() : (Chuck_Array8 *)OBJ_MEMBER_INT(SELF, uanablob_offset_fvals);
 }
 
 CK_DLL_MFUN( uanablob_fval )
 {
     // get index
     t_CKINT i = GET_NEXT_INT(ARGS);
+    // through the proxy, if there is one (without making the array)
+    Chuck_UAnaBlobProxy * proxy = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uanablob_offset_proxy);
+    if( proxy )
+    {
+        proxy->settle();
+        RETURN->v_float = i < 0 || proxy->fvals_size() <= i ? 0 : proxy->fvals_data()[i];
+        return;
+    }
+
     // get the fvals array
     Chuck_Array8 * fvals = (Chuck_Array8 *)OBJ_MEMBER_INT(SELF, uanablob_offset_fvals);
     // check caps
@@ -2665,6 +2918,16 @@ CK_DLL_MFUN( uanablob_cval )
 {
     // get index
     t_CKINT i = GET_NEXT_INT(ARGS);
+    // through the proxy, if there is one (without making the array)
+    Chuck_UAnaBlobProxy * proxy = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uanablob_offset_proxy);
+    if( proxy )
+    {
+        proxy->settle();
+        if( i < 0 || proxy->cvals_size() <= i ) RETURN->v_complex.re = RETURN->v_complex.im = 0;
+        else RETURN->v_complex = proxy->cvals_data()[i];
+        return;
+    }
+
     // get the fvals array
     Chuck_Array16 * cvals = (Chuck_Array16 *)OBJ_MEMBER_INT(SELF, uanablob_offset_cvals);
     // check caps
@@ -2680,8 +2943,11 @@ CK_DLL_MFUN( uanablob_cval )
 
 CK_DLL_MFUN( uanablob_cvals )
 {
+    // the proxy makes the array current
+    Chuck_UAnaBlobProxy * proxy = (Chuck_UAnaBlobProxy *)OBJ_MEMBER_INT(SELF, uanablob_offset_proxy);
+    if( proxy ) proxy->settle();
     // set return
-    RETURN->v_object = (Chuck_Array16 *)OBJ_MEMBER_INT(SELF, uanablob_offset_cvals);
+    RETURN->v_object = proxy ? &proxy->cvals() : (Chuck_Array16 *)OBJ_MEMBER_INT(SELF, uanablob_offset_cvals);
 }
 
 // ctor
@@ -113,6 +113,13 @@ CK_DLL_MFUN( uana_fvals );
 CK_DLL_MFUN( uana_cvals );
 CK_DLL_MFUN( uana_fval );
 CK_DLL_MFUN( uana_cval );
+CK_DLL_MFUN( uana_async );
+CK_DLL_MFUN( uana_cget_async );
+CK_DLL_MFUN( uana_ctrl_hop );
+CK_DLL_MFUN( uana_cget_hop );
+CK_DLL_MFUN( uana_ctrl_autoTock );
+CK_DLL_MFUN( uana_cget_autoTock );
+CK_DLL_MFUN( uana_event );
 CK_DLL_MFUN( uana_connected );
 
 
@@ -135,19 +142,46 @@ CK_DLL_MFUN( uanablob_when );
 struct Chuck_UAnaBlobProxy
 {
 public:
-    Chuck_UAnaBlobProxy( Chuck_Object * blob );
+    Chuck_UAnaBlobProxy( Chuck_Object * blob, Chuck_UAna * uana );
     virtual ~Chuck_UAnaBlobProxy();
 
 public:
     t_CKTIME & when();
+    // the ChucK-visible arrays (made current on first use, then kept so)
     Chuck_Array8 & fvals();
     Chuck_Array16 & cvals();
 
+public: // frame: written in place by producers, read in place by consumers
+    // size the frame and get it for writing (contents are undefined)
+    t_CKFLOAT * fvals_frame( t_CKINT size );
+    t_CKCOMPLEX * cvals_frame( t_CKINT size );
+    // the current values (valid until the next write)
+    const t_CKFLOAT * fvals_data();
+    const t_CKCOMPLEX * cvals_data();
+    t_CKINT fvals_size();
+    t_CKINT cvals_size();
+
 public:
     Chuck_Object * realblob() { return m_blob; }
+    // wait for the owning uana's tock in flight, if any
+    void settle();
 
 protected:
     Chuck_Object * m_blob;
+    // the owning uana (outlives the proxy)
+    Chuck_UAna * m_uana;
+    // aligned frames, until the arrays are taken
+    t_CKFLOAT * m_fvals;
+    t_CKCOMPLEX * m_cvals;
+    void * m_fvals_mem;
+    void * m_cvals_mem;
+    t_CKINT m_num_fvals;
+    t_CKINT m_num_cvals;
+    t_CKINT m_fvals_cap;
+    t_CKINT m_cvals_cap;
+    // whether the arrays have been taken (then they hold the values)
+    t_CKBOOL m_fvals_taken;
+    t_CKBOOL m_cvals_taken;
 };
 
 // get proxy
@@ -42,6 +42,7 @@
 #include <sstream>
 #include <iomanip>
 #include <typeinfo>
+#include <new>
 using namespace std;
 
 #if defined(__PLATFORM_WIN32__)
@@ -151,6 +152,32 @@ void Chuck_VM_Object::release()
 
 
 
+//-----------------------------------------------------------------------------
+// name: operator new()
+// desc: allocate from the vm allocator
+//-----------------------------------------------------------------------------
+void * Chuck_VM_Object::operator new( size_t size )
+{
+    void * ptr = Chuck_VM_Alloc::instance()->alloc_block( size );
+    if( !ptr ) throw std::bad_alloc();
+    return ptr;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: operator delete()
+// desc: give back to the vm allocator (size is that of the dynamic type)
+//-----------------------------------------------------------------------------
+void Chuck_VM_Object::operator delete( void * ptr, size_t size )
+{
+    Chuck_VM_Alloc::instance()->free_block( ptr, size );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: lock()
 // desc: lock to keep from deleted
@@ -261,12 +288,267 @@ void Chuck_VM_Alloc::free_object( Chuck_VM_Object * obj )
 
 
 
+// the calling thread's allocator cache
+#if defined(_MSC_VER)
+static __declspec(thread) Chuck_VM_Alloc::Cache * g_alloc_cache = NULL;
+#else
+static __thread Chuck_VM_Alloc::Cache * g_alloc_cache = NULL;
+#endif
+
+
+//-----------------------------------------------------------------------------
+// name: alloc_block()
+// desc: allocate size bytes: from this thread's free list of its size
+//       class, or from the heap if too big
+//-----------------------------------------------------------------------------
+void * Chuck_VM_Alloc::alloc_block( t_CKUINT size )
+{
+    // too big (or nothing): heap
+    if( size == 0 || size > CK_ALLOC_MAX )
+    {
+        xatomic_add( &m_large_allocs, 1 );
+        return ::operator new( size ? size : 1, std::nothrow );
+    }
+
+    // size class
+    t_CKUINT c = (size - 1) / CK_ALLOC_GRAIN;
+    Cache * k = cache();
+    if( !k ) return NULL;
+
+    // refill
+    if( !k->free[c] && !refill( k, c ) )
+        return NULL;
+
+    // pop
+    void * ptr = k->free[c];
+    k->free[c] = *(void **)ptr;
+    k->count[c]--;
+    k->allocs[c]++;
+
+    return ptr;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: free_block()
+// desc: give back a block from alloc_block(), with the same size (on any
+//       thread: it joins the calling thread's cache)
+//-----------------------------------------------------------------------------
+void Chuck_VM_Alloc::free_block( void * ptr, t_CKUINT size )
+{
+    // check
+    if( !ptr ) return;
+
+    // heap
+    if( size == 0 || size > CK_ALLOC_MAX )
+    {
+        xatomic_add( &m_large_frees, 1 );
+        ::operator delete( ptr );
+        return;
+    }
+
+    // size class
+    t_CKUINT c = (size - 1) / CK_ALLOC_GRAIN;
+    Cache * k = cache();
+    // (no cache: keep it out of circulation)
+    if( !k ) return;
+
+    // push
+    *(void **)ptr = k->free[c];
+    k->free[c] = ptr;
+    k->frees[c]++;
+
+    // more than this thread is likely to need again soon
+    if( ++k->count[c] >= 2 * CK_ALLOC_BATCH )
+        drain( k, c );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: alloc_data()
+// desc: zeroed member data for an object
+//-----------------------------------------------------------------------------
+t_CKBYTE * Chuck_VM_Alloc::alloc_data( t_CKUINT size )
+{
+    t_CKBYTE * data = (t_CKBYTE *)alloc_block( size );
+    if( data ) memset( data, 0, size );
+    return data;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: free_data()
+// desc: give back member data from alloc_data()
+//-----------------------------------------------------------------------------
+void Chuck_VM_Alloc::free_data( t_CKBYTE * data, t_CKUINT size )
+{
+    free_block( data, size );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: cache()
+// desc: the calling thread's cache, made on first use
+//-----------------------------------------------------------------------------
+Chuck_VM_Alloc::Cache * Chuck_VM_Alloc::cache()
+{
+    if( g_alloc_cache ) return g_alloc_cache;
+
+    // new thread
+    Cache * k = (Cache *)calloc( 1, sizeof(Cache) );
+    if( !k ) return NULL;
+
+    m_lock.acquire();
+    k->next = m_caches;
+    m_caches = k;
+    m_lock.release();
+
+    return g_alloc_cache = k;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: refill()
+// desc: refill the empty free list of size class c: a batch from the
+//       depot, else a new slab (allocated with no lock held)
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Alloc::refill( Cache * k, t_CKUINT c )
+{
+    void * batch = NULL;
+
+    // from the depot
+    m_lock.acquire();
+    if( m_depot[c] )
+    {
+        batch = m_depot[c];
+        m_depot[c] = ((void **)batch)[1];
+    }
+    m_lock.release();
+
+    if( batch )
+    {
+        k->free[c] = batch;
+        k->count[c] = CK_ALLOC_BATCH;
+        return TRUE;
+    }
+
+    // carve a new slab
+    t_CKUINT block = (c + 1) * CK_ALLOC_GRAIN;
+    t_CKUINT count = CK_ALLOC_SLAB_SIZE / block;
+    t_CKBYTE * slab = (t_CKBYTE *)::operator new( CK_ALLOC_SLAB_SIZE, std::nothrow );
+    if( !slab ) return FALSE;
+
+    // thread the blocks, in address order
+    for( t_CKUINT i = 0; i < count; i++ )
+        *(void **)(slab + i * block) = i + 1 < count ? slab + (i + 1) * block : NULL;
+    k->free[c] = slab;
+    k->count[c] = count;
+
+    xatomic_add( &m_slabs, 1 );
+    xatomic_add( &m_blocks[c], count );
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: drain()
+// desc: move a batch from the front of a free list to the depot
+//-----------------------------------------------------------------------------
+void Chuck_VM_Alloc::drain( Cache * k, t_CKUINT c )
+{
+    // cut the batch (outside the lock)
+    void * batch = k->free[c];
+    void * last = batch;
+    for( t_CKUINT i = 1; i < CK_ALLOC_BATCH; i++ )
+        last = *(void **)last;
+    k->free[c] = *(void **)last;
+    *(void **)last = NULL;
+    k->count[c] -= CK_ALLOC_BATCH;
+
+    // link it
+    m_lock.acquire();
+    ((void **)batch)[1] = m_depot[c];
+    m_depot[c] = batch;
+    m_lock.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: report()
+// desc: log statistics (per-thread counts are read as they are)
+//-----------------------------------------------------------------------------
+void Chuck_VM_Alloc::report()
+{
+    t_CKUINT allocs = 0, frees = 0, blocks = 0, caches = 0;
+    t_CKUINT class_allocs[CK_ALLOC_NUM_CLASSES];
+    t_CKUINT class_frees[CK_ALLOC_NUM_CLASSES];
+
+    memset( class_allocs, 0, sizeof(class_allocs) );
+    memset( class_frees, 0, sizeof(class_frees) );
+
+    m_lock.acquire();
+    for( Cache * k = m_caches; k; k = k->next, caches++ )
+    {
+        for( t_CKUINT c = 0; c < CK_ALLOC_NUM_CLASSES; c++ )
+        {
+            class_allocs[c] += k->allocs[c];
+            class_frees[c] += k->frees[c];
+        }
+    }
+    m_lock.release();
+
+    for( t_CKUINT c = 0; c < CK_ALLOC_NUM_CLASSES; c++ )
+    {
+        allocs += class_allocs[c];
+        frees += class_frees[c];
+        blocks += m_blocks[c];
+    }
+
+    EM_log( CK_LOG_SYSTEM, "vm allocator: %lu allocs, %lu frees, %lu live; %lu slabs (%lu KB, %lu blocks); %lu/%lu large allocs/frees; %lu threads",
+            allocs, frees, allocs - frees, m_slabs, m_slabs * CK_ALLOC_SLAB_SIZE / 1024,
+            blocks, m_large_allocs, m_large_frees, caches );
+    // per size class
+    EM_pushlog();
+    for( t_CKUINT c = 0; c < CK_ALLOC_NUM_CLASSES; c++ )
+    {
+        if( !class_allocs[c] ) continue;
+        EM_log( CK_LOG_FINE, "%4lu bytes: %lu allocs, %lu live, %lu blocks",
+                (c + 1) * CK_ALLOC_GRAIN, class_allocs[c], class_allocs[c] - class_frees[c], m_blocks[c] );
+    }
+    EM_poplog();
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: Chuck_VM_Alloc()
 // desc: constructor
 //-----------------------------------------------------------------------------
 Chuck_VM_Alloc::Chuck_VM_Alloc()
-{ }
+{
+    memset( m_depot, 0, sizeof(m_depot) );
+    memset( (void *)m_blocks, 0, sizeof(m_blocks) );
+    m_caches = NULL;
+    m_slabs = 0;
+    m_large_allocs = 0;
+    m_large_frees = 0;
+}
 
 
 
@@ -276,7 +558,9 @@ Chuck_VM_Alloc::Chuck_VM_Alloc()
 // desc: destructor
 //-----------------------------------------------------------------------------
 Chuck_VM_Alloc::~Chuck_VM_Alloc()
-{ }
+{
+    // objects may still be out; slabs are kept
+}
 
 
 
@@ -326,10 +610,10 @@ Chuck_Object::~Chuck_Object()
         type = type->parent;
     }
     
-    // free
-    if( vtable ) { delete vtable; vtable = NULL; }
+    // free (the vtable is the type's)
+    vtable = NULL;
     if( type_ref ) { type_ref->release(); type_ref = NULL; }
-    if( data ) { delete [] data; size = 0; data = NULL; }
+    if( data ) { Chuck_VM_Alloc::instance()->free_data( data, size ); size = 0; data = NULL; }
 }
 
 
@@ -1959,6 +2243,20 @@ void Chuck_Array32::zero( t_CKUINT start, t_CKUINT end )
 // static
 t_CKUINT Chuck_Event::our_can_wait = 0;
 
+//-----------------------------------------------------------------------------
+// name: Chuck_Event()
+// desc: constructor
+//-----------------------------------------------------------------------------
+Chuck_Event::Chuck_Event()
+{
+    m_num_waiting = 0;
+    m_vm = NULL;
+}
+
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: signal()
 // desc: signal a event/condition variable, shreduling the next waiting shred
@@ -1966,12 +2264,11 @@ t_CKUINT Chuck_Event::our_can_wait = 0;
 //-----------------------------------------------------------------------------
 void Chuck_Event::signal()
 {
-    m_queue_lock.acquire();
     if( !m_queue.empty() )
     {
         Chuck_VM_Shred * shred = m_queue.front();
         m_queue.pop();
-        m_queue_lock.release();
+        xatomic_store( &m_num_waiting, m_queue.size() );
         Chuck_VM_Shreduler * shreduler = shred->vm_ref->shreduler();
         shred->event = NULL;
         shreduler->remove_blocked( shred );
@@ -1980,8 +2277,6 @@ void Chuck_Event::signal()
         t_CKTIME *& sp = (t_CKTIME *&)shred->reg->sp;
         push_( sp, shreduler->now_system );
     }
-    else
-        m_queue_lock.release();
 }
 
 
@@ -1995,7 +2290,6 @@ t_CKBOOL Chuck_Event::remove( Chuck_VM_Shred * shred )
 {
     queue<Chuck_VM_Shred *> temp;
     t_CKBOOL removed = FALSE;
-    m_queue_lock.acquire();
     while( !m_queue.empty() )
     {
         if( m_queue.front() != shred )
@@ -2008,7 +2302,7 @@ t_CKBOOL Chuck_Event::remove( Chuck_VM_Shred * shred )
     }
 
     m_queue = temp;
-    m_queue_lock.release();
+    xatomic_store( &m_num_waiting, m_queue.size() );
     return removed;
 }
 
@@ -2018,23 +2312,17 @@ t_CKBOOL Chuck_Event::remove( Chuck_VM_Shred * shred )
 //-----------------------------------------------------------------------------
 // name: queue_broadcast()
 // desc: queue the event to broadcast a event/condition variable, by the owner
-//       of the queue
+//       of the queue; called from other threads, so it only looks at the
+//       waiter count, never the queue
 //       added 1.3.0.0: event_buffer to fix big-ass bug
 //-----------------------------------------------------------------------------
 void Chuck_Event::queue_broadcast( CBufferSimple * event_buffer )
 {
     // TODO: handle multiple VM
-    m_queue_lock.acquire();
-    if( !m_queue.empty() )
+    if( xatomic_load( &m_num_waiting ) )
     {
-        Chuck_VM_Shred * shred = m_queue.front();
-        m_queue_lock.release();
         // queue the event on the vm (added 1.3.0.0: event_buffer)
-        shred->vm_ref->queue_event( this, 1, event_buffer );
-    }
-    else
-    {
-        m_queue_lock.release();
+        m_vm->queue_event( this, 1, event_buffer );
     }
 }
 
@@ -2043,18 +2331,31 @@ void Chuck_Event::queue_broadcast( CBufferSimple * event_buffer )
 
 //-----------------------------------------------------------------------------
 // name: broadcast()
-// desc: broadcast a event/condition variable, shreduling all waiting shreds
+// desc: broadcast a event/condition variable, shreduling all waiting shreds;
+//       the waiters are taken all at once and shreduled in one pass
 //-----------------------------------------------------------------------------
 void Chuck_Event::broadcast()
 {
-    m_queue_lock.acquire();
+    m_waking.clear();
     while( !m_queue.empty() )
     {
-        m_queue_lock.release();
-        this->signal();
-        m_queue_lock.acquire();
+        m_waking.push_back( m_queue.front() );
+        m_queue.pop();
+    }
+    xatomic_store( &m_num_waiting, 0 );
+
+    if( m_waking.empty() ) return;
+
+    // TODO: handle multiple VM
+    Chuck_VM_Shreduler * shreduler = m_waking[0]->vm_ref->shreduler();
+    shreduler->wake( &m_waking[0], m_waking.size() );
+
+    // push the current time
+    for( t_CKUINT i = 0; i < m_waking.size(); i++ )
+    {
+        t_CKTIME *& sp = (t_CKTIME *&)m_waking[i]->reg->sp;
+        push_( sp, shreduler->now_system );
     }
-    m_queue_lock.release();
 }
 
 
@@ -2086,9 +2387,9 @@ void Chuck_Event::wait( Chuck_VM_Shred * shred, Chuck_VM * vm )
         shred->is_running = FALSE;
 
         // add to waiting list
-        m_queue_lock.acquire();
         m_queue.push( shred );
-        m_queue_lock.release();
+        m_vm = vm;
+        xatomic_store( &m_num_waiting, m_queue.size() );
 
         // add event to shred
         assert( shred->event == NULL );
@@ -3031,7 +3332,7 @@ THREAD_RETURN ( THREAD_TYPE Chuck_IO_File::writeStr_thread ) ( void *data )
     args->fileio_obj->write ( args->stringArg );
     Chuck_Event *e = args->fileio_obj->m_asyncEvent;
     delete args;
-    e->broadcast(); // wake up
+    e->queue_broadcast(); // wake up (on the vm's thread)
     
     return (THREAD_RETURN)0;
 }
@@ -3040,7 +3341,7 @@ THREAD_RETURN ( THREAD_TYPE Chuck_IO_File::writeInt_thread ) ( void *data )
 {
     async_args *args = (async_args *)data;
     args->fileio_obj->write ( args->intArg );
-    args->fileio_obj->m_asyncEvent->broadcast(); // wake up
+    args->fileio_obj->m_asyncEvent->queue_broadcast(); // wake up (on the vm's thread)
     delete args;
     
     return (THREAD_RETURN)0;
@@ -3050,7 +3351,7 @@ THREAD_RETURN ( THREAD_TYPE Chuck_IO_File::writeFloat_thread ) ( void *data )
 {
     async_args *args = (async_args *)data;
     args->fileio_obj->write ( args->floatArg );
-    args->fileio_obj->m_asyncEvent->broadcast(); // wake up
+    args->fileio_obj->m_asyncEvent->queue_broadcast(); // wake up (on the vm's thread)
     delete args;
     
     return (THREAD_RETURN)0;
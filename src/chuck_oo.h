@@ -49,6 +49,15 @@
   struct DIR;
 #endif
 
+// vm allocator size classes: multiples of GRAIN bytes, up to MAX bytes
+#define CK_ALLOC_GRAIN          16
+#define CK_ALLOC_MAX            1024
+#define CK_ALLOC_NUM_CLASSES    (CK_ALLOC_MAX / CK_ALLOC_GRAIN)
+// bytes per slab, carved into blocks of one size class
+#define CK_ALLOC_SLAB_SIZE      (64 * 1024)
+// blocks moved at a time between a thread's cache and the shared depot
+#define CK_ALLOC_BATCH          32
+
 // forward reference
 struct Chuck_Type;
 struct Chuck_Value;
@@ -86,6 +95,11 @@ public:
     // NOTE: be careful when overriding these, should always
     // explicitly call up to ChucK_VM_Object (ge: 2013)
 
+public:
+    // vm objects (and subclasses) are allocated by Chuck_VM_Alloc
+    static void * operator new( size_t size );
+    static void operator delete( void * ptr, size_t size );
+
 public:
     // unlock_all: dis/allow deletion of locked objects
     static void lock_all();
@@ -110,7 +124,12 @@ private:
 
 //-----------------------------------------------------------------------------
 // name: struct Chuck_VM_Alloc
-// desc: vm object manager
+// desc: vm object manager; vm objects and their member data come from
+//       size-class free lists, carved out of slabs (and are never given
+//       back to the system allocator); bigger blocks go to the heap.
+//       each thread allocates from and frees to its own cache, with no
+//       lock; caches trade whole batches with a shared depot, under a
+//       lock held only to link or unlink one batch.
 //-----------------------------------------------------------------------------
 struct Chuck_VM_Alloc
 {
@@ -121,6 +140,28 @@ public:
     void add_object( Chuck_VM_Object * obj );
     void free_object( Chuck_VM_Object * obj );
 
+public:
+    // memory for vm objects
+    void * alloc_block( t_CKUINT size );
+    void free_block( void * ptr, t_CKUINT size );
+    // zeroed member data for objects
+    t_CKBYTE * alloc_data( t_CKUINT size );
+    void free_data( t_CKBYTE * data, t_CKUINT size );
+    // log statistics
+    void report();
+
+public:
+    // one thread's free blocks (linked through their first word) and stats
+    struct Cache
+    {
+        void * free[CK_ALLOC_NUM_CLASSES];
+        t_CKUINT count[CK_ALLOC_NUM_CLASSES];
+        t_CKUINT allocs[CK_ALLOC_NUM_CLASSES];
+        t_CKUINT frees[CK_ALLOC_NUM_CLASSES];
+        // all caches, for report()
+        Cache * next;
+    };
+
 protected:
     static Chuck_VM_Alloc * our_instance;
 
@@ -128,8 +169,28 @@ protected:
     Chuck_VM_Alloc();
     ~Chuck_VM_Alloc();
 
+    // the calling thread's cache, made on first use
+    Cache * cache();
+    // refill an empty free list: a batch from the depot, else a new slab
+    t_CKBOOL refill( Cache * cache, t_CKUINT c );
+    // give a batch of a full free list back to the depot
+    void drain( Cache * cache, t_CKUINT c );
+
 protected: // data
     std::map<Chuck_VM_Object *, void *> m_objects;
+    // batches of CK_ALLOC_BATCH free blocks per size class (each linked
+    // through first words, batches through the second word of the first)
+    void * m_depot[CK_ALLOC_NUM_CLASSES];
+    // all caches
+    Cache * m_caches;
+    // depot and cache list: allocating threads are audio, compiler, otf...
+    XMutex m_lock;
+
+public: // stats
+    volatile t_CKUINT m_slabs;
+    volatile t_CKUINT m_blocks[CK_ALLOC_NUM_CLASSES];
+    volatile t_CKUINT m_large_allocs;
+    volatile t_CKUINT m_large_frees;
 };
 
 
@@ -424,6 +485,9 @@ public:
 //-----------------------------------------------------------------------------
 struct Chuck_Event : Chuck_Object
 {
+public:
+    Chuck_Event();
+
 public:
     void signal();
     void broadcast();
@@ -438,8 +502,15 @@ public:
     static t_CKUINT our_can_wait;
 
 protected:
+    // waiting shreds (only touched by the vm's thread; other threads,
+    // e.g. FileIO's async writers, wake them with queue_broadcast())
     std::queue<Chuck_VM_Shred *> m_queue;
-    XMutex m_queue_lock;
+    // waiters taken by broadcast() (kept to reuse its storage)
+    std::vector<Chuck_VM_Shred *> m_waking;
+    // how many are waiting, for queue_broadcast() on other threads
+    volatile t_CKUINT m_num_waiting;
+    // the vm they wait on
+    Chuck_VM * m_vm;
 };
 
 
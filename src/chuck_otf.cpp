@@ -182,6 +182,37 @@ t_CKUINT otf_process_msg( Chuck_VM * vm, Chuck_Compiler * compiler,
             }
         }
 
+        // compile on the worker, if there is one
+        if( compiler->worker && compiler->worker->running() &&
+            ( !immediate || vm->shreduler()->m_current_shred ) )
+        {
+            // set the flags for the command
+            cmd->type = msg->type;
+            if( msg->type == MSG_REPLACE )
+                cmd->param = msg->param;
+
+            if( immediate )
+            {
+                // Machine.add/replace: the calling shred resumes with the
+                // result once the vm has processed the command
+                vm->wait_msg( vm->shreduler()->m_current_shred, cmd );
+                compiler->worker->submit( cmd, msg->buffer, fd, NULL );
+                fd = NULL;
+                ret = 0;
+            }
+            else
+            {
+                // wait for the compile, to reply success or failure
+                t_CKINT status = 0;
+                compiler->worker->submit( cmd, msg->buffer, fd, &status );
+                fd = NULL;
+                compiler->worker->wait( &status );
+                ret = status > 0;
+            }
+
+            goto cleanup;
+        }
+
         // construct full path to be associated with the file so me.sourceDir() works
         // (added 1.3.5.2)
         std::string full_path = get_full_path( msg->buffer );
@@ -33,13 +33,677 @@
 // date: Autumn 2004
 //-----------------------------------------------------------------------------
 #include "chuck_stats.h"
+#include "chuck_vm.h"
+#include "chuck_ugen.h"
+#include "chuck_type.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+using namespace std;
+
+#if defined(__PLATFORM_WIN32__)
+  #include <windows.h>
+#else
+  #include <sys/time.h>
+  #if defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+    #include <x86intrin.h>
+    #define __CK_PROFILE_RDTSC__
+  #elif defined(__PLATFORM_MACOSX__)
+    #include <mach/mach_time.h>
+  #else
+    #include <time.h>
+  #endif
+#endif
+
+
+// static members
+Chuck_Profiler * Chuck_Profiler::our_instance = NULL;
+volatile t_CKBOOL Chuck_Profiler::our_on = FALSE;
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: profile_wall()
+// desc: wall clock, in seconds
+//-----------------------------------------------------------------------------
+static t_CKFLOAT profile_wall()
+{
+#if defined(__PLATFORM_WIN32__)
+    LARGE_INTEGER t, f;
+    QueryPerformanceCounter( &t );
+    QueryPerformanceFrequency( &f );
+    return (t_CKFLOAT)t.QuadPart / f.QuadPart;
+#else
+    struct timeval t;
+    gettimeofday( &t, NULL );
+    return t.tv_sec + (t_CKFLOAT)t.tv_usec / 1000000;
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: now()
+// desc: read the counter: cycles where there is a cycle counter
+//-----------------------------------------------------------------------------
+t_CKTICKS Chuck_Profiler::now()
+{
+#if defined(__PLATFORM_WIN32__)
+    LARGE_INTEGER t;
+    QueryPerformanceCounter( &t );
+    return (t_CKTICKS)t.QuadPart;
+#elif defined(__CK_PROFILE_RDTSC__)
+    return (t_CKTICKS)__rdtsc();
+#elif defined(__PLATFORM_MACOSX__)
+    return (t_CKTICKS)mach_absolute_time();
+#else
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return (t_CKTICKS)t.tv_sec * 1000000000 + t.tv_nsec;
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: since()
+// desc: ticks since start, less the cost of reading the counter
+//-----------------------------------------------------------------------------
+t_CKTICKS Chuck_Profiler::since( t_CKTICKS start )
+{
+    t_CKTICKS ticks = now() - start;
+    return ticks > m_overhead ? ticks - m_overhead : 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: rate()
+// desc: counter ticks per second; the cycle counter is measured against
+//       the wall clock for a few ms, the first time
+//-----------------------------------------------------------------------------
+t_CKFLOAT Chuck_Profiler::rate()
+{
+    static t_CKFLOAT the_rate = 0;
+    if( the_rate > 0 ) return the_rate;
+
+#if defined(__PLATFORM_WIN32__)
+    LARGE_INTEGER f;
+    QueryPerformanceFrequency( &f );
+    the_rate = (t_CKFLOAT)f.QuadPart;
+#elif defined(__CK_PROFILE_RDTSC__)
+    t_CKFLOAT start = profile_wall(), end;
+    t_CKTICKS ticks = now();
+    while( ( end = profile_wall() ) - start < .005 );
+    the_rate = ( now() - ticks ) / ( end - start );
+#elif defined(__PLATFORM_MACOSX__)
+    mach_timebase_info_data_t info;
+    mach_timebase_info( &info );
+    the_rate = 1000000000.0 * info.denom / info.numer;
+#else
+    the_rate = 1000000000.0;
+#endif
+
+    return the_rate;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: instance()
+// desc: ...
+//-----------------------------------------------------------------------------
+Chuck_Profiler * Chuck_Profiler::instance()
+{
+    if( !our_instance )
+    {
+        our_instance = new Chuck_Profiler;
+        assert( our_instance );
+    }
+
+    return our_instance;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: Chuck_Profiler()
+// desc: ...
+//-----------------------------------------------------------------------------
+Chuck_Profiler::Chuck_Profiler()
+{
+    m_ugen_count = 0;
+    m_wall = 0;
+    m_wall_start = 0;
+    // not measured yet
+    m_overhead = (t_CKTICKS)-1;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: enable()
+// desc: turn on/off; returns the previous state
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_Profiler::enable( t_CKBOOL on )
+{
+    t_CKBOOL was = our_on;
+    if( on == was ) return was;
+
+    if( on )
+    {
+        // the least it takes to time nothing, measured once
+        if( m_overhead == (t_CKTICKS)-1 )
+        {
+            rate();
+            for( t_CKUINT i = 0; i < 1000; i++ )
+            {
+                t_CKTICKS start = now();
+                t_CKTICKS ticks = now() - start;
+                if( ticks < m_overhead ) m_overhead = ticks;
+            }
+        }
+        m_wall_start = profile_wall();
+    }
+    else m_wall += profile_wall() - m_wall_start;
+
+    our_on = on;
+    return was;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: reset()
+// desc: forget everything so far; entries still held by a shred or ugen
+//       are zeroed, the rest deleted
+//-----------------------------------------------------------------------------
+void Chuck_Profiler::reset()
+{
+    vector<Profile_Entry *> * lists[] = { &m_shreds, &m_ugens };
+
+    m_mutex.acquire();
+    for( t_CKUINT i = 0; i < 2; i++ )
+    {
+        vector<Profile_Entry *> & list = *lists[i];
+        t_CKUINT n = 0;
+        for( t_CKUINT j = 0; j < list.size(); j++ )
+        {
+            if( list[j]->done ) { delete list[j]; continue; }
+            list[j]->ticks = 0;
+            list[j]->count = 0;
+            list[n++] = list[j];
+        }
+        list.resize( n );
+    }
+    m_wall = 0;
+    m_wall_start = profile_wall();
+    m_mutex.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: shred_ran()
+// desc: one activation of a shred took this many ticks
+//-----------------------------------------------------------------------------
+void Chuck_Profiler::shred_ran( Chuck_VM_Shred * shred, t_CKTICKS ticks )
+{
+    Profile_Entry * entry = shred->profile;
+
+    // first time
+    if( !entry )
+    {
+        entry = new Profile_Entry;
+        entry->xid = shred->xid;
+        entry->name = shred->name;
+        entry->shred = shred->xid;
+        entry->ticks = 0;
+        entry->count = 0;
+        entry->done = FALSE;
+        m_mutex.acquire();
+        m_shreds.push_back( entry );
+        m_mutex.release();
+        shred->profile = entry;
+    }
+
+    entry->ticks += ticks;
+    entry->count++;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: shred_done()
+// desc: a profiled shred is being freed
+//-----------------------------------------------------------------------------
+void Chuck_Profiler::shred_done( Chuck_VM_Shred * shred )
+{
+    m_mutex.acquire();
+    shred->profile->done = TRUE;
+    shred->profile = NULL;
+    m_mutex.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ugen_ran()
+// desc: count computes of a ugen took this many ticks; may be called from a
+//       render thread, but never for the same ugen from two at once
+//-----------------------------------------------------------------------------
+void Chuck_Profiler::ugen_ran( Chuck_UGen * ugen, t_CKTICKS ticks, t_CKUINT count )
+{
+    Profile_Entry * entry = ugen->m_profile;
+
+    // first time
+    if( !entry )
+    {
+        entry = new Profile_Entry;
+        entry->name = ugen->type_ref ? ugen->type_ref->name : "UGen";
+        entry->shred = ugen->shred ? ugen->shred->xid : 0;
+        entry->ticks = 0;
+        entry->count = 0;
+        entry->done = FALSE;
+        m_mutex.acquire();
+        entry->xid = ++m_ugen_count;
+        m_ugens.push_back( entry );
+        m_mutex.release();
+        ugen->m_profile = entry;
+    }
+
+    entry->ticks += ticks;
+    entry->count += count;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ugen_done()
+// desc: a profiled ugen is being freed
+//-----------------------------------------------------------------------------
+void Chuck_Profiler::ugen_done( Chuck_UGen * ugen )
+{
+    m_mutex.acquire();
+    ugen->m_profile->done = TRUE;
+    ugen->m_profile = NULL;
+    m_mutex.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: seconds()
+// desc: ticks to seconds
+//-----------------------------------------------------------------------------
+t_CKFLOAT Chuck_Profiler::seconds( t_CKTICKS ticks )
+{
+    return ticks / rate();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: shred_seconds()
+// desc: cpu seconds of the latest shred with this id (0 if none)
+//-----------------------------------------------------------------------------
+t_CKFLOAT Chuck_Profiler::shred_seconds( t_CKUINT xid )
+{
+    t_CKTICKS ticks = 0;
+
+    m_mutex.acquire();
+    for( t_CKINT i = (t_CKINT)m_shreds.size() - 1; i >= 0; i-- )
+        if( m_shreds[i]->xid == xid ) { ticks = m_shreds[i]->ticks; break; }
+    m_mutex.release();
+
+    return seconds( ticks );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ugen_seconds()
+// desc: cpu seconds of a ugen (0 if never profiled)
+//-----------------------------------------------------------------------------
+t_CKFLOAT Chuck_Profiler::ugen_seconds( Chuck_UGen * ugen )
+{
+    return ugen->m_profile ? seconds( ugen->m_profile->ticks ) : 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: more_ticks()
+// desc: sort order, busiest first
+//-----------------------------------------------------------------------------
+static bool more_ticks( const Profile_Entry * a, const Profile_Entry * b )
+{
+    return a->ticks > b->ticks;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: report()
+// desc: per shred (with the ugens made on it), per ugen type, and the
+//       top ugen instances; cpu % is of the wall clock time profiled
+//-----------------------------------------------------------------------------
+string Chuck_Profiler::report( t_CKUINT top )
+{
+    vector<Profile_Entry *> types;
+    vector<Profile_Entry *> ugens;
+    string out;
+    char line[256];
+    t_CKUINT i, j;
+
+    m_mutex.acquire();
+
+    t_CKFLOAT wall = m_wall + ( our_on ? profile_wall() - m_wall_start : 0 );
+    t_CKFLOAT percent = wall > 0 ? 100 / wall : 0;
+    snprintf( line, sizeof(line), "[chuck]: profile: %.3f seconds%s\n",
+              wall, our_on ? "" : " (off)" );
+    out += line;
+
+    // shreds
+    snprintf( line, sizeof(line), "  %-30s %10s %7s %11s %9s %10s\n",
+              "shred", "cpu ms", "cpu %", "activations", "us/act", "ugen ms" );
+    out += line;
+    for( i = 0; i < m_shreds.size(); i++ )
+    {
+        Profile_Entry * s = m_shreds[i];
+        t_CKTICKS ugen_ticks = 0;
+        for( j = 0; j < m_ugens.size(); j++ )
+            if( m_ugens[j]->shred == s->xid ) ugen_ticks += m_ugens[j]->ticks;
+        snprintf( line, sizeof(line), "[%lu] ", s->xid );
+        string name = line + s->name + ( s->done ? " (done)" : "" );
+        snprintf( line, sizeof(line), "  %-30.30s %10.3f %7.2f %11lu %9.2f %10.3f\n",
+                  name.c_str(), seconds( s->ticks ) * 1000, seconds( s->ticks ) * percent, s->count,
+                  s->count ? seconds( s->ticks ) * 1000000 / s->count : 0,
+                  seconds( ugen_ticks ) * 1000 );
+        out += line;
+    }
+
+    // ugen types: one summed entry each, counting instances in xid
+    for( i = 0; i < m_ugens.size(); i++ )
+    {
+        for( j = 0; j < types.size(); j++ )
+            if( types[j]->name == m_ugens[i]->name ) break;
+        if( j == types.size() )
+        {
+            types.push_back( new Profile_Entry( *m_ugens[i] ) );
+            types[j]->ticks = 0; types[j]->count = 0; types[j]->xid = 0;
+        }
+        types[j]->ticks += m_ugens[i]->ticks;
+        types[j]->count += m_ugens[i]->count;
+        types[j]->xid++;
+    }
+    sort( types.begin(), types.end(), more_ticks );
+    snprintf( line, sizeof(line), "  %-30s %10s %7s %11s %9s\n",
+              "ugen type", "cpu ms", "cpu %", "computes", "instances" );
+    out += line;
+    for( i = 0; i < types.size(); i++ )
+    {
+        snprintf( line, sizeof(line), "  %-30.30s %10.3f %7.2f %11lu %9lu\n",
+                  types[i]->name.c_str(), seconds( types[i]->ticks ) * 1000,
+                  seconds( types[i]->ticks ) * percent, types[i]->count, types[i]->xid );
+        out += line;
+        delete types[i];
+    }
+
+    // ugen instances, busiest first
+    ugens = m_ugens;
+    sort( ugens.begin(), ugens.end(), more_ticks );
+    if( ugens.size() > top ) ugens.resize( top );
+    snprintf( line, sizeof(line), "  %-30s %10s %7s %11s %9s\n",
+              "ugen", "cpu ms", "cpu %", "computes", "shred" );
+    out += line;
+    for( i = 0; i < ugens.size(); i++ )
+    {
+        snprintf( line, sizeof(line), "%lu", ugens[i]->xid );
+        string name = ugens[i]->name + " #" + line + ( ugens[i]->done ? " (freed)" : "" );
+        snprintf( line, sizeof(line), "  %-30.30s %10.3f %7.2f %11lu %9lu\n",
+                  name.c_str(), seconds( ugens[i]->ticks ) * 1000,
+                  seconds( ugens[i]->ticks ) * percent, ugens[i]->count, ugens[i]->shred );
+        out += line;
+    }
+
+    m_mutex.release();
+
+    return out;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: Chuck_Deadline()
+// desc: ...
+//-----------------------------------------------------------------------------
+Chuck_Deadline::Chuck_Deadline()
+{
+    for( t_CKUINT i = 0; i < CK_DEADLINE_BINS; i++ ) m_bins[i] = 0;
+    m_blocks = m_near = m_over = 0;
+    m_max_load = 0;
+    m_seq = 0;
+    memset( m_recent, 0, sizeof(m_recent) );
+    m_in_block = FALSE;
+    m_start = 0;
+    m_when = 0;
+    m_shreds = m_msgs = 0;
+    m_shred_ticks = 0;
+    // measure the counter now, not in the callback
+    Chuck_Profiler::rate();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: begin()
+// desc: a VM run is starting, at VM time now
+//-----------------------------------------------------------------------------
+void Chuck_Deadline::begin( t_CKTIME now )
+{
+    m_when = now;
+    m_shreds = m_msgs = 0;
+    m_shred_ticks = 0;
+    for( t_CKUINT i = 0; i < CK_DEADLINE_SHREDS; i++ )
+    { m_top_xid[i] = 0; m_top_ticks[i] = 0; }
+    m_in_block = TRUE;
+    m_start = Chuck_Profiler::now();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: end()
+// desc: the VM run is done; its deadline was frames at srate
+//-----------------------------------------------------------------------------
+void Chuck_Deadline::end( t_CKUINT frames, t_CKUINT srate )
+{
+    t_CKTICKS ticks = Chuck_Profiler::now() - m_start;
+    m_in_block = FALSE;
+    if( !frames || !srate ) return;
+
+    t_CKFLOAT deadline = (t_CKFLOAT)frames / srate * Chuck_Profiler::rate();
+    t_CKFLOAT load = ticks / deadline;
+    t_CKUINT bin = (t_CKUINT)( load * 100 );
+    if( bin >= CK_DEADLINE_BINS ) bin = CK_DEADLINE_BINS - 1;
+
+    // one writer: plain increments, published by the stores
+    xatomic_store( &m_bins[bin], m_bins[bin] + 1 );
+    if( load > m_max_load ) m_max_load = load;
+    if( load >= CK_DEADLINE_NEAR && load < 1 ) xatomic_store( &m_near, m_near + 1 );
+
+    if( load >= 1 )
+    {
+        // write the record between odd and even counts
+        Deadline_Overrun & r = m_recent[m_over % CK_DEADLINE_OVERRUNS];
+        xatomic_store( &m_seq, m_seq + 1 );
+        // (a release store only orders what came before it: keep the
+        // record's stores from being seen ahead of the odd count)
+        xatomic_fence();
+        r.when = m_when;
+        r.load = load;
+        r.shreds = m_shreds;
+        r.msgs = m_msgs;
+        r.shreds_load = m_shred_ticks / deadline;
+        for( t_CKUINT i = 0; i < CK_DEADLINE_SHREDS; i++ )
+        {
+            r.xid[i] = m_top_xid[i];
+            r.xid_load[i] = m_top_ticks[i] / deadline;
+        }
+        xatomic_store( &m_seq, m_seq + 1 );
+        xatomic_store( &m_over, m_over + 1 );
+    }
+
+    xatomic_store( &m_blocks, m_blocks + 1 );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: shred_ran()
+// desc: a shred activation in the block took this many ticks; keeps the
+//       busiest few
+//-----------------------------------------------------------------------------
+void Chuck_Deadline::shred_ran( t_CKUINT xid, t_CKTICKS ticks )
+{
+    t_CKUINT i, j;
+
+    m_shreds++;
+    m_shred_ticks += ticks;
+
+    // the same shred again adds up
+    for( i = 0; i < CK_DEADLINE_SHREDS && m_top_xid[i] != xid; i++ );
+    if( i < CK_DEADLINE_SHREDS ) ticks += m_top_ticks[i];
+    else i = CK_DEADLINE_SHREDS - 1;
+    if( m_top_xid[i] != xid && ticks <= m_top_ticks[i] ) return;
+
+    // move up into place
+    for( j = i; j > 0 && m_top_ticks[j-1] < ticks; j-- )
+    { m_top_xid[j] = m_top_xid[j-1]; m_top_ticks[j] = m_top_ticks[j-1]; }
+    m_top_xid[j] = xid;
+    m_top_ticks[j] = ticks;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: percentile()
+// desc: the load at or under which p (0-1) of the blocks ran, to the 1%
+//       bin (and no more than the max load)
+//-----------------------------------------------------------------------------
+t_CKFLOAT Chuck_Deadline::percentile( t_CKFLOAT p ) const
+{
+    t_CKUINT bins[CK_DEADLINE_BINS], total = 0, sum = 0, i;
+
+    for( i = 0; i < CK_DEADLINE_BINS; i++ )
+        total += ( bins[i] = xatomic_load( &m_bins[i] ) );
+    if( !total ) return 0;
+
+    for( i = 0; i < CK_DEADLINE_BINS - 1; i++ )
+        if( ( sum += bins[i] ) >= p * total ) return std::min( ( i + 1 ) / 100.0, (t_CKFLOAT)m_max_load );
+
+    return m_max_load;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: recent()
+// desc: copy out up to max recent overruns, most recent first
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_Deadline::recent( Deadline_Overrun * out, t_CKUINT max ) const
+{
+    t_CKUINT seq, over, n;
+
+    // retry if the writer was in the middle of one
+    do
+    {
+        seq = xatomic_load( &m_seq );
+        over = xatomic_load( &m_over );
+        n = over < CK_DEADLINE_OVERRUNS ? over : CK_DEADLINE_OVERRUNS;
+        if( n > max ) n = max;
+        for( t_CKUINT i = 0; i < n; i++ )
+            out[i] = m_recent[( over - 1 - i ) % CK_DEADLINE_OVERRUNS];
+        xatomic_fence();
+    } while( ( seq & 1 ) || seq != xatomic_load( &m_seq ) );
+
+    return n;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: report()
+// desc: counts, percentiles and recent overruns, for status
+//-----------------------------------------------------------------------------
+string Chuck_Deadline::report( t_CKUINT srate ) const
+{
+    Deadline_Overrun recent[4];
+    char line[256];
+    string out;
+
+    snprintf( line, sizeof(line),
+              "[chuck](VM): deadline: %lu blocks, %lu near misses (>= %d%%), %lu overruns\n",
+              blocks(), near_misses(), (int)( CK_DEADLINE_NEAR * 100 ), overruns() );
+    out += line;
+    if( !blocks() ) return out;
+
+    snprintf( line, sizeof(line),
+              "    [load]: p50 %.0f%%  p90 %.0f%%  p99 %.0f%%  p99.9 %.0f%%  max %.0f%%\n",
+              percentile( .5 ) * 100, percentile( .9 ) * 100, percentile( .99 ) * 100,
+              percentile( .999 ) * 100, max_load() * 100 );
+    out += line;
+
+    t_CKUINT n = this->recent( recent, 4 );
+    for( t_CKUINT i = 0; i < n; i++ )
+    {
+        snprintf( line, sizeof(line), "    [overrun]: at %.3fs, %.0f%% (shreds %.0f%%), %lu activations, %lu msgs;",
+                  srate ? recent[i].when / srate : 0, recent[i].load * 100,
+                  recent[i].shreds_load * 100, recent[i].shreds, recent[i].msgs );
+        out += line;
+        for( t_CKUINT j = 0; j < CK_DEADLINE_SHREDS && recent[i].xid[j]; j++ )
+        {
+            snprintf( line, sizeof(line), " [%lu] %.0f%%", recent[i].xid[j], recent[i].xid_load[j] * 100 );
+            out += line;
+        }
+        out += "\n";
+    }
+
+    return out;
+}
+
+
+
 
 // tracking
 #if defined(__CHUCK_STAT_TRACK__)
 
-#include "chuck_vm.h"
-using namespace std;
-
 // static members
 Chuck_Stats * Chuck_Stats::our_instance = NULL;
 t_CKBOOL Chuck_Stats::activations_yes = FALSE;
@@ -36,20 +36,218 @@
 #define __CHUCK_STATS_H__
 
 #include "chuck_def.h"
+#include "util_thread.h"
+
+#include <string>
+#include <vector>
+
+
+// profiler ticks (cycle counter, where there is one)
+#define t_CKTICKS                   unsigned long long
+// per-sample ugen computes are timed one sample in this many (power of 2)
+#define CK_PROFILE_SAMPLE_PERIOD    64
+
+
+// forward reference
+struct Chuck_VM_Shred;
+struct Chuck_UGen;
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Profile_Entry
+// desc: time spent in one shred or one ugen, while profiling
+//-----------------------------------------------------------------------------
+struct Profile_Entry
+{
+    // shred id, or ugen instance number
+    t_CKUINT xid;
+    // shred name, or ugen type
+    std::string name;
+    // ugen: the shred it was made on (0: none)
+    t_CKUINT shred;
+    // ticks spent, over how many activations / computes
+    t_CKTICKS ticks;
+    t_CKUINT count;
+    // shred is done / ugen is freed
+    t_CKBOOL done;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Profiler
+// desc: always-available cpu profiler: times each shred activation and each
+//       ugen compute against a cycle counter, when turned on (--profile,
+//       Machine.profile()).  when off, the cost is a flag test per shred
+//       activation and per ugen compute; when on, per-sample computes are
+//       sampled (CK_PROFILE_SAMPLE_PERIOD).  shreds and ugens keep a pointer
+//       to their entry, so recording never searches; entries outlive them
+//       until reset().
+//-----------------------------------------------------------------------------
+struct Chuck_Profiler
+{
+public:
+    static Chuck_Profiler * instance();
+    // test before timing anything
+    static volatile t_CKBOOL our_on;
+    // read the counter, and its rate (measured once)
+    static t_CKTICKS now();
+    static t_CKFLOAT rate();
+    // ticks since start, less the cost of reading the counter
+    t_CKTICKS since( t_CKTICKS start );
+
+public:
+    // turn on/off; returns the previous state
+    t_CKBOOL enable( t_CKBOOL on );
+    // forget everything so far (entries still in use are zeroed)
+    void reset();
+
+public: // recording
+    void shred_ran( Chuck_VM_Shred * shred, t_CKTICKS ticks );
+    void shred_done( Chuck_VM_Shred * shred );
+    void ugen_ran( Chuck_UGen * ugen, t_CKTICKS ticks, t_CKUINT count = 1 );
+    void ugen_done( Chuck_UGen * ugen );
+
+public: // results
+    // ticks to seconds
+    t_CKFLOAT seconds( t_CKTICKS ticks );
+    // cpu seconds of a shred (latest with that id) / a ugen
+    t_CKFLOAT shred_seconds( t_CKUINT xid );
+    t_CKFLOAT ugen_seconds( Chuck_UGen * ugen );
+    // per shred, per ugen type, and the top ugen instances
+    std::string report( t_CKUINT top = 20 );
+
+protected:
+    Chuck_Profiler();
+    static Chuck_Profiler * our_instance;
+
+protected:
+    // every entry since the last reset, in order of first activation
+    std::vector<Profile_Entry *> m_shreds;
+    std::vector<Profile_Entry *> m_ugens;
+    // guards the entry lists (ugens may first run on a render thread)
+    XMutex m_mutex;
+    // ugen instance numbers
+    t_CKUINT m_ugen_count;
+    // wall clock time profiled, not counting now
+    t_CKFLOAT m_wall;
+    // when profiling was last turned on
+    t_CKFLOAT m_wall_start;
+    // ticks it takes to read the counter twice (measured on first enable)
+    t_CKTICKS m_overhead;
+};
+
+
+
+
+// load histogram bins, 1% of the deadline each; the last takes the rest
+#define CK_DEADLINE_BINS            256
+// a block taking at least this much of its deadline is a near miss
+#define CK_DEADLINE_NEAR            0.8
+// overruns remembered, most recent
+#define CK_DEADLINE_OVERRUNS        16
+// busiest shreds remembered per block
+#define CK_DEADLINE_SHREDS          3
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Deadline_Overrun
+// desc: a block that took longer than its deadline, and what ran in it
+//-----------------------------------------------------------------------------
+struct Deadline_Overrun
+{
+    // VM time at the start of the block (samples)
+    t_CKTIME when;
+    // time taken, as a fraction of the deadline
+    t_CKFLOAT load;
+    // shred activations and VM messages in the block
+    t_CKUINT shreds;
+    t_CKUINT msgs;
+    // of the load, the part spent running shreds (the rest: ugens, messages)
+    t_CKFLOAT shreds_load;
+    // busiest shreds (0: none) and their fraction of the deadline
+    t_CKUINT xid[CK_DEADLINE_SHREDS];
+    t_CKFLOAT xid_load[CK_DEADLINE_SHREDS];
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Deadline
+// desc: audio callback deadline monitor.  the callback brackets each VM run
+//       with begin() / end(); the VM reports shred activations and
+//       messages in between.  the time each block took against its
+//       deadline ( frames / srate ) goes into a load histogram; near
+//       misses and overruns are counted, and overruns kept with what ran
+//       in the block.  one writer (the audio thread); readers on any
+//       thread see counters updated with atomic stores, and overrun
+//       records through a sequence count.
+//-----------------------------------------------------------------------------
+struct Chuck_Deadline
+{
+public:
+    Chuck_Deadline();
+
+public: // audio thread
+    void begin( t_CKTIME now );
+    void end( t_CKUINT frames, t_CKUINT srate );
+    // whether a block is being timed (shred activations are worth timing)
+    t_CKBOOL in_block() const { return m_in_block; }
+    void shred_ran( t_CKUINT xid, t_CKTICKS ticks );
+    void msg_processed() { m_msgs++; }
+
+public: // any thread
+    t_CKUINT blocks() const { return xatomic_load( &m_blocks ); }
+    t_CKUINT near_misses() const { return xatomic_load( &m_near ); }
+    t_CKUINT overruns() const { return xatomic_load( &m_over ); }
+    // load (fraction of the deadline) at or under which p of the blocks ran
+    t_CKFLOAT percentile( t_CKFLOAT p ) const;
+    t_CKFLOAT max_load() const { return m_max_load; }
+    // recent overruns, most recent first; returns how many
+    t_CKUINT recent( Deadline_Overrun * out, t_CKUINT max ) const;
+    // counts, percentiles and recent overruns, for status
+    std::string report( t_CKUINT srate ) const;
+
+protected:
+    // the histogram and counts
+    volatile t_CKUINT m_bins[CK_DEADLINE_BINS];
+    volatile t_CKUINT m_blocks;
+    volatile t_CKUINT m_near;
+    volatile t_CKUINT m_over;
+    volatile t_CKFLOAT m_max_load;
+    // the last overruns, by m_over; m_seq is odd while one is written
+    Deadline_Overrun m_recent[CK_DEADLINE_OVERRUNS];
+    volatile t_CKUINT m_seq;
+
+protected: // the block being timed
+    t_CKBOOL m_in_block;
+    t_CKTICKS m_start;
+    t_CKTIME m_when;
+    t_CKUINT m_shreds;
+    t_CKUINT m_msgs;
+    t_CKTICKS m_shred_ticks;
+    t_CKUINT m_top_xid[CK_DEADLINE_SHREDS];
+    t_CKTICKS m_top_ticks[CK_DEADLINE_SHREDS];
+};
+
+
+
 
 // tracking
 #if defined(__CHUCK_STAT_TRACK__)
 
-#include "util_thread.h"
-
-#include <string>
 #include <map>
 #include <queue>
 
 
 // forward reference
 struct Chuck_VM;
-struct Chuck_VM_Shred;
 struct Shred_Data;
 struct Shred_Time;
 
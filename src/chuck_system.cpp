@@ -59,6 +59,8 @@
 #include "util_network.h"
 #include "ulib_machine.h"
 #include "hidio_sdl.h"
+#include "ugen_stk.h"
+#include "ugen_xxx.h"
 
 #include "chuck_system.h"
 
@@ -69,8 +71,10 @@
   #include <netinet/in.h>
   #include <arpa/inet.h>
   #include <sys/param.h>   // added 1.3.0.0
+  #include <sys/time.h>
 #else
   #include <direct.h>      // added 1.3.0.0
+  #include <sys/timeb.h>
   #define MAXPATHLEN (255) // addec 1.3.0.0
 #endif // #ifndef __PLATFORM_WIN32__
 
@@ -94,6 +98,9 @@ CHUCK_THREAD g_tid_shell = 0;
 // default destination host name
 char g_host[256] = "127.0.0.1";
 
+// offline render target (--render)
+static WvOut * g_render_out = NULL;
+
 
 
 //-----------------------------------------------------------------------------
@@ -117,11 +124,15 @@ extern "C" void signal_int( int sig_num )
         {
             // stop VM
             vm->stop();
+            // finish the render file (before the writer is shut down)
+            if( g_render_out ) g_render_out->closeFile();
             // stop (was VM::stop())
             all_stop();
             // detach
             all_detach();
         }
+        // stop compiling into the vm (releasing the otf thread, if waiting)
+        if( compiler ) compiler->stop_worker();
 
         // things don't work so good on windows...
 #if !defined(__PLATFORM_WIN32__) || defined(__WINDOWS_PTHREAD__)
@@ -150,6 +161,26 @@ extern "C" void signal_int( int sig_num )
 
 
 
+//-----------------------------------------------------------------------------
+// name: render_clock()
+// desc: wall clock, in seconds
+//-----------------------------------------------------------------------------
+static t_CKFLOAT render_clock()
+{
+#ifdef __PLATFORM_WIN32__
+    struct _timeb t;
+    _ftime(&t);
+    return t.time + t.millitm/1000.0;
+#else
+    struct timeval t;
+    gettimeofday(&t,NULL);
+    return t.tv_sec + (t_CKFLOAT)t.tv_usec/1000000;
+#endif
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: uh()
 // desc: ...
@@ -270,11 +301,16 @@ static void usage()
 {
     // (note: optional colon added 1.3.0.0)
     fprintf( stderr, "usage: chuck --[options|commands] [+-=^] file1 file2 file3 ...\n" );
-    fprintf( stderr, "   [options] = halt|loop|audio|silent|dump|nodump|server|about|probe|\n" );
+    fprintf( stderr, "   [options] = halt|loop|audio|silent|dump|nodump|optimize|nooptimize|\n" );
+    fprintf( stderr, "               server|about|probe|\n" );
     fprintf( stderr, "               channels:<N>|out:<N>|in:<N>|dac:<N>|adc:<N>|\n" );
     fprintf( stderr, "               srate:<N>|bufsize:<N>|bufnum:<N>|shell|empty|\n" );
     fprintf( stderr, "               remote:<hostname>|port:<N>|verbose:<N>|level:<N>|\n" );
-    fprintf( stderr, "               callback|deprecate:{stop|warn|ignore}|\n" );
+    fprintf( stderr, "               callback|deprecate:{stop|warn|ignore}|shred-pool:<N>|\n" );
+    fprintf( stderr, "               render-threads:<N>|uana-threads:<N>|\n" );
+    fprintf( stderr, "               render:<file>|duration:<secs>|\n" );
+    fprintf( stderr, "               render-format:{int16|float32|float64}|\n" );
+    fprintf( stderr, "               dispatch:{threaded|virtual}|profile|\n" );
     fprintf( stderr, "               chugin-load:{auto|off}|chugin-path:<path>|chugin:<name>\n" );
     fprintf( stderr, "   [commands] = add|remove|replace|remove.all|status|time|kill\n" );
     fprintf( stderr, "   [+-=^] = shortcuts for add, remove, replace, status\n" );
@@ -415,7 +451,10 @@ bool Chuck_System::compileCode( const std::string & code, const std::string & ar
 //-----------------------------------------------------------------------------
 void Chuck_System::run( SAMPLE * input, SAMPLE * output, int numFrames )
 {
+    // timed against the real-time deadline, as in the audio callback
+    m_vmRef->deadline().begin( m_vmRef->shreduler()->now_system );
     m_vmRef->run( numFrames, input, output );
+    m_vmRef->deadline().end( numFrames, m_vmRef->srate() );
 }
 
 
@@ -492,9 +531,17 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
     t_CKBOOL enable_server = TRUE;
     t_CKBOOL do_watchdog = TRUE;
     t_CKINT  adaptive_size = 0;
+    t_CKINT  shred_pool_size = CVM_SHRED_POOL_SIZE;
+    t_CKINT  render_threads = 1;
+    t_CKINT  uana_threads = 1;
     t_CKINT  log_level = CK_LOG_CORE;
     t_CKINT  deprecate_level = 1; // 1 == warn
     t_CKINT  chugin_load = 1; // 1 == auto (variable added 1.3.0.0)
+    string   render_file = "";
+    t_CKUINT render_format = Stk::STK_SINT16;
+    t_CKFLOAT duration = 0;
+    t_CKBOOL threaded_dispatch = TRUE;
+    t_CKBOOL profile = FALSE;
     string   filename = "";
     vector<string> args;
 
@@ -547,6 +594,8 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
             if( !strcmp(argv[i], "--dump") || !strcmp(argv[i], "+d")
                 || !strcmp(argv[i], "--nodump") || !strcmp(argv[i], "-d") )
                 continue;
+            else if( !strcmp(argv[i], "--optimize") || !strcmp(argv[i], "--nooptimize") )
+                continue;
             else if( get_count( argv[i], &count ) )
                 continue;
             else if( !strcmp(argv[i], "--audio") || !strcmp(argv[i], "-a") )
@@ -708,6 +757,48 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
                 adaptive_size = argv[i][11] ? atoi( argv[i]+11 ) : -1;
             else if( !strncmp(argv[i], "--adaptive", 10) )
                 adaptive_size = argv[i][10] ? atoi( argv[i]+10 ) : -1;
+            else if( !strncmp(argv[i], "--shred-pool:", 13) )
+                shred_pool_size = atoi( argv[i]+13 ) >= 0 ? atoi( argv[i]+13 ) : shred_pool_size;
+            else if( !strncmp(argv[i], "--render-threads:", 17) )
+                render_threads = atoi( argv[i]+17 ) > 0 ? atoi( argv[i]+17 ) : render_threads;
+            else if( !strncmp(argv[i], "--uana-threads:", 15) )
+                uana_threads = atoi( argv[i]+15 ) > 0 ? atoi( argv[i]+15 ) : uana_threads;
+            else if( !strncmp(argv[i], "--render-format:", 16) )
+            {
+                // get the rest
+                string arg = argv[i]+16;
+                if( arg == "int16" ) render_format = Stk::STK_SINT16;
+                else if( arg == "float32" ) render_format = Stk::MY_FLOAT32;
+                else if( arg == "float64" ) render_format = Stk::MY_FLOAT64;
+                else
+                {
+                    // error
+                    fprintf( stderr, "[chuck]: invalid arguments for '--render-format'...\n" );
+                    fprintf( stderr, "[chuck]: ... (looking for :int16, :float32, or :float64)\n" );
+                    exit( 1 );
+                }
+            }
+            // offline: no audio device, no otf listener, dac to file
+            else if( !strncmp(argv[i], "--render:", 9) && argv[i][9] )
+            {   render_file = argv[i]+9; g_enable_realtime_audio = FALSE; enable_server = FALSE; }
+            else if( !strncmp(argv[i], "--dispatch:", 11) )
+            {
+                // get the rest
+                string arg = argv[i]+11;
+                if( arg == "threaded" ) threaded_dispatch = TRUE;
+                else if( arg == "virtual" ) threaded_dispatch = FALSE;
+                else
+                {
+                    // error
+                    fprintf( stderr, "[chuck]: invalid arguments for '--dispatch'...\n" );
+                    fprintf( stderr, "[chuck]: ... (looking for :threaded or :virtual)\n" );
+                    exit( 1 );
+                }
+            }
+            else if( !strcmp(argv[i], "--profile") )
+                profile = TRUE;
+            else if( !strncmp(argv[i], "--duration:", 11) )
+                duration = atof( argv[i]+11 ) > 0 ? atof( argv[i]+11 ) : duration;
             else if( !strncmp(argv[i], "--deprecate", 11) )
             {
                 // get the rest
@@ -839,6 +930,8 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
     Chuck_VM::our_priority = g_priority;
     // set watchdog
     g_do_watchdog = do_watchdog;
+    // render threads work per block; default to adaptive blocks
+    if( render_threads > 1 && adaptive_size == 0 ) adaptive_size = -1;
     // set adaptive size
     if( adaptive_size < 0 ) adaptive_size = buffer_size;
 
@@ -857,6 +950,13 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
         exit( 1 );
     }
 
+    // a render has to end
+    if( render_file != "" && !vm_halt && duration <= 0 )
+    {
+        fprintf( stderr, "[chuck]: '--render' without '--halt' needs '--duration'...\n" );
+        exit( 1 );
+    }
+
     // shell initialization without vm
     if( g_enable_shell && no_vm )
     {
@@ -920,11 +1020,14 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
     // allocate the vm - needs the type system
     vm = m_vmRef = g_vm = new Chuck_VM;
     // ge: refactor 2015: initialize VM
-    if( !vm->initialize( srate, dac_chans, adc_chans, adaptive_size, vm_halt ) )
+    if( !vm->initialize( srate, dac_chans, adc_chans, adaptive_size, vm_halt,
+                         shred_pool_size, render_threads, uana_threads ) )
     {
         fprintf( stderr, "[chuck]: %s\n", vm->last_error() );
         exit( 1 );
     }
+    // interpreter
+    vm->m_threaded = threaded_dispatch;
 
     
 //--------------------------- AUDIO I/O SETUP ---------------------------------
@@ -1117,6 +1220,10 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
                 compiler->emitter->dump = TRUE;
             else if( !strcmp(argv[i], "--nodump") || !strcmp(argv[i], "-d" ) )
                 compiler->emitter->dump = FALSE;
+            else if( !strcmp(argv[i], "--optimize") )
+                compiler->emitter->optimize = TRUE;
+            else if( !strcmp(argv[i], "--nooptimize") )
+                compiler->emitter->optimize = FALSE;
             else
                 get_count( argv[i], &count );
 
@@ -1136,6 +1243,10 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
     // reset the parser
     reset_parse();
 
+    // from here on, compile Machine.add/replace and otf requests off the
+    // audio thread (before boosting priority, which the thread would inherit)
+    compiler->start_worker( vm );
+
     // boost priority
     if( Chuck_VM::our_priority != 0x7fffffff )
     {
@@ -1237,6 +1348,9 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
         return TRUE;
     }
     
+    // cpu profile, reported at the end (--profile)
+    if( profile ) Chuck_Profiler::instance()->enable( TRUE );
+
     // start audio
     if( !audio_started )
     {
@@ -1260,6 +1374,39 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
     memset( input, 0, sizeof(SAMPLE)*buffer_size*adc_chans );
     memset( output, 0, sizeof(SAMPLE)*buffer_size*dac_chans );
 
+    // offline render: the dac, through the WvOut file writer
+    MY_FLOAT * render_buffer = NULL;
+    if( render_file != "" )
+    {
+        // file type from the extension (default WAV)
+        WvOut::FILE_TYPE type = WvOut::WVOUT_WAV;
+        std::string ext = tolower( render_file );
+        if( str_endsin( ext.c_str(), ".aif" ) || str_endsin( ext.c_str(), ".aiff" ) ) type = WvOut::WVOUT_AIF;
+        else if( str_endsin( ext.c_str(), ".snd" ) || str_endsin( ext.c_str(), ".au" ) ) type = WvOut::WVOUT_SND;
+        else if( str_endsin( ext.c_str(), ".mat" ) ) type = WvOut::WVOUT_MAT;
+        else if( str_endsin( ext.c_str(), ".raw" ) ) type = WvOut::WVOUT_RAW;
+
+        // open
+        g_render_out = new WvOut;
+        try { g_render_out->openFile( render_file.c_str(), dac_chans, type, render_format ); }
+        catch( StkError & e )
+        {
+            fprintf( stderr, "[chuck]: cannot render to '%s'...\n", render_file.c_str() );
+            exit( 1 );
+        }
+        // offline, so wait for the writer rather than drop data
+        WvOut::s_writeThread->set_blocking( TRUE );
+        // conversion buffer
+        render_buffer = new MY_FLOAT[buffer_size*dac_chans];
+        // log
+        EM_log( CK_LOG_SYSTEM, "rendering to '%s'...", render_file.c_str() );
+    }
+
+    // --duration, in samples (0: until the VM halts)
+    t_CKUINT duration_frames = (t_CKUINT)(duration * srate + .5);
+    t_CKUINT rendered = 0;
+    t_CKFLOAT render_start = render_clock();
+
     // wait
     while( vm->running() )
     {
@@ -1273,10 +1420,48 @@ bool Chuck_System::go( int argc, const char ** argv, t_CKBOOL clientMode )
         }
         else // silent mode
         {
+            t_CKTIME before = vm->shreduler()->now_system;
             // keep running as fast as possible
             this->run( input, output, buffer_size );
+            // frames actually computed (less, if the VM halted)
+            t_CKUINT frames = (t_CKUINT)(vm->shreduler()->now_system - before);
+
+            // stop at --duration
+            if( duration_frames && rendered + frames >= duration_frames )
+            {
+                frames = duration_frames - rendered;
+                vm->stop();
+            }
+
+            // capture
+            if( g_render_out )
+            {
+                for( t_CKUINT j = 0; j < frames*dac_chans; j++ )
+                    render_buffer[j] = output[j];
+                g_render_out->tickFrame( render_buffer, frames );
+            }
+
+            rendered += frames;
         }
     }
+
+    // finish the render
+    if( g_render_out )
+    {
+        // close (header is written on close)
+        g_render_out->closeFile();
+        SAFE_DELETE( g_render_out );
+        SAFE_DELETE_ARRAY( render_buffer );
+
+        // report
+        t_CKFLOAT seconds = (t_CKFLOAT)rendered / srate;
+        t_CKFLOAT elapsed = render_clock() - render_start;
+        fprintf( stderr, "[chuck]: rendered %.3f seconds to '%s' in %.3f seconds (%.1fx realtime)\n",
+                 seconds, render_file.c_str(), elapsed, elapsed > 0 ? seconds / elapsed : 0 );
+    }
+
+    // report the profile
+    if( profile ) fprintf( stderr, "%s", Chuck_Profiler::instance()->report().c_str() );
     
     // shutdown
     clientShutdown();
@@ -1318,8 +1503,12 @@ bool Chuck_System::clientShutdown()
         g_main_thread_quit( g_main_thread_bindle );
     clear_main_thread_hook();
     
+    // stop compiling into the vm
+    if( g_compiler ) g_compiler->stop_worker();
     // free vm
     SAFE_DELETE( g_vm ); m_vmRef = NULL;
+    // stop streaming sound files (after the vm has let go of them)
+    xxx_shutdown();
     // free the compiler
     SAFE_DELETE( g_compiler ); m_compilerRef = NULL;
     
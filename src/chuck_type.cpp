@@ -38,6 +38,7 @@
 #include "chuck_lang.h"
 #include "util_string.h"
 #include "ugen_xxx.h"
+#include <math.h>
 
 using namespace std;
 
@@ -617,6 +618,602 @@ done:
 
 
 
+//-----------------------------------------------------------------------------
+// name: struct Chuck_Fold_Stats
+// desc: what the folding pass did to a context
+//-----------------------------------------------------------------------------
+struct Chuck_Fold_Stats
+{
+    t_CKUINT folded;
+    t_CKUINT pruned;
+
+    Chuck_Fold_Stats() : folded( 0 ), pruned( 0 ) { }
+};
+
+static void type_engine_fold_stmt_list( Chuck_Env * env, a_Stmt_List list, Chuck_Fold_Stats & stats );
+static void type_engine_fold_stmt( Chuck_Env * env, a_Stmt stmt, Chuck_Fold_Stats & stats );
+static void type_engine_fold_exp( Chuck_Env * env, a_Exp exp, Chuck_Fold_Stats & stats );
+static void type_engine_fold_func_def( Chuck_Env * env, a_Func_Def func_def, Chuck_Fold_Stats & stats );
+static void type_engine_fold_class_def( Chuck_Env * env, a_Class_Def class_def, Chuck_Fold_Stats & stats );
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_context()
+// desc: constant folding on the type-checked parse tree, before it is
+//       emitted: int/float/dur/time arithmetic and comparisons on literals,
+//       built-in constants (pi, second, Math.PI...) and pure Math functions
+//       of constant arguments become literals, and statements behind
+//       conditions that fold to a constant are dropped
+//-----------------------------------------------------------------------------
+t_CKBOOL type_engine_fold_context( Chuck_Env * env,
+                                   Chuck_Context * context,
+                                   te_HowMuch how_much )
+{
+    a_Program prog = context->parse_tree;
+    Chuck_Fold_Stats stats;
+
+    // log
+    EM_log( CK_LOG_FINER, "folding constants in context '%s'...",
+        context->filename.c_str() );
+
+    // go through each of the program sections
+    while( prog )
+    {
+        switch( prog->section->s_type )
+        {
+        case ae_section_stmt:
+            // if only classes, then skip
+            if( how_much == te_do_classes_only ) break;
+            type_engine_fold_stmt_list( env, prog->section->stmt_list, stats );
+            break;
+
+        case ae_section_func:
+            // if only classes, then skip
+            if( how_much == te_do_classes_only ) break;
+            type_engine_fold_func_def( env, prog->section->func_def, stats );
+            break;
+
+        case ae_section_class:
+            // if no classes, then skip
+            if( how_much == te_do_no_classes ) break;
+            type_engine_fold_class_def( env, prog->section->class_def, stats );
+            break;
+
+        default: break;
+        }
+
+        prog = prog->next;
+    }
+
+    // log
+    EM_log( CK_LOG_FINE, "folded %lu expressions, pruned %lu statements in '%s'",
+        stats.folded, stats.pruned, context->filename.c_str() );
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_kind()
+// desc: 1 for int, 2 for float, dur and time (double on the stack), else 0
+//-----------------------------------------------------------------------------
+static t_CKUINT type_engine_fold_kind( Chuck_Type * type )
+{
+    if( !type ) return 0;
+    if( equals( type, &t_int ) ) return 1;
+    if( equals( type, &t_float ) || equals( type, &t_dur ) ||
+        equals( type, &t_time ) ) return 2;
+    return 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_value()
+// desc: value of a literal int or float, after its implicit cast (if any)
+//-----------------------------------------------------------------------------
+static t_CKBOOL type_engine_fold_value( a_Exp exp, t_CKBOOL * is_float,
+                                        t_CKINT * i, t_CKFLOAT * f )
+{
+    if( exp->s_type != ae_exp_primary ) return FALSE;
+
+    if( exp->primary.s_type == ae_primary_num )
+    { *is_float = FALSE; *i = exp->primary.num; *f = 0; }
+    else if( exp->primary.s_type == ae_primary_float )
+    { *is_float = TRUE; *f = exp->primary.fnum; *i = 0; }
+    else return FALSE;
+
+    // implicit cast: only int to float
+    if( exp->cast_to )
+    {
+        if( *is_float || !equals( exp->cast_to, &t_float ) ) return FALSE;
+        *is_float = TRUE; *f = (t_CKFLOAT)*i;
+    }
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_cond()
+// desc: whether a condition is a folded constant, and if so its truth
+//-----------------------------------------------------------------------------
+t_CKBOOL type_engine_fold_cond( a_Exp cond, t_CKBOOL * truth )
+{
+    t_CKBOOL is_float; t_CKINT i; t_CKFLOAT f;
+
+    if( !cond || cond->next || !type_engine_fold_value( cond, &is_float, &i, &f ) )
+        return FALSE;
+
+    *truth = is_float ? f != 0 : i != 0;
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_to()
+// desc: turn exp into a literal, if the value fits its type
+//-----------------------------------------------------------------------------
+static void type_engine_fold_to( a_Exp exp, t_CKBOOL is_float, t_CKINT i,
+                                 t_CKFLOAT f, Chuck_Fold_Stats & stats )
+{
+    // int for int, double for float/dur/time; not the target of an assignment
+    if( type_engine_fold_kind( exp->type ) != ( is_float ? 2 : 1 ) || exp->emit_var ) return;
+
+    // (the union: operands are gone from here on)
+    exp->s_type = ae_exp_primary;
+    exp->s_meta = ae_meta_value;
+    exp->primary.s_type = is_float ? ae_primary_float : ae_primary_num;
+    if( is_float ) exp->primary.fnum = f;
+    else exp->primary.num = i;
+    exp->primary.value = NULL;
+    exp->primary.linepos = exp->linepos;
+    exp->primary.self = exp;
+
+    stats.folded++;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_binary()
+// desc: int or double arithmetic, comparison, and && || on literals; int
+//       division by zero is left for the VM to report
+//-----------------------------------------------------------------------------
+static void type_engine_fold_binary( a_Exp exp, Chuck_Fold_Stats & stats )
+{
+    a_Exp_Binary binary = &exp->binary;
+    t_CKBOOL lf, rf, lhs, rhs;
+    t_CKINT li, ri;
+    t_CKFLOAT lv, rv;
+    // ints wrap
+    t_CKUINT lu, ru;
+
+    lhs = type_engine_fold_value( binary->lhs, &lf, &li, &lv );
+    rhs = type_engine_fold_value( binary->rhs, &rf, &ri, &rv );
+
+    // && and || can be decided by the left side alone
+    if( lhs && !lf && ( binary->op == ae_op_and || binary->op == ae_op_or ) )
+    {
+        if( binary->op == ae_op_and && !li )
+            type_engine_fold_to( exp, FALSE, 0, 0, stats );
+        else if( binary->op == ae_op_or && li )
+            type_engine_fold_to( exp, FALSE, 1, 0, stats );
+        // otherwise the result is the right side
+        else if( rhs && !rf )
+            type_engine_fold_to( exp, FALSE, ri, 0, stats );
+        return;
+    }
+
+    if( !lhs || !rhs || lf != rf ) return;
+
+    // int
+    if( !lf )
+    {
+        lu = (t_CKUINT)li; ru = (t_CKUINT)ri;
+        switch( binary->op )
+        {
+        case ae_op_plus: li = (t_CKINT)( lu + ru ); break;
+        case ae_op_minus: li = (t_CKINT)( lu - ru ); break;
+        case ae_op_times: li = (t_CKINT)( lu * ru ); break;
+        case ae_op_divide: if( ri == 0 || ri == -1 ) return; li = li / ri; break;
+        case ae_op_percent: if( ri == 0 || ri == -1 ) return; li = li % ri; break;
+        case ae_op_shift_left: if( ru >= sizeof(t_CKUINT) * 8 ) return; li = (t_CKINT)( lu << ru ); break;
+        case ae_op_shift_right: if( ru >= sizeof(t_CKUINT) * 8 ) return; li = (t_CKINT)( lu >> ru ); break;
+        case ae_op_s_and: li = (t_CKINT)( lu & ru ); break;
+        case ae_op_s_or: li = (t_CKINT)( lu | ru ); break;
+        case ae_op_s_xor: li = (t_CKINT)( lu ^ ru ); break;
+        case ae_op_lt: li = li < ri; break;
+        case ae_op_le: li = li <= ri; break;
+        case ae_op_gt: li = li > ri; break;
+        case ae_op_ge: li = li >= ri; break;
+        case ae_op_eq: li = li == ri; break;
+        case ae_op_neq: li = li != ri; break;
+        default: return;
+        }
+
+        type_engine_fold_to( exp, FALSE, li, 0, stats );
+        return;
+    }
+
+    // float, dur, time
+    switch( binary->op )
+    {
+    case ae_op_plus: lv = lv + rv; break;
+    case ae_op_minus: lv = lv - rv; break;
+    case ae_op_times: lv = lv * rv; break;
+    case ae_op_divide: lv = lv / rv; break;
+    case ae_op_percent: lv = ::fmod( lv, rv ); break;
+    // comparisons are int
+    case ae_op_lt: type_engine_fold_to( exp, FALSE, lv < rv, 0, stats ); return;
+    case ae_op_le: type_engine_fold_to( exp, FALSE, lv <= rv, 0, stats ); return;
+    case ae_op_gt: type_engine_fold_to( exp, FALSE, lv > rv, 0, stats ); return;
+    case ae_op_ge: type_engine_fold_to( exp, FALSE, lv >= rv, 0, stats ); return;
+    case ae_op_eq: type_engine_fold_to( exp, FALSE, lv == rv, 0, stats ); return;
+    case ae_op_neq: type_engine_fold_to( exp, FALSE, lv != rv, 0, stats ); return;
+    default: return;
+    }
+
+    type_engine_fold_to( exp, TRUE, 0, lv, stats );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_math()
+// desc: call a pure Math function on literal arguments now instead of at
+//       run time; random and complex/polar functions are left alone
+//-----------------------------------------------------------------------------
+static void type_engine_fold_math( a_Exp exp, Chuck_Fold_Stats & stats )
+{
+    static const char * pure[] = { "abs", "fabs", "sgn", "sin", "cos", "tan",
+        "asin", "acos", "atan", "atan2", "sinh", "cosh", "tanh", "hypot", "pow",
+        "sqrt", "exp", "log", "log2", "log10", "floor", "ceil", "round", "trunc",
+        "fmod", "remainder", "min", "max", "isinf", "isnan", "nextpow2",
+        "ensurePow2", "mtof", "ftom", "powtodb", "rmstodb", "dbtopow", "dbtorms",
+        "gauss" };
+    Chuck_Func * func = exp->func_call.ck_func;
+    t_CKBYTE args[8 * sz_FLOAT];
+    t_CKUINT offset = 0, n;
+    Chuck_DL_Return retval;
+    t_CKBOOL is_float; t_CKINT i; t_CKFLOAT f;
+
+    // static, imported, in Math
+    if( !func || func->is_member || !func->def || func->def->s_type != ae_func_builtin ||
+        !func->code || !func->code->native_func || func->code->need_this ) return;
+    if( !func->value_ref || !func->value_ref->owner_class ||
+        func->value_ref->owner_class->name != "Math" ) return;
+    for( n = 0; n < sizeof(pure) / sizeof(pure[0]); n++ )
+        if( !strcmp( S_name(func->def->name), pure[n] ) ) break;
+    if( n == sizeof(pure) / sizeof(pure[0]) ) return;
+
+    // arguments, laid out as on the VM stack
+    a_Arg_List formal = func->def->arg_list;
+    a_Exp arg = exp->func_call.args;
+    for( ; formal && arg; formal = formal->next, arg = arg->next )
+    {
+        if( !type_engine_fold_value( arg, &is_float, &i, &f ) ) return;
+        if( offset + sz_FLOAT > sizeof(args) ) return;
+
+        if( formal->type && equals( formal->type, &t_int ) && !is_float )
+        { memcpy( args + offset, &i, sz_INT ); offset += sz_INT; }
+        else if( formal->type && equals( formal->type, &t_float ) )
+        {
+            if( !is_float ) f = (t_CKFLOAT)i;
+            memcpy( args + offset, &f, sz_FLOAT ); offset += sz_FLOAT;
+        }
+        else return;
+    }
+    if( formal || arg ) return;
+
+    // call it
+    ((f_sfun)func->code->native_func)( args, &retval, NULL, Chuck_DL_Api::Api::instance() );
+
+    if( equals( func->def->ret_type, &t_int ) )
+        type_engine_fold_to( exp, FALSE, retval.v_int, 0, stats );
+    else if( equals( func->def->ret_type, &t_float ) )
+        type_engine_fold_to( exp, TRUE, 0, retval.v_float, stats );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_const()
+// desc: value of a built-in global (true, pi, second...) or static class
+//       constant (Math.PI...) with an address
+//-----------------------------------------------------------------------------
+static void type_engine_fold_const( a_Exp exp, Chuck_Value * value,
+                                    Chuck_Fold_Stats & stats )
+{
+    if( !value || !value->is_const || !value->addr || value->is_member ) return;
+
+    switch( type_engine_fold_kind( value->type ) )
+    {
+    case 1: type_engine_fold_to( exp, FALSE, *(t_CKINT *)value->addr, 0, stats ); break;
+    case 2: type_engine_fold_to( exp, TRUE, 0, *(t_CKFLOAT *)value->addr, stats ); break;
+    default: break;
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_exp()
+// desc: fold operands first, then the expression itself
+//-----------------------------------------------------------------------------
+static void type_engine_fold_exp( Chuck_Env * env, a_Exp exp, Chuck_Fold_Stats & stats )
+{
+    t_CKBOOL is_float; t_CKINT i; t_CKFLOAT f;
+    t_CKBOOL truth;
+    Chuck_Type * t_base;
+    Chuck_Value * value;
+    a_Var_Decl_List list;
+
+    for( ; exp; exp = exp->next )
+    {
+        switch( exp->s_type )
+        {
+        case ae_exp_binary:
+            type_engine_fold_exp( env, exp->binary.lhs, stats );
+            type_engine_fold_exp( env, exp->binary.rhs, stats );
+            type_engine_fold_binary( exp, stats );
+            break;
+
+        case ae_exp_unary:
+            if( exp->unary.code ) type_engine_fold_stmt( env, exp->unary.code, stats );
+            if( exp->unary.array ) type_engine_fold_exp( env, exp->unary.array->exp_list, stats );
+            if( !exp->unary.exp ) break;
+            type_engine_fold_exp( env, exp->unary.exp, stats );
+            // same types as the emitter handles
+            if( !type_engine_fold_value( exp->unary.exp, &is_float, &i, &f ) ) break;
+            if( exp->unary.op == ae_op_minus && equals( exp->unary.exp->type, &t_int ) )
+                type_engine_fold_to( exp, FALSE, (t_CKINT)( 0 - (t_CKUINT)i ), 0, stats );
+            else if( exp->unary.op == ae_op_minus && equals( exp->unary.exp->type, &t_float ) )
+                type_engine_fold_to( exp, TRUE, 0, -f, stats );
+            else if( exp->unary.op == ae_op_tilda && !is_float )
+                type_engine_fold_to( exp, FALSE, ~i, 0, stats );
+            else if( exp->unary.op == ae_op_exclamation && !is_float )
+                type_engine_fold_to( exp, FALSE, !i, 0, stats );
+            break;
+
+        case ae_exp_cast:
+            type_engine_fold_exp( env, exp->cast.exp, stats );
+            if( !type_engine_fold_value( exp->cast.exp, &is_float, &i, &f ) ) break;
+            if( equals( exp->type, &t_int ) )
+                type_engine_fold_to( exp, FALSE, is_float ? (t_CKINT)f : i, 0, stats );
+            else if( equals( exp->type, &t_float ) )
+                type_engine_fold_to( exp, TRUE, 0, is_float ? f : (t_CKFLOAT)i, stats );
+            break;
+
+        case ae_exp_postfix:
+            type_engine_fold_exp( env, exp->postfix.exp, stats );
+            break;
+
+        case ae_exp_dur:
+        {
+            t_CKBOOL ufloat; t_CKINT ui; t_CKFLOAT uf;
+            type_engine_fold_exp( env, exp->dur.base, stats );
+            type_engine_fold_exp( env, exp->dur.unit, stats );
+            if( !type_engine_fold_value( exp->dur.base, &is_float, &i, &f ) ||
+                !type_engine_fold_value( exp->dur.unit, &ufloat, &ui, &uf ) || !ufloat )
+                break;
+            type_engine_fold_to( exp, TRUE, 0, ( is_float ? f : (t_CKFLOAT)i ) * uf, stats );
+            break;
+        }
+
+        case ae_exp_primary:
+            switch( exp->primary.s_type )
+            {
+            case ae_primary_var:
+                // built-in globals only
+                value = exp->primary.value;
+                if( value && env->global()->lookup_value( exp->primary.var, FALSE ) == value )
+                    type_engine_fold_const( exp, value, stats );
+                break;
+            case ae_primary_exp:
+            case ae_primary_hack:
+                type_engine_fold_exp( env, exp->primary.exp, stats );
+                // ( literal )
+                if( exp->primary.s_type == ae_primary_exp && !exp->primary.exp->next &&
+                    type_engine_fold_value( exp->primary.exp, &is_float, &i, &f ) )
+                    type_engine_fold_to( exp, is_float, i, f, stats );
+                break;
+            case ae_primary_array:
+                type_engine_fold_exp( env, exp->primary.array->exp_list, stats );
+                break;
+            case ae_primary_complex:
+                type_engine_fold_exp( env, exp->primary.complex->re, stats );
+                break;
+            case ae_primary_polar:
+                type_engine_fold_exp( env, exp->primary.polar->mod, stats );
+                break;
+            case ae_primary_vec:
+                type_engine_fold_exp( env, exp->primary.vec->args, stats );
+                break;
+            default: break;
+            }
+            break;
+
+        case ae_exp_array:
+            type_engine_fold_exp( env, exp->array.base, stats );
+            type_engine_fold_exp( env, exp->array.indices->exp_list, stats );
+            break;
+
+        case ae_exp_func_call:
+            type_engine_fold_exp( env, exp->func_call.func, stats );
+            type_engine_fold_exp( env, exp->func_call.args, stats );
+            type_engine_fold_math( exp, stats );
+            break;
+
+        case ae_exp_dot_member:
+            type_engine_fold_exp( env, exp->dot_member.base, stats );
+            // static constant, e.g. Math.PI
+            if( isa( exp->dot_member.t_base, &t_class ) && !isfunc( exp->type ) )
+            {
+                t_base = exp->dot_member.t_base->actual_type;
+                if( t_base && t_base->info )
+                    type_engine_fold_const( exp,
+                        t_base->info->lookup_value( exp->dot_member.xid, FALSE ), stats );
+            }
+            break;
+
+        case ae_exp_if:
+            type_engine_fold_exp( env, exp->exp_if.cond, stats );
+            type_engine_fold_exp( env, exp->exp_if.if_exp, stats );
+            type_engine_fold_exp( env, exp->exp_if.else_exp, stats );
+            if( type_engine_fold_cond( exp->exp_if.cond, &truth ) &&
+                type_engine_fold_value( truth ? exp->exp_if.if_exp : exp->exp_if.else_exp,
+                                        &is_float, &i, &f ) )
+                type_engine_fold_to( exp, is_float, i, f, stats );
+            break;
+
+        case ae_exp_decl:
+            for( list = exp->decl.var_decl_list; list; list = list->next )
+                if( list->var_decl->array )
+                    type_engine_fold_exp( env, list->var_decl->array->exp_list, stats );
+            break;
+
+        default: break;
+        }
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_stmt()
+// desc: fold expressions, and drop bodies that a folded condition rules out
+//       (loops that always continue are left to the emitter, see
+//       type_engine_fold_cond())
+//-----------------------------------------------------------------------------
+static void type_engine_fold_stmt( Chuck_Env * env, a_Stmt stmt, Chuck_Fold_Stats & stats )
+{
+    t_CKBOOL truth;
+
+    if( !stmt ) return;
+
+    switch( stmt->s_type )
+    {
+    case ae_stmt_exp:
+        type_engine_fold_exp( env, stmt->stmt_exp, stats );
+        break;
+
+    case ae_stmt_if:
+        type_engine_fold_exp( env, stmt->stmt_if.cond, stats );
+        if( type_engine_fold_cond( stmt->stmt_if.cond, &truth ) )
+        {
+            a_Stmt & dead = truth ? stmt->stmt_if.else_body : stmt->stmt_if.if_body;
+            if( dead ) { dead = NULL; stats.pruned++; }
+        }
+        type_engine_fold_stmt( env, stmt->stmt_if.if_body, stats );
+        type_engine_fold_stmt( env, stmt->stmt_if.else_body, stats );
+        break;
+
+    case ae_stmt_while:
+        type_engine_fold_exp( env, stmt->stmt_while.cond, stats );
+        // while( false ) never runs the body; do/while runs it once
+        if( !stmt->stmt_while.is_do && stmt->stmt_while.body &&
+            type_engine_fold_cond( stmt->stmt_while.cond, &truth ) && !truth )
+        { stmt->stmt_while.body = NULL; stats.pruned++; }
+        type_engine_fold_stmt( env, stmt->stmt_while.body, stats );
+        break;
+
+    case ae_stmt_until:
+        type_engine_fold_exp( env, stmt->stmt_until.cond, stats );
+        if( !stmt->stmt_until.is_do && stmt->stmt_until.body &&
+            type_engine_fold_cond( stmt->stmt_until.cond, &truth ) && truth )
+        { stmt->stmt_until.body = NULL; stats.pruned++; }
+        type_engine_fold_stmt( env, stmt->stmt_until.body, stats );
+        break;
+
+    case ae_stmt_for:
+        type_engine_fold_stmt( env, stmt->stmt_for.c1, stats );
+        type_engine_fold_stmt( env, stmt->stmt_for.c2, stats );
+        type_engine_fold_exp( env, stmt->stmt_for.c3, stats );
+        if( stmt->stmt_for.c2 && stmt->stmt_for.body &&
+            type_engine_fold_cond( stmt->stmt_for.c2->stmt_exp, &truth ) && !truth )
+        { stmt->stmt_for.body = NULL; stmt->stmt_for.c3 = NULL; stats.pruned++; }
+        type_engine_fold_stmt( env, stmt->stmt_for.body, stats );
+        break;
+
+    case ae_stmt_loop:
+        type_engine_fold_exp( env, stmt->stmt_loop.cond, stats );
+        type_engine_fold_stmt( env, stmt->stmt_loop.body, stats );
+        break;
+
+    case ae_stmt_code:
+        type_engine_fold_stmt_list( env, stmt->stmt_code.stmt_list, stats );
+        break;
+
+    case ae_stmt_return:
+        type_engine_fold_exp( env, stmt->stmt_return.val, stats );
+        break;
+
+    default: break;
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_fold_stmt_list() / _func_def() / _class_def()
+// desc: ...
+//-----------------------------------------------------------------------------
+static void type_engine_fold_stmt_list( Chuck_Env * env, a_Stmt_List list,
+                                        Chuck_Fold_Stats & stats )
+{
+    for( ; list; list = list->next )
+        type_engine_fold_stmt( env, list->stmt, stats );
+}
+
+static void type_engine_fold_func_def( Chuck_Env * env, a_Func_Def func_def,
+                                       Chuck_Fold_Stats & stats )
+{
+    // imported functions have no body
+    if( func_def->s_type == ae_func_user )
+        type_engine_fold_stmt( env, func_def->code, stats );
+}
+
+static void type_engine_fold_class_def( Chuck_Env * env, a_Class_Def class_def,
+                                        Chuck_Fold_Stats & stats )
+{
+    for( a_Class_Body body = class_def->body; body; body = body->next )
+    {
+        switch( body->section->s_type )
+        {
+        case ae_section_stmt:
+            type_engine_fold_stmt_list( env, body->section->stmt_list, stats );
+            break;
+        case ae_section_func:
+            type_engine_fold_func_def( env, body->section->func_def, stats );
+            break;
+        case ae_section_class:
+            type_engine_fold_class_def( env, body->section->class_def, stats );
+            break;
+        default: break;
+        }
+    }
+}
+
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: type_engine_load_context()
 // desc: call this before context is type-checked
@@ -5164,11 +5761,16 @@ Chuck_Type * type_engine_import_ugen_begin( Chuck_Env * env, const char * name,
     info->add_ref();
     info->tick = type->parent->ugen_info->tick;
     info->tickf = type->parent->ugen_info->tickf; // added 1.3.0.0
+    info->tickv = type->parent->ugen_info->tickv;
     info->pmsg = type->parent->ugen_info->pmsg;
+    info->serial = type->parent->ugen_info->serial;
+    info->async = type->parent->ugen_info->async;
+    info->snap = type->parent->ugen_info->snap;
     info->num_ins = type->parent->ugen_info->num_ins;
     info->num_outs = type->parent->ugen_info->num_outs;
-    if( tick ) info->tick = tick;
-    if( tickf ) { info->tickf = tickf; info->tick = NULL; } // added 1.3.0.0
+    // a new tick invalidates any inherited block tick
+    if( tick ) { info->tick = tick; info->tickv = NULL; }
+    if( tickf ) { info->tickf = tickf; info->tick = NULL; info->tickv = NULL; } // added 1.3.0.0
     if( pmsg ) info->pmsg = pmsg;
     if( num_ins != 0xffffffff ) info->num_ins = num_ins;
     if( num_outs != 0xffffffff ) info->num_outs = num_outs;
@@ -5218,6 +5820,83 @@ Chuck_Type * type_engine_import_ugen_begin( Chuck_Env * env, const char * name,
 
 
 
+//-----------------------------------------------------------------------------
+// name: type_engine_import_ugen_tickv()
+// desc: set the block tick of the ugen currently being imported; must be
+//       called between ugen_begin and class_end, after the tick is set
+//-----------------------------------------------------------------------------
+t_CKBOOL type_engine_import_ugen_tickv( Chuck_Env * env, f_tickv tickv )
+{
+    // make sure we are in a ugen class
+    if( !env->class_def || !env->class_def->ugen_info )
+    {
+        // error
+        EM_error2( 0, "import error: import_ugen_tickv invoked outside of ugen begin/end" );
+        return FALSE;
+    }
+
+    // set it
+    env->class_def->ugen_info->tickv = tickv;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_import_ugen_serial()
+// desc: mark the ugen currently being imported (and its subclasses) as
+//       ticking only on the audio thread, never on a render thread
+//-----------------------------------------------------------------------------
+t_CKBOOL type_engine_import_ugen_serial( Chuck_Env * env )
+{
+    // make sure we are in a ugen class
+    if( !env->class_def || !env->class_def->ugen_info )
+    {
+        // error
+        EM_error2( 0, "import error: import_ugen_serial invoked outside of ugen begin/end" );
+        return FALSE;
+    }
+
+    // set it
+    env->class_def->ugen_info->serial = TRUE;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: type_engine_import_uana_async()
+// desc: mark the uana currently being imported (and its subclasses) as able
+//       to tock on an analysis thread; snap (if any) runs first on the audio
+//       thread, to copy whatever tock reads that tick keeps writing; the
+//       uana's ctrl/cget functions must settle() before touching state
+//       tock uses (see Chuck_UAna::settle())
+//-----------------------------------------------------------------------------
+t_CKBOOL type_engine_import_uana_async( Chuck_Env * env, f_snap snap )
+{
+    // make sure we are in a uana class
+    if( !env->class_def || !env->class_def->ugen_info ||
+        !env->class_def->ugen_info->tock )
+    {
+        // error
+        EM_error2( 0, "import error: import_uana_async invoked outside of uana begin/end" );
+        return FALSE;
+    }
+
+    // set it
+    env->class_def->ugen_info->async = TRUE;
+    env->class_def->ugen_info->snap = snap;
+
+    return TRUE;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: type_engine_import_uana_begin()
 // desc: ...
@@ -5496,6 +6175,9 @@ t_CKBOOL type_engine_import_svar( Chuck_Env * env, const char * type,
         return FALSE;
     }
     
+    // constant, e.g. Math.PI (lets the folding pass use it)
+    var_decl->value->is_const = is_const != 0;
+
     if( doc != NULL )
         var_decl->value->doc = doc;
     
@@ -6208,6 +6890,10 @@ t_CKBOOL type_engine_add_class_from_dl( Chuck_Env * env, Chuck_DL_Class * c )
                                           c->ugen_num_in, c->ugen_num_out,
                                           c->doc.length() > 0 ? c->doc.c_str() : NULL ))
             goto error;
+        
+        // block tick, if the module provides one
+        if( c->ugen_tickv && !type_engine_import_ugen_tickv( env, c->ugen_tickv ) )
+            goto error;
     }
     else
     {
@@ -516,8 +516,12 @@ struct Chuck_UGen_Info : public Chuck_VM_Object
     f_tick tick;
     // multichannel/vector tick function pointer (added 1.3.0.0)
     f_tickf tickf;
+    // single-channel block tick function pointer
+    f_tickv tickv;
     // pmsg function pointer
     f_pmsg pmsg;
+    // tick must run on the audio thread (runs VM code, shared state)
+    t_CKBOOL serial;
     // number of incoming channels
     t_CKUINT num_ins;
     // number of outgoing channels
@@ -525,6 +529,9 @@ struct Chuck_UGen_Info : public Chuck_VM_Object
     
     // for uana, NULL for ugen
     f_tock tock;
+    // tock may run off the audio thread (after snap, if any)
+    t_CKBOOL async;
+    f_snap snap;
     // number of incoming ana channels
     t_CKUINT num_ins_ana;
     // number of outgoing channels
@@ -532,8 +539,8 @@ struct Chuck_UGen_Info : public Chuck_VM_Object
 
     // constructor
     Chuck_UGen_Info()
-    { tick = NULL; tickf = NULL; pmsg = NULL; num_ins = num_outs = 1; 
-      tock = NULL; num_ins_ana = num_outs_ana = 1; }
+    { tick = NULL; tickf = NULL; tickv = NULL; pmsg = NULL; serial = FALSE; num_ins = num_outs = 1; 
+      tock = NULL; async = FALSE; snap = NULL; num_ins_ana = num_outs_ana = 1; }
 };
 
 
@@ -797,6 +804,12 @@ Chuck_Context * type_engine_make_context( a_Program prog,
 t_CKBOOL type_engine_check_context( Chuck_Env * env,
                                     Chuck_Context * context,
                                     te_HowMuch how_much = te_do_all );
+// fold constants in a type-checked context
+t_CKBOOL type_engine_fold_context( Chuck_Env * env,
+                                   Chuck_Context * context,
+                                   te_HowMuch how_much = te_do_all );
+// whether a (folded) condition is constant, and its truth
+t_CKBOOL type_engine_fold_cond( a_Exp cond, t_CKBOOL * truth );
 // type check a statement
 t_CKBOOL type_engine_check_stmt( Chuck_Env * env, a_Stmt stmt );
 // type check an expression
@@ -845,6 +858,9 @@ Chuck_Type * type_engine_import_uana_begin( Chuck_Env * env, const char * name,
                                             t_CKUINT num_ins = 0xffffffff, t_CKUINT num_outs = 0xffffffff,
                                             t_CKUINT num_ins_ana = 0xffffffff, t_CKUINT num_outs_ana = 0xffffffff,
                                             const char * doc = NULL );
+t_CKBOOL type_engine_import_ugen_tickv( Chuck_Env * env, f_tickv tickv );
+t_CKBOOL type_engine_import_ugen_serial( Chuck_Env * env );
+t_CKBOOL type_engine_import_uana_async( Chuck_Env * env, f_snap snap = NULL );
 t_CKBOOL type_engine_import_mfun( Chuck_Env * env, Chuck_DL_Func * mfun );
 t_CKBOOL type_engine_import_sfun( Chuck_Env * env, Chuck_DL_Func * sfun );
 t_CKUINT type_engine_import_mvar( Chuck_Env * env, const char * type, 
@@ -39,9 +39,50 @@
 #include "chuck_vm.h"
 #include "chuck_lang.h"
 #include "chuck_errmsg.h"
+#include <map>
+#include <algorithm>
 using namespace std;
 
 
+// connection changes since startup (see Chuck_UGen_Schedule)
+t_CKUINT Chuck_UGen::our_graph_version = 0;
+// compile passes over all schedules
+t_CKUINT Chuck_UGen_Schedule::our_pass = 0;
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: profile_compute() / profile_compute_v()
+// desc: system_compute(_v)(), timed when the profiler is on; one sample
+//       in CK_PROFILE_SAMPLE_PERIOD stands for the period (reading the
+//       counter around every sample would cost more than most ticks)
+//-----------------------------------------------------------------------------
+static inline t_CKBOOL profile_compute( Chuck_UGen * ugen )
+{
+    if( !Chuck_Profiler::our_on || ( (t_CKUINT)ugen->m_time & ( CK_PROFILE_SAMPLE_PERIOD - 1 ) ) )
+        return ugen->system_compute();
+
+    t_CKTICKS ticks = Chuck_Profiler::now();
+    t_CKBOOL valid = ugen->system_compute();
+    Chuck_Profiler * profiler = Chuck_Profiler::instance();
+    profiler->ugen_ran( ugen, profiler->since( ticks ) * CK_PROFILE_SAMPLE_PERIOD,
+                        CK_PROFILE_SAMPLE_PERIOD );
+    return valid;
+}
+
+static inline t_CKBOOL profile_compute_v( Chuck_UGen * ugen, t_CKUINT numFrames )
+{
+    if( !Chuck_Profiler::our_on ) return ugen->system_compute_v( numFrames );
+
+    t_CKTICKS ticks = Chuck_Profiler::now();
+    t_CKBOOL valid = ugen->system_compute_v( numFrames );
+    Chuck_Profiler * profiler = Chuck_Profiler::instance();
+    profiler->ugen_ran( ugen, profiler->since( ticks ), numFrames );
+    return valid;
+}
+
+
 
 
 //-----------------------------------------------------------------------------
@@ -180,6 +221,7 @@ void Chuck_UGen::init()
 {
     tick = NULL;
     tickf = NULL; // added 1.3.0.0
+    tickv = NULL;
     pmsg = NULL;
     m_multi_chan = NULL;
     m_multi_chan_size = 0;
@@ -220,6 +262,10 @@ void Chuck_UGen::init()
     m_is_subgraph = FALSE;
     m_inlet = m_outlet = NULL;
     m_multi_in_v = m_multi_out_v = NULL;
+
+    // not in any schedule yet
+    m_sched_mark = 0;
+    m_profile = NULL;
 }
 
 
@@ -239,6 +285,10 @@ void Chuck_UGen::done()
     // disconnect
     this->disconnect( TRUE );
     m_valid = FALSE;
+    // may still be in a schedule, e.g. as a channel owner
+    our_graph_version++;
+    // keep what the profiler has
+    if( m_profile ) Chuck_Profiler::instance()->ugen_done( this );
 
     fa_done( m_src_list, m_src_cap );
     fa_done( m_dest_list, m_dest_cap );
@@ -416,6 +466,9 @@ t_CKBOOL Chuck_UGen::add( Chuck_UGen * src, t_CKBOOL isUpChuck )
         // call add on the src's outlet instead
         return add( src->outlet(), isUpChuck );
     }
+
+    // not while an async tock reads our inputs
+    if( m_is_uana ) ((Chuck_UAna *)this)->settle();
     
     // examine ins and outs
     t_CKUINT outs = src->m_num_outs;
@@ -436,6 +489,8 @@ t_CKBOOL Chuck_UGen::add( Chuck_UGen * src, t_CKBOOL isUpChuck )
         m_num_src++;
         src->add_ref();
         src->add_by( this, isUpChuck );
+        // topology changed
+        our_graph_version++;
         
         // upchuck
         if( isUpChuck )
@@ -541,6 +596,9 @@ t_CKBOOL Chuck_UGen::remove( Chuck_UGen * src )
         // use the src's outlet
         return remove(src->outlet());
     }
+
+    // not while an async tock reads our inputs
+    if( m_is_uana ) ((Chuck_UAna *)this)->settle();
     
     // ins and outs
     t_CKUINT outs = src->m_num_outs;
@@ -579,7 +637,9 @@ t_CKBOOL Chuck_UGen::remove( Chuck_UGen * src )
                 src->release();
                 --i;
             }
-        
+
+        // topology changed
+        if( ret ) our_graph_version++;
     }
     /* else if( outs >= 2 && ins == 1 )
     {
@@ -702,6 +762,8 @@ void Chuck_UGen::remove_all( )
 
             // null the last element
             m_src_list[--m_num_src] = NULL;
+            // topology changed
+            our_graph_version++;
         }
     }
 }
@@ -796,33 +858,82 @@ t_CKBOOL Chuck_UGen::is_connected_from( Chuck_UGen * src )
 
 //-----------------------------------------------------------------------------
 // name: tick()
-// dsec: ...
+// dsec: recursive pull; ticks sources, channels and owner as needed
 //-----------------------------------------------------------------------------
 t_CKBOOL Chuck_UGen::system_tick( t_CKTIME now )
 {
     if( m_time >= now )
         return m_valid;
 
-    t_CKUINT i; Chuck_UGen * ugen; SAMPLE multi;
+    t_CKUINT i; Chuck_UGen * ugen;
 
     
     /*** Part 1: Tick upstream ugens ***/
     
     // inc time
     m_time = now;
+
+    // tick the src list
+    for( i = 0; i < m_num_src; i++ )
+    {
+        ugen = m_src_list[i];
+        if( ugen->m_time < now ) ugen->system_tick( now );
+    }
+
+    // tick multiple channels
+    for( i = 0; i < m_multi_chan_size; i++ )
+    {
+        ugen = m_multi_chan[i];
+        if( ugen->m_time < now ) ugen->system_tick( now );
+    }
+
+    // sum the inputs
+    system_gather();
+
+    // if owner (i.e., this ugen is one of the channels in a multi-channel ugen)
+    if( owner != NULL && owner->m_time < now )
+    {
+        // tick the owner
+        owner->system_tick( now );
+
+        // if the owner has a multichannel tick function (added 1.3.0.0)
+        if( owner->tickf )
+        {
+            // set the latest to the current
+            m_last = m_current;
+            // done, don't want multi-channel subchannels to synthesize
+            // it should be taken care of in the owner (added 1.3.0.0)
+            return TRUE;
+        }
+    }
+    
+    
+    /*** Part Two: Synthesize with tick function ***/
+    
+    return profile_compute( this );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: system_gather()
+// dsec: sum sources and channels into m_sum; sources must be ticked already
+//-----------------------------------------------------------------------------
+void Chuck_UGen::system_gather()
+{
+    t_CKUINT i; Chuck_UGen * ugen; SAMPLE multi;
+
     // initial sum
     m_sum = 0.0f;
     if( m_num_src )
     {
-        ugen = m_src_list[0];
-        if( ugen->m_time < now ) ugen->system_tick( now );
-        m_sum = ugen->m_current;
+        m_sum = m_src_list[0]->m_current;
 
-        // tick the src list
+        // sum the src list
         for( i = 1; i < m_num_src; i++ )
         {
             ugen = m_src_list[i];
-            if( ugen->m_time < now ) ugen->system_tick( now );
             if( ugen->m_valid )
             {
                 if( m_op <= 1 )
@@ -841,61 +952,44 @@ t_CKBOOL Chuck_UGen::system_tick( t_CKTIME now )
         }
     }
 
-    // tick multiple channels
+    // multiple channels
     multi = 0.0f;
     if( m_multi_chan_size )
     {
         // spencer 2012 - use multichannel tick function (added 1.3.0.0)
         if( tickf )
         {
-            // system tick each input channel (added 1.3.0.0)
             for( i = 0; i < m_multi_chan_size; i++ )
             {
-                ugen = m_multi_chan[i];
-                // tick sub-ugens for individual channels
-                if( ugen->m_time < now ) ugen->system_tick( now );
                 // set to tickf input
                 // TODO: if op is not 1? 
-                m_multi_in_v[i] = m_sum + ugen->m_sum;
+                m_multi_in_v[i] = m_sum + m_multi_chan[i]->m_sum;
             }
         }
         else
         {
+            // multiple channels are added
             for( i = 0; i < m_multi_chan_size; i++ )
-            {
-                ugen = m_multi_chan[i];
-                if( ugen->m_time < now ) ugen->system_tick( now );
-                // multiple channels are added
-                multi += ugen->m_current;
-            }
+                multi += m_multi_chan[i]->m_current;
             
             // scale multi
             multi /= m_multi_chan_size;
             m_sum += multi;
         }
     }
+}
 
-    // if owner (i.e., this ugen is one of the channels in a multi-channel ugen)
-    if( owner != NULL && owner->m_time < now )
-    {
-        // tick the owner
-        owner->system_tick( now );
 
-        // if the owner has a multichannel tick function (added 1.3.0.0)
-        if( owner->tickf )
-        {
-            // set the latest to the current
-            m_last = m_current;
-            // done, don't want multi-channel subchannels to synthesize
-            // it should be taken care of in the owner (added 1.3.0.0)
-            return TRUE;
-        }
-    }
-    
-    
-    
-    /*** Part Two: Synthesize with tick function ***/
-    
+
+
+//-----------------------------------------------------------------------------
+// name: system_compute()
+// dsec: synthesize from m_sum with the tick function
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UGen::system_compute()
+{
+    t_CKUINT i; Chuck_UGen * ugen; SAMPLE multi;
+
     if( m_multi_chan_size && tickf )
     {
         /* evaluate multi-channel tickf (added 1.3.0.0) */
@@ -994,15 +1088,14 @@ t_CKBOOL Chuck_UGen::system_tick( t_CKTIME now )
 
 //-----------------------------------------------------------------------------
 // name: tick_v()
-// dsec: ...
+// dsec: recursive pull, block version
 //-----------------------------------------------------------------------------
 t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
 {
     if( m_time >= now )
         return m_valid;
     
-    t_CKUINT i, j; Chuck_UGen * ugen; SAMPLE factor;
-    SAMPLE multi;
+    t_CKUINT i; Chuck_UGen * ugen;
     
     // inc time
     m_time = now;
@@ -1010,17 +1103,64 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
     
     /*** Part 1: Tick upstream ugens ***/
     
-    if( m_num_src )
+    // tick the src list
+    for( i = 0; i < m_num_src; i++ )
     {
-        ugen = m_src_list[0];
+        ugen = m_src_list[i];
+        if( ugen->m_time < now ) ugen->system_tick_v( now, numFrames );
+    }
+
+    // tick multiple channels
+    for( i = 0; i < m_multi_chan_size; i++ )
+    {
+        ugen = m_multi_chan[i];
         if( ugen->m_time < now ) ugen->system_tick_v( now, numFrames );
-        memcpy( m_sum_v, ugen->m_current_v, numFrames * sizeof(SAMPLE) );
+    }
+
+    // sum the inputs
+    system_gather_v( numFrames );
+    
+    // if owner
+    if( owner != NULL && owner->m_time < now )
+    {
+        owner->system_tick_v( now, numFrames );
         
-        // tick the src list
+        // if the owner has a multichannel tick function (added 1.3.0.0)
+        if( owner->tickf )
+        {
+            // set the latest to the current
+            m_last = m_current_v[numFrames - 1];
+            // done, don't want multi-channel subchannels to synthesize
+            // it should be taken care of in the owner (added 1.3.0.0)
+            return TRUE;
+        }
+    }
+    
+    
+    /*** Part Two: Synthesize with tick function ***/
+    
+    return profile_compute_v( this, numFrames );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: system_gather_v()
+// dsec: block version of system_gather()
+//-----------------------------------------------------------------------------
+void Chuck_UGen::system_gather_v( t_CKUINT numFrames )
+{
+    t_CKUINT i, j; Chuck_UGen * ugen; SAMPLE factor;
+    
+    if( m_num_src )
+    {
+        memcpy( m_sum_v, m_src_list[0]->m_current_v, numFrames * sizeof(SAMPLE) );
+        
+        // sum the src list
         for( i = 1; i < m_num_src; i++ )
         {
             ugen = m_src_list[i];
-            if( ugen->m_time < now ) ugen->system_tick_v( now, numFrames );
             if( ugen->m_valid )
             {
                 if( m_op <= 1 )
@@ -1048,19 +1188,16 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
         memset( m_sum_v, 0, numFrames * sizeof(SAMPLE) );
     }
 
-    // tick multiple channels
+    // multiple channels
     if( m_multi_chan_size )
     {
-        if(tickf)
+        if( tickf )
         {
-            // system tick each input channel (added 1.3.0.0)
-            for( int c = 0; c < m_multi_chan_size; c++ )
+            // set to tickf input (added 1.3.0.0)
+            for( t_CKUINT c = 0; c < m_multi_chan_size; c++ )
             {
                 ugen = m_multi_chan[c];
-                // tick sub-ugens for individual channels
-                if( ugen->m_time < now ) ugen->system_tick_v( now, numFrames );
-                // set to tickf input
-                for( int f = 0; f < numFrames; f++ )
+                for( t_CKUINT f = 0; f < numFrames; f++ )
                     m_multi_in_v[f*m_multi_chan_size+c] = ugen->m_sum_v[f];
             }
         }
@@ -1072,31 +1209,24 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
             for( i = 0; i < m_multi_chan_size; i++ )
             {
                 ugen = m_multi_chan[i];
-                if( ugen->m_time < now ) ugen->system_tick_v( now, numFrames );
                 for( j = 0; j < numFrames; j++ )
                     m_sum_v[j] += ugen->m_current_v[j] * factor;
             }
         }
     }
-    
-    // if owner
-    if( owner != NULL && owner->m_time < now )
-    {
-        owner->system_tick_v( now, numFrames );
-        
-        // if the owner has a multichannel tick function (added 1.3.0.0)
-        if( owner->tickf )
-        {
-            // set the latest to the current
-            m_last = m_current_v[numFrames - 1];
-            // done, don't want multi-channel subchannels to synthesize
-            // it should be taken care of in the owner (added 1.3.0.0)
-            return TRUE;
-        }
-    }
-    
-    
-    /*** Part Two: Synthesize with tick function ***/
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: system_compute_v()
+// dsec: block version of system_compute()
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UGen::system_compute_v( t_CKUINT numFrames )
+{
+    t_CKUINT j; Chuck_UGen * ugen; SAMPLE factor;
+    SAMPLE multi;
     
     if( m_multi_chan_size && tickf )
     {
@@ -1120,14 +1250,15 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
                 
                 for( int c = 0; c < m_multi_chan_size; c++ )
                 {
+                    ugen = m_multi_chan[c];
                     // apply gain/pan
                     m_multi_out_v[f*m_multi_chan_size+c] *= ugen->m_gain * ugen->m_pan;
                     // dedenormal
                     CK_DDN( m_multi_out_v[f*m_multi_chan_size+c] );
                     // copy from tickf output to channel's current sample
-                    m_multi_chan[c]->m_current_v[f] = m_multi_out_v[f*m_multi_chan_size+c];
+                    ugen->m_current_v[f] = m_multi_out_v[f*m_multi_chan_size+c];
                     // add to mono mixdown
-                    multi += m_multi_chan[c]->m_current_v[f];
+                    multi += ugen->m_current_v[f];
                 }
                 
                 // compute mono-mixdown for the owner-ugen
@@ -1150,7 +1281,7 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
             else // UGEN_OP_STOP
             {
                 // zero out
-                memset( m_multi_out_v, 0, sizeof(SAMPLE)*m_multi_chan_size );
+                memset( m_multi_out_v, 0, sizeof(SAMPLE) * m_multi_chan_size * numFrames );
                 m_valid = TRUE;
             }
             
@@ -1166,7 +1297,7 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
                 }
                 
                 // mono mixdown
-                m_current_v[i] = multi/m_multi_chan_size;
+                m_current_v[f] = multi/m_multi_chan_size;
             }
             
             // save as last
@@ -1182,21 +1313,29 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
 
         if( m_op > 0 )  // UGEN_OP_TICK
         {
-            // tick the ugen (Chuck_DL_Api::Api::instance() added 1.3.0.0)
-            if( tick )
+            // tick the whole block in one call, if the ugen can
+            if( tickv )
+                m_valid = tickv( this, m_sum_v, m_current_v, numFrames, NULL, Chuck_DL_Api::Api::instance() );
+            // otherwise tick the ugen per sample (Chuck_DL_Api::Api::instance() added 1.3.0.0)
+            else if( tick )
+            {
+                CK_DL_API api = Chuck_DL_Api::Api::instance();
                 for( j = 0; j < numFrames; j++ )
-                    m_valid = tick( this, m_sum_v[j], &(m_current_v[j]), NULL, Chuck_DL_Api::Api::instance() );
+                    m_valid = tick( this, m_sum_v[j], &(m_current_v[j]), NULL, api );
+            }
             if( !m_valid )
-                for( j = 0; j < numFrames; j++ )
-                    m_current_v[j] = 0.0f;
+                memset( m_current_v, 0, numFrames * sizeof(SAMPLE) );
             else
+            {
+                // apply gain and pan
+                SAMPLE gain = m_gain * m_pan;
                 for( j = 0; j < numFrames; j++ )
                 {
-                    // apply gain and pan
-                    m_current_v[j] *= m_gain * m_pan;
+                    m_current_v[j] *= gain;
                     // dedenormal
                     CK_DDN( m_current_v[j] );
                 }
+            }
         }
         else if( m_op < 0 ) // UGEN_OP_PASS
         {
@@ -1225,100 +1364,581 @@ t_CKBOOL Chuck_UGen::system_tick_v( t_CKTIME now, t_CKUINT numFrames )
 
 
 //-----------------------------------------------------------------------------
-// name: init_subgraph()
-// desc: init subgraph, added 1.3.0.0
+// name: Chuck_UGen_Schedule()
+// desc: constructor
 //-----------------------------------------------------------------------------
-void Chuck_UGen::init_subgraph()
+Chuck_UGen_Schedule::Chuck_UGen_Schedule()
 {
-    // set flag
-    m_is_subgraph = TRUE;
-    // pointer
-    Chuck_Object * obj = NULL;
-    
-    // instantiate object for inlet
-    obj = instantiate_and_initialize_object( &t_ugen, this->shred );
-    // set as inlet
-    m_inlet = (Chuck_UGen *)obj;
-    // additional reference count
-    m_inlet->add_ref();
-    // owner
-    m_inlet->owner = this;
-    // ref count
-    this->add_ref();
-    
-    // instantiate object for outlet
-    obj = instantiate_and_initialize_object( &t_ugen, this->shred );
-    // set as outlet
-    m_outlet = (Chuck_UGen *)obj;
-    // additional reference count
-    m_outlet->add_ref();
-    // owner
-    m_outlet->owner = this;
-    // ref count
-    this->add_ref();
+    m_input = NULL;
+    m_version = 0;
+    m_pass = 0;
+    m_compiled = FALSE;
+    m_pool = NULL;
+    m_min_frames = 0;
+    m_now = 0;
+    m_frames = 0;
 }
 
 
 
 
 //-----------------------------------------------------------------------------
-// name: inlet()
-// desc: get inlet (added 1.3.0.0)
+// name: set_roots()
+// desc: set the graph roots (ticked in order) and the externally fed input
 //-----------------------------------------------------------------------------
-Chuck_UGen * Chuck_UGen::inlet()
+void Chuck_UGen_Schedule::set_roots( Chuck_UGen ** roots, t_CKUINT num_roots,
+                                     Chuck_UGen * input )
 {
-    return m_inlet;
+    m_roots.assign( roots, roots + num_roots );
+    m_input = input;
+    m_compiled = FALSE;
 }
 
 
 
 
 //-----------------------------------------------------------------------------
-// name: outlet()
-// desc: get outlet (added 1.3.0.0)
+// name: compile()
+// desc: flatten the graph reachable from the roots
 //-----------------------------------------------------------------------------
-Chuck_UGen * Chuck_UGen::outlet()
+void Chuck_UGen_Schedule::compile()
 {
-    return m_outlet;
-}
+    t_CKUINT i;
 
+    // new pass; marks from earlier compiles no longer count
+    m_pass = ++our_pass;
+    m_steps.clear();
 
+    // the input is written before the pass, like an already-ticked ugen
+    if( m_input )
+    {
+        m_input->m_sched_mark = m_pass;
+        for( i = 0; i < m_input->m_multi_chan_size; i++ )
+            m_input->m_multi_chan[i]->m_sched_mark = m_pass;
+    }
 
+    // walk from each root
+    for( i = 0; i < m_roots.size(); i++ )
+        visit( m_roots[i] );
 
-//-----------------------------------------------------------------------------
-// name: Chuck_UAna()
-// desc: constructor
-//-----------------------------------------------------------------------------
-Chuck_UAna::Chuck_UAna() : Chuck_UGen()
-{
-    // mark as true
-    m_is_uana = TRUE;
-    // reset uana time (HACK: negative so upchuck() works at now=0)
-    m_uana_time = -1;
-    // zero out proxy
-    // m_blob_proxy = NULL;
+    // parts for the pool
+    partition();
+
+    m_version = Chuck_UGen::our_graph_version;
+    m_compiled = TRUE;
 }
 
 
 
 
 //-----------------------------------------------------------------------------
-// name: ~Chuck_UAna()
-// desc: destructor
+// name: visit()
+// desc: mirrors Chuck_UGen::system_tick(), recording steps instead of
+//       running them; a ugen already marked is either done or on the
+//       current path (a feedback edge), and in both cases is not re-entered
 //-----------------------------------------------------------------------------
-Chuck_UAna::~Chuck_UAna()
+void Chuck_UGen_Schedule::visit( Chuck_UGen * ugen )
 {
-    // do nothing for now
-}
-
+    Step step;
+    t_CKUINT i;
 
+    // mark on entry
+    ugen->m_sched_mark = m_pass;
+    step.ugen = ugen;
 
+    // sources, then channels
+    for( i = 0; i < ugen->m_num_src; i++ )
+        if( ugen->m_src_list[i]->m_sched_mark != m_pass )
+            visit( ugen->m_src_list[i] );
+    for( i = 0; i < ugen->m_multi_chan_size; i++ )
+        if( ugen->m_multi_chan[i]->m_sched_mark != m_pass )
+            visit( ugen->m_multi_chan[i] );
 
-//-----------------------------------------------------------------------------
-// name: blobProxy()
-// desc: ...
-//-----------------------------------------------------------------------------
-Chuck_UAnaBlobProxy * Chuck_UAna::blobProxy() const { return getBlobProxy( this ); }
+    // sum the inputs
+    step.op = STEP_GATHER;
+    m_steps.push_back( step );
+
+    // a channel reached before its owner ticks the owner
+    if( ugen->owner != NULL && ugen->owner->m_sched_mark != m_pass )
+    {
+        visit( ugen->owner );
+
+        // the owner's tickf synthesizes this channel
+        if( ugen->owner->tickf )
+        {
+            step.op = STEP_LAST;
+            m_steps.push_back( step );
+            return;
+        }
+    }
+
+    // synthesize; fused with the gather when nothing came between them
+    if( m_steps.back().ugen == ugen && m_steps.back().op == STEP_GATHER )
+        m_steps.back().op = STEP_TICK;
+    else
+    {
+        step.op = STEP_COMPUTE;
+        m_steps.push_back( step );
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: tick()
+// desc: tick one sample as a linear pass over the steps
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::tick( t_CKTIME now )
+{
+    // rebuild if the graph changed since the last pass
+    if( !m_compiled || m_version != Chuck_UGen::our_graph_version )
+        compile();
+
+    const Step * step = m_steps.empty() ? NULL : &m_steps[0];
+    const Step * end = step + m_steps.size();
+
+    for( ; step != end; step++ )
+    {
+        switch( step->op )
+        {
+        case STEP_GATHER:
+            step->ugen->m_time = now;
+            step->ugen->system_gather();
+            break;
+        case STEP_TICK:
+            step->ugen->m_time = now;
+            step->ugen->system_gather();
+            // fall through
+        case STEP_COMPUTE:
+            profile_compute( step->ugen );
+            // a tick (e.g. a chugen) changed the graph: the remaining
+            // steps may be stale, so finish this pass recursively
+            if( m_version != Chuck_UGen::our_graph_version )
+            {
+                for( t_CKUINT i = 0; i < m_roots.size(); i++ )
+                    m_roots[i]->system_tick( now );
+                return;
+            }
+            break;
+        default: // STEP_LAST
+            step->ugen->m_last = step->ugen->m_current;
+            break;
+        }
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: tick_v()
+// desc: tick one block as a linear pass over the steps; with a pool, the
+//       independent parts run there first and the rest runs here after
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::tick_v( t_CKTIME now, t_CKUINT numFrames )
+{
+    // rebuild if the graph changed since the last pass
+    if( !m_compiled || m_version != Chuck_UGen::our_graph_version )
+        compile();
+
+    const std::vector<Step> * steps = &m_steps;
+
+    // independent parts
+    if( !m_tasks.empty() && numFrames >= m_min_frames )
+    {
+        m_now = now;
+        m_frames = numFrames;
+        m_pool->run( run_task, this, m_tasks.size() );
+        steps = &m_serial;
+    }
+
+    if( steps->empty() ) return;
+    if( !run_v( &(*steps)[0], &(*steps)[0] + steps->size(), now, numFrames ) )
+    {
+        // a tick (e.g. a chugen) changed the graph: the remaining
+        // steps may be stale, so finish this pass recursively
+        for( t_CKUINT i = 0; i < m_roots.size(); i++ )
+            m_roots[i]->system_tick_v( now, numFrames );
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: run_v()
+// desc: run steps for one block; stops and returns FALSE if a tick
+//       changed the graph
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UGen_Schedule::run_v( const Step * step, const Step * end,
+                                     t_CKTIME now, t_CKUINT numFrames )
+{
+    for( ; step != end; step++ )
+    {
+        switch( step->op )
+        {
+        case STEP_GATHER:
+            step->ugen->m_time = now;
+            step->ugen->system_gather_v( numFrames );
+            break;
+        case STEP_TICK:
+            step->ugen->m_time = now;
+            step->ugen->system_gather_v( numFrames );
+            // fall through
+        case STEP_COMPUTE:
+            profile_compute_v( step->ugen, numFrames );
+            if( m_version != Chuck_UGen::our_graph_version )
+                return FALSE;
+            break;
+        default: // STEP_LAST
+            step->ugen->m_last = step->ugen->m_current_v[numFrames - 1];
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: run_task()
+// desc: pool task: one independent part for the current block
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::run_task( void * data, t_CKUINT task )
+{
+    Chuck_UGen_Schedule * schedule = (Chuck_UGen_Schedule *)data;
+    const std::vector<Step> & steps = schedule->m_tasks[task];
+
+    // native ticks only (see partition()), so the graph cannot change here
+    schedule->run_v( &steps[0], &steps[0] + steps.size(),
+                     schedule->m_now, schedule->m_frames );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: set_pool()
+// desc: render independent parts of the graph on a pool in tick_v(), for
+//       blocks of at least min_frames; NULL to turn off
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::set_pool( XWorkPool * pool, t_CKUINT min_frames )
+{
+    m_pool = pool;
+    m_min_frames = min_frames;
+    m_compiled = FALSE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: find_root()
+// desc: union-find root, with path halving
+//-----------------------------------------------------------------------------
+static t_CKUINT find_root( std::vector<t_CKUINT> & root, t_CKUINT i )
+{
+    while( root[i] != i )
+        i = root[i] = root[root[i]];
+    return i;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: larger_task()
+// desc: sort order for parts, largest first
+//-----------------------------------------------------------------------------
+template <typename T>
+static bool larger_task( const T & a, const T & b )
+{
+    return a.size() > b.size();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: partition()
+// desc: split the steps into parts that can run concurrently, before the
+//       rest.  a part is a connected piece of the graph left after taking
+//       out the mix points (roots, their channels, and ugens whose tick
+//       must stay on the audio thread), peeling off the outputs of any
+//       piece that still holds most of the graph.  a part only runs
+//       concurrently if that cannot change what anything reads: every
+//       value crossing its edge must be read either after it was computed
+//       or before, the same as in the serial order.  the serial steps sum
+//       the parts' outputs in source-list order, so the mix is the same
+//       whatever order the parts finish in.
+//-----------------------------------------------------------------------------
+void Chuck_UGen_Schedule::partition()
+{
+    std::map<Chuck_UGen *, t_CKUINT> index;
+    std::map<Chuck_UGen *, t_CKUINT>::iterator it;
+    std::vector<Chuck_UGen *> nodes;
+    std::vector<t_CKUINT> first, last, unit, root, size, part;
+    std::vector<t_CKBOOL> serial, bad;
+    t_CKUINT i, j, n, id, total, largest, num_parts;
+    Chuck_UGen * ugen;
+
+    m_tasks.clear();
+    m_serial.clear();
+    if( !m_pool || m_pool->num_threads() < 2 ) return;
+
+    // distinct ugens, with the steps where they first read their sources
+    // and where their output is final
+    for( i = 0; i < m_steps.size(); i++ )
+    {
+        ugen = m_steps[i].ugen;
+        it = index.find( ugen );
+        if( it == index.end() )
+        {
+            id = nodes.size();
+            index[ugen] = id;
+            nodes.push_back( ugen );
+            first.push_back( i );
+            last.push_back( i );
+        }
+        else id = it->second;
+        if( m_steps[i].op != STEP_GATHER ) last[id] = i;
+    }
+    n = nodes.size();
+
+    // a multi-channel ugen and its channels move as one unit
+    unit.resize( n );
+    for( i = 0; i < n; i++ )
+    {
+        it = nodes[i]->owner ? index.find( nodes[i]->owner ) : index.end();
+        unit[i] = it != index.end() ? it->second : i;
+    }
+
+    // mix points
+    serial.assign( n, FALSE );
+    for( i = 0; i < n; i++ )
+    {
+        Chuck_Type * type = nodes[unit[i]]->type_ref;
+        if( type && type->ugen_info && type->ugen_info->serial )
+            serial[unit[i]] = TRUE;
+    }
+    for( i = 0; i < m_roots.size(); i++ )
+        if( (it = index.find( m_roots[i] )) != index.end() )
+            serial[it->second] = TRUE;
+
+    // connected pieces; peel the outputs off a dominant one and retry
+    root.resize( n );
+    for( t_CKUINT round = 0; round < n; round++ )
+    {
+        for( i = 0; i < n; i++ ) root[i] = i;
+        for( i = 0; i < n; i++ )
+        {
+            if( serial[unit[i]] ) continue;
+            for( j = 0; j < nodes[i]->m_num_src; j++ )
+            {
+                it = index.find( nodes[i]->m_src_list[j] );
+                if( it == index.end() || serial[unit[it->second]] ) continue;
+                t_CKUINT a = find_root( root, unit[i] );
+                t_CKUINT b = find_root( root, unit[it->second] );
+                if( a != b ) root[a] = b;
+            }
+        }
+
+        // sizes
+        size.assign( n, 0 );
+        total = 0; largest = 0;
+        for( i = 0; i < n; i++ )
+        {
+            if( serial[unit[i]] ) continue;
+            id = find_root( root, unit[i] );
+            size[id]++; total++;
+            if( size[id] > size[largest] ) largest = id;
+        }
+
+        // no single piece holds most of the graph
+        if( total == 0 || size[largest] * 2 <= total ) break;
+
+        // its ugens that feed a mix point become mix points
+        t_CKBOOL peeled = FALSE;
+        for( i = 0; i < n; i++ )
+        {
+            if( serial[unit[i]] || find_root( root, unit[i] ) != largest ) continue;
+            for( j = 0; j < nodes[i]->m_num_dest; j++ )
+            {
+                it = index.find( nodes[i]->m_dest_list[j] );
+                if( it != index.end() && serial[unit[it->second]] )
+                { serial[unit[i]] = TRUE; peeled = TRUE; break; }
+            }
+        }
+        if( !peeled ) break;
+    }
+
+    // parts whose edges would read differently when run first
+    bad.assign( n, FALSE );
+    for( i = 0; i < n; i++ )
+    {
+        if( serial[unit[i]] ) continue;
+        id = find_root( root, unit[i] );
+        // a mix point computed before this reads it
+        for( j = 0; j < nodes[i]->m_num_src; j++ )
+        {
+            it = index.find( nodes[i]->m_src_list[j] );
+            if( it != index.end() && serial[unit[it->second]] &&
+                last[it->second] < first[i] ) bad[id] = TRUE;
+        }
+        // a mix point that read this before it was computed
+        for( j = 0; j < nodes[i]->m_num_dest; j++ )
+        {
+            it = index.find( nodes[i]->m_dest_list[j] );
+            if( it != index.end() && serial[unit[it->second]] &&
+                first[it->second] < last[i] ) bad[id] = TRUE;
+        }
+    }
+
+    // number the good parts
+    part.assign( n, (t_CKUINT)-1 );
+    num_parts = 0;
+    for( i = 0; i < n; i++ )
+    {
+        if( serial[unit[i]] ) continue;
+        id = find_root( root, unit[i] );
+        if( !bad[id] && part[id] == (t_CKUINT)-1 ) part[id] = num_parts++;
+    }
+
+    // not worth it
+    if( num_parts < 2 ) return;
+
+    // deal out the steps, keeping their order
+    m_tasks.resize( num_parts );
+    for( i = 0; i < m_steps.size(); i++ )
+    {
+        id = index[m_steps[i].ugen];
+        if( serial[unit[id]] || bad[find_root( root, unit[id] )] )
+            m_serial.push_back( m_steps[i] );
+        else
+            m_tasks[part[find_root( root, unit[id] )]].push_back( m_steps[i] );
+    }
+
+    // largest first, for the pool to deal out
+    std::sort( m_tasks.begin(), m_tasks.end(), larger_task< std::vector<Step> > );
+
+    EM_log( CK_LOG_FINE, "ugen schedule: %lu steps, %lu parallel parts, %lu serial steps",
+            m_steps.size(), m_tasks.size(), m_serial.size() );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: init_subgraph()
+// desc: init subgraph, added 1.3.0.0
+//-----------------------------------------------------------------------------
+void Chuck_UGen::init_subgraph()
+{
+    // set flag
+    m_is_subgraph = TRUE;
+    // pointer
+    Chuck_Object * obj = NULL;
+    
+    // instantiate object for inlet
+    obj = instantiate_and_initialize_object( &t_ugen, this->shred );
+    // set as inlet
+    m_inlet = (Chuck_UGen *)obj;
+    // additional reference count
+    m_inlet->add_ref();
+    // owner
+    m_inlet->owner = this;
+    // ref count
+    this->add_ref();
+    
+    // instantiate object for outlet
+    obj = instantiate_and_initialize_object( &t_ugen, this->shred );
+    // set as outlet
+    m_outlet = (Chuck_UGen *)obj;
+    // additional reference count
+    m_outlet->add_ref();
+    // owner
+    m_outlet->owner = this;
+    // ref count
+    this->add_ref();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: inlet()
+// desc: get inlet (added 1.3.0.0)
+//-----------------------------------------------------------------------------
+Chuck_UGen * Chuck_UGen::inlet()
+{
+    return m_inlet;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: outlet()
+// desc: get outlet (added 1.3.0.0)
+//-----------------------------------------------------------------------------
+Chuck_UGen * Chuck_UGen::outlet()
+{
+    return m_outlet;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: Chuck_UAna()
+// desc: constructor
+//-----------------------------------------------------------------------------
+Chuck_UAna::Chuck_UAna() : Chuck_UGen()
+{
+    // mark as true
+    m_is_uana = TRUE;
+    // reset uana time (HACK: negative so upchuck() works at now=0)
+    m_uana_time = -1;
+    // zero out proxy
+    // m_blob_proxy = NULL;
+    // synchronous until asked
+    tock = NULL;
+    snap = NULL;
+    m_async_ok = FALSE;
+    m_async = FALSE;
+    m_job = NULL;
+    // tocked by shreds until asked
+    m_hop = CK_UANA_DEFAULT_HOP;
+    m_auto_next = 0;
+    m_auto_sched = NULL;
+    m_event = NULL;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~Chuck_UAna()
+// desc: destructor
+//-----------------------------------------------------------------------------
+Chuck_UAna::~Chuck_UAna()
+{
+    // no longer tocked by hop
+    if( m_auto_sched ) m_auto_sched->remove_auto_tock( this );
+    SAFE_RELEASE( m_event );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: blobProxy()
+// desc: ...
+//-----------------------------------------------------------------------------
+Chuck_UAnaBlobProxy * Chuck_UAna::blobProxy() const { return getBlobProxy( this ); }
 
 
 
@@ -1485,6 +2105,437 @@ t_CKBOOL Chuck_UAna::system_tock( t_CKTIME now )
 }
 
 
+
+
+
+//-----------------------------------------------------------------------------
+// name: gather()
+// desc: the traversal of system_tock(), without tocking: uanas are marked
+//       tocked at now and listed in the order system_tock() would tock
+//       them.  a tock still in flight anywhere upstream is settled first.
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UAna::gather( t_CKTIME now, std::vector<Chuck_UAna *> & chain )
+{
+    // our blob (and m_uana_time) are final once settled
+    this->settle();
+    if( m_uana_time >= now )
+        return TRUE;
+
+    t_CKUINT i; Chuck_UGen * ugen; t_CKBOOL ok = TRUE;
+
+    // inc time
+    m_uana_time = now;
+    if( m_num_src )
+    {
+        // sum (as system_tock)
+        m_sum = m_src_list[0]->m_current;
+        // gather the src list
+        for( i = 0; i < m_num_src; i++ )
+        {
+            ugen = m_src_list[i];
+            if( ugen->m_is_uana ) ok = ((Chuck_UAna *)ugen)->gather( now, chain ) && ok;
+        }
+    }
+
+    // gather multiple channels
+    for( i = 0; i < m_multi_chan_size; i++ )
+    {
+        ugen = m_multi_chan[i];
+        if( ugen->m_is_uana ) ok = ((Chuck_UAna *)ugen)->gather( now, chain ) && ok;
+    }
+
+    // if owner
+    if( owner != NULL && owner->m_is_uana )
+        ok = ((Chuck_UAna *)owner)->gather( now, chain ) && ok;
+
+    // UGEN_OP_TOCK
+    if( m_op > 0 )
+    {
+        chain.push_back( this );
+        ok = ok && m_async_ok;
+    }
+
+    return ok;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: upchuck()
+// desc: tock the chain at now; if this is async (and everything upstream
+//       can be), on the vm's analysis worker while shred waits
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UAna::upchuck( Chuck_VM * vm, Chuck_VM_Shred * shred, t_CKTIME now )
+{
+    Chuck_UAna_Worker * worker = vm->uana_worker( m_async );
+
+    // no async uana yet: as always
+    if( !worker )
+    {
+        if( m_uana_time < now ) system_tock( now );
+        return FALSE;
+    }
+
+    Chuck_UAna_Job * job = m_job;
+    // upchucked again while in flight for the same time: wait along
+    if( !job || !m_async || job->now != now )
+    {
+        std::vector<Chuck_UAna *> chain;
+        t_CKBOOL async = gather( now, chain ) && m_async;
+        // nothing to do
+        if( chain.empty() ) return FALSE;
+
+        job = new Chuck_UAna_Job;
+        job->now = now;
+        job->chain.swap( chain );
+        job->worker = worker;
+        job->notify = NULL;
+        job->done = FALSE;
+
+        // synchronous after all (e.g. IFFT upstream)
+        if( !async )
+        {
+            job->run();
+            delete job;
+            return FALSE;
+        }
+
+        // copy what the audio thread keeps writing, and hold on to the chain
+        for( t_CKUINT i = 0; i < job->chain.size(); i++ )
+        {
+            Chuck_UAna * uana = job->chain[i];
+            if( uana->snap ) uana->snap( uana, uana, Chuck_DL_Api::Api::instance() );
+            uana->m_job = job;
+            uana->add_ref();
+        }
+        worker->submit( job );
+    }
+
+    // no shred: announce when completed
+    if( !shred )
+    {
+        if( !job->notify ) { job->notify = this; this->add_ref(); }
+        return TRUE;
+    }
+
+    // suspend until the job is completed (see Chuck_VM::wait_msg)
+    job->waiting.push_back( shred );
+    shred->add_ref();
+    shred->is_running = FALSE;
+    vm->shreduler()->add_blocked( shred );
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: settle()
+// desc: wait for the tock in flight on this uana, if any; called on the vm
+//       thread before anything an async tock uses is read or changed
+//       (ctrl/cget functions, the blob and its arrays)
+//-----------------------------------------------------------------------------
+void Chuck_UAna::settle()
+{
+    if( m_job ) m_job->worker->settle( m_job );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: auto_tock()
+// desc: tock the chain at now, as an upchuck would, but without a shred
+//-----------------------------------------------------------------------------
+void Chuck_UAna::auto_tock( Chuck_VM * vm, t_CKTIME now )
+{
+    // through the analysis worker, once there is one
+    if( m_async || vm->uana_worker( FALSE ) )
+    {
+        // (announced when the job is completed)
+        if( upchuck( vm, NULL, now ) ) return;
+    }
+    else if( m_uana_time < now )
+        system_tock( now );
+
+    tocked();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: tocked()
+// desc: an auto tock is done
+//-----------------------------------------------------------------------------
+void Chuck_UAna::tocked()
+{
+    if( m_event ) m_event->broadcast();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: run()
+// desc: tock the chain, in order (any thread)
+//-----------------------------------------------------------------------------
+void Chuck_UAna_Job::run()
+{
+    for( t_CKUINT i = 0; i < chain.size(); i++ )
+    {
+        Chuck_UAna * uana = chain[i];
+        // tock the uana
+        if( uana->tock ) uana->m_valid = uana->tock( uana, uana, uana->blobProxy(), NULL, Chuck_DL_Api::Api::instance() );
+        // timestamp the blob
+        uana->blobProxy()->when() = now;
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: Chuck_UAna_Worker()
+// desc: constructor
+//-----------------------------------------------------------------------------
+Chuck_UAna_Worker::Chuck_UAna_Worker()
+{
+    m_vm = NULL;
+    m_threads = NULL;
+    m_num_threads = 0;
+    m_num_finished = 0;
+    m_quit = FALSE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~Chuck_UAna_Worker()
+// desc: destructor
+//-----------------------------------------------------------------------------
+Chuck_UAna_Worker::~Chuck_UAna_Worker()
+{
+    this->stop();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: start()
+// desc: start the threads
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_UAna_Worker::start( Chuck_VM * vm, t_CKUINT num_threads )
+{
+    if( m_threads ) return TRUE;
+
+    m_vm = vm;
+    m_quit = FALSE;
+    m_threads = new XThread[num_threads > 0 ? num_threads : 1];
+    for( m_num_threads = 0; m_num_threads < num_threads; m_num_threads++ )
+        if( !m_threads[m_num_threads].start( worker_cb, this ) )
+            break;
+
+    // none, none at all
+    if( !m_num_threads )
+    {
+        SAFE_DELETE_ARRAY( m_threads );
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: stop()
+// desc: join the threads, then run and complete whatever is left
+//-----------------------------------------------------------------------------
+void Chuck_UAna_Worker::stop()
+{
+    if( !m_threads ) return;
+
+    m_lock.acquire();
+    m_quit = TRUE;
+    m_wake.signal_all();
+    m_lock.release();
+
+    for( t_CKUINT i = 0; i < m_num_threads; i++ )
+        m_threads[i].wait( -1, false );
+    SAFE_DELETE_ARRAY( m_threads );
+    m_num_threads = 0;
+
+    // no one else is left
+    while( !m_queue.empty() )
+    {
+        Chuck_UAna_Job * job = m_queue.front();
+        m_queue.pop_front();
+        job->run();
+        complete( job );
+    }
+    this->finish();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: submit()
+// desc: queue a job for the threads
+//-----------------------------------------------------------------------------
+void Chuck_UAna_Worker::submit( Chuck_UAna_Job * job )
+{
+    m_lock.acquire();
+    m_queue.push_back( job );
+    m_wake.signal_all();
+    m_lock.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: settle()
+// desc: run job here if no thread has taken it yet, else wait for it to be
+//       done; then complete it
+//-----------------------------------------------------------------------------
+void Chuck_UAna_Worker::settle( Chuck_UAna_Job * job )
+{
+    m_lock.acquire();
+    std::deque<Chuck_UAna_Job *>::iterator q;
+    q = std::find( m_queue.begin(), m_queue.end(), job );
+    if( q != m_queue.end() )
+    {
+        // take it back
+        m_queue.erase( q );
+        m_lock.release();
+        job->run();
+    }
+    else
+    {
+        // wait for it
+        while( !job->done )
+            m_done.wait( m_lock );
+        // it's ours to complete
+        m_finished.erase( std::find( m_finished.begin(), m_finished.end(), job ) );
+        m_num_finished = m_finished.size();
+        m_lock.release();
+    }
+
+    complete( job );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: finish()
+// desc: complete the jobs done since the last call; returns how many
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_UAna_Worker::finish()
+{
+    // usually nothing
+    if( !xatomic_load( &m_num_finished ) ) return 0;
+
+    std::vector<Chuck_UAna_Job *> done;
+    m_lock.acquire();
+    done.swap( m_finished );
+    m_num_finished = 0;
+    m_lock.release();
+
+    for( t_CKUINT i = 0; i < done.size(); i++ )
+        complete( done[i] );
+
+    return done.size();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: complete()
+// desc: resume the waiting shreds at now_system, release everything
+//-----------------------------------------------------------------------------
+void Chuck_UAna_Worker::complete( Chuck_UAna_Job * job )
+{
+    t_CKUINT i;
+
+    for( i = 0; i < job->chain.size(); i++ )
+    {
+        job->chain[i]->m_job = NULL;
+        job->chain[i]->release();
+    }
+
+    Chuck_VM_Shreduler * shreduler = m_vm->shreduler();
+    for( i = 0; i < job->waiting.size(); i++ )
+    {
+        Chuck_VM_Shred * shred = job->waiting[i];
+        if( !shred->is_done )
+        {
+            shreduler->remove_blocked( shred );
+            shreduler->shredule( shred, shreduler->now_system );
+        }
+        shred->release();
+    }
+
+    // auto tock
+    if( job->notify )
+    {
+        job->notify->tocked();
+        job->notify->release();
+    }
+
+    delete job;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: worker_cb()
+// desc: thread function
+//-----------------------------------------------------------------------------
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+void * Chuck_UAna_Worker::worker_cb( void * _worker )
+#elif defined(__PLATFORM_WIN32__)
+unsigned Chuck_UAna_Worker::worker_cb( void * _worker )
+#endif
+{
+    Chuck_UAna_Worker * worker = (Chuck_UAna_Worker *)_worker;
+
+    worker->m_lock.acquire();
+    while( TRUE )
+    {
+        // wait for a job
+        while( !worker->m_quit && worker->m_queue.empty() )
+            worker->m_wake.wait( worker->m_lock );
+        if( worker->m_quit ) break;
+
+        Chuck_UAna_Job * job = worker->m_queue.front();
+        worker->m_queue.pop_front();
+
+        worker->m_lock.release();
+        job->run();
+        worker->m_lock.acquire();
+
+        // report back
+        job->done = TRUE;
+        worker->m_finished.push_back( job );
+        xatomic_store( &worker->m_num_finished, worker->m_finished.size() );
+        worker->m_done.signal_all();
+    }
+    worker->m_lock.release();
+
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: ugen_generic_num_in()
 // dsec: get number of input channels for ugen or ugen array
@@ -39,11 +39,19 @@
 #include "chuck_def.h"
 #include "chuck_oo.h"
 #include "chuck_dl.h"
+#include <vector>
+#include <deque>
 
 
 // forward reference
+struct Chuck_VM;
 struct Chuck_VM_Shred;
+struct Chuck_VM_Shreduler;
 struct Chuck_UAnaBlobProxy;
+struct Chuck_UAna_Job;
+struct Chuck_UAna_Worker;
+struct XWorkPool;
+struct Profile_Entry;
 
 
 // op mode
@@ -51,6 +59,9 @@ struct Chuck_UAnaBlobProxy;
 #define UGEN_OP_STOP    0
 #define UGEN_OP_TICK    1
 
+// default UAna.hop (samples)
+#define CK_UANA_DEFAULT_HOP 512
+
 
 
 
@@ -76,6 +87,11 @@ public: // src
     t_CKUINT disconnect( t_CKBOOL recursive );
     t_CKUINT system_tick( t_CKTIME now );
     t_CKUINT system_tick_v( t_CKTIME now, t_CKUINT numFrames );
+    // the non-recursive halves of a tick, run in order by Chuck_UGen_Schedule
+    void system_gather();
+    t_CKBOOL system_compute();
+    void system_gather_v( t_CKUINT numFrames );
+    t_CKBOOL system_compute_v( t_CKUINT numFrames );
     t_CKBOOL alloc_v( t_CKUINT size );
     
     Chuck_UGen *src_chan( t_CKUINT chan );
@@ -90,6 +106,8 @@ public:
     f_tick tick;
     // multichannel/vectorized tick function (added 1.3.0.0)
     f_tickf tickf;
+    // single-channel block tick function
+    f_tickv tickv;
     // msg function
     f_pmsg pmsg;
     // channels (if more than one is required)
@@ -152,6 +170,89 @@ public: // data
     
     // what a hack!
     t_CKBOOL m_is_uana;
+
+    // last schedule compile that visited this ugen
+    t_CKUINT m_sched_mark;
+    // profiler entry, once profiled
+    Profile_Entry * m_profile;
+
+public:
+    // bumped whenever any connection changes; schedules rebuild on mismatch
+    static t_CKUINT our_graph_version;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_UGen_Schedule
+// dsec: the ugen graph reachable from a set of roots (dac, blackhole)
+//       flattened into the exact order the recursive system_tick() would
+//       gather and compute each ugen; ticking is a linear pass over it.
+//       feedback edges read the previous sample, as with the recursion.
+//-----------------------------------------------------------------------------
+struct Chuck_UGen_Schedule
+{
+public:
+    Chuck_UGen_Schedule();
+
+public:
+    // set the graph roots, in tick order, and a ugen fed from outside (adc)
+    void set_roots( Chuck_UGen ** roots, t_CKUINT num_roots, Chuck_UGen * input );
+    // tick one sample / one block; rebuilds first if the graph changed
+    void tick( t_CKTIME now );
+    void tick_v( t_CKTIME now, t_CKUINT numFrames );
+    // rebuild the flat order now
+    void compile();
+    // number of steps in the current order
+    t_CKUINT size() const { return m_steps.size(); }
+    // render independent parts on a pool in tick_v(); NULL to turn off
+    void set_pool( XWorkPool * pool, t_CKUINT min_frames );
+    // number of parts rendered on the pool (0: all serial)
+    t_CKUINT num_parts() const { return m_tasks.size(); }
+
+protected:
+    void visit( Chuck_UGen * ugen );
+    void partition();
+
+protected:
+    // step ops
+    enum { STEP_TICK = 0, STEP_GATHER, STEP_COMPUTE, STEP_LAST };
+    // one step of the pass
+    struct Step
+    {
+        Chuck_UGen * ugen;
+        t_CKUINT op;
+    };
+
+    // the flat order
+    std::vector<Step> m_steps;
+    // roots, in tick order
+    std::vector<Chuck_UGen *> m_roots;
+    // fed from outside the graph; never ticked
+    Chuck_UGen * m_input;
+    // graph version the steps were built from
+    t_CKUINT m_version;
+    // mark for the current compile (shared, so schedules never collide)
+    t_CKUINT m_pass;
+    static t_CKUINT our_pass;
+    // whether the steps have been built
+    t_CKBOOL m_compiled;
+
+    // pool for tick_v(), and the smallest block worth sending there
+    XWorkPool * m_pool;
+    t_CKUINT m_min_frames;
+    // independent parts, largest first, each in step order
+    std::vector< std::vector<Step> > m_tasks;
+    // the steps left for the calling thread, in order
+    std::vector<Step> m_serial;
+    // the block the pool is rendering
+    t_CKTIME m_now;
+    t_CKUINT m_frames;
+
+protected:
+    t_CKBOOL run_v( const Step * step, const Step * end, t_CKTIME now, t_CKUINT numFrames );
+    static void run_task( void * data, t_CKUINT task );
 };
 
 
@@ -171,19 +272,133 @@ public:
     t_CKBOOL system_tock( t_CKTIME now );
     t_CKBOOL is_up_connected_from( Chuck_UAna * src );
 
+public: // async tock (see Chuck_UAna_Worker)
+    // upchuck at now, through the vm's analysis worker; returns TRUE if
+    // the chain tocks later: shred (if not NULL) is suspended until then,
+    // else the tock is announced (see tocked()) when done
+    t_CKBOOL upchuck( Chuck_VM * vm, Chuck_VM_Shred * shred, t_CKTIME now );
+    // wait for the tock in flight on this uana, if any
+    void settle();
+
+public: // auto tock (see Chuck_VM_Shreduler::auto_tock())
+    // tock the chain at now, no shred involved
+    void auto_tock( Chuck_VM * vm, t_CKTIME now );
+    // an auto tock is done: broadcast m_event, if any
+    void tocked();
+
 public: // blob retrieval
     t_CKINT numIncomingUAnae() const;
     Chuck_UAna * getIncomingUAna( t_CKUINT index ) const;
     Chuck_UAnaBlobProxy * getIncomingBlob( t_CKUINT index ) const;
     Chuck_UAnaBlobProxy * blobProxy() const;
 
+protected:
+    // mark the chain upstream of this (and this) as tocked at now, and list
+    // in tock order the uanas that need it; returns TRUE if all may tock
+    // on another thread
+    t_CKBOOL gather( t_CKTIME now, std::vector<Chuck_UAna *> & chain );
+
 public:
     // tock function
     f_tock tock;
+    // copy tick state for an async tock (can be NULL)
+    f_snap snap;
 
 public: // data
     t_CKTIME m_uana_time;
     // Chuck_UAnaBlobProxy * m_blob_proxy;
+    // this type may tock on another thread
+    t_CKBOOL m_async_ok;
+    // upchuck() on this tocks on another thread (see UAna.async())
+    t_CKBOOL m_async;
+    // the tock in flight on this, or NULL
+    Chuck_UAna_Job * m_job;
+    // tock every m_hop samples (see UAna.autoTock()), next at m_auto_next
+    t_CKDUR m_hop;
+    t_CKTIME m_auto_next;
+    // the shreduler tocking this, or NULL
+    Chuck_VM_Shreduler * m_auto_sched;
+    // broadcast after each auto tock (NULL until UAna.event())
+    Chuck_Event * m_event;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_UAna_Job
+// desc: one async upchuck: a chain of uanas to tock, in order, at now
+//-----------------------------------------------------------------------------
+struct Chuck_UAna_Job
+{
+    // time of the upchuck
+    t_CKTIME now;
+    // the uanas to tock, upstream first (each referenced)
+    std::vector<Chuck_UAna *> chain;
+    // shreds suspended until done (each referenced)
+    std::vector<Chuck_VM_Shred *> waiting;
+    // the worker it was submitted to
+    Chuck_UAna_Worker * worker;
+    // uana to announce when done (auto tock; referenced), or NULL
+    Chuck_UAna * notify;
+    // tocked (set under the worker's lock)
+    t_CKBOOL done;
+
+    // tock the chain
+    void run();
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_UAna_Worker
+// desc: threads tocking async uana chains off the audio thread.  jobs are
+//       submitted and completed (shreds resumed, references released) by
+//       the vm thread only; the threads just run them.
+//-----------------------------------------------------------------------------
+struct Chuck_UAna_Worker
+{
+public:
+    Chuck_UAna_Worker();
+    ~Chuck_UAna_Worker();
+
+public:
+    // start num_threads threads
+    t_CKBOOL start( Chuck_VM * vm, t_CKUINT num_threads );
+    // join the threads, then run and complete whatever is left
+    void stop();
+
+public: // vm thread
+    // queue job
+    void submit( Chuck_UAna_Job * job );
+    // run job here if not yet started, else wait for it; then complete it
+    void settle( Chuck_UAna_Job * job );
+    // complete the jobs done since last time; returns how many
+    t_CKUINT finish();
+
+protected:
+    // resume the waiting shreds, release everything, delete job
+    void complete( Chuck_UAna_Job * job );
+    // thread function
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    static void * worker_cb( void * _worker );
+#elif defined(__PLATFORM_WIN32__)
+    static unsigned THREAD_TYPE worker_cb( void * _worker );
+#endif
+
+protected:
+    Chuck_VM * m_vm;
+    XThread * m_threads;
+    t_CKUINT m_num_threads;
+    XMutex m_lock;
+    XCondition m_wake;
+    XCondition m_done;
+    std::deque<Chuck_UAna_Job *> m_queue;
+    std::vector<Chuck_UAna_Job *> m_finished;
+    // size of m_finished, checked without the lock
+    volatile t_CKUINT m_num_finished;
+    t_CKBOOL m_quit;
 };
 
 
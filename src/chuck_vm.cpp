@@ -59,6 +59,13 @@ using namespace std;
 #define CK_VM_DEBUG(x)
 #endif // CK_VM_DEBUG_ENABLE
 
+// threaded interpreter dispatches through computed goto where available
+#if defined(__GNUC__)
+#define CK_VM_COMPUTED_GOTO (1)
+#else
+#define CK_VM_COMPUTED_GOTO (0)
+#endif
+
 
 
 
@@ -130,11 +137,16 @@ Chuck_VM::Chuck_VM()
     m_num_shreds = 0;
     m_shreduler = NULL;
     m_num_dumped_shreds = 0;
+    m_shred_pool = NULL;
+    m_render_pool = NULL;
+    m_uana_worker = NULL;
+    m_uana_threads = 1;
     m_msg_buffer = NULL;
     m_reply_buffer = NULL;
     m_event_buffer = NULL;
     m_shred_id = 0;
     m_halt = TRUE;
+    m_threaded = TRUE;
 
     m_dac = NULL;
     m_adc = NULL;
@@ -251,7 +263,9 @@ t_CKBOOL Chuck_VM::set_priority( t_CKINT priority, Chuck_VM * vm )
 // desc: ...
 //-----------------------------------------------------------------------------
 t_CKBOOL Chuck_VM::initialize( t_CKUINT srate, t_CKUINT dac_chan,
-                               t_CKUINT adc_chan, t_CKUINT adaptive, t_CKBOOL halt )
+                               t_CKUINT adc_chan, t_CKUINT adaptive, t_CKBOOL halt,
+                               t_CKUINT shred_pool_size, t_CKUINT render_threads,
+                               t_CKUINT uana_threads )
 {
     if( m_init )
     {
@@ -267,6 +281,7 @@ t_CKBOOL Chuck_VM::initialize( t_CKUINT srate, t_CKUINT dac_chan,
     m_num_adc_channels = adc_chan;
     m_num_dac_channels = dac_chan;
     m_srate = srate;
+    m_uana_threads = uana_threads > 0 ? uana_threads : 1;
 
     // lockdown
     Chuck_VM_Object::lock_all();
@@ -278,16 +293,33 @@ t_CKBOOL Chuck_VM::initialize( t_CKUINT srate, t_CKUINT dac_chan,
     m_shreduler->vm_ref = this;
     m_shreduler->set_adaptive( adaptive > 0 ? adaptive : 0 );
 
+    // log
+    EM_log( CK_LOG_SYSTEM, "allocating shred pool (%lu shreds)...", shred_pool_size );
+    // allocate shred pool
+    m_shred_pool = new Chuck_VM_Shred_Pool;
+    m_shred_pool->initialize( shred_pool_size );
+
+    // render threads (used in adaptive block processing only)
+    if( render_threads > 1 )
+    {
+        // log
+        EM_log( CK_LOG_SYSTEM, "starting render threads (%lu)...", render_threads );
+        m_render_pool = new XWorkPool;
+        m_render_pool->initialize( render_threads );
+        if( !m_shreduler->m_adaptive )
+            EM_log( CK_LOG_WARNING, "render threads need adaptive block processing (--adaptive)" );
+    }
+
     // log
     EM_log( CK_LOG_SYSTEM, "allocating messaging buffers..." );
     // allocate msg buffer
-    m_msg_buffer = new CBufferSimple;
+    m_msg_buffer = new CBufferMPSC;
     m_msg_buffer->initialize( 1024, sizeof(Chuck_Msg *) );
     //m_msg_buffer->join(); // this should return 0
     m_reply_buffer = new CBufferSimple;
     m_reply_buffer->initialize( 1024, sizeof(Chuck_Msg *) );
     //m_reply_buffer->join(); // this should return 0 too
-    m_event_buffer = new CBufferSimple;
+    m_event_buffer = new CBufferMPSC;
     m_event_buffer->initialize( 1024, sizeof(Chuck_Event *) );
     //m_event_buffer->join(); // this should also return 0
 
@@ -372,6 +404,10 @@ t_CKBOOL Chuck_VM::initialize_synthesis( )
     m_shreduler->m_bunghole = m_bunghole;
     m_shreduler->m_num_dac_channels = m_num_dac_channels;
     m_shreduler->m_num_adc_channels = m_num_adc_channels;
+    // dac first, then bunghole, as advance() always ticked them
+    Chuck_UGen * roots[2] = { m_dac, m_bunghole };
+    m_shreduler->m_schedule.set_roots( roots, 2, m_adc );
+    m_shreduler->m_schedule.set_pool( m_render_pool, CVM_RENDER_MIN_FRAMES );
 
     // pop indent
     EM_poplog();
@@ -398,6 +434,15 @@ t_CKBOOL Chuck_VM::shutdown()
     // unlockdown
     Chuck_VM_Object::unlock_all();
 
+    // finish any async tocks (the shreduler takes their shreds back)
+    if( m_uana_worker )
+    {
+        // log
+        EM_log( CK_LOG_SYSTEM, "stopping uana threads..." );
+        m_uana_worker->stop();
+        SAFE_DELETE( m_uana_worker );
+    }
+
     // log
     EM_log( CK_LOG_SYSTEM, "freeing shreduler..." );
     // free the shreduler
@@ -433,6 +478,19 @@ t_CKBOOL Chuck_VM::shutdown()
     this->release_dump();
     EM_poplog();
 
+    // log
+    EM_log( CK_LOG_SYSTEM, "freeing shred pool..." );
+    // report and free
+    if( m_shred_pool ) m_shred_pool->report();
+    SAFE_DELETE( m_shred_pool );
+    // and the object allocator's
+    Chuck_VM_Alloc::instance()->report();
+
+    // log
+    EM_log( CK_LOG_SYSTEM, "stopping render threads..." );
+    // (the shreduler, and its schedule, are already gone)
+    SAFE_DELETE( m_render_pool );
+
     // log
     EM_log( CK_LOG_SYSTEM, "freeing special ugens..." );
     // go
@@ -523,12 +581,15 @@ t_CKBOOL Chuck_VM::compute()
 
             // track shred activation
             CK_TRACK( Chuck_Stats::instance()->activate_shred( shred ) );
+            // time it, if profiling or in a block under a deadline
+            t_CKTICKS ticks = ( Chuck_Profiler::our_on || m_deadline.in_block() ) ? Chuck_Profiler::now() : 0;
 
             // run the shred
             if( !shred->run( this ) )
             {
                 // track shred deactivation
                 CK_TRACK( Chuck_Stats::instance()->deactivate_shred( shred ) );
+                if( ticks ) this->shred_ran( shred, ticks );
 
                 this->free( shred, TRUE );
                 shred = NULL;
@@ -537,6 +598,7 @@ t_CKBOOL Chuck_VM::compute()
 
             // track shred deactivation
             CK_TRACK( if( shred ) Chuck_Stats::instance()->deactivate_shred( shred ) );
+            if( ticks && shred ) this->shred_ran( shred, ticks );
 
             // zero out
             shred = NULL;
@@ -545,6 +607,10 @@ t_CKBOOL Chuck_VM::compute()
         // set to false for now
         iterate = FALSE;
 
+        // tock the uanas due now, then run whoever waits on them
+        if( m_shreduler->auto_tock() )
+            iterate = TRUE;
+
         // broadcast queued events
         while( m_event_buffer->get( &event, 1 ) )
         { event->broadcast(); iterate = TRUE; }
@@ -559,7 +625,11 @@ t_CKBOOL Chuck_VM::compute()
 
         // process messages
         while( m_msg_buffer->get( &msg, 1 ) )
-        { process_msg( msg ); iterate = TRUE; }
+        { m_deadline.msg_processed(); process_msg( msg ); iterate = TRUE; }
+
+        // resume shreds whose async upchuck is done
+        if( m_uana_worker && m_uana_worker->finish() )
+            iterate = TRUE;
 
         // clear dumped shreds
         if( m_num_dumped_shreds > 0 )
@@ -573,6 +643,21 @@ t_CKBOOL Chuck_VM::compute()
 
 
 
+//-----------------------------------------------------------------------------
+// name: shred_ran()
+// desc: a timed shred activation is done
+//-----------------------------------------------------------------------------
+void Chuck_VM::shred_ran( Chuck_VM_Shred * shred, t_CKTICKS start )
+{
+    if( m_deadline.in_block() )
+        m_deadline.shred_ran( shred->xid, Chuck_Profiler::now() - start );
+    if( Chuck_Profiler::our_on )
+        Chuck_Profiler::instance()->shred_ran( shred, Chuck_Profiler::instance()->since( start ) );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: run()
 // desc: ...
@@ -651,13 +736,61 @@ void Chuck_VM::gc( )
 t_CKBOOL Chuck_VM::queue_msg( Chuck_Msg * msg, int count )
 {
     assert( count == 1 );
-    m_msg_buffer->put( &msg, count );
+    // the otf listener and the compile worker may both queue; neither
+    // is the audio thread, so wait for room rather than drop a message
+    while( !m_msg_buffer->put( &msg, count ) )
+        usleep( 1000 );
     return TRUE;
 }
 
 
 
 
+//-----------------------------------------------------------------------------
+// name: wait_msg()
+// desc: suspend shred (inside a native call) until msg is processed
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM::wait_msg( Chuck_VM_Shred * shred, Chuck_Msg * msg )
+{
+    // where the native call will push its return value
+    msg->waiting = shred;
+    msg->waiting_result = (t_CKUINT *)shred->reg->sp;
+    // keep it around, even if it is removed in the meantime
+    shred->add_ref();
+
+    // suspend
+    shred->is_running = FALSE;
+    m_shreduler->add_blocked( shred );
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: uana_worker()
+// desc: the async UAna worker; started on first use, if create
+//-----------------------------------------------------------------------------
+Chuck_UAna_Worker * Chuck_VM::uana_worker( t_CKBOOL create )
+{
+    if( m_uana_worker || !create ) return m_uana_worker;
+
+    // log
+    EM_log( CK_LOG_SYSTEM, "starting uana threads (%lu)...", m_uana_threads );
+    m_uana_worker = new Chuck_UAna_Worker;
+    if( !m_uana_worker->start( this, m_uana_threads ) )
+    {
+        EM_log( CK_LOG_WARNING, "cannot start uana threads; upchuck stays synchronous" );
+        SAFE_DELETE( m_uana_worker );
+    }
+
+    return m_uana_worker;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: queue_event()
 // desc: since 1.3.0.0 a buffer is passed in associated with each thread
@@ -667,14 +800,12 @@ t_CKBOOL Chuck_VM::queue_event( Chuck_Event * event, int count,
 {
     // sanity
     assert( count == 1 );
-    // if null
+    // if null, use the buffer shared by all threads
     if( buffer == NULL )
-    {
-        // use non thread-safe buffer
-        buffer = m_event_buffer;
-    }
-    // put into the buffer
-    buffer->put( &event, count );
+        m_event_buffer->put( &event, count );
+    // else the calling thread's own
+    else
+        buffer->put( &event, count );
 
     // done
     return TRUE;
@@ -736,6 +867,17 @@ t_CKUINT Chuck_VM::process_msg( Chuck_Msg * msg )
 {
     t_CKUINT retval = 0xfffffff0;
 
+    // finish compiling what the compile worker parsed
+    if( msg->compile ) msg->compile( msg );
+
+    // add/replace whose compile failed (queued for the shred waiting on it)
+    if( ( msg->type == MSG_ADD || msg->type == MSG_REPLACE ) &&
+        !msg->code && !msg->shred )
+    {
+        retval = 0;
+        goto done;
+    }
+
     if( msg->type == MSG_REPLACE )
     {
         Chuck_VM_Shred * out = m_shreduler->lookup( msg->param );
@@ -750,8 +892,9 @@ t_CKUINT Chuck_VM::process_msg( Chuck_Msg * msg )
         Chuck_VM_Shred * shred = msg->shred;
         if( !shred )
         {
-            shred = new Chuck_VM_Shred;
-            shred->initialize( msg->code );
+            shred = m_shred_pool->get_shred();
+            shred->initialize( msg->code, CVM_MEM_STACK_SIZE,
+                               CVM_REG_STACK_SIZE, m_shred_pool );
             shred->name = msg->code->name;
             shred->base_ref = shred->mem;
             shred->add_ref();
@@ -941,6 +1084,20 @@ t_CKUINT Chuck_VM::process_msg( Chuck_Msg * msg )
 
 done:
 
+    // resume the shred waiting on this, with the result
+    if( msg->waiting )
+    {
+        Chuck_VM_Shred * shred = msg->waiting;
+        if( !shred->is_done )
+        {
+            *(msg->waiting_result) = retval;
+            m_shreduler->remove_blocked( shred );
+            m_shreduler->shredule( shred, m_shreduler->now_system );
+        }
+        shred->release();
+        msg->waiting = NULL;
+    }
+
     if( msg->reply )
     {
         msg->replyA = retval;
@@ -1009,10 +1166,10 @@ Chuck_VM_Shred * Chuck_VM::fork( Chuck_VM_Code * code )
 //-----------------------------------------------------------------------------
 Chuck_VM_Shred * Chuck_VM::spork( Chuck_VM_Code * code, Chuck_VM_Shred * parent )
 {
-    // allocate a new shred
-    Chuck_VM_Shred * shred = new Chuck_VM_Shred;
-    // initialize the shred (default stack size)
-    shred->initialize( code );
+    // get a shred (recycled, if the pool has one)
+    Chuck_VM_Shred * shred = m_shred_pool->get_shred();
+    // initialize the shred (default stack size, stacks from the pool)
+    shred->initialize( code, CVM_MEM_STACK_SIZE, CVM_REG_STACK_SIZE, m_shred_pool );
     // set the name
     shred->name = code->name;
     // set the parent
@@ -1102,6 +1259,7 @@ t_CKBOOL Chuck_VM::free( Chuck_VM_Shred * shred, t_CKBOOL cascade, t_CKBOOL dec
 
     // track remove shred
     CK_TRACK( Chuck_Stats::instance()->remove_shred( shred ) );
+    if( shred->profile ) Chuck_Profiler::instance()->shred_done( shred );
 
     // free!
     m_shreduler->remove( shred );
@@ -1183,7 +1341,13 @@ void Chuck_VM::release_dump( )
 
     // iterate through dump
     for( t_CKUINT i = 0; i < m_shred_dump.size(); i++ )
-        SAFE_RELEASE( m_shred_dump[i] );
+    {
+        // back to the pool, if it will take it
+        if( m_shred_pool && m_shred_pool->recycle( m_shred_dump[i] ) )
+            m_shred_dump[i] = NULL;
+        else
+            SAFE_RELEASE( m_shred_dump[i] );
+    }
 
     // clear the dump
     m_shred_dump.clear();
@@ -1245,6 +1409,8 @@ Chuck_VM_Stack::Chuck_VM_Stack()
     stack = sp = sp_max = NULL;
     prev = next = NULL;
     m_is_init = FALSE;
+    m_size = 0;
+    m_is_dirty = FALSE;
 }
 
 
@@ -1274,6 +1440,7 @@ Chuck_VM_Code::Chuck_VM_Code()
     need_this = FALSE;
     native_func = 0;
     native_func_type = NATIVE_UNKNOWN;
+    ops = NULL;
 }
 
 
@@ -1296,12 +1463,49 @@ Chuck_VM_Code::~Chuck_VM_Code()
         SAFE_DELETE_ARRAY( instr );
     }
 
+    // free threaded code
+    SAFE_DELETE_ARRAY( ops );
+
     num_instr = 0;
 }
 
 
 
 
+//-----------------------------------------------------------------------------
+// name: translate()
+// desc: build the threaded form of the instructions; handlers holds the
+//       interpreter's label per opcode, or NULL when it dispatches by switch
+//-----------------------------------------------------------------------------
+Chuck_Instr_Op * Chuck_VM_Code::translate( const void * const * handlers )
+{
+    t_CKUINT ported = 0;
+
+    // once
+    if( ops ) return ops;
+
+    ops = new Chuck_Instr_Op[num_instr];
+    for( t_CKUINT i = 0; i < num_instr; i++ )
+    {
+        ops[i].a.u = 0;
+        ops[i].b = 0;
+        ops[i].instr = instr[i];
+        // native handler, else back to execute()
+        if( instr[i]->translate( ops[i] ) ) ported++;
+        else ops[i].code = CK_OP_FALLBACK;
+        ops[i].handler = handlers ? handlers[ops[i].code] : NULL;
+    }
+
+    // log
+    EM_log( CK_LOG_FINE, "threaded code '%s': %lu of %lu instructions native",
+            name.c_str(), ported, num_instr );
+
+    return ops;
+}
+
+
+
+
 // offset in bytes at the beginning of a stack for initializing data
 #define VM_STACK_OFFSET  16
 // 1/factor of stack is left blank, to give room to detect overflow
@@ -1315,6 +1519,8 @@ t_CKBOOL Chuck_VM_Stack::initialize( t_CKUINT size )
     if( m_is_init )
         return FALSE;
 
+    // remember usable size
+    m_size = size;
     // make room for header
     size += VM_STACK_OFFSET;
     // allocate stack
@@ -1363,6 +1569,30 @@ t_CKBOOL Chuck_VM_Stack::shutdown()
 
     // set the flag to false
     m_is_init = FALSE;
+    m_is_dirty = FALSE;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: reset()
+// desc: rewind for reuse; zero only if a previous shred used it
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Stack::reset()
+{
+    if( !m_is_init )
+        return FALSE;
+
+    // zero, including header
+    if( m_is_dirty )
+        memset( stack - VM_STACK_OFFSET, 0, m_size + VM_STACK_OFFSET );
+
+    // rewind
+    sp = stack;
+    m_is_dirty = FALSE;
 
     return TRUE;
 }
@@ -1376,8 +1606,9 @@ t_CKBOOL Chuck_VM_Stack::shutdown()
 //-----------------------------------------------------------------------------
 Chuck_VM_Shred::Chuck_VM_Shred()
 {
-    mem = new Chuck_VM_Stack;
-    reg = new Chuck_VM_Stack;
+    // stacks are set up in initialize()
+    mem = NULL;
+    reg = NULL;
     code = code_orig = NULL;
     next = prev = NULL;
     instr = NULL;
@@ -1388,10 +1619,13 @@ Chuck_VM_Shred::Chuck_VM_Shred()
     vm_ref = NULL;
     event = NULL;
     xid = 0;
+    wake_index = -1;
+    wake_seq = 0;
     m_serials = NULL;
 
     // set
     CK_TRACK( stat = NULL );
+    profile = NULL;
 }
 
 
@@ -1415,11 +1649,23 @@ Chuck_VM_Shred::~Chuck_VM_Shred()
 //-----------------------------------------------------------------------------
 t_CKBOOL Chuck_VM_Shred::initialize( Chuck_VM_Code * c,
                                      t_CKUINT mem_stack_size, 
-                                     t_CKUINT reg_stack_size )
+                                     t_CKUINT reg_stack_size,
+                                     Chuck_VM_Shred_Pool * pool )
 {
     // allocate mem and reg
-    if( !mem->initialize( mem_stack_size ) ) return FALSE;
-    if( !reg->initialize( reg_stack_size ) ) return FALSE;
+    if( pool )
+    {
+        mem = pool->get_stack( mem_stack_size );
+        reg = pool->get_stack( reg_stack_size );
+    }
+    else
+    {
+        mem = new Chuck_VM_Stack;
+        reg = new Chuck_VM_Stack;
+        if( !mem->initialize( mem_stack_size ) ) return FALSE;
+        if( !reg->initialize( reg_stack_size ) ) return FALSE;
+    }
+    if( !mem || !reg ) return FALSE;
 
     // program counter
     pc = 0;
@@ -1440,9 +1686,16 @@ t_CKBOOL Chuck_VM_Shred::initialize( Chuck_VM_Code * c,
     instr = c->instr;
     // zero out the id
     xid = 0;
+    // clear state left over if recycled
+    parent = NULL;
+    base_ref = NULL;
+    event = NULL;
+    wake_index = -1;
+    prev = next = NULL;
+    args.clear();
 
-    // initialize
-    initialize_object( this, &t_shred );
+    // initialize (recycled shreds keep their object state)
+    if( !type_ref ) initialize_object( this, &t_shred );
 
     return TRUE;
 }
@@ -1573,7 +1826,8 @@ t_CKBOOL Chuck_VM_Shred::add( Chuck_UGen * ugen )
 //-----------------------------------------------------------------------------
 t_CKBOOL Chuck_VM_Shred::remove( Chuck_UGen * ugen )
 {
-    if( !ugen || !m_ugen_map[ugen] )
+    // find (don't insert: ugens can outlive the shred's map, e.g. recycled)
+    if( !ugen || m_ugen_map.find( ugen ) == m_ugen_map.end() )
         return FALSE;
 
     // decrement reference count (added 1.3.0.0)
@@ -1616,6 +1870,13 @@ t_CKVOID Chuck_VM_Shred::add_parent_ref( Chuck_Object * obj )
 //-----------------------------------------------------------------------------
 t_CKBOOL Chuck_VM_Shred::run( Chuck_VM * vm )
 {
+    // the stacks now hold this shred's data (zeroed on reuse)
+    mem->m_is_dirty = reg->m_is_dirty = TRUE;
+
+    // threaded interpreter, unless tracing every instruction
+    if( vm->m_threaded && !CK_VM_DEBUG_ENABLE )
+        return run_threaded( vm );
+
     // get the code
     instr = code->instr;
     is_running = TRUE;
@@ -1664,6 +1925,375 @@ CK_VM_DEBUG(fprintf(stderr, "CK_VM_DEBUG reg sp in: 0x%08lx out: 0x%08lx\n",
 
 
 
+
+//-----------------------------------------------------------------------------
+// name: run_threaded()
+// desc: run() over the translated code: ported instructions execute inline,
+//       with pc and the stack pointers held in locals, and jump straight to
+//       the next handler; the rest go through execute() as in run()
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Shred::run_threaded( Chuck_VM * vm )
+{
+// typed access to stack memory
+#define CK_INT( p )             (*(t_CKINT *)(p))
+#define CK_UINT( p )            (*(t_CKUINT *)(p))
+#define CK_FLOAT( p )           (*(t_CKFLOAT *)(p))
+#if CK_VM_COMPUTED_GOTO
+#define CK_OP_HANDLER( name )   op_##name
+#define CK_OP_DISPATCH()        goto *ip->handler
+#else
+#define CK_OP_HANDLER( name )   case CK_OP_##name
+#define CK_OP_DISPATCH()        goto dispatch
+#endif
+// on to the next instruction
+#define CK_OP_NEXT()            ip++; CK_TRACK( stat->cycles++ ); CK_OP_DISPATCH()
+// to the instruction at index ip->a.u; loops check the vm and abort here
+#define CK_OP_JUMP()            ip = ops + ip->a.u; CK_TRACK( stat->cycles++ ); \
+                                if( !*loop_running || is_abort ) goto done; \
+                                CK_OP_DISPATCH()
+
+#if CK_VM_COMPUTED_GOTO
+    // label per opcode (filled in on first run)
+    static const void * handlers[CK_OP_NUM] = { NULL };
+    if( !handlers[CK_OP_FALLBACK] )
+    {
+        #define CK_OP_LABEL( name ) handlers[CK_OP_##name] = &&op_##name
+        CK_OP_LABEL( ADD_INT ); CK_OP_LABEL( MINUS_INT ); CK_OP_LABEL( TIMES_INT );
+        CK_OP_LABEL( DIVIDE_INT ); CK_OP_LABEL( MOD_INT ); CK_OP_LABEL( PREINC_INT );
+        CK_OP_LABEL( POSTINC_INT ); CK_OP_LABEL( PREDEC_INT ); CK_OP_LABEL( POSTDEC_INT );
+        CK_OP_LABEL( ADD_INT_ASSIGN ); CK_OP_LABEL( MINUS_INT_ASSIGN );
+        CK_OP_LABEL( ADD_DOUBLE ); CK_OP_LABEL( MINUS_DOUBLE ); CK_OP_LABEL( TIMES_DOUBLE );
+        CK_OP_LABEL( DIVIDE_DOUBLE ); CK_OP_LABEL( ADD_DOUBLE_ASSIGN );
+        CK_OP_LABEL( LT_INT ); CK_OP_LABEL( GT_INT ); CK_OP_LABEL( LE_INT );
+        CK_OP_LABEL( GE_INT ); CK_OP_LABEL( EQ_INT ); CK_OP_LABEL( NEQ_INT );
+        CK_OP_LABEL( LT_DOUBLE ); CK_OP_LABEL( GT_DOUBLE ); CK_OP_LABEL( LE_DOUBLE );
+        CK_OP_LABEL( GE_DOUBLE ); CK_OP_LABEL( NOT_INT ); CK_OP_LABEL( NEGATE_INT );
+        CK_OP_LABEL( NEGATE_DOUBLE );
+        CK_OP_LABEL( BRANCH_LT_INT ); CK_OP_LABEL( BRANCH_GT_INT ); CK_OP_LABEL( BRANCH_LE_INT );
+        CK_OP_LABEL( BRANCH_GE_INT ); CK_OP_LABEL( BRANCH_EQ_INT ); CK_OP_LABEL( BRANCH_NEQ_INT );
+        CK_OP_LABEL( GOTO ); CK_OP_LABEL( REG_PUSH_IMM ); CK_OP_LABEL( REG_PUSH_IMM2 );
+        CK_OP_LABEL( REG_DUP_LAST ); CK_OP_LABEL( REG_PUSH_MEM ); CK_OP_LABEL( REG_PUSH_MEM2 );
+        CK_OP_LABEL( REG_PUSH_MEM_ADDR ); CK_OP_LABEL( REG_POP_WORD ); CK_OP_LABEL( REG_POP_WORD2 );
+        CK_OP_LABEL( REG_POP_WORD4 ); CK_OP_LABEL( MEM_SET_IMM ); CK_OP_LABEL( ALLOC_WORD );
+        CK_OP_LABEL( ALLOC_WORD2 ); CK_OP_LABEL( ASSIGN_PRIMITIVE ); CK_OP_LABEL( ASSIGN_PRIMITIVE2 );
+        CK_OP_LABEL( CAST_DOUBLE2INT ); CK_OP_LABEL( CAST_INT2DOUBLE ); CK_OP_LABEL( FUNC_TO_CODE );
+        CK_OP_LABEL( REG_POP_TO_MEM ); CK_OP_LABEL( REG_POP_TO_MEM2 ); CK_OP_LABEL( ASSIGN_PRIMITIVE_POP );
+        CK_OP_LABEL( ASSIGN_PRIMITIVE2_POP ); CK_OP_LABEL( INC_INT_MEM );
+        CK_OP_LABEL( REG_PUSH_MEM_OP_IMM ); CK_OP_LABEL( BRANCH_MEM_IMM );
+        #undef CK_OP_LABEL
+        // last, so a partly filled table is never used
+        handlers[CK_OP_FALLBACK] = &&op_FALLBACK;
+    }
+#else
+    const void * const * handlers = NULL;
+#endif
+
+    // get the code
+    Chuck_VM_Code * the_code = code;
+    Chuck_Instr_Op * ops = the_code->translate( handlers );
+    Chuck_Instr_Op * ip = ops + pc;
+    // stacks
+    t_CKBYTE * reg_sp = reg->sp;
+    t_CKBYTE * mem_sp = mem->sp;
+    // globals (chugen tick shreds have no base)
+    t_CKBYTE * base_sp = base_ref ? base_ref->stack : NULL;
+    t_CKINT * ptr;
+    t_CKFLOAT * fptr;
+    t_CKINT temp;
+    Chuck_Instr_Reg_Push_Mem_Op_Imm * mem_op;
+    Chuck_Instr_Branch_Mem_Imm * mem_branch;
+    instr = code->instr;
+    is_running = TRUE;
+    // pointer to running state
+    t_CKBOOL * loop_running = &(vm_ref->runningState());
+
+    // go!
+    if( !*loop_running || is_abort ) goto done;
+    CK_OP_DISPATCH();
+
+#if !CK_VM_COMPUTED_GOTO
+dispatch:
+    switch( ip->code )
+    {
+#endif
+
+    CK_OP_HANDLER( FALLBACK ):
+    fallback:
+        // the instruction sees the same shred state as under run()
+        pc = ip - ops;
+        next_pc = pc + 1;
+        reg->sp = reg_sp;
+        mem->sp = mem_sp;
+        ip->instr->execute( vm, this );
+        CK_TRACK( stat->cycles++ );
+        reg_sp = reg->sp;
+        mem_sp = mem->sp;
+        // function call or return
+        if( code != the_code )
+        {
+            the_code = code;
+            ops = the_code->translate( handlers );
+        }
+        ip = ops + next_pc;
+        if( !is_running || !*loop_running || is_abort ) goto done;
+        CK_OP_DISPATCH();
+
+    // integer arithmetic
+    CK_OP_HANDLER( ADD_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) += CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( MINUS_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) -= CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( TIMES_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) *= CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( DIVIDE_INT ):
+        // execute() reports division by zero
+        if( CK_INT(reg_sp - sz_INT) == 0 ) goto fallback;
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) /= CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( MOD_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) %= CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( PREINC_INT ):
+        ptr = *(t_CKINT **)(reg_sp - sz_UINT); CK_INT(reg_sp - sz_UINT) = ++(*ptr);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( POSTINC_INT ):
+        ptr = *(t_CKINT **)(reg_sp - sz_UINT); CK_INT(reg_sp - sz_UINT) = (*ptr)++;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( PREDEC_INT ):
+        ptr = *(t_CKINT **)(reg_sp - sz_UINT); CK_INT(reg_sp - sz_UINT) = --(*ptr);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( POSTDEC_INT ):
+        ptr = *(t_CKINT **)(reg_sp - sz_UINT); CK_INT(reg_sp - sz_UINT) = (*ptr)--;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( ADD_INT_ASSIGN ):
+        reg_sp -= sz_UINT; ptr = *(t_CKINT **)reg_sp;
+        CK_INT(reg_sp - sz_INT) = (*ptr += CK_INT(reg_sp - sz_INT));
+        CK_OP_NEXT();
+    CK_OP_HANDLER( MINUS_INT_ASSIGN ):
+        reg_sp -= sz_UINT; ptr = *(t_CKINT **)reg_sp;
+        CK_INT(reg_sp - sz_INT) = (*ptr -= CK_INT(reg_sp - sz_INT));
+        CK_OP_NEXT();
+
+    // float arithmetic
+    CK_OP_HANDLER( ADD_DOUBLE ):
+        reg_sp -= sz_FLOAT; CK_FLOAT(reg_sp - sz_FLOAT) += CK_FLOAT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( MINUS_DOUBLE ):
+        reg_sp -= sz_FLOAT; CK_FLOAT(reg_sp - sz_FLOAT) -= CK_FLOAT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( TIMES_DOUBLE ):
+        reg_sp -= sz_FLOAT; CK_FLOAT(reg_sp - sz_FLOAT) *= CK_FLOAT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( DIVIDE_DOUBLE ):
+        reg_sp -= sz_FLOAT; CK_FLOAT(reg_sp - sz_FLOAT) /= CK_FLOAT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( ADD_DOUBLE_ASSIGN ):
+        reg_sp -= sz_UINT; fptr = *(t_CKFLOAT **)reg_sp;
+        CK_FLOAT(reg_sp - sz_FLOAT) = (*fptr += CK_FLOAT(reg_sp - sz_FLOAT));
+        CK_OP_NEXT();
+
+    // comparison
+    CK_OP_HANDLER( LT_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) = CK_INT(reg_sp - sz_INT) < CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( GT_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) = CK_INT(reg_sp - sz_INT) > CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( LE_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) = CK_INT(reg_sp - sz_INT) <= CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( GE_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) = CK_INT(reg_sp - sz_INT) >= CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( EQ_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) = CK_INT(reg_sp - sz_INT) == CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( NEQ_INT ):
+        reg_sp -= sz_INT; CK_INT(reg_sp - sz_INT) = CK_INT(reg_sp - sz_INT) != CK_INT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( LT_DOUBLE ):
+        reg_sp -= sz_FLOAT * 2; temp = CK_FLOAT(reg_sp) < CK_FLOAT(reg_sp + sz_FLOAT);
+        CK_UINT(reg_sp) = temp; reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( GT_DOUBLE ):
+        reg_sp -= sz_FLOAT * 2; temp = CK_FLOAT(reg_sp) > CK_FLOAT(reg_sp + sz_FLOAT);
+        CK_UINT(reg_sp) = temp; reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( LE_DOUBLE ):
+        reg_sp -= sz_FLOAT * 2; temp = CK_FLOAT(reg_sp) <= CK_FLOAT(reg_sp + sz_FLOAT);
+        CK_UINT(reg_sp) = temp; reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( GE_DOUBLE ):
+        reg_sp -= sz_FLOAT * 2; temp = CK_FLOAT(reg_sp) >= CK_FLOAT(reg_sp + sz_FLOAT);
+        CK_UINT(reg_sp) = temp; reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( NOT_INT ):
+        CK_INT(reg_sp - sz_INT) = !CK_INT(reg_sp - sz_INT);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( NEGATE_INT ):
+        CK_INT(reg_sp - sz_INT) = -CK_INT(reg_sp - sz_INT);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( NEGATE_DOUBLE ):
+        CK_FLOAT(reg_sp - sz_FLOAT) = -CK_FLOAT(reg_sp - sz_FLOAT);
+        CK_OP_NEXT();
+
+    // branching
+    CK_OP_HANDLER( BRANCH_LT_INT ):
+        reg_sp -= sz_INT * 2;
+        if( CK_INT(reg_sp) < CK_INT(reg_sp + sz_INT) ) { CK_OP_JUMP(); }
+        CK_OP_NEXT();
+    CK_OP_HANDLER( BRANCH_GT_INT ):
+        reg_sp -= sz_INT * 2;
+        if( CK_INT(reg_sp) > CK_INT(reg_sp + sz_INT) ) { CK_OP_JUMP(); }
+        CK_OP_NEXT();
+    CK_OP_HANDLER( BRANCH_LE_INT ):
+        reg_sp -= sz_INT * 2;
+        if( CK_INT(reg_sp) <= CK_INT(reg_sp + sz_INT) ) { CK_OP_JUMP(); }
+        CK_OP_NEXT();
+    CK_OP_HANDLER( BRANCH_GE_INT ):
+        reg_sp -= sz_INT * 2;
+        if( CK_INT(reg_sp) >= CK_INT(reg_sp + sz_INT) ) { CK_OP_JUMP(); }
+        CK_OP_NEXT();
+    CK_OP_HANDLER( BRANCH_EQ_INT ):
+        reg_sp -= sz_INT * 2;
+        if( CK_INT(reg_sp) == CK_INT(reg_sp + sz_INT) ) { CK_OP_JUMP(); }
+        CK_OP_NEXT();
+    CK_OP_HANDLER( BRANCH_NEQ_INT ):
+        reg_sp -= sz_INT * 2;
+        if( CK_INT(reg_sp) != CK_INT(reg_sp + sz_INT) ) { CK_OP_JUMP(); }
+        CK_OP_NEXT();
+    CK_OP_HANDLER( GOTO ):
+        CK_OP_JUMP();
+
+    // stack
+    CK_OP_HANDLER( REG_PUSH_IMM ):
+        CK_UINT(reg_sp) = ip->a.u; reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_PUSH_IMM2 ):
+        CK_FLOAT(reg_sp) = ip->a.f; reg_sp += sz_FLOAT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_DUP_LAST ):
+        CK_UINT(reg_sp) = CK_UINT(reg_sp - sz_UINT); reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_PUSH_MEM ):
+        CK_UINT(reg_sp) = CK_UINT((ip->b ? base_sp : mem_sp) + ip->a.u); reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_PUSH_MEM2 ):
+        CK_FLOAT(reg_sp) = CK_FLOAT((ip->b ? base_sp : mem_sp) + ip->a.u); reg_sp += sz_FLOAT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_PUSH_MEM_ADDR ):
+        CK_UINT(reg_sp) = (t_CKUINT)((ip->b ? base_sp : mem_sp) + ip->a.u); reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_POP_WORD ):
+        reg_sp -= sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_POP_WORD2 ):
+        reg_sp -= sz_FLOAT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_POP_WORD4 ):
+        reg_sp -= ip->a.u * sz_WORD;
+        CK_OP_NEXT();
+
+    // memory
+    CK_OP_HANDLER( MEM_SET_IMM ):
+        CK_UINT(mem_sp + ip->b) = ip->a.u;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( ALLOC_WORD ):
+        CK_UINT(mem_sp + ip->a.u) = 0;
+        CK_UINT(reg_sp) = (t_CKUINT)(mem_sp + ip->a.u); reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( ALLOC_WORD2 ):
+        CK_FLOAT(mem_sp + ip->a.u) = 0.0;
+        CK_UINT(reg_sp) = (t_CKUINT)(mem_sp + ip->a.u); reg_sp += sz_UINT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( ASSIGN_PRIMITIVE ):
+        reg_sp -= sz_UINT; *(t_CKUINT *)CK_UINT(reg_sp) = CK_UINT(reg_sp - sz_UINT);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( ASSIGN_PRIMITIVE2 ):
+        reg_sp -= sz_UINT; *(t_CKFLOAT *)CK_UINT(reg_sp) = CK_FLOAT(reg_sp - sz_FLOAT);
+        CK_OP_NEXT();
+
+    // casts
+    CK_OP_HANDLER( CAST_DOUBLE2INT ):
+        reg_sp -= sz_FLOAT; temp = (t_CKINT)CK_FLOAT(reg_sp);
+        CK_INT(reg_sp) = temp; reg_sp += sz_INT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( CAST_INT2DOUBLE ):
+        reg_sp -= sz_INT; temp = CK_INT(reg_sp);
+        CK_FLOAT(reg_sp) = (t_CKFLOAT)temp; reg_sp += sz_FLOAT;
+        CK_OP_NEXT();
+
+    // functions
+    CK_OP_HANDLER( FUNC_TO_CODE ):
+        CK_UINT(reg_sp - sz_UINT) = (t_CKUINT)((Chuck_Func *)CK_UINT(reg_sp - sz_UINT))->code;
+        CK_OP_NEXT();
+
+    // superinstructions
+    CK_OP_HANDLER( REG_POP_TO_MEM ):
+        reg_sp -= sz_UINT; CK_UINT((ip->b ? base_sp : mem_sp) + ip->a.u) = CK_UINT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_POP_TO_MEM2 ):
+        reg_sp -= sz_FLOAT; CK_FLOAT((ip->b ? base_sp : mem_sp) + ip->a.u) = CK_FLOAT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( ASSIGN_PRIMITIVE_POP ):
+        reg_sp -= sz_UINT * 2; *(t_CKUINT *)CK_UINT(reg_sp + sz_UINT) = CK_UINT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( ASSIGN_PRIMITIVE2_POP ):
+        reg_sp -= sz_FLOAT + sz_UINT; *(t_CKFLOAT *)CK_UINT(reg_sp + sz_FLOAT) = CK_FLOAT(reg_sp);
+        CK_OP_NEXT();
+    CK_OP_HANDLER( INC_INT_MEM ):
+        CK_INT((ip->b ? base_sp : mem_sp) + ip->a.u) += ((Chuck_Instr_Inc_int_Mem *)ip->instr)->delta;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( REG_PUSH_MEM_OP_IMM ):
+        mem_op = (Chuck_Instr_Reg_Push_Mem_Op_Imm *)ip->instr;
+        CK_INT(reg_sp) = ck_int_op( mem_op->oper, CK_INT((ip->b ? base_sp : mem_sp) + ip->a.u), mem_op->imm );
+        reg_sp += sz_INT;
+        CK_OP_NEXT();
+    CK_OP_HANDLER( BRANCH_MEM_IMM ):
+        mem_branch = (Chuck_Instr_Branch_Mem_Imm *)ip->instr;
+        if( ck_int_op( mem_branch->cmp, CK_INT((ip->b ? base_sp : mem_sp) + mem_branch->src), mem_branch->imm ) )
+        { CK_OP_JUMP(); }
+        CK_OP_NEXT();
+
+#if !CK_VM_COMPUTED_GOTO
+    default:
+        goto fallback;
+    }
+#endif
+
+done:
+    // leave the shred where run() would
+    pc = ip - ops;
+    next_pc = pc + 1;
+    reg->sp = reg_sp;
+    mem->sp = mem_sp;
+
+    // check abort
+    if( is_abort )
+    {
+        // log
+        EM_log( CK_LOG_SYSTEM, "aborting shred (id: %d)", this->xid );
+        // done
+        is_done = TRUE;
+    }
+
+#undef CK_INT
+#undef CK_UINT
+#undef CK_FLOAT
+#undef CK_OP_HANDLER
+#undef CK_OP_DISPATCH
+#undef CK_OP_NEXT
+#undef CK_OP_JUMP
+
+    // is the shred finished
+    return !is_done;
+}
+
+
+
 //-----------------------------------------------------------------------------
 // name: add_serialio()
 // desc: ...
@@ -1743,6 +2373,242 @@ bool Chuck_VM_Shred::popLoopCounter()
 
 
 
+//-----------------------------------------------------------------------------
+// name: Chuck_VM_Shred_Pool()
+// desc: ...
+//-----------------------------------------------------------------------------
+Chuck_VM_Shred_Pool::Chuck_VM_Shred_Pool()
+{
+    m_capacity = 0;
+    m_shred_hits = m_shred_misses = 0;
+    m_stack_hits = m_stack_misses = 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~Chuck_VM_Shred_Pool()
+// desc: ...
+//-----------------------------------------------------------------------------
+Chuck_VM_Shred_Pool::~Chuck_VM_Shred_Pool()
+{
+    this->shutdown();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: initialize()
+// desc: preallocate shreds and default-size stacks
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Shred_Pool::initialize( t_CKUINT num_shreds )
+{
+    m_capacity = num_shreds;
+
+    for( t_CKUINT i = 0; i < num_shreds; i++ )
+    {
+        m_shreds.push_back( new Chuck_VM_Shred );
+
+        // one of each stack per shred
+        Chuck_VM_Stack * mem = new Chuck_VM_Stack;
+        Chuck_VM_Stack * reg = new Chuck_VM_Stack;
+        if( !mem->initialize( 1 << size_class( CVM_MEM_STACK_SIZE ) ) ||
+            !reg->initialize( 1 << size_class( CVM_REG_STACK_SIZE ) ) )
+        {
+            SAFE_DELETE( mem );
+            SAFE_DELETE( reg );
+            return FALSE;
+        }
+        put_stack( mem );
+        put_stack( reg );
+    }
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: shutdown()
+// desc: free everything in the pool
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Shred_Pool::shutdown()
+{
+    // free shreds (ref count is 0; see recycle())
+    for( t_CKUINT i = 0; i < m_shreds.size(); i++ )
+        Chuck_VM_Alloc::instance()->free_object( m_shreds[i] );
+    m_shreds.clear();
+
+    // free stacks
+    for( t_CKUINT c = 0; c <= CVM_STACK_CLASS_MAX - CVM_STACK_CLASS_MIN; c++ )
+    {
+        for( t_CKUINT i = 0; i < m_stacks[c].size(); i++ )
+            SAFE_DELETE( m_stacks[c][i] );
+        m_stacks[c].clear();
+    }
+
+    m_capacity = 0;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: size_class()
+// desc: log2 of the smallest power of two >= size; -1 if too large
+//-----------------------------------------------------------------------------
+t_CKINT Chuck_VM_Shred_Pool::size_class( t_CKUINT size ) const
+{
+    t_CKINT c = CVM_STACK_CLASS_MIN;
+    while( ((t_CKUINT)1 << c) < size )
+        if( ++c > CVM_STACK_CLASS_MAX ) return -1;
+
+    return c;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: get_shred()
+// desc: get a shred, recycled if possible
+//-----------------------------------------------------------------------------
+Chuck_VM_Shred * Chuck_VM_Shred_Pool::get_shred()
+{
+    if( m_shreds.empty() )
+    {
+        m_shred_misses++;
+        return new Chuck_VM_Shred;
+    }
+
+    Chuck_VM_Shred * shred = m_shreds.back();
+    m_shreds.pop_back();
+    m_shred_hits++;
+
+    return shred;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: get_stack()
+// desc: get an initialized stack of at least size bytes
+//-----------------------------------------------------------------------------
+Chuck_VM_Stack * Chuck_VM_Shred_Pool::get_stack( t_CKUINT size )
+{
+    Chuck_VM_Stack * stack = NULL;
+    t_CKINT c = size_class( size );
+
+    // reuse
+    if( c >= 0 && !m_stacks[c - CVM_STACK_CLASS_MIN].empty() )
+    {
+        stack = m_stacks[c - CVM_STACK_CLASS_MIN].back();
+        m_stacks[c - CVM_STACK_CLASS_MIN].pop_back();
+        m_stack_hits++;
+        // zero it now, rather than when it was given back
+        stack->reset();
+    }
+    else
+    {
+        // allocate (full size class, so it can be pooled later)
+        stack = new Chuck_VM_Stack;
+        if( !stack->initialize( c >= 0 ? ((t_CKUINT)1 << c) : size ) )
+        {
+            SAFE_DELETE( stack );
+            return NULL;
+        }
+        m_stack_misses++;
+    }
+
+    return stack;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: put_stack()
+// desc: keep a stack for reuse, or free it
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shred_Pool::put_stack( Chuck_VM_Stack * stack )
+{
+    if( !stack ) return;
+
+    t_CKINT c = size_class( stack->m_size );
+    // only exact size classes are pooled
+    if( c < 0 || ((t_CKUINT)1 << c) != stack->m_size ||
+        m_stacks[c - CVM_STACK_CLASS_MIN].size() >= m_capacity )
+    {
+        delete stack;
+        return;
+    }
+
+    m_stacks[c - CVM_STACK_CLASS_MIN].push_back( stack );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: put_stacks()
+// desc: take back the stacks of a finished shred
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shred_Pool::put_stacks( Chuck_VM_Shred * shred )
+{
+    put_stack( shred->mem );
+    put_stack( shred->reg );
+    shred->mem = shred->reg = NULL;
+    shred->base_ref = NULL;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: recycle()
+// desc: take back a finished shred; if anything besides the VM still
+//       references it, only its stacks are kept and FALSE is returned
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Shred_Pool::recycle( Chuck_VM_Shred * shred )
+{
+    // stacks are never needed after the shred is dumped
+    put_stacks( shred );
+
+    // someone else holds it (e.g. a Shred variable), or pool is full
+    if( shred->m_ref_count != 1 || m_shreds.size() >= m_capacity )
+        return FALSE;
+
+    // release what the shred holds, as the destructor would
+    shred->shutdown();
+    // the pool holds it unreferenced, like a freshly allocated shred
+    shred->m_ref_count = 0;
+    m_shreds.push_back( shred );
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: report()
+// desc: log hit/miss counts
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shred_Pool::report()
+{
+    EM_log( CK_LOG_SYSTEM, "shred pool: shreds %lu hit / %lu miss, stacks %lu hit / %lu miss",
+            m_shred_hits, m_shred_misses, m_stack_hits, m_stack_misses );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: Chuck_VM_Shreduler()
 // desc: ...
@@ -1752,13 +2618,14 @@ Chuck_VM_Shreduler::Chuck_VM_Shreduler()
     now_system = 0;
     rt_audio = FALSE;
     vm_ref = NULL;
-    shred_list = NULL;
+    m_wake_seq = 0;
     m_current_shred = NULL;
     m_dac = NULL;
     m_adc = NULL;
     m_bunghole = NULL;
     m_num_dac_channels = 0;
     m_num_adc_channels = 0;
+    m_next_tock = -1;
     
     set_adaptive( 0 );
 }
@@ -1796,6 +2663,12 @@ t_CKBOOL Chuck_VM_Shreduler::initialize()
 //-----------------------------------------------------------------------------
 t_CKBOOL Chuck_VM_Shreduler::shutdown()
 {
+    // the uanas may outlive us
+    for( t_CKUINT i = 0; i < m_auto_tock.size(); i++ )
+        m_auto_tock[i]->m_auto_sched = NULL;
+    m_auto_tock.clear();
+    m_next_tock = -1;
+
     return TRUE;
 }
 
@@ -1851,6 +2724,60 @@ t_CKBOOL Chuck_VM_Shreduler::remove_blocked( Chuck_VM_Shred * shred )
 
 
 
+//-----------------------------------------------------------------------------
+// name: wake()
+// desc: take shreds off the blocked list and shredule them at now_system,
+//       in the order given; the wake queue is restored once for all of
+//       them, by sifting each up or, for many, by rebuilding it.
+//       returns the number shreduled
+//-----------------------------------------------------------------------------
+t_CKUINT Chuck_VM_Shreduler::wake( Chuck_VM_Shred ** shreds, t_CKUINT count )
+{
+    t_CKUINT first = shred_queue.size();
+    std::map<Chuck_VM_Shred *, Chuck_VM_Shred *>::iterator iter;
+
+    for( t_CKUINT i = 0; i < count; i++ )
+    {
+        Chuck_VM_Shred * shred = shreds[i];
+
+        // no longer blocked
+        iter = blocked.find( shred );
+        if( iter != blocked.end() ) blocked.erase( iter );
+        shred->event = NULL;
+
+        // sanity check (see shredule())
+        if( shred->wake_index >= 0 )
+        {
+            EM_error3( "[chuck](VM): internal sanity check failed in wake()" );
+            EM_error3( "[chuck](VM): (shred shreduled while shreduled)" );
+            continue;
+        }
+
+        shred->wake_time = now_system;
+        shred->wake_seq = m_wake_seq++;
+        shred_queue.push_back( shred );
+        place( shred, shred_queue.size() - 1 );
+    }
+
+    t_CKUINT added = shred_queue.size() - first;
+    // many: rebuild in linear time; few: sift each up
+    if( added > 1 && added * 4 > shred_queue.size() )
+        heapify();
+    else
+    {
+        for( t_CKUINT i = first; i < shred_queue.size(); i++ )
+            sift_up( i );
+    }
+
+    // update
+    update_samps_until_next();
+
+    return added;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: shredule()
 // desc: ...
@@ -1871,7 +2798,7 @@ t_CKBOOL Chuck_VM_Shreduler::shredule( Chuck_VM_Shred * shred,
                                        t_CKTIME wake_time )
 {
     // sanity check
-    if( shred->prev || shred->next )
+    if( shred->wake_index >= 0 )
     {
         // something is really wrong here - no shred can be 
         // shreduled more than once
@@ -1892,48 +2819,222 @@ t_CKBOOL Chuck_VM_Shreduler::shredule( Chuck_VM_Shred * shred,
     }
 
     shred->wake_time = wake_time;
+    // shreds with equal wake times run in the order they were shreduled
+    shred->wake_seq = m_wake_seq++;
 
-    // list empty
-    if( !shred_list )
-        shred_list = shred;
-    else
+    // append and restore heap order
+    shred_queue.push_back( shred );
+    place( shred, shred_queue.size() - 1 );
+    sift_up( shred->wake_index );
+
+    // update
+    update_samps_until_next();
+    
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: wakes_before()
+// desc: wake queue ordering: earlier wake time first, then shredule order
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Shreduler::wakes_before( Chuck_VM_Shred * lhs,
+                                           Chuck_VM_Shred * rhs ) const
+{
+    if( lhs->wake_time != rhs->wake_time )
+        return lhs->wake_time < rhs->wake_time;
+    return lhs->wake_seq < rhs->wake_seq;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: place()
+// desc: put shred at index in the wake queue
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::place( Chuck_VM_Shred * shred, t_CKINT index )
+{
+    shred_queue[index] = shred;
+    shred->wake_index = index;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: heapify()
+// desc: restore heap order over the whole wake queue
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::heapify()
+{
+    for( t_CKINT i = (t_CKINT)shred_queue.size() / 2 - 1; i >= 0; i-- )
+        sift_down( i );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: sift_up()
+// desc: move shred at index toward the root until heap order holds
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::sift_up( t_CKINT index )
+{
+    Chuck_VM_Shred * shred = shred_queue[index];
+
+    while( index > 0 )
     {
-        // pointers to the shred queue
-        Chuck_VM_Shred * curr = shred_list;
-        Chuck_VM_Shred * prev = NULL;
+        t_CKINT parent = (index - 1) >> 1;
+        if( !wakes_before( shred, shred_queue[parent] ) )
+            break;
 
-        while( curr )
-        {
-            // found the place to insert
-            if( curr->wake_time > wake_time )
-                break;
+        place( shred_queue[parent], index );
+        index = parent;
+    }
 
-            prev = curr;
-            curr = curr->next;
-        }
+    place( shred, index );
+}
 
-        if( !prev )
-        {
-            shred->next = shred_list;
-            if( shred_list ) shred_list->prev = shred;
-            shred_list = shred;
-        }
-        else
-        {
-            // insert the shred in sorted order
-            shred->next = prev->next;
-            shred->prev = prev;
-            if( prev->next ) prev->next->prev = shred;
-            prev->next = shred;
-        }
+
+
+
+//-----------------------------------------------------------------------------
+// name: sift_down()
+// desc: move shred at index toward the leaves until heap order holds
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::sift_down( t_CKINT index )
+{
+    t_CKINT size = (t_CKINT)shred_queue.size();
+    Chuck_VM_Shred * shred = shred_queue[index];
+
+    while( TRUE )
+    {
+        t_CKINT child = (index << 1) + 1;
+        if( child >= size )
+            break;
+
+        // pick the earlier of the two children
+        if( child + 1 < size && wakes_before( shred_queue[child+1], shred_queue[child] ) )
+            child++;
+        if( !wakes_before( shred_queue[child], shred ) )
+            break;
+
+        place( shred_queue[child], index );
+        index = child;
     }
 
-    t_CKTIME diff = shred_list->wake_time - this->now_system;
+    place( shred, index );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: update_samps_until_next()
+// desc: recompute samples until the earliest wake (for adaptive mode)
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::update_samps_until_next()
+{
+    // nothing shreduled
+    if( shred_queue.empty() )
+    {
+        m_samps_until_next = -1;
+        return;
+    }
+
+    t_CKTIME diff = shred_queue[0]->wake_time - this->now_system;
     if( diff < 0 ) diff = 0;
-    // if( diff < m_samps_until_next )
     m_samps_until_next = diff;
-    
-    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: add_auto_tock()
+// desc: tock uana every uana->m_hop samples, starting at now
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::add_auto_tock( Chuck_UAna * uana )
+{
+    uana->m_auto_next = this->now_system;
+    if( !uana->m_auto_sched )
+    {
+        uana->m_auto_sched = this;
+        m_auto_tock.push_back( uana );
+    }
+    update_next_tock();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: remove_auto_tock()
+// desc: stop tocking uana
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::remove_auto_tock( Chuck_UAna * uana )
+{
+    std::vector<Chuck_UAna *>::iterator iter;
+    iter = std::find( m_auto_tock.begin(), m_auto_tock.end(), uana );
+    if( iter != m_auto_tock.end() ) m_auto_tock.erase( iter );
+    uana->m_auto_sched = NULL;
+    update_next_tock();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: update_next_tock()
+// desc: recompute the earliest auto tock
+//-----------------------------------------------------------------------------
+void Chuck_VM_Shreduler::update_next_tock()
+{
+    m_next_tock = -1;
+    for( t_CKUINT i = 0; i < m_auto_tock.size(); i++ )
+        if( m_next_tock < 0 || m_auto_tock[i]->m_auto_next < m_next_tock )
+            m_next_tock = m_auto_tock[i]->m_auto_next;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: auto_tock()
+// desc: tock the uanas due at now_system, in the order they were added,
+//       each as a shred upchucking it would; returns TRUE if any were
+//-----------------------------------------------------------------------------
+t_CKBOOL Chuck_VM_Shreduler::auto_tock()
+{
+    // usually not yet
+    if( m_next_tock < 0 || m_next_tock > this->now_system + .5 )
+        return FALSE;
+
+    // (a tock can't add or remove, but an event broadcast can free)
+    std::vector<Chuck_UAna *> due;
+    for( t_CKUINT i = 0; i < m_auto_tock.size(); i++ )
+    {
+        Chuck_UAna * uana = m_auto_tock[i];
+        if( uana->m_auto_next > this->now_system + .5 ) continue;
+        // next hop (on the same grid, unless behind)
+        uana->m_auto_next += uana->m_hop;
+        if( uana->m_auto_next <= this->now_system )
+            uana->m_auto_next = this->now_system + uana->m_hop;
+        uana->add_ref();
+        due.push_back( uana );
+    }
+    update_next_tock();
+
+    for( t_CKUINT i = 0; i < due.size(); i++ )
+    {
+        due[i]->auto_tock( vm_ref, this->now_system );
+        due[i]->release();
+    }
+
+    return due.size() > 0;
 }
 
 
@@ -1953,6 +3054,12 @@ void Chuck_VM_Shreduler::advance_v( t_CKINT & numLeft, t_CKINT & offset )
     
     // compute number of frames to compute; update
     numFrames = ck_min( m_max_block_size, numLeft );
+    // stop at the next auto tock
+    if( m_next_tock >= 0 )
+    {
+        t_CKINT until = (t_CKINT)( m_next_tock - this->now_system );
+        numFrames = ck_min( numFrames, until > 1 ? until : 1 );
+    }
     if( this->m_samps_until_next >= 0 )
     {
         numFrames = (t_CKINT)(ck_min( numFrames, this->m_samps_until_next ));
@@ -2002,11 +3109,8 @@ void Chuck_VM_Shreduler::advance_v( t_CKINT & numLeft, t_CKINT & offset )
     // update time
     m_adc->m_time = this->now_system;
 
-    // PROCESSING
-    m_dac->system_tick_v( this->now_system, numFrames );
-
-    // suck samples
-    m_bunghole->system_tick_v( this->now_system, numFrames );
+    // PROCESSING (and suck samples)
+    m_schedule.tick_v( this->now_system, numFrames );
 
     // OUTPUT: adaptive block
     for( i = 0; i < numFrames; i++ )
@@ -2050,14 +3154,11 @@ void Chuck_VM_Shreduler::advance( t_CKINT N )
     m_adc->m_last = m_adc->m_current = sum / m_num_adc_channels;
     m_adc->m_time = this->now_system;
 
-    // PROCESSING
-    m_dac->system_tick( this->now_system );
+    // PROCESSING (and suck samples)
+    m_schedule.tick( this->now_system );
     // OUTPUT
     for( i = 0; i < m_num_dac_channels; i++ )
         output[i] = m_dac->m_multi_chan[i]->m_current; // * .5f;
-
-    // suck samples
-    m_bunghole->system_tick( this->now_system );
 }
 
 
@@ -2069,31 +3170,34 @@ void Chuck_VM_Shreduler::advance( t_CKINT N )
 //-----------------------------------------------------------------------------
 Chuck_VM_Shred * Chuck_VM_Shreduler::get( )
 {
-    Chuck_VM_Shred * shred = shred_list;
-
-    // list empty
-    if( !shred )
+    // queue empty
+    if( shred_queue.empty() )
     {
         m_samps_until_next = -1;
         return NULL;
     }
 
+    Chuck_VM_Shred * shred = shred_queue[0];
+
     // TODO: should this be <=?
     if( shred->wake_time <= ( this->now_system + .5 ) )
     {
         // if( shred->wake_time < this->now_system )
         //    assert( false );
 
-        shred_list = shred->next;
-        shred->next = NULL;
-        shred->prev = NULL;
-        
-        if( shred_list )
+        // move the last shred to the root and restore heap order
+        Chuck_VM_Shred * last = shred_queue.back();
+        shred_queue.pop_back();
+        if( last != shred )
         {
-            shred_list->prev = NULL;
-            m_samps_until_next = shred_list->wake_time - this->now_system;
-            if( m_samps_until_next < 0 ) m_samps_until_next = 0;
+            place( last, 0 );
+            sift_down( 0 );
         }
+        shred->wake_index = -1;
+
+        // only update if there are still shreds waiting
+        if( !shred_queue.empty() )
+            update_samps_until_next();
 
         return shred;
     }
@@ -2110,13 +3214,13 @@ Chuck_VM_Shred * Chuck_VM_Shreduler::get( )
 //-----------------------------------------------------------------------------
 t_CKUINT Chuck_VM_Shreduler::highest( )
 {
-    Chuck_VM_Shred * shred = shred_list;
+    Chuck_VM_Shred * shred = NULL;
     t_CKUINT n = 0;
 
-    while( shred )
+    for( t_CKUINT i = 0; i < shred_queue.size(); i++ )
     {
+        shred = shred_queue[i];
         if( shred->xid > n ) n = shred->xid;
-        shred = shred->next;
     }
 
     std::map<Chuck_VM_Shred *, Chuck_VM_Shred *>::iterator iter;    
@@ -2141,23 +3245,15 @@ t_CKBOOL Chuck_VM_Shreduler::replace( Chuck_VM_Shred * out, Chuck_VM_Shred * in
     assert( FALSE );
 
     // sanity check
-    if( !out || !in )
+    if( !out || !in || out->wake_index < 0 )
         return FALSE;
 
-    if( !out->prev )
-        shred_list = in;
-    else
-        out->prev->next = in;
-    
-    if( out->next )
-        out->next->prev = in;
-    
-    in->next = out->next;
-    in->prev = out->prev;
-    
-    out->next = out->prev = NULL;
-
+    // take over the slot; same wake time and order, so heap order holds
     in->wake_time = out->wake_time;
+    in->wake_seq = out->wake_seq;
+    place( in, out->wake_index );
+    out->wake_index = -1;
+
     in->start = in->wake_time;
     
     return TRUE;
@@ -2174,25 +3270,31 @@ t_CKBOOL Chuck_VM_Shreduler::remove( Chuck_VM_Shred * out )
 {
     if( !out ) return FALSE;
 
-    // if blocked
-    if( out->event != NULL )
+    // if blocked (on an event, or on a message; see wait_msg)
+    if( out->event != NULL || blocked.find( out ) != blocked.end() )
     {
         return remove_blocked( out );
     }
 
     // sanity check
-    if( !out->prev && !out->next && out != shred_list )
+    if( out->wake_index < 0 )
         return FALSE;
-    
-    if( !out->prev )
-        shred_list = out->next;
-    else
-        out->prev->next = out->next;
-    
-    if( out->next )
-        out->next->prev = out->prev;
-    
-    out->next = out->prev = NULL;
+
+    t_CKINT index = out->wake_index;
+    Chuck_VM_Shred * last = shred_queue.back();
+    shred_queue.pop_back();
+    out->wake_index = -1;
+
+    // fill the hole with the last shred, then fix it up in either direction
+    if( last != out )
+    {
+        place( last, index );
+        sift_down( index );
+        sift_up( last->wake_index );
+    }
+
+    // update
+    update_samps_until_next();
 
     return TRUE;
 }
@@ -2206,19 +3308,18 @@ t_CKBOOL Chuck_VM_Shreduler::remove( Chuck_VM_Shred * out )
 //-----------------------------------------------------------------------------
 Chuck_VM_Shred * Chuck_VM_Shreduler::lookup( t_CKUINT xid )
 {
-    Chuck_VM_Shred * shred = shred_list;
+    Chuck_VM_Shred * shred = NULL;
 
     // current shred?
     if( m_current_shred != NULL && m_current_shred->xid == xid )
         return m_current_shred;
 
-    // look for in shreduled list
-    while( shred )
+    // look for in shreduled queue
+    for( t_CKUINT i = 0; i < shred_queue.size(); i++ )
     {
+        shred = shred_queue[i];
         if( shred->xid == xid )
             return shred;
-
-        shred = shred->next;
     }
 
     // blocked?
@@ -2255,7 +3356,7 @@ struct SortByID
 //-----------------------------------------------------------------------------
 void Chuck_VM_Shreduler::status( Chuck_VM_Status * status )
 {
-    Chuck_VM_Shred * shred = shred_list;
+    Chuck_VM_Shred * shred = NULL;
     Chuck_VM_Shred * temp = NULL;
 
     t_CKUINT srate = vm_ref->srate(); // 1.3.5.3; was: Digitalio::sampling_rate();
@@ -2273,14 +3374,19 @@ void Chuck_VM_Shreduler::status( Chuck_VM_Status * status )
     status->t_second = sec;
     status->t_minute = m;
     status->t_hour = h;
+
+    // deadline
+    Chuck_Deadline & deadline = vm_ref->deadline();
+    status->blocks = deadline.blocks();
+    status->near_misses = deadline.near_misses();
+    status->overruns = deadline.overruns();
+    status->load_p50 = deadline.percentile( .5 );
+    status->load_p90 = deadline.percentile( .9 );
+    status->load_p99 = deadline.percentile( .99 );
+    status->load_max = deadline.max_load();
     
     // get list of shreds
-    vector<Chuck_VM_Shred *> list;
-    while( shred )
-    {
-        list.push_back( shred );
-        shred = shred->next;
-    }
+    vector<Chuck_VM_Shred *> list( shred_queue.begin(), shred_queue.end() );
 
     // get blocked
     std::map<Chuck_VM_Shred *, Chuck_VM_Shred *>::iterator iter;    
@@ -2336,6 +3442,9 @@ void Chuck_VM_Shreduler::status( )
             (m_status.now_system - shred->start) / m_status.srate,
             shred->has_event ? " (blocked)" : "" );
     }
+
+    // deadline
+    fprintf( stdout, "%s", vm_ref->deadline().report( m_status.srate ).c_str() );
 }
 
 
@@ -2350,6 +3459,8 @@ Chuck_VM_Status::Chuck_VM_Status()
     srate = 0;
     now_system = 0;
     t_second = t_minute = t_hour = 0;
+    blocks = near_misses = overruns = 0;
+    load_p50 = load_p90 = load_p99 = load_max = 0;
 }
 
 
@@ -34,11 +34,8 @@
 
 #include "chuck_oo.h"
 #include "chuck_ugen.h"
-
-// tracking
-#ifdef __CHUCK_STAT_TRACK__
+// tracking, profiler
 #include "chuck_stats.h"
-#endif
 
 #include <string>
 #include <map>
@@ -62,17 +59,27 @@
 //-----------------------------------------------------------------------------
 #define CVM_MEM_STACK_SIZE          (0x1 << 16)
 #define CVM_REG_STACK_SIZE          (0x1 << 14)
+// default number of preallocated shreds in the shred pool
+#define CVM_SHRED_POOL_SIZE         32
+// stack size classes in the shred pool: 2^MIN through 2^MAX bytes
+#define CVM_STACK_CLASS_MIN         10
+#define CVM_STACK_CLASS_MAX         24
+// smallest block rendered on the render threads; shorter ones stay serial
+#define CVM_RENDER_MIN_FRAMES       16
 
 
 // forward references
 struct Chuck_Instr;
+struct Chuck_Instr_Op;
 struct Chuck_VM;
 struct Chuck_VM_Func;
 struct Chuck_VM_FTable;
+struct Chuck_VM_Shred_Pool;
 struct Chuck_Msg;
 
 class BBQ;
 class CBufferSimple;
+class CBufferMPSC;
 class Digitalio;
 
 
@@ -94,6 +101,8 @@ public:
 public:
     t_CKBOOL initialize( t_CKUINT size );
     t_CKBOOL shutdown();
+    // rewind for reuse, zeroing if dirty
+    t_CKBOOL reset();
 
 //-----------------------------------------------------------------------------
 // data
@@ -109,6 +118,61 @@ public: // linked list
 
 public: // state
     t_CKBOOL m_is_init;
+    // usable size in bytes, as requested from initialize()
+    t_CKUINT m_size;
+    // whether the stack may hold data from a previous shred
+    t_CKBOOL m_is_dirty;
+};
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct Chuck_VM_Shred_Pool
+// desc: preallocated shreds and stacks, recycled by the VM so that spork
+//       does not allocate (or page-fault fresh stacks) on the audio thread
+//-----------------------------------------------------------------------------
+struct Chuck_VM_Shred_Pool
+{
+public:
+    Chuck_VM_Shred_Pool();
+    ~Chuck_VM_Shred_Pool();
+
+public:
+    // preallocate num_shreds shreds, with default-size stacks for each
+    t_CKBOOL initialize( t_CKUINT num_shreds );
+    t_CKBOOL shutdown();
+
+public:
+    // get a shred, recycled if possible (not initialized)
+    Chuck_VM_Shred * get_shred();
+    // get an initialized stack of at least size bytes
+    Chuck_VM_Stack * get_stack( t_CKUINT size );
+    // take back the stacks of a finished shred
+    void put_stacks( Chuck_VM_Shred * shred );
+    // take back a finished shred; FALSE if the caller should release it
+    t_CKBOOL recycle( Chuck_VM_Shred * shred );
+    // log hit/miss counts
+    void report();
+
+protected:
+    // size class index for a stack size
+    t_CKINT size_class( t_CKUINT size ) const;
+    void put_stack( Chuck_VM_Stack * stack );
+
+public:
+    // max shreds (and stacks per size class) kept around
+    t_CKUINT m_capacity;
+    // stats
+    t_CKUINT m_shred_hits;
+    t_CKUINT m_shred_misses;
+    t_CKUINT m_stack_hits;
+    t_CKUINT m_stack_misses;
+
+protected:
+    // free shreds (ref count 0, shut down)
+    std::vector<Chuck_VM_Shred *> m_shreds;
+    // free stacks, by size class
+    std::vector<Chuck_VM_Stack *> m_stacks[CVM_STACK_CLASS_MAX - CVM_STACK_CLASS_MIN + 1];
 };
 
 
@@ -144,6 +208,10 @@ public:
     // filename this code came from (added 1.3.0.0)
     std::string filename;
 
+    // threaded form of instr, built on first run (see translate())
+    Chuck_Instr_Op * ops;
+    Chuck_Instr_Op * translate( const void * const * handlers );
+
     // native func types
     enum { NATIVE_UNKNOWN, NATIVE_CTOR, NATIVE_DTOR, NATIVE_MFUN, NATIVE_SFUN };
 };
@@ -167,9 +235,11 @@ public:
 
     t_CKBOOL initialize( Chuck_VM_Code * c, 
                          t_CKUINT mem_st_size = CVM_MEM_STACK_SIZE, 
-                         t_CKUINT reg_st_size = CVM_REG_STACK_SIZE );
+                         t_CKUINT reg_st_size = CVM_REG_STACK_SIZE,
+                         Chuck_VM_Shred_Pool * pool = NULL );
     t_CKBOOL shutdown();
     t_CKBOOL run( Chuck_VM * vm );
+    t_CKBOOL run_threaded( Chuck_VM * vm );
     t_CKBOOL add( Chuck_UGen * ugen );
     t_CKBOOL remove( Chuck_UGen * ugen );
     
@@ -219,6 +289,10 @@ public:
     t_CKBOOL is_abort;
     t_CKBOOL is_dumped;
     Chuck_Event * event;  // event shred is waiting on
+    // position in the shreduler wake queue (-1 if not shreduled)
+    t_CKINT wake_index;
+    // shredule order, keeps shreds waking at the same time in FIFO order
+    t_CKUINT wake_seq;
     std::map<Chuck_UGen *, Chuck_UGen *> m_ugen_map;
     // references kept by the shred itself (e.g., when sporking member functions)
     // to be released when shred is done -- added 1.3.1.2
@@ -235,6 +309,8 @@ public:
 
     // tracking
     CK_TRACK( Shred_Stat * stat );
+    // profiler entry, once profiled
+    Profile_Entry * profile;
 
 public: // ge: 1.3.5.3
     // make and push new loop counter
@@ -300,6 +376,15 @@ public:
     t_CKUINT t_hour;
     // list of shred status
 	std::vector<Chuck_VM_Shred_Status *> list;
+    // audio callback deadline: blocks, near misses, overruns, and load
+    // (fraction of the deadline) percentiles
+    t_CKUINT blocks;
+    t_CKUINT near_misses;
+    t_CKUINT overruns;
+    t_CKFLOAT load_p50;
+    t_CKFLOAT load_p90;
+    t_CKFLOAT load_p99;
+    t_CKFLOAT load_max;
 };
 
 
@@ -341,6 +426,23 @@ public: // high-level shred interface
 public: // for event related shred queue
     t_CKBOOL add_blocked( Chuck_VM_Shred * shred );
     t_CKBOOL remove_blocked( Chuck_VM_Shred * shred );
+    // shredule blocked shreds now, in order, in one pass (event broadcast)
+    t_CKUINT wake( Chuck_VM_Shred ** shreds, t_CKUINT count );
+
+public: // uanas tocked every hop, without a shred (see UAna.autoTock())
+    void add_auto_tock( Chuck_UAna * uana );
+    void remove_auto_tock( Chuck_UAna * uana );
+    // tock the uanas due at now_system; returns TRUE if any were
+    t_CKBOOL auto_tock();
+
+protected: // wake queue (binary min-heap on wake_time, then wake_seq)
+    t_CKBOOL wakes_before( Chuck_VM_Shred * lhs, Chuck_VM_Shred * rhs ) const;
+    void sift_up( t_CKINT index );
+    void sift_down( t_CKINT index );
+    void place( Chuck_VM_Shred * shred, t_CKINT index );
+    void heapify();
+    void update_samps_until_next();
+    void update_next_tock();
 
 //-----------------------------------------------------------------------------
 // data
@@ -352,8 +454,10 @@ public:
     // added ge: 1.3.5.3
     Chuck_VM * vm_ref;
 
-    // shreds to be shreduled
-    Chuck_VM_Shred * shred_list;
+    // shreds to be shreduled (heap ordered, see wakes_before())
+    std::vector<Chuck_VM_Shred *> shred_queue;
+    // next shredule order number
+    t_CKUINT m_wake_seq;
     // shreds waiting on events
     std::map<Chuck_VM_Shred *, Chuck_VM_Shred *> blocked;
     // current shred
@@ -365,6 +469,8 @@ public:
     Chuck_UGen * m_bunghole;
     t_CKUINT m_num_dac_channels;
     t_CKUINT m_num_adc_channels;
+    // flat tick order for the graph under dac and bunghole
+    Chuck_UGen_Schedule m_schedule;
     
     // status cache
     Chuck_VM_Status m_status;
@@ -373,6 +479,11 @@ public:
     t_CKUINT m_max_block_size;
     t_CKBOOL m_adaptive;
     t_CKDUR m_samps_until_next;
+
+    // auto-tocked uanas (not referenced; each removes itself when freed)
+    std::vector<Chuck_UAna *> m_auto_tock;
+    // earliest m_auto_next among them, or -1
+    t_CKTIME m_next_tock;
 };
 
 
@@ -393,7 +504,10 @@ public:
 
 public: // init
     t_CKBOOL initialize( t_CKUINT srate, t_CKUINT dac_chan, t_CKUINT adc_chan,
-                         t_CKUINT adaptive, t_CKBOOL halt );
+                         t_CKUINT adaptive, t_CKBOOL halt,
+                         t_CKUINT shred_pool_size = CVM_SHRED_POOL_SIZE,
+                         t_CKUINT render_threads = 1,
+                         t_CKUINT uana_threads = 1 );
     t_CKBOOL initialize_synthesis( );
     t_CKBOOL shutdown();
     t_CKBOOL has_init() { return m_init; }
@@ -438,6 +552,12 @@ public: // msg
     t_CKBOOL queue_event( Chuck_Event * event, int num_msg, CBufferSimple * buffer = NULL );
     t_CKUINT process_msg( Chuck_Msg * msg );
     Chuck_Msg * get_reply( );
+    // suspend shred (inside a native call) until msg is processed; the
+    // call then returns process_msg()'s result
+    t_CKBOOL wait_msg( Chuck_VM_Shred * shred, Chuck_Msg * msg );
+
+    // threads for async UAna tocks (started on first use, if create)
+    Chuck_UAna_Worker * uana_worker( t_CKBOOL create );
 
     // added 1.3.0.0 to fix uber-crash
     CBufferSimple * create_event_buffer();
@@ -460,11 +580,16 @@ public:
     t_CKUINT m_num_dac_channels;
     t_CKBOOL m_halt;
     t_CKBOOL m_is_running;
+    // run shreds on the threaded interpreter (else one virtual call per instr)
+    t_CKBOOL m_threaded;
 
     // for shreduler, ge: 1.3.5.3
     const SAMPLE * input_ref() { return m_input_ref; }
     SAMPLE * output_ref() { return m_output_ref; }
 
+    // audio callback deadline monitor; the caller of run() brackets it
+    Chuck_Deadline & deadline() { return m_deadline; }
+
 protected:
     // for shreduler, ge: 1.3.5.3
     const SAMPLE * m_input_ref;
@@ -476,10 +601,14 @@ protected:
                    t_CKBOOL dec = TRUE );
     void dump( Chuck_VM_Shred * shred );
     void release_dump();
+    // a timed shred activation is done (profiler, deadline monitor)
+    void shred_ran( Chuck_VM_Shred * shred, t_CKTICKS start );
 
 protected:
     t_CKBOOL m_init;
     std::string m_last_error;
+    // audio callback deadline monitor
+    Chuck_Deadline m_deadline;
 
     // shred
     Chuck_VM_Shred * m_shreds;
@@ -489,11 +618,19 @@ protected:
     // place to put dumped shreds
     std::vector<Chuck_VM_Shred *> m_shred_dump;
     t_CKUINT m_num_dumped_shreds;
-
-    // message queue
-    CBufferSimple * m_msg_buffer;
+    // recycled shreds and stacks
+    Chuck_VM_Shred_Pool * m_shred_pool;
+    // threads for rendering independent parts of the ugen graph
+    XWorkPool * m_render_pool;
+    // threads for async UAna tocks (NULL until first async upchuck)
+    Chuck_UAna_Worker * m_uana_worker;
+    t_CKUINT m_uana_threads;
+
+    // message queue (the otf listener and the compile worker both queue)
+    CBufferMPSC * m_msg_buffer;
     CBufferSimple * m_reply_buffer;
-    CBufferSimple * m_event_buffer;
+    // events queued by any thread without a buffer of its own
+    CBufferMPSC * m_event_buffer;
     
     // TODO: vector? (added 1.3.0.0 to fix uber-crash)
     std::list<CBufferSimple *> m_event_buffers;
@@ -533,6 +670,8 @@ enum Chuck_Msg_Type
 
 // callback function prototype
 typedef void (* ck_msg_func)( const Chuck_Msg * msg );
+// compile function prototype
+typedef void (* ck_msg_compile)( Chuck_Msg * msg );
 //-----------------------------------------------------------------------------
 // name: struct Chuck_Msg
 // desc: ...
@@ -551,6 +690,15 @@ struct Chuck_Msg
     t_CKUINT replyB;
     void * replyC;
 
+    // shred suspended until this is processed (see wait_msg)
+    Chuck_VM_Shred * waiting;
+    t_CKUINT * waiting_result;
+
+    // if set, type-checks and emits compile_data into code (left NULL on
+    // failure) on the vm thread, before the msg is processed
+    ck_msg_compile compile;
+    void * compile_data;
+
     std::vector<std::string> * args;
 
     Chuck_Msg() : args(NULL) { clear(); }
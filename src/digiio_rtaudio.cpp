@@ -906,8 +906,10 @@ int Digitalio::cb2( void *output_buffer, void *input_buffer,
     {
         // timestamp
         if( g_do_watchdog ) g_watchdog_time = get_current_time( TRUE );
-        // get samples from output
+        // get samples from output, timed against the buffer's deadline
+        vm_ref->deadline().begin( vm_ref->shreduler()->now_system );
         vm_ref->run( buffer_size, m_buffer_in, m_buffer_out );
+        vm_ref->deadline().end( buffer_size, vm_ref->srate() );
         // ...
         if( m_xrun ) m_xrun--;
     }
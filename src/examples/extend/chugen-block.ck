@@ -0,0 +1,28 @@
+// ChuGen, block at a time
+// tickv() gets the whole block (with --adaptive processing) instead of
+// one sample per call to tick(); without blocks it sees one sample
+
+class Fuzz extends Chugen
+{
+    1.0/2.0 => float p;
+    
+    2 => intensity;
+    
+    fun void tickv(float in[], float out[])
+    {
+        in.size() => int n;
+        for(0 => int i; i < n; i++)
+            Math.pow(Math.fabs(in[i]), p) * Math.sgn(in[i]) => out[i];
+    }
+    
+    fun void intensity(float i)
+    {
+        if(i > 1)
+            1.0/i => p;
+    }
+}
+
+adc => Fuzz f => dac;
+2.5 => f.intensity;
+
+while(true) 1::second => now;
@@ -0,0 +1,42 @@
+
+// Machine.add/replace return the new shred id (0 on failure),
+// with the file compiled off the audio thread
+
+if( me.args() )
+{
+    // added copy: stay around briefly
+    10::ms => now;
+    me.exit();
+}
+
+me.dir() + "/92.ck:child" => string child;
+
+Machine.add( child ) => int id;
+if( id != me.id() + 1 )
+{
+    <<< "failure: add returned", id >>>;
+    me.exit();
+}
+
+Machine.replace( id, child ) => int id2;
+if( id2 != id )
+{
+    <<< "failure: replace returned", id2 >>>;
+    me.exit();
+}
+
+if( Machine.add( me.dir() + "/no-such-file.ck" ) != 0 )
+{
+    <<< "failure: add of missing file" >>>;
+    me.exit();
+}
+
+if( Machine.replace( 1000, child ) != 0 )
+{
+    <<< "failure: replace of missing shred" >>>;
+    me.exit();
+}
+
+// let the copy finish
+20::ms => now;
+<<< "success" >>>;
@@ -0,0 +1,39 @@
+// chugens with a block tick, tickv( float in[], float out[] ), a scalar
+// tick, or both; the same with or without --adaptive block processing
+
+class Half extends Chugen { fun float tick( float in ) { return in * 0.5; } }
+class HalfV extends Chugen
+{
+    fun void tickv( float in[], float out[] )
+    { in.size() => int n; for( 0 => int i; i < n; i++ ) in[i] * 0.5 => out[i]; }
+}
+class Both extends Chugen
+{
+    0 => int frames;
+    fun float tick( float in ) { frames++; return in * 0.5; }
+    fun void tickv( float in[], float out[] )
+    { in.size() +=> frames; for( 0 => int i; i < in.size(); i++ ) in[i] * 0.5 => out[i]; }
+}
+// output left alone passes the input through
+class Through extends Chugen { fun void tickv( float in[], float out[] ) { } }
+
+Step s => Half a => blackhole;
+s => HalfV b => blackhole;
+s => Both c => blackhole;
+s => Through d => blackhole;
+// block ticks chain
+s => HalfV e => HalfV f => blackhole;
+
+0 => int fails;
+for( 0 => int k; k < 20; k++ )
+{
+    k * 0.1 => s.next;
+    1::samp => now;
+    if( a.last() != b.last() || a.last() != c.last() || d.last() != s.last() ||
+        Math.fabs( f.last() - s.last() * 0.25 ) > .000001 )
+        fails++;
+}
+100::samp => now;
+
+if( fails == 0 && c.frames == 120 ) <<< "success" >>>;
+else <<< "failed:", fails, c.frames >>>;
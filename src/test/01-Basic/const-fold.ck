@@ -0,0 +1,55 @@
+// expressions the compiler folds to constants before emitting,
+// and statements behind conditions that fold to a constant
+
+// int arithmetic, bitwise, shifts, compares
+if( !( ( 5 * 7 - 3 ) / 4 == 8 && 17 % 5 == 2 && -17 % 5 == -2 ) ) { <<< "fail: int arith" >>>; me.exit(); }
+if( !( ( 1 << 4 ) == 16 && ( 256 >> 3 ) == 32 && ( 6 & 3 ) == 2 && ( 6 | 3 ) == 7 && ( 6 ^ 3 ) == 5 ) ) { <<< "fail: bitwise" >>>; me.exit(); }
+if( !( -(3) == -3 && !0 == 1 && !7 == 0 && ~5 == -6 ) ) { <<< "fail: unary" >>>; me.exit(); }
+if( !( ( 3 < 4 ) + ( 3 > 4 ) + ( 3 <= 3 ) + ( 3 >= 4 ) + ( 3 == 3 ) + ( 3 != 3 ) == 3 ) ) { <<< "fail: int compare" >>>; me.exit(); }
+if( !( ( 1 && 0 ) == 0 && ( 0 || 2 ) == 2 && ( 0 && 1 / 0 ) == 0 && ( 1 || 1 / 0 ) == 1 ) ) { <<< "fail: short circuit" >>>; me.exit(); }
+
+// float, mixed and casts
+if( !( 1.5 * 4 == 6.0 && 7 / 2.0 == 3.5 && 7.5 % 2 == 1.5 && 2 + 0.5 == 2.5 ) ) { <<< "fail: float arith" >>>; me.exit(); }
+if( !( ( 7 $ float ) / 2 == 3.5 && ( 3.9 $ int ) == 3 && ( -3.9 $ int ) == -3 ) ) { <<< "fail: casts" >>>; me.exit(); }
+if( !( 1.5 < 2 && 2.0 == 2 && !( 0.1 > 0.2 ) ) ) { <<< "fail: float compare" >>>; me.exit(); }
+
+// dur and time
+if( !( 1.5::second == 1500::ms && 2::second / 1::second == 2.0 ) ) { <<< "fail: dur" >>>; me.exit(); }
+if( !( second / samp > 0 && minute == 60::second && t_zero + 1::second - t_zero == 1::second ) ) { <<< "fail: dur constants" >>>; me.exit(); }
+
+// Math with constant arguments
+if( !( Math.sqrt( 16 ) == 4.0 && Math.pow( 2, 10 ) == 1024.0 && Math.abs( -3 ) == 3 ) ) { <<< "fail: math" >>>; me.exit(); }
+if( !( Math.floor( 2.5 ) == 2.0 && Math.max( 3, 9 ) == 9 && Math.mtof( 69 ) == 440.0 ) ) { <<< "fail: math 2" >>>; me.exit(); }
+if( !( Math.isinf( Math.INFINITY ) && Math.PI == pi && Math.nextpow2( 100 ) == 128 ) ) { <<< "fail: math constants" >>>; me.exit(); }
+
+// conditional expressions
+if( !( ( 1 ? 4 : 5 ) == 4 && ( 0 ? 4.0 : 5.0 ) == 5.0 ) ) { <<< "fail: ?:" >>>; me.exit(); }
+
+// dead branches
+0 => int n;
+if( false ) n--; else n++;
+if( 1 < 2 ) n++; else n--;
+if( Math.PI > 4 ) { n--; }
+if( n != 2 ) { <<< "fail: if" >>>; me.exit(); }
+
+// loops whose condition folds
+while( false ) n--;
+until( true ) n--;
+for( 0 => int i; 0; i++ ) n--;
+if( n != 2 ) { <<< "fail: dead loops" >>>; me.exit(); }
+while( true ) { n++; if( n > 5 ) break; }
+until( false ) { n++; if( n > 8 ) break; }
+for( 0 => int i; true; i++ ) { n++; if( i == 2 ) break; }
+if( n != 12 ) { <<< "fail: endless loops" >>>; me.exit(); }
+do { n++; } while( false );
+do { n++; } until( true );
+do { n++; if( n > 15 ) break; } while( 1 );
+if( n != 16 ) { <<< "fail: do loops" >>>; me.exit(); }
+
+// folded values inside functions and classes
+fun float scale( float x ) { return x * ( 2 + 3 ) * Math.cos( 0 ); }
+class Foo { 3 * 4 => int k; fun int get() { return k + ( 1 << 2 ); } }
+Foo foo;
+if( !( scale( 2 ) == 10.0 && foo.get() == 16 ) ) { <<< "fail: func, class" >>>; me.exit(); }
+
+<<< "success" >>>;
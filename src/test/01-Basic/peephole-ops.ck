@@ -0,0 +1,63 @@
+// code shapes the emitter's peephole pass (--optimize) rewrites:
+// compare-and-branch, load-op, store and increment on locals and
+// globals, push/pop pairs, and jumps into the middle of those
+// (run the suite with: test.py chuck . --optimize)
+
+// stores, increments and load-op on globals
+5 => int g; 2.5 => float gf;
+g++; ++g; g--; 3 +=> g; 1 -=> g; -4 +=> g;
+if( g != 4 ) { <<< "fail: global inc" >>>; me.exit(); }
+g * 3 => int t; g % 3 => int m; g - -2 => int d;
+if( !( t == 12 && m == 1 && d == 6 ) ) { <<< "fail: global op imm" >>>; me.exit(); }
+gf => float hf; 1.0 +=> hf;
+if( !( gf == 2.5 && hf == 3.5 ) ) { <<< "fail: float store" >>>; me.exit(); }
+
+// the same on locals, inside a function
+fun int locals( int k )
+{
+    0 => int s; 1.0 => float f;
+    for( 0 => int i; i < k; i++ )
+    {
+        if( i % 4 == 0 ) continue;
+        if( i > 20 ) break;
+        i +=> s; 2 +=> s; 2.0 *=> f;
+    }
+    return s;
+}
+if( !( locals( 10 ) == 47 && locals( 100 ) == 180 ) ) { <<< "fail: local loop" >>>; me.exit(); }
+
+// every compare, against constants and fused with branches
+0 => int hits;
+for( -3 => int i; i <= 3; i++ )
+{
+    if( i < 0 ) hits++; if( i > 0 ) hits++; if( i <= 0 ) hits++;
+    if( i >= 0 ) hits++; if( i == 0 ) hits++; if( i != 0 ) hits++;
+    if( !( i < 1 ) ) hits++;
+}
+if( hits != 24 ) { <<< "fail: compare branch" >>>; me.exit(); }
+
+// compare results used as values, not branched on
+( g < 5 ) + ( g > 5 ) + ( g == 4 ) => int v;
+if( v != 2 ) { <<< "fail: compare values" >>>; me.exit(); }
+
+// short circuits jump past pops
+0 => int sc;
+for( 0 => int i; i < 6; i++ ) { if( i > 1 && i < 4 ) sc++; if( i == 0 || i == 5 ) sc++; }
+if( sc != 4 ) { <<< "fail: short circuit" >>>; me.exit(); }
+
+// nested loops: gotos to gotos
+0 => int nest;
+0 => int a;
+while( a < 5 )
+{
+    0 => int b;
+    while( true ) { if( b >= a ) break; b++; nest++; }
+    a++;
+}
+if( nest != 10 ) { <<< "fail: nested" >>>; me.exit(); }
+
+// values left on the stack (not popped) stay
+0 => int q;
+if( !( ( q++ ) == 0 && ( ++q ) == 2 && ( 3 +=> q ) == 5 ) ) { <<< "fail: used results" >>>; me.exit(); }
+
+<<< "success" >>>;
@@ -0,0 +1,33 @@
+// cpu profiler: per shred, per ugen, on and off, reset
+
+fun void busy() { while( true ) { 0 => float x; for( 0 => int i; i < 2000; i++ ) x + i => x; 1::ms => now; } }
+fun void idle() { while( true ) 1::ms => now; }
+
+if( Machine.profile( 1 ) != 0 ) { <<< "fail: was off" >>>; me.exit(); }
+SinOsc s => Gain g => blackhole;
+spork ~ busy() @=> Shred b;
+spork ~ idle() @=> Shred i;
+1::second => now;
+
+if( Machine.profileShred( b.id() ) <= 0 ) { <<< "fail: busy shred" >>>; me.exit(); }
+if( Machine.profileShred( b.id() ) <= Machine.profileShred( i.id() ) ) { <<< "fail: busy > idle" >>>; me.exit(); }
+if( Machine.profileShred( 12345 ) != 0 ) { <<< "fail: no such shred" >>>; me.exit(); }
+if( Machine.profileUGen( s ) <= 0 ) { <<< "fail: ugen" >>>; me.exit(); }
+SinOsc never;
+if( Machine.profileUGen( never ) != 0 ) { <<< "fail: unconnected ugen" >>>; me.exit(); }
+
+Machine.profileReport() => string report;
+if( report.find( "spork~busy" ) < 0 ) { <<< "fail: report shred" >>>; me.exit(); }
+if( !( report.find( "SinOsc" ) >= 0 && report.find( "Gain" ) >= 0 ) ) { <<< "fail: report ugen types" >>>; me.exit(); }
+
+// off: nothing more is counted
+if( Machine.profile( 0 ) != 1 ) { <<< "fail: was on" >>>; me.exit(); }
+Machine.profileShred( b.id() ) => float before;
+100::ms => now;
+if( Machine.profileShred( b.id() ) != before ) { <<< "fail: off" >>>; me.exit(); }
+
+// reset
+Machine.profileReset();
+if( !( Machine.profileShred( b.id() ) == 0 && Machine.profileUGen( s ) == 0 ) ) { <<< "fail: reset" >>>; me.exit(); }
+
+<<< "success" >>>;
@@ -0,0 +1,43 @@
+// instructions with native handlers in the threaded interpreter
+// (see Chuck_VM_Shred::run_threaded()) against known results
+
+// integer arithmetic and assignment
+7 => int a; 3 => int b;
+if( !( a + b == 10 && a - b == 4 && a * b == 21 ) ) { <<< "fail: int +-*" >>>; me.exit(); }
+if( !( a / b == 2 && a % b == 1 && -a / b == -2 ) ) { <<< "fail: int / %" >>>; me.exit(); }
+a => int c; 5 +=> c; 2 -=> c;
+if( c != 10 ) { <<< "fail: int +=> -=>" >>>; me.exit(); }
+if( !( c++ == 10 && c == 11 && ++c == 12 && c-- == 12 && --c == 10 ) ) { <<< "fail: inc / dec" >>>; me.exit(); }
+if( !( !0 && !( !a ) && -c == -10 ) ) { <<< "fail: not / negate" >>>; me.exit(); }
+
+// comparison and branching
+if( !( ( a < b ) == 0 && ( a > b ) && ( b <= 3 ) && ( a >= 7 ) ) ) { <<< "fail: int compare" >>>; me.exit(); }
+if( !( ( a == 7 ) && ( a != b ) ) ) { <<< "fail: int equality" >>>; me.exit(); }
+0 => int n;
+for( 0 => int i; i < 100; i++ ) { if( i % 2 == 0 ) continue; n++; }
+while( n > 10 ) n--;
+if( n != 10 ) { <<< "fail: loops" >>>; me.exit(); }
+
+// floats
+1.5 => float x; 0.25 => float y;
+if( !( x + y == 1.75 && x - y == 1.25 && x * y == .375 && x / y == 6.0 ) ) { <<< "fail: float +-*/" >>>; me.exit(); }
+x => float z; y +=> z;
+if( !( z == 1.75 && -z == -1.75 ) ) { <<< "fail: float +=> / negate" >>>; me.exit(); }
+if( !( ( x < y ) == 0 && ( x > y ) && ( y <= .25 ) && ( x >= 2.0 ) == 0 ) ) { <<< "fail: float compare" >>>; me.exit(); }
+
+// casts
+if( !( ( 7.9 $ int ) == 7 && ( 3 $ float ) == 3.0 && Math.floor( a ) == 7.0 ) ) { <<< "fail: casts" >>>; me.exit(); }
+
+// functions and globals from inside them
+0 => int calls;
+fun int fact( int k ) { calls++; if( k <= 1 ) return 1; return k * fact( k - 1 ); }
+if( !( fact( 10 ) == 3628800 && calls == 10 ) ) { <<< "fail: recursion" >>>; me.exit(); }
+
+// shreds yielding in the middle of a loop
+0 => int ticks;
+fun void ticker() { for( 0 => int i; i < 10; i++ ) { ticks++; 1::samp => now; } }
+spork ~ ticker(); spork ~ ticker();
+11::samp => now;
+if( ticks != 20 ) { <<< "fail: yield" >>>; me.exit(); }
+
+<<< "success" >>>;
@@ -0,0 +1,48 @@
+// DCT matches the direct sum (fast and matrix sizes), and IDCT inverts DCT
+
+fun int check( int N )
+{
+    DCT dct =^ IDCT idct => blackhole;
+    N => dct.size => idct.size;
+
+    // a mix of two basis functions and a ramp
+    float x[N];
+    for( int i; i < N; i++ )
+        Math.cos( pi * 3 * (i + .5) / N ) + .5 * Math.cos( pi * (N/2-1) * (i + .5) / N ) + (i $ float) / N => x[i];
+    dct.transform( x );
+    float X[N];
+    dct.spectrum( X );
+
+    // against the direct sum
+    for( int k; k < N; k++ )
+    {
+        0.0 => float sum;
+        for( int n; n < N; n++ ) x[n] * Math.cos( pi / N * k * (n + .5) ) +=> sum;
+        if( Std.fabs( X[k] - sum ) > .001 * N )
+        {
+            <<< "failure: size", N, "coefficient", k, X[k], sum >>>;
+            return false;
+        }
+    }
+
+    // back again
+    idct.transform( X );
+    float y[N];
+    idct.samples( y );
+    for( int i; i < N; i++ )
+    {
+        if( Std.fabs( y[i] - x[i] ) > .001 )
+        {
+            <<< "failure: size", N, "inverse at", i, y[i], x[i] >>>;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+if( !check( 512 ) ) me.exit();
+if( !check( 2 ) ) me.exit();
+if( !check( 12 ) ) me.exit();
+
+<<< "success" >>>;
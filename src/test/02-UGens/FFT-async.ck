@@ -0,0 +1,47 @@
+// an async upchuck analyzes the same samples as a synchronous one, on an
+// analysis thread; the shred resumes with the filled blob
+
+SinOsc s => FFT a =^ Centroid ca => blackhole;
+s => FFT b =^ Centroid cb => blackhole;
+b =^ Flux fb => blackhole;
+1024 => a.size => b.size;
+Windowing.hann( 1024 ) => a.window => b.window;
+
+1 => cb.async;
+if( !cb.async() || ca.async() )
+{
+    <<< "failure: async flag" >>>;
+    me.exit();
+}
+
+for( 0 => int i; i < 40; i++ )
+{
+    200 + i * 37 => s.freq;
+    ca.upchuck() @=> UAnaBlob x;
+    now => time then;
+    cb.upchuck() @=> UAnaBlob y;
+    // a synchronous upchuck downstream of an async FFT
+    fb.upchuck();
+    if( y.when() != then || x.fval(0) != y.fval(0) || x.fval(0) <= 0 )
+    {
+        <<< "failure:", i, x.fval(0), y.fval(0) >>>;
+        me.exit();
+    }
+    512::samp => now;
+}
+
+// a resize on the analysis thread leaves a held array alone; the blob
+// makes it current on its next use
+1 => b.async;
+b.upchuck().fvals() @=> float held[];
+256 => b.size;
+Windowing.hann( 256 ) => b.window;
+256::samp => now;
+b.upchuck() @=> UAnaBlob z;
+if( held.size() != 512 || z.fvals().size() != 128 || z.fvals() != held || z.fval( 3 ) != held[3] )
+{
+    <<< "failure: resize", held.size(), z.fvals().size() >>>;
+    me.exit();
+}
+
+<<< "success" >>>;
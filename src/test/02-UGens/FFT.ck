@@ -0,0 +1,36 @@
+// FFT finds a sinusoid's bin, and IFFT inverts FFT
+
+1024 => int N;
+FFT fft =^ IFFT ifft => blackhole;
+N => fft.size => ifft.size;
+
+// bin 37 of a 1024-point transform
+float x[N];
+for( int i; i < N; i++ ) Math.cos( 2 * pi * 37 * i / N ) => x[i];
+fft.transform( x );
+complex s[N/2];
+fft.spectrum( s );
+
+0 => int peak;
+for( int i; i < N/2; i++ )
+    if( (s[i]$polar).mag > (s[peak]$polar).mag ) i => peak;
+if( peak != 37 )
+{
+    <<< "failure: peak at bin", peak >>>;
+    me.exit();
+}
+
+// back again
+ifft.transform( s );
+float y[N];
+ifft.samples( y );
+for( int i; i < N; i++ )
+{
+    if( Std.fabs( y[i] - x[i] ) > .001 )
+    {
+        <<< "failure: inverse at", i, y[i], x[i] >>>;
+        me.exit();
+    }
+}
+
+<<< "success" >>>;
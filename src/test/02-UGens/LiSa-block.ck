@@ -0,0 +1,84 @@
+// LiSa renders its voices a block at a time under --adaptive, and a
+// sample at a time while recording; check both give the same output
+// for voices that wrap, turn, run off the buffer and ramp
+
+1000 => int LEN;
+5000 => int N;
+
+// block (a) and per-sample (b): b records silence over itself with
+// feedback 1, which leaves its buffer as is
+LiSa a => LiSa capA => blackhole;
+LiSa b => LiSa capB => blackhole;
+
+fun void setup( LiSa l )
+{
+    LEN::samp => l.duration;
+    for( 0 => int i; i < LEN; i++ )
+        l.valueAt( Math.sin( i * .05 ) * .5 + ( i % 7 ) * .05, i::samp );
+
+    // looped, across the wrap
+    l.loop( 0, 1 );
+    l.loopStart( 0, 100::samp );
+    l.loopEnd( 0, 900::samp );
+    l.playPos( 0, 850::samp );
+    l.rate( 0, 1.37 );
+    l.play( 0, 1 );
+
+    // bi-directional, ramping up
+    l.loop( 1, 1 );
+    l.bi( 1, 1 );
+    l.loopStart( 1, 200::samp );
+    l.loopEnd( 1, 600::samp );
+    l.playPos( 1, 300::samp );
+    l.rate( 1, .73 );
+    l.voiceGain( 1, .6 );
+    l.rampUp( 1, 300::samp );
+
+    // no loop, off the end of the buffer
+    l.loop( 2, 0 );
+    l.playPos( 2, 700::samp );
+    l.rate( 2, 2.1 );
+    l.rampUp( 2, 50::samp );
+
+    // looped backwards, ramped down later
+    l.loop( 3, 1 );
+    l.loopStart( 3, 0::samp );
+    l.loopEnd( 3, 1000::samp );
+    l.playPos( 3, 400::samp );
+    l.rate( 3, -1.5 );
+    l.play( 3, 1 );
+}
+
+fun void capture( LiSa l )
+{
+    N::samp => l.duration;
+    0::samp => l.recRamp;
+    l.record( 1 );
+}
+
+setup( a );
+setup( b );
+1. => b.feedback;
+0::samp => b.recRamp;
+b.loopRec( 1 );
+b.record( 1 );
+capture( capA );
+capture( capB );
+
+1000::samp => now;
+a.rampDown( 3, 777::samp );
+b.rampDown( 3, 777::samp );
+( N - 1000 )::samp => now;
+
+0 => int bad;
+0. => float sum;
+for( 0 => int i; i < N; i++ )
+{
+    capA.valueAt( i::samp ) => float x;
+    capB.valueAt( i::samp ) => float y;
+    if( Std.fabs( x - y ) > .00001 ) bad++;
+    Std.fabs( y ) +=> sum;
+}
+
+if( bad == 0 && sum > 100 ) <<< "success" >>>;
+else <<< "mismatch:", bad, "sum:", sum >>>;
@@ -0,0 +1,45 @@
+// streaming SndBuf plays what the in-memory one does, except for
+// samples counted as underruns (chunks not loaded in time)
+
+me.dir() + "../../examples/book/digital-artists/audio/stereo_fx_01.wav" => string file;
+
+SndBuf mem => blackhole;
+SndBuf str => blackhole;
+
+0 => mem.chunks;
+mem.read( file );
+1024 => str.chunks;
+1 => str.stream;
+4 => str.streamMax;
+str.read( file );
+
+if( str.samples() != mem.samples() || str.samples() == 0 )
+{
+    <<< "failure: samples", str.samples(), mem.samples() >>>;
+    me.exit();
+}
+
+fun int compare( int n )
+{
+    for( int i; i < n; i++ )
+    {
+        str.underruns() => int u;
+        1::samp => now;
+        if( str.last() != mem.last() && str.underruns() == u )
+            return false;
+    }
+    return true;
+}
+
+1 => mem.loop => str.loop;
+
+// forward, across the loop point
+mem.samples() - 5000 => mem.pos => str.pos;
+if( !compare( 20000 ) ) { <<< "failure: forward" >>>; me.exit(); }
+
+// backward, across the loop point
+-1.5 => mem.rate => str.rate;
+10000 => mem.pos => str.pos;
+if( !compare( 20000 ) ) { <<< "failure: backward" >>>; me.exit(); }
+
+<<< "success" >>>;
@@ -0,0 +1,92 @@
+// SndBufs and STK instruments reading the same source share one
+// decoded copy through the sample cache, and play what a private
+// (streamed) copy plays
+
+me.dir() + "../../examples/book/digital-artists/audio/stereo_fx_01.wav" => string file;
+
+SndBuf a => blackhole;
+SndBuf b => blackhole;
+SndBuf str => blackhole;
+
+a.read( file );
+Machine.sampleCacheHits() => int hits;
+Machine.sampleCacheMisses() => int misses;
+b.read( file );
+if( Machine.sampleCacheHits() != hits + 1 || Machine.sampleCacheMisses() != misses )
+{
+    <<< "failure: SndBuf not shared" >>>;
+    me.exit();
+}
+
+// streaming never shares
+1024 => str.chunks;
+1 => str.stream;
+str.read( file );
+if( str.samples() != a.samples() || b.samples() != a.samples() || a.samples() == 0 )
+{
+    <<< "failure: samples", a.samples(), b.samples(), str.samples() >>>;
+    me.exit();
+}
+
+1 => a.loop => b.loop => str.loop;
+1.5 => b.rate;
+for( int i; i < 20000; i++ )
+{
+    str.underruns() => int u;
+    1::samp => now;
+    if( a.last() != str.last() && str.underruns() == u )
+    {
+        <<< "failure: shared != streamed" >>>;
+        me.exit();
+    }
+}
+
+// chunked on purpose: read as it plays, not whole and shared; a copy
+// that is already shared is used, though
+me.dir() + "../../examples/book/digital-artists/audio/cowbell_01.wav" => string other;
+SndBuf c => blackhole;
+SndBuf d => blackhole;
+SndBuf e => blackhole;
+1024 => c.chunks;
+c.read( other );
+Machine.sampleCacheHits() => hits;
+d.read( other );
+1024 => e.chunks;
+e.read( other );
+if( Machine.sampleCacheHits() != hits + 1 )
+{
+    <<< "failure: chunked", Machine.sampleCacheHits() - hits >>>;
+    me.exit();
+}
+for( int i; i < 2000; i++ )
+{
+    1::samp => now;
+    if( c.last() != d.last() || e.last() != d.last() )
+    {
+        <<< "failure: chunked != whole" >>>;
+        me.exit();
+    }
+}
+
+// special: waves, once per process
+Machine.sampleCacheMisses() => misses;
+Mandolin m[8];
+Rhodey r[8];
+Mandolin one;
+if( Machine.sampleCacheMisses() > misses + 4 )
+{
+    <<< "failure: instruments not shared", Machine.sampleCacheMisses() - misses >>>;
+    me.exit();
+}
+
+// nothing kept once unreferenced, with no budget
+0 => Machine.sampleCacheBudget;
+b.read( "special:glot_ahh" );
+a.read( "special:glot_ahh" );
+if( a.samples() != b.samples() || a.valueAt( 100 ) != b.valueAt( 100 ) )
+{
+    <<< "failure: special" >>>;
+    me.exit();
+}
+
+<<< "success" >>>;
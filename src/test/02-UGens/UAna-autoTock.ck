@@ -0,0 +1,65 @@
+// a UAna tocked by hop (no shred) analyzes what a shred upchucking it
+// every hop would, and announces each result through its event
+
+SinOsc s => FFT a =^ Centroid ca => blackhole;
+s => FFT b =^ Centroid cb => blackhole;
+256 => a.size => b.size;
+ca.upchuck() @=> UAnaBlob ba;
+cb.upchuck() @=> UAnaBlob bb;
+
+// reference: upchucked by a shred, every hop
+float ref[0];
+fun void drive()
+{
+    while( true )
+    {
+        ca.upchuck();
+        ca.fval(0) => ref[ "" + ( ba.when() / samp ) ];
+        100::samp => now;
+    }
+}
+spork ~ drive();
+
+// and a moving input
+fun void sweep()
+{
+    while( true )
+    {
+        s.freq() * 1.01 + 3 => s.freq;
+        37::samp => now;
+    }
+}
+spork ~ sweep();
+
+100::samp => cb.hop;
+if( cb.hop() != 100::samp || cb.autoTock() )
+{
+    <<< "failure: hop / autoTock" >>>;
+    me.exit();
+}
+1 => cb.autoTock;
+
+now => time start;
+for( 0 => int i; i < 50; i++ )
+{
+    cb.event() => now;
+    // the first tock is now
+    if( now != start + i * 100::samp || bb.when() != now ||
+        cb.fval(0) != ref[ "" + ( bb.when() / samp ) ] )
+    {
+        <<< "failure:", i, now / samp, bb.when() / samp >>>;
+        me.exit();
+    }
+}
+
+// stops
+0 => cb.autoTock;
+bb.when() => time last;
+1::second => now;
+if( bb.when() != last )
+{
+    <<< "failure: still tocking" >>>;
+    me.exit();
+}
+
+<<< "success" >>>;
@@ -0,0 +1,75 @@
+// analysis results are written in place; arrays taken from a blob stay
+// current across upchucks, and fval()/cval() agree with them
+
+SinOsc s => FFT fft =^ Centroid c => blackhole;
+fft =^ FeatureCollector fc => blackhole;
+c =^ fc;
+256 => fft.size;
+
+// before any array is taken
+fft.upchuck();
+c.upchuck();
+fft.fval( 4 ) => float first;
+
+fft.upchuck() @=> UAnaBlob b;
+b.fvals() @=> float held[];
+if( held != fft.fvals() || held.size() != 128 || held[4] != first )
+{
+    <<< "failure: first frame", held.size(), held[4], first >>>;
+    me.exit();
+}
+
+for( 0 => int i; i < 20; i++ )
+{
+    300 + i * 113 => s.freq;
+    256::samp => now;
+    fc.upchuck();
+    // the held array follows the frame
+    for( 0 => int k; k < held.size(); k++ )
+    {
+        fft.cval( k ) $ polar => polar p;
+        if( held[k] != fft.fval( k ) || held[k] != b.fval( k ) || Math.fabs( held[k] - p.mag ) > .000000001 )
+        {
+            <<< "failure:", i, k, held[k], fft.fval( k ), p.mag >>>;
+            me.exit();
+        }
+    }
+    // collected: the spectrum, then the centroid
+    if( fc.fvals().size() != 129 || fc.fval( 7 ) != held[7] || fc.fval( 128 ) != c.fval( 0 ) )
+    {
+        <<< "failure: collected", i, fc.fvals().size() >>>;
+        me.exit();
+    }
+}
+
+// a blob outlives its uana: it keeps the last frame
+UAnaBlob @ kept;
+float kept_f[0];
+complex kept_c[0];
+fun void analyze()
+{
+    SinOsc t => FFT x => blackhole;
+    64 => x.size;
+    64::samp => now;
+    x.upchuck() @=> kept;
+    for( 0 => int k; k < 8; k++ ) { kept_f << x.fval( k ); kept_c << x.cval( k ); }
+}
+spork ~ analyze();
+// (the shred, and with it the FFT, is gone)
+100::samp => now;
+if( kept.fvals().size() != 32 || kept.cvals().size() != 32 )
+{
+    <<< "failure: kept size", kept.fvals().size(), kept.cvals().size() >>>;
+    me.exit();
+}
+for( 0 => int k; k < 8; k++ )
+{
+    if( kept.fval( k ) != kept_f[k] || kept.fvals()[k] != kept_f[k] ||
+        kept.cval( k ) != kept_c[k] || kept.cvals()[k] != kept_c[k] )
+    {
+        <<< "failure: kept", k, kept.fval( k ), kept_f[k] >>>;
+        me.exit();
+    }
+}
+
+<<< "success" >>>;
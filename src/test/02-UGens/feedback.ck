@@ -0,0 +1,39 @@
+// feedback.ck
+// desc: a feedback loop reads the previous sample, and connecting or
+//       disconnecting mid-run takes effect on the next sample
+
+0 => int failures;
+
+// a = step + b[n-1], b = .5 * a
+Step st => Gain a => Gain b => blackhole;
+b => a; .5 => b.gain; 1 => st.next;
+
+b.last() => float prev;
+for( 0 => int i; i < 16; i++ )
+{
+    1::samp => now;
+    1 + prev => float expect;
+    if( Std.fabs( a.last() - expect ) > .0001 ) 1 +=> failures;
+    if( Std.fabs( b.last() - .5 * expect ) > .0001 ) 1 +=> failures;
+    b.last() => prev;
+}
+
+// break the loop
+b =< a;
+1::samp => now;
+if( Std.fabs( a.last() - 1 ) > .0001 ) 1 +=> failures;
+
+// a new branch is ticked from the next sample on
+Step st2 => Gain c => a; 2 => st2.next;
+1::samp => now;
+if( Std.fabs( a.last() - 3 ) > .0001 ) 1 +=> failures;
+
+// channels of a multi-channel ugen reached before the ugen itself
+Step st3 => Pan2 p => blackhole; -1 => p.pan;
+p.left => Gain l => blackhole;
+2::samp => now;
+if( Std.fabs( l.last() - p.left.last() ) > .0001 ) 1 +=> failures;
+if( p.left.last() == 0 ) 1 +=> failures;
+
+if( failures == 0 ) <<< "success" >>>;
+else <<< "failures:", failures >>>;
@@ -0,0 +1,31 @@
+// test asynchronous write: each write waits on the writer thread,
+// which wakes the shred through the vm
+
+fun void busy() { while( true ) 1::samp => now; }
+for( 0 => int i; i < 4; i++ ) spork ~ busy();
+
+FileIO f;
+f.open(me.dir() + "/file.bin", FileIO.WRITE);
+IO.MODE_ASYNC => f.mode;
+
+for( 0 => int i; i < 100; i++ )
+{
+    f.write(i);
+    f.write(" ");
+}
+
+f.close();
+
+// read it back
+f.open(me.dir() + "/file.bin", FileIO.READ);
+for( 0 => int i; i < 100; i++ )
+{
+    if( f.readInt( IO.INT32 ) != i )
+    {
+        <<< "bad value at", i >>>;
+        me.exit();
+    }
+}
+f.close();
+
+<<< "success" >>>;
@@ -0,0 +1,66 @@
+// OscRecv address matching: exact addresses, OSC 1.0 patterns in the
+// incoming address ( matched one part at a time ), and type tags
+
+12004 => int OSC_PORT;
+
+OscRecv recv;
+OSC_PORT => recv.port;
+recv.listen();
+
+recv.event( "/synth/1/freq, f" ) @=> OscEvent freq1;
+recv.event( "/synth/2/freq, f" ) @=> OscEvent freq2;
+recv.event( "/synth/1/gain, f" ) @=> OscEvent gain1;
+recv.event( "/synth/10/freq, f" ) @=> OscEvent freq10;
+recv.event( "/name, s s" ) @=> OscEvent name;
+recv.event( "/name, s s" ) @=> OscEvent name2;
+recv.event( "/done, i" ) @=> OscEvent done;
+
+OscSend xmit;
+xmit.setHost( "localhost", OSC_PORT );
+
+fun void sendf( string addr, float f ) { xmit.startMsg( addr, "f" ); f => xmit.addFloat; }
+
+sendf( "/synth/1/freq", 1 );      // freq1
+sendf( "/synth/*/freq", 2 );      // freq1 freq2 freq10
+sendf( "/synth/?/freq", 3 );      // freq1 freq2
+sendf( "/synth/[2-9]/freq", 4 );  // freq2
+sendf( "/synth/{1,10}/*", 5 );    // freq1 gain1 freq10
+sendf( "/synth/[!1]/freq", 6 );   // freq2
+sendf( "/*/freq", 7 );            // nothing: '*' stays within a part
+sendf( "/synth/1", 8 );           // nothing
+xmit.startMsg( "/synth/1/freq", "i" ); 9 => xmit.addInt; // nothing: type
+xmit.startMsg( "/n*e", "s s" ); "hello" => xmit.addString; "there" => xmit.addString;
+xmit.startMsg( "/name", "s s" ); "again" => xmit.addString; "x" => xmit.addString;
+
+// wait for the receiver thread to get through all of it
+fun void sync() { xmit.startMsg( "/done", "i" ); 0 => xmit.addInt; done => now; done.nextMsg(); }
+sync();
+
+fun string drain( OscEvent e )
+{
+    "" => string s;
+    while( e.nextMsg() ) e.getFloat() $ int + "" +=> s;
+    return s;
+}
+
+if( drain( freq1 ) != "1235" ) { <<< "fail: freq1" >>>; me.exit(); }
+if( drain( freq2 ) != "2346" ) { <<< "fail: freq2" >>>; me.exit(); }
+if( drain( gain1 ) != "5" ) { <<< "fail: gain1" >>>; me.exit(); }
+if( drain( freq10 ) != "25" ) { <<< "fail: freq10" >>>; me.exit(); }
+
+// both listeners see both strings, from one shared copy
+"" => string s;
+while( name.nextMsg() ) name.getString() + name.getString() + "," +=> s;
+if( s != "hellothere,againx," ) { <<< "fail: name" >>>; me.exit(); }
+"" => s;
+while( name2.nextMsg() ) name2.getString() + name2.getString() + "," +=> s;
+if( s != "hellothere,againx," ) { <<< "fail: name2" >>>; me.exit(); }
+
+// re-addressed listeners are re-indexed
+freq10.set( "/synth/3/freq, f" );
+sendf( "/synth/3/freq", 10 );
+sendf( "/synth/10/freq", 11 );
+sync();
+if( drain( freq10 ) != "10" ) { <<< "fail: re-addressed" >>>; me.exit(); }
+
+<<< "success" >>>;
@@ -0,0 +1,49 @@
+// event-broadcast.ck
+// desc: thousands of shreds waiting on one event; every broadcast wakes
+//       all of them at the same time, in the order they waited, ahead of
+//       shreds shreduled later; signal() still wakes one at a time
+
+Event e;
+4000 => int N;
+10 => int ROUNDS;
+0 => int failures;
+0 => int woken;
+-1 => int last;
+
+fun void voice( int id )
+{
+    for( 0 => int r; r < ROUNDS; r++ )
+    {
+        e => now;
+        // wait order
+        if( id != last + 1 ) 1 +=> failures;
+        id => last;
+        woken++;
+    }
+}
+
+for( 0 => int i; i < N; i++ ) spork ~ voice( i );
+// let them all wait
+me.yield();
+
+for( 0 => int r; r < ROUNDS; r++ )
+{
+    -1 => last;
+    0 => woken;
+    now => time before;
+    e.broadcast();
+    me.yield();
+    if( woken != N || now != before ) 1 +=> failures;
+    1::samp => now;
+}
+
+// one at a time
+spork ~ voice( 0 ) @=> Shred one;
+me.yield();
+-1 => last; 0 => woken;
+e.signal();
+me.yield();
+if( woken != 1 ) 1 +=> failures;
+
+if( failures == 0 ) <<< "success" >>>;
+else <<< "failures:", failures >>>;
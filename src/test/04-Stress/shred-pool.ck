@@ -0,0 +1,31 @@
+// shred-pool.ck
+// desc: short-lived shreds reuse pooled shreds and stacks; make sure
+//       recycled shreds start clean, and referenced ones are not reused
+
+0 => int failures;
+
+fun void grain( int i )
+{
+    // fresh locals, even on a reused stack
+    int a; float b; string s;
+    if( a != 0 || b != 0.0 || s != "" ) 1 +=> failures;
+    i => a; i => b; "grain" => s;
+    1::samp => now;
+    if( a != i ) 1 +=> failures;
+}
+
+// hold on to one finished shred
+spork ~ grain( -1 ) @=> Shred held;
+
+for( 0 => int i; i < 2000; i++ )
+{
+    spork ~ grain( i );
+    if( i % 10 == 0 ) 1::samp => now;
+}
+
+2::samp => now;
+
+if( !held.done() ) 1 +=> failures;
+
+if( failures == 0 ) <<< "success" >>>;
+else <<< "failures:", failures >>>;
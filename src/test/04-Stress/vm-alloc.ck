@@ -0,0 +1,35 @@
+// vm-alloc.ck
+// desc: objects and member data come from recycled blocks; make sure
+//       reused blocks start zeroed, and live objects are not reused
+
+0 => int failures;
+
+class Small { int a; }
+class Big { float f[0]; int a; int b; int c; float x; float y; float z; string s; Small @ ref; }
+
+// keep some alive
+Big keep[100];
+for( 0 => int i; i < keep.size(); i++ )
+{
+    new Big @=> keep[i];
+    i => keep[i].a; "keep" + i => keep[i].s;
+    new Small @=> keep[i].ref; i => keep[i].ref.a;
+}
+
+// churn
+for( 0 => int i; i < 20000; i++ )
+{
+    Small s; Big b; Event e;
+    // fresh members, even in a reused block
+    if( s.a != 0 || b.a != 0 || b.x != 0.0 || b.s != "" || b.ref != null ) 1 +=> failures;
+    i => s.a; i => b.a => b.b => b.c; i => b.x; "churn" => b.s; s @=> b.ref;
+}
+
+// the kept ones are untouched
+for( 0 => int i; i < keep.size(); i++ )
+{
+    if( keep[i].a != i || keep[i].s != "keep" + i || keep[i].ref.a != i ) 1 +=> failures;
+}
+
+if( failures == 0 ) <<< "success" >>>;
+else <<< "failures:", failures >>>;
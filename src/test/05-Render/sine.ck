@@ -0,0 +1,9 @@
+// rendered by test.py (see check_render); run normally, it just plays
+
+SinOsc s => dac;
+440 => s.freq;
+.5 => s.gain;
+
+1::second => now;
+
+<<< "success" >>>;
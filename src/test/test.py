@@ -4,10 +4,16 @@ import sys
 import os
 import subprocess
 import time
+import tempfile
+import shutil
+import struct
+import wave
 
 
 failures = 0
 successes = 0
+# extra chuck flags, e.g. --optimize
+flags = []
 
 
 def handle_directory(dir, exe):
@@ -30,7 +36,7 @@ def run_test(exe, path, filename, attempt):
     print "> %s %s" % (exe, path)
 
     try:
-        result = subprocess.check_output([exe, "--silent", "%s" % path], stderr=subprocess.STDOUT)
+        result = subprocess.check_output([exe, "--silent"] + flags + ["%s" % path], stderr=subprocess.STDOUT)
 
         if not result.strip().endswith(("\"success\" : (string)",)):
             if os.path.isfile(path.replace(".ck", ".txt")):
@@ -67,6 +73,62 @@ def handle_failure(exe, path, filename, attempt, error_string):
         fail(filename, error_string)
 
 
+def check_render(exe, dir):
+    script = os.path.join(dir, "05-Render", "sine.ck")
+    if not os.path.isfile(script):
+        return
+
+    print ""
+    print ">>> Performing render checks <<<"
+
+    tmp = tempfile.mkdtemp()
+    try:
+        # cut at the duration; '.raw' in the path must not make it raw
+        os.mkdir(os.path.join(tmp, "x.raw.d"))
+        render_test(exe, script, os.path.join(tmp, "x.raw.d", "out.wav"), 0.5, 22050)
+        # the script halts (after 1 second) before the duration
+        render_test(exe, script, os.path.join(tmp, "out.wav"), 2, 44100)
+    finally:
+        shutil.rmtree(tmp)
+
+
+def render_test(exe, script, out, duration, frames):
+    global successes
+    args = ["--srate:44100", "--render:%s" % out, "--duration:%g" % duration, "--render-format:int16"]
+    name = "%s %s" % (os.path.basename(script), " ".join(args))
+    print "> %s %s %s" % (exe, " ".join(args), script)
+
+    try:
+        subprocess.check_output([exe] + flags + args + [script], stderr=subprocess.STDOUT)
+        w = wave.open(out, "rb")
+        shape = (w.getnchannels(), w.getsampwidth(), w.getframerate(), w.getnframes())
+        data = w.readframes(w.getnframes())
+        w.close()
+    except subprocess.CalledProcessError as e:
+        fail(name, e.output)
+        return
+    except (wave.Error, IOError, EOFError) as e:
+        fail(name, "cannot read '%s' as wav: %s" % (out, e))
+        return
+
+    if shape != (2, 2, 44100, frames):
+        fail(name, "expected (channels, bytes, srate, frames) %s, got %s" % ((2, 2, 44100, frames), shape))
+        return
+
+    # both channels carry the 440Hz sine at half gain
+    samples = struct.unpack("<%dh" % (frames * 2), data)
+    left = samples[0::2]
+    right = samples[1::2]
+    peak = max(abs(x) for x in left)
+    cycles = len([i for i in range(1, frames) if left[i-1] < 0 <= left[i]])
+    expected = int(440 * frames / 44100.0)
+    if left != right or abs(peak - 16384) > 200 or abs(cycles - expected) > 1:
+        fail(name, "bad signal: peak %d, %d cycles (expected %d)" % (peak, cycles, expected))
+        return
+
+    successes += 1
+
+
 def fail(test_name, output):
     global failures
     print "*** Test '%s' failed: ***" % test_name
@@ -75,6 +137,7 @@ def fail(test_name, output):
 
 
 def main():
+    global flags
     exe = 'chuck'
     test_dir = '.'
 
@@ -82,8 +145,11 @@ def main():
         exe = sys.argv[1]
     if len(sys.argv) >= 3:
         test_dir = sys.argv[2]
+    if len(sys.argv) >= 4:
+        flags = sys.argv[3:]
 
     handle_directory(test_dir, exe)
+    check_render(exe, test_dir)
 
     print ""
 
@@ -135,7 +135,7 @@ CK_DLL_MFUN( LPC_cget_coefs );
 
 
 // utility functions
-void xcorr_fft( SAMPLE * f, t_CKINT fs, SAMPLE * g, t_CKINT gs, SAMPLE * buffer, t_CKINT bs );
+void xcorr_fft( SAMPLE * f, t_CKINT fs, SAMPLE * g, t_CKINT gs, SAMPLE * buffer, t_CKINT bs, fft_plan * plan );
 void xcorr_normalize( SAMPLE * buffy, t_CKINT bs, SAMPLE * f, t_CKINT fs, SAMPLE * g, t_CKINT gs );
 
 
@@ -165,6 +165,8 @@ DLL_QUERY extract_query( Chuck_DL_Query * QUERY )
                                         doc.c_str()) )
         return FALSE;
 
+    if( !type_engine_import_uana_async( env ) ) goto error;
+
     // end the class import
     type_engine_import_class_end( env );
 
@@ -181,6 +183,8 @@ DLL_QUERY extract_query( Chuck_DL_Query * QUERY )
                                         doc.c_str()) )
         return FALSE;
 
+    if( !type_engine_import_uana_async( env ) ) goto error;
+
     // compute
     func = make_new_sfun( "float", "compute", Centroid_compute );
     func->add_arg( "float[]", "input" );
@@ -203,6 +207,8 @@ DLL_QUERY extract_query( Chuck_DL_Query * QUERY )
                                         doc.c_str()) )
         return FALSE;
 
+    if( !type_engine_import_uana_async( env ) ) goto error;
+
     // data offset
     Flux_offset_data = type_engine_import_mvar( env, "int", "@Flux_data", FALSE );
     if( Flux_offset_data == CK_INVALID_OFFSET ) goto error;
@@ -243,6 +249,8 @@ DLL_QUERY extract_query( Chuck_DL_Query * QUERY )
                                         doc.c_str()) )
         return FALSE;
 
+    if( !type_engine_import_uana_async( env ) ) goto error;
+
     // compute
     func = make_new_sfun( "float", "compute", RMS_compute );
     func->add_arg( "float[]", "input" );
@@ -265,6 +273,8 @@ DLL_QUERY extract_query( Chuck_DL_Query * QUERY )
                                         doc.c_str()) )
         return FALSE;
 
+    if( !type_engine_import_uana_async( env ) ) goto error;
+
     // data offset
     RollOff_offset_percent = type_engine_import_mvar( env, "float", "@RollOff_data", FALSE );
     if( RollOff_offset_percent == CK_INVALID_OFFSET ) goto error;
@@ -298,6 +308,8 @@ DLL_QUERY extract_query( Chuck_DL_Query * QUERY )
                                         AutoCorr_tick, AutoCorr_tock, AutoCorr_pmsg ) )
         return FALSE;
 
+    if( !type_engine_import_uana_async( env ) ) goto error;
+
     // data offset
     AutoCorr_offset_data = type_engine_import_mvar( env, "float", "@AutoCorr_data", FALSE );
     if( AutoCorr_offset_data == CK_INVALID_OFFSET ) goto error;
@@ -329,6 +341,8 @@ DLL_QUERY extract_query( Chuck_DL_Query * QUERY )
                                         XCorr_tick, XCorr_tock, XCorr_pmsg ) )
         return FALSE;
 
+    if( !type_engine_import_uana_async( env ) ) goto error;
+
     // data offset
     XCorr_offset_data = type_engine_import_mvar( env, "float", "@XCorr_data", FALSE );
     if( XCorr_offset_data == CK_INVALID_OFFSET ) goto error;
@@ -366,6 +380,8 @@ DLL_QUERY extract_query( Chuck_DL_Query * QUERY )
                                         doc.c_str()) )
         return FALSE;
 
+    if( !type_engine_import_uana_async( env ) ) goto error;
+
     // data offset
     ZeroX_offset_data = type_engine_import_mvar( env, "int", "@ZeroX_data", FALSE );
     if( ZeroX_offset_data == CK_INVALID_OFFSET ) goto error;
@@ -404,9 +420,9 @@ CK_DLL_TOCK( FeatureCollector_tock )
     //t_CKFLOAT * features; 
     t_CKINT num_feats = 0;
     t_CKINT num_incoming = UANA->numIncomingUAnae();
-    t_CKINT i, j;
-    
-    
+    t_CKINT i;
+
+
     // Get all incoming features and agglomerate into one vector
     if( num_incoming > 0 )
     {
@@ -418,33 +434,25 @@ CK_DLL_TOCK( FeatureCollector_tock )
             // sanity check
             assert( BLOB_IN != NULL );
             // count number of features from this UAna
-            Chuck_Array8 & these_fvals = BLOB_IN->fvals();
-            num_feats += these_fvals.size();
+            num_feats += BLOB_IN->fvals_size();
         }
 
-        // get fvals of output BLOB
-        Chuck_Array8 & fvals = BLOB->fvals();
-        if( fvals.size() != num_feats )
-            fvals.set_size( num_feats );
+        // get the output BLOB's frame
+        t_CKFLOAT * fvals = BLOB->fvals_frame( num_feats );
 
         t_CKINT next_index = 0;
-        for( i = 0; i < num_incoming; i++ )
+        for( i = 0; fvals && i < num_incoming; i++ )
         {
             // get next blob
             Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( i );
-            Chuck_Array8 & these_fvals = BLOB_IN->fvals();
-            t_CKINT num_these = these_fvals.size();
-            for( j = 0; j < num_these; j++ )
-            {
-                t_CKFLOAT v;
-                these_fvals.get( j, &v );
-                fvals.set( next_index, v);
-                next_index++;
-            }
-        } 
+            t_CKINT num_these = BLOB_IN->fvals_size();
+            // copy its features in
+            if( num_these ) memcpy( fvals + next_index, BLOB_IN->fvals_data(), num_these * sizeof(t_CKFLOAT) );
+            next_index += num_these;
+        }
     } else {
         // no input to collect
-        BLOB->fvals().set_size(0);
+        BLOB->fvals_frame( 0 );
     }
 
     return TRUE;
@@ -456,7 +464,13 @@ CK_DLL_PMSG( FeatureCollector_pmsg )
     return TRUE;
 }
 
-static t_CKFLOAT compute_centroid( Chuck_Array8 & buffer, t_CKUINT size )
+// the values of a script array, in place
+static t_CKFLOAT * array_data( Chuck_Array8 & array )
+{
+    return array.size() ? &array.m_vector[0] : NULL;
+}
+
+static t_CKFLOAT compute_centroid( const t_CKFLOAT * buffer, t_CKUINT size )
 {
     t_CKFLOAT m0 = 0.0;
     t_CKFLOAT m1 = 0.0;
@@ -467,7 +481,7 @@ static t_CKFLOAT compute_centroid( Chuck_Array8 & buffer, t_CKUINT size )
     // Compute centroid using moments
     for( i = 0; i < size; i++ )
     {
-        buffer.get( i, &v );
+        v = buffer[i];
         m1 += (i * v);
         m0 += v;
     }
@@ -498,10 +512,8 @@ CK_DLL_TOCK( Centroid_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array8 & mag = BLOB_IN->fvals();
-        // compute centroid
-        result = compute_centroid( mag, mag.size() );
+        // compute centroid (on the frame, in place)
+        result = compute_centroid( BLOB_IN->fvals_data(), BLOB_IN->fvals_size() );
     }
     // otherwise zero out
     else
@@ -510,13 +522,9 @@ CK_DLL_TOCK( Centroid_tock )
         result = 0.0;
     }
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != 1 )
-        fvals.set_size( 1 );
-    // copy the result in
-    fvals.set( 0, result );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( 1 );
+    if( fvals ) fvals[0] = result;
 
     return TRUE;
 }
@@ -540,7 +548,7 @@ CK_DLL_SFUN( Centroid_compute )
     else
     {
         // do it
-        RETURN->v_float = compute_centroid( *array, array->size() );
+        RETURN->v_float = compute_centroid( array_data( *array ), array->size() );
     }
 }
 
@@ -548,8 +556,8 @@ CK_DLL_SFUN( Centroid_compute )
 // Flux state
 struct StateOfFlux
 {
-    Chuck_Array8 prev;
-    Chuck_Array8 norm;
+    std::vector<t_CKFLOAT> prev;
+    std::vector<t_CKFLOAT> norm;
     t_CKBOOL initialized;
 
     StateOfFlux()
@@ -560,63 +568,53 @@ struct StateOfFlux
 
 
 // compute norm rms
-static void compute_norm_rms( Chuck_Array8 & curr, Chuck_Array8 & norm )
+static void compute_norm_rms( const t_CKFLOAT * curr, t_CKUINT size, t_CKFLOAT * norm )
 {
     t_CKUINT i;
     t_CKFLOAT energy = 0.0;
     t_CKFLOAT v;
 
-    // check size
-    if( norm.size() != curr.size() )
-        norm.set_size( curr.size() );
-
     // get energy
-    for( i = 0; i < curr.size(); i++ )
+    for( i = 0; i < size; i++ )
     {
-        curr.get( i, &v );
+        v = curr[i];
         energy += v * v;
     }
 
     // check energy
-    if (energy == 0.0) 
+    if (energy == 0.0)
     {
         // all zeros
-        norm.zero( 0, norm.size() );
+        for( i = 0; i < size; i++ ) norm[i] = 0.0;
         return;
     }
-    else 
+    else
         energy = ::sqrt( energy );
-    
-    for( i = 0; i < curr.size(); i++ )
+
+    for( i = 0; i < size; i++ )
     {
-        curr.get( i, & v );
-        if( v > 0.0) 
-            norm.set( i, v / energy );
+        v = curr[i];
+        if( v > 0.0)
+            norm[i] = v / energy;
         else
-            norm.set( i, 0.0 );
+            norm[i] = 0.0;
     }
 }
 
 // compute flux
-static t_CKFLOAT compute_flux( Chuck_Array8 & curr, Chuck_Array8 & prev, Chuck_Array8 * write )
+static t_CKFLOAT compute_flux( const t_CKFLOAT * curr, const t_CKFLOAT * prev,
+                               t_CKUINT size, t_CKFLOAT * write )
 {
-    // sanity check
-    assert( curr.size() == prev.size() );
-
-    // ensure size
-    if( write != NULL && (write->size() != curr.size()) )
-        write->set_size( curr.size() );
-
     // find difference
     t_CKFLOAT v, w, result = 0.0;
-    for( t_CKUINT i = 0; i < curr.size(); i++ )
+    for( t_CKUINT i = 0; i < size; i++ )
     {
-        curr.get( i, &v );
-        prev.get( i, &w );
+        v = curr[i];
+        w = prev[i];
         // accumulate into flux
         result += (v - w)*(v - w);
         // copy to write
-        if( write != NULL ) write->set( i, v );
+        if( write != NULL ) write[i] = v;
     }
 
     // take sqrt of flux
@@ -624,37 +622,34 @@ static t_CKFLOAT compute_flux( Chuck_Array8 & curr, Chuck_Array8 & prev, Chuck_A
 }
 
 // compute flux
-static t_CKFLOAT compute_flux( Chuck_Array8 & curr, StateOfFlux & sof )
+static t_CKFLOAT compute_flux( const t_CKFLOAT * curr, t_CKUINT size, StateOfFlux & sof )
 {
     // flux
     t_CKFLOAT result = 0.0;
-    t_CKFLOAT v;
 
     // verify size
-    if( curr.size() != sof.prev.size() )
+    if( size != sof.prev.size() )
     {
         sof.initialized = FALSE;
         // resize prev
-        sof.prev.set_size( curr.size() );
+        sof.prev.resize( size, 0.0 );
     }
+    // (new values start at zero)
+    if( size != sof.norm.size() )
+        sof.norm.resize( size, 0.0 );
 
     // check initialized
-    if( sof.initialized )
+    if( sof.initialized && size )
     {
         // compute normalize rms
-        compute_norm_rms( curr, sof.norm );
+        compute_norm_rms( curr, size, &sof.norm[0] );
         // do it
-        result = compute_flux( sof.norm, sof.prev, &sof.prev );
+        result = compute_flux( &sof.norm[0], &sof.prev[0], size, &sof.prev[0] );
     }
 
     // copy curr to prev
-    for( t_CKUINT i = 0; i < curr.size(); i++ )
-    {
-        // get the value
-        sof.norm.get( i, &v );
-        // set it
-        sof.prev.set( i, v );
-    }
+    for( t_CKUINT i = 0; i < size; i++ )
+        sof.prev[i] = sof.norm[i];
 
     // initialize
     sof.initialized = TRUE;
@@ -701,10 +696,8 @@ CK_DLL_TOCK( Flux_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array8 & mag = BLOB_IN->fvals();
-        // compute flux
-        result = compute_flux( mag, *state );
+        // compute flux (on the frame, in place)
+        result = compute_flux( BLOB_IN->fvals_data(), BLOB_IN->fvals_size(), *state );
     }
     // otherwise zero out
     else
@@ -713,13 +706,9 @@ CK_DLL_TOCK( Flux_tock )
         result = 0.0;
     }
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != 1 )
-        fvals.set_size( 1 );
-    // copy the result in
-    fvals.set( 0, result );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( 1 );
+    if( fvals ) fvals[0] = result;
 
     return TRUE;
 }
@@ -734,6 +723,7 @@ CK_DLL_MFUN( Flux_ctrl_reset )
 {
     // get state
     StateOfFlux * state = (StateOfFlux *)OBJ_MEMBER_UINT( SELF, Flux_offset_data );
+    ((Chuck_UAna *)SELF)->settle();
     // set
     state->initialized = FALSE;
 }
@@ -763,7 +753,7 @@ CK_DLL_SFUN( Flux_compute )
         else
         {
             // flux
-            RETURN->v_float = compute_flux( *lhs, *rhs, NULL );
+            RETURN->v_float = compute_flux( array_data( *lhs ), array_data( *rhs ), lhs->size(), NULL );
         }
     }
 }
@@ -793,14 +783,18 @@ CK_DLL_SFUN( Flux_compute2 )
         }
         else
         {
+            // ensure size
+            if( diff != NULL && diff->size() != lhs->size() )
+                diff->set_size( lhs->size() );
             // flux
-            RETURN->v_float = compute_flux( *lhs, *rhs, diff );
+            RETURN->v_float = compute_flux( array_data( *lhs ), array_data( *rhs ), lhs->size(),
+                                            diff != NULL ? array_data( *diff ) : NULL );
         }
     }
 }
 
 
-static t_CKFLOAT compute_rms( Chuck_Array8 & buffer, t_CKUINT size )
+static t_CKFLOAT compute_rms( const t_CKFLOAT * buffer, t_CKUINT size )
 {
     t_CKFLOAT rms = 0.0;
     t_CKFLOAT v;
@@ -809,7 +803,7 @@ static t_CKFLOAT compute_rms( Chuck_Array8 & buffer, t_CKUINT size )
     // get sum of squares
     for( i = 0; i < size; i++ )
     {
-        buffer.get( i, &v );
+        v = buffer[i];
         rms += (v * v);
     }
 
@@ -838,10 +832,8 @@ CK_DLL_TOCK( RMS_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array8 & mag = BLOB_IN->fvals();
-        // compute centroid
-        result = compute_rms( mag, mag.size() );
+        // compute rms (on the frame, in place)
+        result = compute_rms( BLOB_IN->fvals_data(), BLOB_IN->fvals_size() );
     }
     // otherwise zero out
     else
@@ -850,13 +842,9 @@ CK_DLL_TOCK( RMS_tock )
         result = 0.0;
     }
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != 1 )
-        fvals.set_size( 1 );
-    // copy the result in
-    fvals.set( 0, result );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( 1 );
+    if( fvals ) fvals[0] = result;
 
     return TRUE;
 }
@@ -880,12 +868,12 @@ CK_DLL_SFUN( RMS_compute )
     else
     {
         // do it
-        RETURN->v_float = compute_rms( *array, array->size() );
+        RETURN->v_float = compute_rms( array_data( *array ), array->size() );
     }
 }
 
 
-static t_CKFLOAT compute_rolloff( Chuck_Array8 & buffer, t_CKUINT size, t_CKFLOAT percent )
+static t_CKFLOAT compute_rolloff( const t_CKFLOAT * buffer, t_CKUINT size, t_CKFLOAT percent )
 {
     t_CKFLOAT sum = 0.0, v, target;
     t_CKINT i;
@@ -896,7 +884,7 @@ static t_CKFLOAT compute_rolloff( Chuck_Array8 & buffer, t_CKUINT size, t_CKFLOA
     // iterate
     for( i = 0; i < size; i++ )
     {
-        buffer.get( i, &v );
+        v = buffer[i];
         sum += v;
     }
 
@@ -907,7 +895,7 @@ static t_CKFLOAT compute_rolloff( Chuck_Array8 & buffer, t_CKUINT size, t_CKFLOA
     // iterate
     for( i = 0; i < size; i++ )
     {
-        buffer.get( i, &v );
+        v = buffer[i];
         sum += v;
         if( sum >= target ) break;
     }
@@ -945,10 +933,8 @@ CK_DLL_TOCK( RollOff_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array8 & mag = BLOB_IN->fvals();
-        // compute rolloff
-        result = compute_rolloff( mag, mag.size(), percent );
+        // compute rolloff (on the frame, in place)
+        result = compute_rolloff( BLOB_IN->fvals_data(), BLOB_IN->fvals_size(), percent );
     }
     // otherwise zero out
     else
@@ -957,13 +943,9 @@ CK_DLL_TOCK( RollOff_tock )
         result = 0.0;
     }
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != 1 )
-        fvals.set_size( 1 );
-    // copy the result in
-    fvals.set( 0, result );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( 1 );
+    if( fvals ) fvals[0] = result;
 
     return TRUE;
 }
@@ -978,6 +960,7 @@ CK_DLL_CTRL( RollOff_ctrl_percent )
 {
     // get percent
     t_CKFLOAT percent = GET_NEXT_FLOAT(ARGS);
+    ((Chuck_UAna *)SELF)->settle();
     // check it
     if( percent < 0.0 ) percent = 0.0;
     else if( percent > 1.0 ) percent = 1.0;
@@ -1009,7 +992,7 @@ CK_DLL_SFUN( RollOff_compute )
     else
     {
         // do it
-        RETURN->v_float = compute_rolloff( *array, array->size(), percent );
+        RETURN->v_float = compute_rolloff( array_data( *array ), array->size(), percent );
     }
 }
 
@@ -1030,6 +1013,9 @@ struct Corr_Object
     // result
     SAMPLE * buffy;
     t_CKINT bufcap;
+    // fft tables for bufcap (looked up as the buffers grow, so an async
+    // tock rarely goes to the shared plan cache)
+    fft_plan * plan;
 
     // static corr instance
     static Corr_Object * ourCorr;
@@ -1042,6 +1028,7 @@ struct Corr_Object
         // zero out pointers
         fbuf = gbuf = buffy = NULL;
         fcap = gcap = bufcap = 0;
+        plan = NULL;
         // TODO: default
         resize( 512, 512 );
     }
@@ -1060,6 +1047,7 @@ struct Corr_Object
         SAFE_DELETE_ARRAY( gbuf );
         SAFE_DELETE_ARRAY( buffy );
         fcap = gcap = bufcap = 0;
+        plan = NULL;
     }
 
     // clear
@@ -1098,6 +1086,7 @@ struct Corr_Object
             SAFE_DELETE_ARRAY( buffy );
             buffy = new SAMPLE[mincap];
             bufcap = mincap;
+            plan = bufcap >= 2 ? fft_plan_get( bufcap/2 ) : NULL;
         }
 
         // hopefully
@@ -1137,11 +1126,17 @@ struct Corr_Object
 Corr_Object * Corr_Object::ourCorr = NULL;
 
 // compute correlation
-static void compute_corr( Corr_Object * corr, Chuck_Array8 & f, t_CKINT fs, 
-                          Chuck_Array8 & g, t_CKINT gs, Chuck_Array8 & buffy )
+// size of the correlation of fs and gs values
+static t_CKINT corr_size( t_CKINT fs, t_CKINT gs )
+{
+    return fs + gs > 0 ? fs + gs - 1 : 0;
+}
+
+// (buffy holds corr_size( fs, gs ) values)
+static void compute_corr( Corr_Object * corr, const t_CKFLOAT * f, t_CKINT fs,
+                          const t_CKFLOAT * g, t_CKINT gs, t_CKFLOAT * buffy )
 {
     t_CKINT i;
-    t_CKFLOAT v;
     t_CKINT size;
 
     // ensure size
@@ -1149,19 +1144,13 @@ static void compute_corr( Corr_Object * corr, Chuck_Array8 & f, t_CKINT fs,
 
     // copy into buffers
     for( i = 0; i < fs; i++ )
-    {
-        f.get( i, &v );
-        corr->fbuf[i] = v;
-    }
+        corr->fbuf[i] = f[i];
     for( i = 0; i < gs; i++ )
-    {
-        g.get( i, &v );
-        corr->gbuf[i] = v;
-    }
+        corr->gbuf[i] = g[i];
 
     // compute
     xcorr_fft( corr->fbuf, corr->fcap, corr->gbuf, corr->gcap,
-               corr->buffy, corr->bufcap );
+               corr->buffy, corr->bufcap, corr->plan );
 
     // check flags
     if( corr->normalize )
@@ -1172,12 +1161,9 @@ static void compute_corr( Corr_Object * corr, Chuck_Array8 & f, t_CKINT fs,
     }
 
     // copy into result
-    size = fs + gs - 1;
-    buffy.set_size( size );
-    for( i = 0; i < size; i++ )
-    {
-        buffy.set( i, corr->buffy[i] );
-    }
+    size = corr_size( fs, gs );
+    for( i = 0; buffy && i < size; i++ )
+        buffy[i] = corr->buffy[i];
 }
 
 // AutoCorr
@@ -1212,20 +1198,17 @@ CK_DLL_TOCK( AutoCorr_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array8 & mag = BLOB_IN->fvals();
-        // get fvals of output BLOB
-        Chuck_Array8 & fvals = BLOB->fvals();
-        // compute autocorr
-        compute_corr( ac, mag, mag.size(), mag, mag.size(), fvals );
+        // read the frame in place
+        const t_CKFLOAT * mag = BLOB_IN->fvals_data();
+        t_CKINT size = BLOB_IN->fvals_size();
+        // compute autocorr, into the output BLOB's frame
+        compute_corr( ac, mag, size, mag, size, BLOB->fvals_frame( corr_size( size, size ) ) );
     }
     // otherwise zero out
     else
     {
-        // get fvals of output BLOB
-        Chuck_Array8 & fvals = BLOB->fvals();
-        // resize
-        fvals.set_size( 0 );
+        // empty the output BLOB's frame
+        BLOB->fvals_frame( 0 );
     }
 
     return TRUE;
@@ -1241,6 +1224,7 @@ CK_DLL_CTRL( AutoCorr_ctrl_normalize )
 {
     // get object
     Corr_Object * ac = (Corr_Object *)OBJ_MEMBER_UINT( SELF, AutoCorr_offset_data );
+    ((Chuck_UAna *)SELF)->settle();
     // get percent
     ac->normalize = GET_NEXT_INT(ARGS) != 0;
     // return it
@@ -1266,9 +1250,11 @@ CK_DLL_SFUN( AutoCorr_compute )
 
     // set normalize
     Corr_Object::getOurObject()->normalize = normalize;
+    // size the output
+    output->set_size( corr_size( input->size(), input->size() ) );
     // compute autocrr
-    compute_corr( Corr_Object::getOurObject(), *input, input->size(),
-        *input, input->size(), *output );
+    compute_corr( Corr_Object::getOurObject(), array_data( *input ), input->size(),
+        array_data( *input ), input->size(), array_data( *output ) );
 }
 
 
@@ -1306,21 +1292,18 @@ CK_DLL_TOCK( XCorr_tock )
         Chuck_UAnaBlobProxy * BLOB_G = UANA->getIncomingBlob( 1 );
         // sanity check
         assert( BLOB_F != NULL && BLOB_G != NULL );
-        // get the array
-        Chuck_Array8 & mag_f = BLOB_F->fvals();
-        Chuck_Array8 & mag_g = BLOB_G->fvals();
-        // get fvals of output BLOB
-        Chuck_Array8 & fvals = BLOB->fvals();
-        // compute xcorr
-        compute_corr( xc, mag_f, mag_f.size(), mag_g, mag_g.size(), fvals );
+        // read the frames in place
+        t_CKINT fs = BLOB_F->fvals_size();
+        t_CKINT gs = BLOB_G->fvals_size();
+        // compute xcorr, into the output BLOB's frame
+        compute_corr( xc, BLOB_F->fvals_data(), fs, BLOB_G->fvals_data(), gs,
+                      BLOB->fvals_frame( corr_size( fs, gs ) ) );
     }
     // otherwise zero out
     else
     {
-        // get fvals of output BLOB
-        Chuck_Array8 & fvals = BLOB->fvals();
-        // resize
-        fvals.set_size( 0 );
+        // empty the output BLOB's frame
+        BLOB->fvals_frame( 0 );
     }
 
     return TRUE;
@@ -1336,6 +1319,7 @@ CK_DLL_CTRL( XCorr_ctrl_normalize )
 {
     // get object
     Corr_Object * ac = (Corr_Object *)OBJ_MEMBER_UINT( SELF, XCorr_offset_data );
+    ((Chuck_UAna *)SELF)->settle();
     // get percent
     ac->normalize = GET_NEXT_INT(ARGS) != 0;
     // return it
@@ -1362,9 +1346,11 @@ CK_DLL_SFUN( XCorr_compute )
 
     // set normalize
     Corr_Object::getOurObject()->normalize = normalize;
+    // size the output
+    output->set_size( corr_size( f->size(), g->size() ) );
     // compute autocrr
-    compute_corr( Corr_Object::getOurObject(), *f, f->size(),
-        *g, g->size(), *output );
+    compute_corr( Corr_Object::getOurObject(), array_data( *f ), f->size(),
+        array_data( *g ), g->size(), array_data( *output ) );
 }
 
 
@@ -1372,16 +1358,19 @@ CK_DLL_SFUN( XCorr_compute )
 
 //-----------------------------------------------------------------------------
 // name: xcorr_fft()
-// desc: FFT-based cross correlation
+// desc: FFT-based cross correlation, with the plan for size (or NULL)
 //-----------------------------------------------------------------------------
-void xcorr_fft( SAMPLE * f, t_CKINT fsize, SAMPLE * g, t_CKINT gsize, SAMPLE * buffy, t_CKINT size )
+void xcorr_fft( SAMPLE * f, t_CKINT fsize, SAMPLE * g, t_CKINT gsize, SAMPLE * buffy, t_CKINT size, fft_plan * plan )
 {
     // sanity check
-    assert( fsize == gsize == size );
+    assert( fsize == size && gsize == size );
+    assert( !plan || plan->NC == size/2 );
 
     // take fft
-    rfft( f, size/2, FFT_FORWARD );
-    rfft( g, size/2, FFT_FORWARD );
+    if( plan ) rfft_plan( plan, f, FFT_FORWARD );
+    else rfft( f, size/2, FFT_FORWARD );
+    if( plan ) rfft_plan( plan, g, FFT_FORWARD );
+    else rfft( g, size/2, FFT_FORWARD );
 
     // complex
     t_CKCOMPLEX_SAMPLE * F = (t_CKCOMPLEX_SAMPLE *)f;
@@ -1399,7 +1388,8 @@ void xcorr_fft( SAMPLE * f, t_CKINT fsize, SAMPLE * g, t_CKINT gsize, SAMPLE * b
     }
 
     // inverse fft
-    rfft( buffy, size/2, FFT_INVERSE );
+    if( plan ) rfft_plan( plan, buffy, FFT_INVERSE );
+    else rfft( buffy, size/2, FFT_INVERSE );
 }
 
 
@@ -1429,16 +1419,16 @@ void xcorr_normalize( SAMPLE * buffy, t_CKINT size, SAMPLE * f, t_CKINT fs, SAMP
 
 // ZeroX
 #define __SGN(x)  (x >= 0.0f ? 1.0f : -1.0f )
-static t_CKINT compute_zerox( Chuck_Array8 & buffer, t_CKUINT size )
+static t_CKINT compute_zerox( const t_CKFLOAT * buffer, t_CKUINT size )
 {
     t_CKUINT i, xings = 0;
     t_CKFLOAT v = 0, p = 0;
-    buffer.get( 0, &p );
+    if( size ) p = buffer[0];
 
     // Compute centroid using moments
     for( i = 0; i < size; i++ )
     {
-        buffer.get( i, &v );
+        v = buffer[i];
         xings += __SGN(v) != __SGN(p);
         p = v;
     }
@@ -1478,10 +1468,8 @@ CK_DLL_TOCK( ZeroX_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array8 & mag = BLOB_IN->fvals();
-        // compute ZeroX
-        result = (t_CKFLOAT)( compute_zerox( mag, mag.size() ) + .5 );
+        // compute ZeroX (on the frame, in place)
+        result = (t_CKFLOAT)( compute_zerox( BLOB_IN->fvals_data(), BLOB_IN->fvals_size() ) + .5 );
     }
     // otherwise zero out
     else
@@ -1490,13 +1478,9 @@ CK_DLL_TOCK( ZeroX_tock )
         result = 0.0;
     }
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != 1 )
-        fvals.set_size( 1 );
-    // copy the result in
-    fvals.set( 0, result );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( 1 );
+    if( fvals ) fvals[0] = result;
 
     return TRUE;
 }
@@ -1520,6 +1504,6 @@ CK_DLL_SFUN( ZeroX_compute )
     else
     {
         // do it
-        RETURN->v_float = (t_CKFLOAT)( compute_centroid( *array, array->size() ) + .5 );
+        RETURN->v_float = (t_CKFLOAT)( compute_centroid( array_data( *array ), array->size() ) + .5 );
     }
 }
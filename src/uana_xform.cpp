@@ -45,6 +45,7 @@ CK_DLL_DTOR( FFT_dtor );
 CK_DLL_TICK( FFT_tick );
 CK_DLL_PMSG( FFT_pmsg );
 CK_DLL_TOCK( FFT_tock );
+CK_DLL_SNAP( FFT_snap );
 CK_DLL_CTRL( FFT_ctrl_window );
 CK_DLL_CGET( FFT_cget_window );
 CK_DLL_CGET( FFT_cget_windowSize );
@@ -79,6 +80,7 @@ CK_DLL_DTOR( Flip_dtor );
 CK_DLL_TICK( Flip_tick );
 CK_DLL_PMSG( Flip_pmsg );
 CK_DLL_TOCK( Flip_tock );
+CK_DLL_SNAP( Flip_snap );
 CK_DLL_CTRL( Flip_ctrl_window );
 CK_DLL_CGET( Flip_cget_window );
 CK_DLL_CGET( Flip_cget_windowSize );
@@ -113,6 +115,7 @@ CK_DLL_DTOR( DCT_dtor );
 CK_DLL_TICK( DCT_tick );
 CK_DLL_PMSG( DCT_pmsg );
 CK_DLL_TOCK( DCT_tock );
+CK_DLL_SNAP( DCT_snap );
 CK_DLL_CTRL( DCT_ctrl_window );
 CK_DLL_CGET( DCT_cget_window );
 CK_DLL_CGET( DCT_cget_windowSize );
@@ -183,6 +186,8 @@ DLL_QUERY xform_query( Chuck_DL_Query * QUERY )
     FFT_offset_data = type_engine_import_mvar( env, "int", "@FFT_data", FALSE );
     if( FFT_offset_data == CK_INVALID_OFFSET ) goto error;
 
+    if( !type_engine_import_uana_async( env, FFT_snap ) ) goto error;
+
     // transform
     func = make_new_mfun( "void", "transform", FFT_transform );
     func->add_arg( "float[]", "from" );
@@ -327,6 +332,8 @@ DLL_QUERY xform_query( Chuck_DL_Query * QUERY )
     Flip_offset_data = type_engine_import_mvar( env, "int", "@Flip_data", FALSE );
     if( Flip_offset_data == CK_INVALID_OFFSET ) goto error;
 
+    if( !type_engine_import_uana_async( env, Flip_snap ) ) goto error;
+
     // transform
     func = make_new_mfun( "void", "transform", Flip_take );
     func->add_arg( "float[]", "from" );
@@ -432,6 +439,8 @@ DLL_QUERY xform_query( Chuck_DL_Query * QUERY )
     DCT_offset_data = type_engine_import_mvar( env, "int", "@DCT_data", FALSE );
     if( DCT_offset_data == CK_INVALID_OFFSET ) goto error;
 
+    if( !type_engine_import_uana_async( env, DCT_snap ) ) goto error;
+
     // transform
     func = make_new_mfun( "void", "transform", DCT_transform );
     func->add_arg( "float[]", "from" );
@@ -487,7 +496,7 @@ DLL_QUERY xform_query( Chuck_DL_Query * QUERY )
 
     // transform
     func = make_new_mfun( "void", "transform", IDCT_transform );
-    func->add_arg( "complex[]", "from" );
+    func->add_arg( "float[]", "from" );
     func->doc = "Manually take IDCT (as opposed to using .upchuck() / upchuck operator).";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
@@ -564,6 +573,8 @@ public:
     SAMPLE * m_buffer;
     // result
     t_CKCOMPLEX * m_spectrum;
+    // tables for this size
+    fft_plan * m_plan;
 };
 
 
@@ -581,6 +592,7 @@ FFT_object::FFT_object()
     m_window_size = m_size;
     m_buffer = NULL;
     m_spectrum = NULL;
+    m_plan = NULL;
     // initialize window
     this->window( NULL, m_window_size );
     // allocate buffer
@@ -648,6 +660,8 @@ t_CKBOOL FFT_object::resize( t_CKINT size )
     memset( m_spectrum, 0, size/2 * sizeof(t_CKCOMPLEX) );
     // set
     m_size = size;
+    // get the tables for this size
+    m_plan = size >= 2 ? fft_plan_get( size/2 ) : NULL;
     // if no window specified, then set accum size
     if( !m_window )
     {
@@ -744,7 +758,8 @@ void FFT_object::transform()
     // zero pad
     memset( m_buffer + m_window_size, 0, (m_size - m_window_size)*sizeof(SAMPLE) );
     // go for it
-    rfft( m_buffer, m_size/2, FFT_FORWARD );
+    if( m_plan ) rfft_plan( m_plan, m_buffer, FFT_FORWARD );
+    else rfft( m_buffer, m_size/2, FFT_FORWARD );
     // copy into the result
     SAMPLE * ptr = m_buffer;
     for( t_CKINT i = 0; i < m_size/2; i++ )
@@ -919,28 +934,33 @@ CK_DLL_TOCK( FFT_tock )
     // microsoft blows
     t_CKINT i;
 
-    // get cvals of output BLOB
-    Chuck_Array16 & cvals = BLOB->cvals();
-    // ensure capacity == resulting size
-    if( cvals.size() != fft->m_size/2 )
-        cvals.set_size( fft->m_size/2 );
-    // copy the result in
-    for( i = 0; i < fft->m_size/2; i++ )
-        cvals.set( i, fft->m_spectrum[i] );
-
-    // get fvals of output BLOB; fill with magnitude spectrum
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != fft->m_size/2 )
-        fvals.set_size( fft->m_size/2 );
-    // copy the result in
-    for( i = 0; i < fft->m_size/2; i++ )
-        fvals.set( i, __modulus(fft->m_spectrum[i]) );
+    // write the spectrum into the output BLOB's frame
+    t_CKCOMPLEX * cvals = BLOB->cvals_frame( fft->m_size/2 );
+    if( cvals ) memcpy( cvals, fft->m_spectrum, fft->m_size/2 * sizeof(t_CKCOMPLEX) );
+
+    // and the magnitude spectrum
+    t_CKFLOAT * fvals = BLOB->fvals_frame( fft->m_size/2 );
+    if( fvals )
+        for( i = 0; i < fft->m_size/2; i++ )
+            fvals[i] = __modulus(fft->m_spectrum[i]);
 
     return TRUE;
 }
 
 
+//-----------------------------------------------------------------------------
+// name: 
+// desc: copy the accumulated samples for an async tock
+//-----------------------------------------------------------------------------
+CK_DLL_SNAP( FFT_snap )
+{
+    // get object
+    FFT_object * fft = (FFT_object *)OBJ_MEMBER_UINT(SELF, FFT_offset_data);
+    // the tock reads this instead of the live buffer
+    fft->m_accum.snap();
+}
+
+
 //-----------------------------------------------------------------------------
 // name: 
 // desc: 
@@ -949,6 +969,7 @@ CK_DLL_MFUN( FFT_transform )
 {
     // get object
     FFT_object * fft = (FFT_object *)OBJ_MEMBER_UINT(SELF, FFT_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get array
     Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
     // do it
@@ -964,6 +985,7 @@ CK_DLL_CTRL( FFT_ctrl_window )
 {
     // get object
     FFT_object * fft = (FFT_object *)OBJ_MEMBER_UINT(SELF, FFT_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get window (can be NULL)
     Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
     // set it
@@ -1005,6 +1027,7 @@ CK_DLL_CTRL( FFT_ctrl_size )
 {
     // get object
     FFT_object * fft = (FFT_object *)OBJ_MEMBER_UINT(SELF, FFT_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get arg
     t_CKINT size = GET_NEXT_INT(ARGS);
     // sanity check
@@ -1055,6 +1078,7 @@ CK_DLL_MFUN( FFT_spectrum )
 {
     // get object
     FFT_object * fft = (FFT_object *)OBJ_MEMBER_UINT(SELF, FFT_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get array
     Chuck_Array16 * arr = (Chuck_Array16 *)GET_NEXT_OBJECT(ARGS);
     // check for null
@@ -1102,6 +1126,8 @@ public:
     SAMPLE * m_buffer;
     // result
     SAMPLE * m_inverse;
+    // tables for this size
+    fft_plan * m_plan;
 };
 
 
@@ -1119,6 +1145,7 @@ IFFT_object::IFFT_object()
     m_window_size = m_size;
     m_buffer = NULL;
     m_inverse = NULL;
+    m_plan = NULL;
     // initialize window
     this->window( NULL, m_window_size );
     // allocate buffer
@@ -1186,6 +1213,8 @@ t_CKBOOL IFFT_object::resize( t_CKINT size )
     memset( m_inverse, 0, size * sizeof(SAMPLE) );
     // set
     m_size = size;
+    // get the tables for this size
+    m_plan = size >= 2 ? fft_plan_get( size/2 ) : NULL;
     // set deccum size
     m_deccum.resize( m_size );
     // if no window specified, then set accum size
@@ -1271,7 +1300,8 @@ void IFFT_object::transform( )
     // sanity
     assert( m_window_size <= m_size );
     // go for it
-    rfft( m_buffer, m_size/2, FFT_INVERSE );
+    if( m_plan ) rfft_plan( m_plan, m_buffer, FFT_INVERSE );
+    else rfft( m_buffer, m_size/2, FFT_INVERSE );
     // copy
     memcpy( m_inverse, m_buffer, m_size * sizeof(SAMPLE) );
     // apply window, if there is one
@@ -1411,21 +1441,20 @@ CK_DLL_TOCK( IFFT_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array16 & cmp = BLOB_IN->cvals();
+        // read the frame in place
+        const t_CKCOMPLEX * cmp = BLOB_IN->cvals_data();
+        t_CKINT size = BLOB_IN->cvals_size();
         // resize if necessary
-        if( cmp.size()*2 > ifft->m_size )
-            ifft->resize( cmp.size()*2 );
+        if( size*2 > ifft->m_size )
+            ifft->resize( size*2 );
         // sanity check
         assert( ifft->m_buffer != NULL );
-        // copy into transform buffer
-        t_CKCOMPLEX cval;
+        // copy into transform buffer (zero padded)
         for( t_CKINT i = 0; i < ifft->m_size/2; i++ )
         {
             // copy complex value in
-            cmp.get( i, &cval );
-            ifft->m_buffer[i*2] = cval.re;
-            ifft->m_buffer[i*2+1] = cval.im;
+            ifft->m_buffer[i*2] = i < size ? cmp[i].re : 0;
+            ifft->m_buffer[i*2+1] = i < size ? cmp[i].im : 0;
         }
 
         // take transform
@@ -1440,14 +1469,11 @@ CK_DLL_TOCK( IFFT_tock )
         memset( ifft->m_inverse, 0, sizeof(SAMPLE)*ifft->m_size );
     }
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != ifft->m_size )
-        fvals.set_size( ifft->m_size );
-    // copy the result in
-    for( t_CKINT i = 0; i < ifft->m_size; i++ )
-        fvals.set( i, ifft->m_inverse[i] );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( ifft->m_size );
+    if( fvals )
+        for( t_CKINT i = 0; i < ifft->m_size; i++ )
+            fvals[i] = ifft->m_inverse[i];
 
     return TRUE;
 }
@@ -2103,19 +2129,29 @@ CK_DLL_TOCK( Flip_tock )
     // microsoft blows
     t_CKINT i;
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure capacity == resulting size
-    if( fvals.size() != flip->m_size )
-        fvals.set_size( flip->m_size );
-    // copy the result in
-    for( i = 0; i < flip->m_size; i++ )
-        fvals.set( i, flip->m_buffer[i] );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( flip->m_size );
+    if( fvals )
+        for( i = 0; i < flip->m_size; i++ )
+            fvals[i] = flip->m_buffer[i];
 
     return TRUE;
 }
 
 
+//-----------------------------------------------------------------------------
+// name: 
+// desc: copy the accumulated samples for an async tock
+//-----------------------------------------------------------------------------
+CK_DLL_SNAP( Flip_snap )
+{
+    // get object
+    Flip_object * flip = (Flip_object *)OBJ_MEMBER_UINT(SELF, Flip_offset_data);
+    // the tock reads this instead of the live buffer
+    flip->m_accum.snap();
+}
+
+
 //-----------------------------------------------------------------------------
 // name: 
 // desc: 
@@ -2124,6 +2160,7 @@ CK_DLL_MFUN( Flip_take )
 {
     // get object
     Flip_object * flip = (Flip_object *)OBJ_MEMBER_UINT(SELF, Flip_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get array
     Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
     // do it
@@ -2139,6 +2176,7 @@ CK_DLL_CTRL( Flip_ctrl_window )
 {
     // get object
     Flip_object * flip = (Flip_object *)OBJ_MEMBER_UINT(SELF, Flip_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get window (can be NULL)
     Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
     // set it
@@ -2180,6 +2218,7 @@ CK_DLL_CTRL( Flip_ctrl_size )
 {
     // get object
     Flip_object * flip = (Flip_object *)OBJ_MEMBER_UINT(SELF, Flip_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get arg
     t_CKINT size = GET_NEXT_INT(ARGS);
     // sanity check
@@ -2230,6 +2269,7 @@ CK_DLL_MFUN( Flip_output )
 {
     // get object
     Flip_object * flip = (Flip_object *)OBJ_MEMBER_UINT(SELF, Flip_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get array
     Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
     // check for null
@@ -2564,21 +2604,17 @@ CK_DLL_TOCK( UnFlip_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array8 & val = BLOB_IN->fvals();
+        // read the frame in place
+        const t_CKFLOAT * val = BLOB_IN->fvals_data();
+        t_CKINT size = BLOB_IN->fvals_size();
         // resize if necessary
-        if( val.size() > unflip->m_size )
-            unflip->resize( val.size() );
+        if( size > unflip->m_size )
+            unflip->resize( size );
         // sanity check
         assert( unflip->m_buffer != NULL );
-        // copy into transform buffer
-        t_CKFLOAT v;
+        // copy into transform buffer (zero padded)
         for( t_CKINT i = 0; i < unflip->m_size; i++ )
-        {
-            // copy value in
-            val.get( i, &v );
-            unflip->m_buffer[i] = v;
-        }
+            unflip->m_buffer[i] = i < size ? val[i] : 0;
 
         // take transform
         unflip->transform();
@@ -2591,14 +2627,11 @@ CK_DLL_TOCK( UnFlip_tock )
         memset( unflip->m_buffer, 0, sizeof(SAMPLE)*unflip->m_size );
     }
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != unflip->m_size )
-        fvals.set_size( unflip->m_size );
-    // copy the result in
-    for( t_CKINT i = 0; i < unflip->m_size; i++ )
-        fvals.set( i, unflip->m_buffer[i] );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( unflip->m_size );
+    if( fvals )
+        for( t_CKINT i = 0; i < unflip->m_size; i++ )
+            fvals[i] = unflip->m_buffer[i];
 
     return TRUE;
 }
@@ -2770,7 +2803,8 @@ public:
     t_CKBOOL resize( t_CKINT size );
     t_CKBOOL window( Chuck_Array8 * window, t_CKINT win_size );
     void transform( );
-    void transform( const t_CKFLOAT * in, t_CKCOMPLEX * out );
+    void transformFromAccum( );
+    void transform( Chuck_Array8 * frame );
     void copyTo( Chuck_Array8 * frame );
 
 public:
@@ -2784,7 +2818,9 @@ public:
     AccumBuffer m_accum;
     // DCT buffer
     SAMPLE * m_buffer;
-    // DCT matrix
+    // FFT plan (power of 2 sizes)
+    fft_plan * m_plan;
+    // DCT matrix (other sizes)
     SAMPLE ** m_matrix;
     // result
     SAMPLE * m_spectrum;
@@ -2804,6 +2840,7 @@ DCT_object::DCT_object()
     m_window = NULL;
     m_window_size = m_size;
     m_buffer = NULL;
+    m_plan = NULL;
     m_matrix = NULL;
     m_spectrum = NULL;
     // initialize window
@@ -2847,15 +2884,21 @@ t_CKBOOL DCT_object::resize( t_CKINT size )
     // reallocate
     SAFE_DELETE_ARRAY( m_buffer );
     delete_matrix( m_matrix, m_size );
+    m_matrix = NULL;
     SAFE_DELETE_ARRAY( m_spectrum );
     m_size = 0;
     m_buffer = new SAMPLE[size];
     m_spectrum = new SAMPLE[size];
-    m_matrix = new SAMPLE *[size];
-    for( i = 0; i < size; i++ ) m_matrix[i] = new SAMPLE[size];
+    // power of 2: through the FFT, otherwise the matrix
+    m_plan = ( size >= 2 && !(size & (size-1)) ) ? fft_plan_get( size/2 ) : NULL;
+    if( !m_plan )
+    {
+        m_matrix = new SAMPLE *[size];
+        for( i = 0; i < size; i++ ) m_matrix[i] = new SAMPLE[size];
+    }
 
     // check it
-    if( !m_buffer || !m_spectrum || !m_matrix )
+    if( !m_buffer || !m_spectrum || (!m_plan && !m_matrix) )
     {
         // out of memory
         fprintf( stderr, "[chuck]: DCT failed to allocate %ld, %ld buffers...\n",
@@ -2863,6 +2906,7 @@ t_CKBOOL DCT_object::resize( t_CKINT size )
         // clean
         SAFE_DELETE_ARRAY( m_buffer );
         delete_matrix( m_matrix, size );
+        m_matrix = NULL;
         SAFE_DELETE_ARRAY( m_spectrum );
         // done
         return FALSE;
@@ -2872,7 +2916,7 @@ t_CKBOOL DCT_object::resize( t_CKINT size )
     memset( m_buffer, 0, size * sizeof(SAMPLE) );
     memset( m_spectrum, 0, size * sizeof(SAMPLE) );
     // compute dct matrix
-    the_dct_matrix( m_matrix, size );
+    if( m_matrix ) the_dct_matrix( m_matrix, size );
     // set
     m_size = size;
     // if no window specified, then set accum size
@@ -2965,15 +3009,57 @@ void DCT_object::transform( )
     // sanity
     assert( m_window_size <= m_size );
 
-    // get the last buffer of samples
-    m_accum.get( m_buffer, m_window_size );
     // apply window, if there is one
     if( m_window )
         apply_window( m_buffer, m_window, m_window_size );
     // zero pad
     memset( m_buffer + m_window_size, 0, (m_size - m_window_size)*sizeof(SAMPLE) );
     // go for it
-    the_dct_now( m_buffer, m_matrix, m_size, m_spectrum, m_size );
+    if( m_plan ) the_dct_plan( m_plan, m_buffer, m_size, m_spectrum, m_size );
+    else the_dct_now( m_buffer, m_matrix, m_size, m_spectrum, m_size );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: transformFromAccum()
+// desc: ...
+//-----------------------------------------------------------------------------
+void DCT_object::transformFromAccum()
+{
+    // get the last buffer of samples
+    m_accum.get( m_buffer, m_window_size );
+
+    // um
+    transform();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: transform()
+// desc: ...
+//-----------------------------------------------------------------------------
+void DCT_object::transform( Chuck_Array8 * frame )
+{
+    // convert to right type
+    t_CKINT amount = ck_min( frame->size(), m_size );
+    // copy
+    t_CKFLOAT v;
+    for( t_CKINT i = 0; i < amount; i++ )
+    {
+        frame->get( i, &v );
+        m_buffer[i] = v;
+    }
+
+    // zero pad
+    for( t_CKINT j = amount; j < m_size; j++ )
+        m_buffer[j] = 0;
+
+    // um
+    this->transform();
 }
 
 
@@ -3092,23 +3178,33 @@ CK_DLL_TOCK( DCT_tock )
     // get object
     DCT_object * dct = (DCT_object *)OBJ_MEMBER_UINT(SELF, DCT_offset_data);
     // take transform
-    dct->transform();
+    dct->transformFromAccum();
     // microsoft blows
     t_CKINT i;
 
-    // get cvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure capacity == resulting size
-    if( fvals.size() != dct->m_size )
-        fvals.set_size( dct->m_size );
-    // copy the result in
-    for( i = 0; i < dct->m_size; i++ )
-        fvals.set( i, dct->m_spectrum[i] );
+    // write the coefficients into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( dct->m_size );
+    if( fvals )
+        for( i = 0; i < dct->m_size; i++ )
+            fvals[i] = dct->m_spectrum[i];
 
     return TRUE;
 }
 
 
+//-----------------------------------------------------------------------------
+// name: 
+// desc: copy the accumulated samples for an async tock
+//-----------------------------------------------------------------------------
+CK_DLL_SNAP( DCT_snap )
+{
+    // get object
+    DCT_object * dct = (DCT_object *)OBJ_MEMBER_UINT(SELF, DCT_offset_data);
+    // the tock reads this instead of the live buffer
+    dct->m_accum.snap();
+}
+
+
 //-----------------------------------------------------------------------------
 // name: 
 // desc: 
@@ -3116,9 +3212,12 @@ CK_DLL_TOCK( DCT_tock )
 CK_DLL_MFUN( DCT_transform )
 {
     // get object
-//    DCT_object * dct = (DCT_object *)OBJ_MEMBER_UINT(SELF, DCT_offset_data);
+    DCT_object * dct = (DCT_object *)OBJ_MEMBER_UINT(SELF, DCT_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get array
-//    Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
+    Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
+    // do it
+    dct->transform( arr );
 }
 
 
@@ -3130,6 +3229,7 @@ CK_DLL_CTRL( DCT_ctrl_window )
 {
     // get object
     DCT_object * dct = (DCT_object *)OBJ_MEMBER_UINT(SELF, DCT_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get window (can be NULL)
     Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
     // set it
@@ -3167,6 +3267,7 @@ CK_DLL_CTRL( DCT_ctrl_size )
 {
     // get object
     DCT_object * dct = (DCT_object *)OBJ_MEMBER_UINT(SELF, DCT_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get arg
     t_CKINT size = GET_NEXT_INT(ARGS);
     // sanity check
@@ -3217,6 +3318,7 @@ CK_DLL_MFUN( DCT_spectrum )
 {
     // get object
     DCT_object * dct = (DCT_object *)OBJ_MEMBER_UINT(SELF, DCT_offset_data);
+    ((Chuck_UAna *)SELF)->settle();
     // get array
     Chuck_Array8 * arr = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
     // check for null
@@ -3262,7 +3364,9 @@ public:
     DeccumBuffer m_deccum;
     // IDCT buffer
     SAMPLE * m_buffer;
-    // IDCT matrix
+    // FFT plan (power of 2 sizes)
+    fft_plan * m_plan;
+    // IDCT matrix (other sizes)
     SAMPLE ** m_matrix;
     // result
     SAMPLE * m_inverse;
@@ -3282,6 +3386,7 @@ IDCT_object::IDCT_object()
     m_window = NULL;
     m_window_size = m_size;
     m_buffer = NULL;
+    m_plan = NULL;
     m_matrix = NULL;
     m_inverse = NULL;
     // initialize window
@@ -3325,14 +3430,20 @@ t_CKBOOL IDCT_object::resize( t_CKINT size )
     // reallocate
     SAFE_DELETE_ARRAY( m_buffer );
     delete_matrix( m_matrix, m_size );
+    m_matrix = NULL;
     SAFE_DELETE_ARRAY( m_inverse );
     m_size = 0;
     m_buffer = new SAMPLE[size];
-    m_matrix = new SAMPLE *[size];
-    for( i = 0; i < size; i++ ) m_matrix[i] = new SAMPLE[size];
+    // power of 2: through the FFT, otherwise the matrix
+    m_plan = ( size >= 2 && !(size & (size-1)) ) ? fft_plan_get( size/2 ) : NULL;
+    if( !m_plan )
+    {
+        m_matrix = new SAMPLE *[size];
+        for( i = 0; i < size; i++ ) m_matrix[i] = new SAMPLE[size];
+    }
     m_inverse = new SAMPLE[size];
     // check it TODO: check individual m_matrix[i]
-    if( !m_buffer || !m_inverse || !m_matrix )
+    if( !m_buffer || !m_inverse || (!m_plan && !m_matrix) )
     {
         // out of memory
         fprintf( stderr, "[chuck]: IDCT failed to allocate %ld, %ld, %ldx%ld buffers...\n",
@@ -3340,6 +3451,7 @@ t_CKBOOL IDCT_object::resize( t_CKINT size )
         // clean
         SAFE_DELETE_ARRAY( m_buffer );
         delete_matrix( m_matrix, size );
+        m_matrix = NULL;
         SAFE_DELETE_ARRAY( m_inverse );
         // done
         return FALSE;
@@ -3349,7 +3461,7 @@ t_CKBOOL IDCT_object::resize( t_CKINT size )
     memset( m_buffer, 0, size * sizeof(SAMPLE) );
     memset( m_inverse, 0, size * sizeof(SAMPLE) );
     // compute IDCT matrix
-    the_inverse_dct_matrix( m_matrix, size );
+    if( m_matrix ) the_inverse_dct_matrix( m_matrix, size );
     // set
     m_size = size;
     // set deccum size
@@ -3437,7 +3549,8 @@ void IDCT_object::transform( )
     // sanity
     assert( m_window_size <= m_size );
     // go for it
-    the_inverse_dct_now( m_buffer, m_matrix, m_size, m_inverse, m_size );
+    if( m_plan ) the_inverse_dct_plan( m_plan, m_buffer, m_size, m_inverse, m_size );
+    else the_inverse_dct_now( m_buffer, m_matrix, m_size, m_inverse, m_size );
     // apply window, if there is one
     if( m_window )
         apply_window( m_inverse, m_window, m_window_size );
@@ -3573,22 +3686,21 @@ CK_DLL_TOCK( IDCT_tock )
         Chuck_UAnaBlobProxy * BLOB_IN = UANA->getIncomingBlob( 0 );
         // sanity check
         assert( BLOB_IN != NULL );
-        // get the array
-        Chuck_Array16 & cmp = BLOB_IN->cvals();
+        // read the frame in place (DCT puts its coefficients in fvals)
+        const t_CKFLOAT * coefs = BLOB_IN->fvals_data();
+        t_CKINT size = BLOB_IN->fvals_size();
         // resize if necessary
-        if( cmp.size()*2 > idct->m_size )
-            idct->resize( cmp.size()*2 );
+        if( size > idct->m_size )
+            idct->resize( size );
         // sanity check
         assert( idct->m_buffer != NULL );
         // copy into transform buffer
-        t_CKCOMPLEX cval;
-        for( t_CKINT i = 0; i < idct->m_size/2; i++ )
-        {
-            // copy complex value in
-            cmp.get( i, &cval );
-            idct->m_buffer[i*2] = cval.re;
-            idct->m_buffer[i*2+1] = cval.im;
-        }
+        t_CKINT amount = ck_min( size, idct->m_size );
+        for( t_CKINT i = 0; i < amount; i++ )
+            idct->m_buffer[i] = coefs[i];
+        // zero pad
+        for( t_CKINT j = amount; j < idct->m_size; j++ )
+            idct->m_buffer[j] = 0;
 
         // take transform
         idct->transform();
@@ -3602,14 +3714,11 @@ CK_DLL_TOCK( IDCT_tock )
         memset( idct->m_inverse, 0, sizeof(SAMPLE)*idct->m_size );
     }
 
-    // get fvals of output BLOB
-    Chuck_Array8 & fvals = BLOB->fvals();
-    // ensure size == resulting size
-    if( fvals.size() != idct->m_size )
-        fvals.set_size( idct->m_size );
-    // copy the result in
-    for( t_CKINT i = 0; i < idct->m_size; i++ )
-        fvals.set( i, idct->m_inverse[i] );
+    // write the result into the output BLOB's frame
+    t_CKFLOAT * fvals = BLOB->fvals_frame( idct->m_size );
+    if( fvals )
+        for( t_CKINT i = 0; i < idct->m_size; i++ )
+            fvals[i] = idct->m_inverse[i];
 
     return TRUE;
 }
@@ -3623,7 +3732,7 @@ CK_DLL_MFUN( IDCT_transform )
 {
     // get object
     IDCT_object * idct = (IDCT_object *)OBJ_MEMBER_UINT(SELF, IDCT_offset_data);
-    // get complex array
+    // get float array
     Chuck_Array8 * frame = (Chuck_Array8 *)GET_NEXT_OBJECT(ARGS);
     // sanity
     if( frame == NULL ) goto null_pointer;
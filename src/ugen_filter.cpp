@@ -164,6 +164,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         BPF_ctor, NULL, BPF_tick, BPF_pmsg, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, BPF_tickv ) ) goto error;
+
     type_engine_import_add_ex(env, "filter/bp.ck");
     
     // freq
@@ -202,6 +205,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
     if( !type_engine_import_ugen_begin( env, "BRF", "FilterBasic", env->global(),
                                         BRF_ctor, NULL, BRF_tick, BRF_pmsg, doc.c_str() ) )
         return FALSE;
+
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, BRF_tickv ) ) goto error;
     
     type_engine_import_add_ex(env, "filter/br.ck");
 
@@ -241,6 +247,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
     if( !type_engine_import_ugen_begin( env, "LPF", "FilterBasic", env->global(),
                                         RLPF_ctor, NULL, RLPF_tick, RLPF_pmsg, doc.c_str() ) )
         return FALSE;
+
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, RLPF_tickv ) ) goto error;
     
     type_engine_import_add_ex(env, "filter/lp.ck");
 
@@ -280,6 +289,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
     if( !type_engine_import_ugen_begin( env, "HPF", "FilterBasic", env->global(),
                                         RHPF_ctor, NULL, RHPF_tick, RHPF_pmsg, doc.c_str() ) )
         return FALSE;
+
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, RHPF_tickv ) ) goto error;
     
     type_engine_import_add_ex(env, "filter/hp.ck");
 
@@ -320,6 +332,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         ResonZ_ctor, NULL, ResonZ_tick, ResonZ_pmsg, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, ResonZ_tickv ) ) goto error;
+
     type_engine_import_add_ex(env, "filter/resonz.ck");
     
     // freq
@@ -359,6 +374,9 @@ DLL_QUERY filter_query( Chuck_DL_Query * QUERY )
                                         biquad_ctor, biquad_dtor, biquad_tick, NULL, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, biquad_tickv ) ) goto error;
+
     // member variable
     biquad_offset_data = type_engine_import_mvar ( env, "int", "@biquad_data", FALSE );
     if ( biquad_offset_data == CK_INVALID_OFFSET ) goto error;
@@ -1261,6 +1279,19 @@ CK_DLL_TICK( BPF_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: BPF_tickv()
+// desc: block TICK function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( BPF_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = d->tick_bpf( in[i] );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: BPF_ctrl_freq()
 // desc: CTRL function
@@ -1375,6 +1406,19 @@ CK_DLL_TICK( BRF_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: BRF_tickv()
+// desc: block TICK function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( BRF_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = d->tick_brf( in[i] );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: BRF_ctrl_freq()
 // desc: CTRL function
@@ -1491,6 +1535,19 @@ CK_DLL_TICK( RLPF_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: RLPF_tickv()
+// desc: block TICK function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( RLPF_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = d->tick_rlpf( in[i] );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: RLPF_ctrl_freq()
 // desc: CTRL function
@@ -1607,6 +1664,19 @@ CK_DLL_TICK( ResonZ_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: ResonZ_tickv()
+// desc: block TICK function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( ResonZ_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = d->tick_resonz( in[i] );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: ResonZ_ctrl_freq()
 // desc: CTRL function
@@ -1723,6 +1793,19 @@ CK_DLL_TICK( RHPF_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: RHPF_tickv()
+// desc: block TICK function ...
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( RHPF_tickv )
+{
+    FilterBasic_data * d = (FilterBasic_data *)OBJ_MEMBER_UINT(SELF, FilterBasic_offset_data);
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = d->tick_rhpf( in[i] );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: RHPF_ctrl_freq()
 // desc: CTRL function
@@ -1969,6 +2052,45 @@ CK_DLL_TICK( biquad_tick )
     return TRUE;
 }
 
+//-----------------------------------------------------------------------------
+// name: biquad_tickv()
+// desc: block TICK function ... state is kept in locals across the block
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( biquad_tickv )
+{
+    biquad_data * d = (biquad_data *)OBJ_MEMBER_UINT(SELF, biquad_offset_data );
+    
+    // coefficients
+    SAMPLE a0 = d->m_a0, a1 = d->m_a1, a2 = d->m_a2;
+    SAMPLE b0 = d->m_b0, b1 = d->m_b1, b2 = d->m_b2;
+    // state
+    SAMPLE x0 = d->m_input0, x1 = d->m_input1, x2 = d->m_input2;
+    SAMPLE y0 = d->m_output0, y1 = d->m_output1, y2 = d->m_output2;
+
+    for( t_CKUINT i = 0; i < nframes; i++ )
+    {
+        x0 = a0 * in[i];
+        y0 = b0 * x0 + b1 * x1 + b2 * x2;
+        y0 -= a2 * y2 + a1 * y1;
+        x2 = x1;
+        x1 = x0;
+        y2 = y1;
+        y1 = y0;
+
+        // be normal
+        CK_DDN(y1);
+        CK_DDN(y2);
+
+        out[i] = y0;
+    }
+
+    // write back
+    d->m_input0 = x0; d->m_input1 = x1; d->m_input2 = x2;
+    d->m_output0 = y0; d->m_output1 = y1; d->m_output2 = y2;
+
+    return TRUE;
+}
+
 void biquad_set_reson( biquad_data * d )
 {
     d->m_a2 = (SAMPLE)(d->prad * d->prad);
@@ -145,6 +145,9 @@ DLL_QUERY osc_query( Chuck_DL_Query * QUERY )
                                         NULL, NULL, sinosc_tick, NULL,
                                         doc.c_str() ) )
         return FALSE;
+
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, sinosc_tickv ) ) goto error;
     
     type_engine_import_add_ex( env, "basic/whirl.ck" );
 
@@ -160,6 +163,9 @@ DLL_QUERY osc_query( Chuck_DL_Query * QUERY )
                                         NULL, NULL, triosc_tick, NULL,
                                         doc.c_str() ) )
         return FALSE;
+
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, triosc_tickv ) ) goto error;
     
     func = make_new_mfun( "float", "width", osc_ctrl_width );
     func->add_arg( "float", "width" );
@@ -205,6 +211,9 @@ DLL_QUERY osc_query( Chuck_DL_Query * QUERY )
                                         doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, pulseosc_tickv ) ) goto error;
+
     func = make_new_mfun( "float", "width", osc_ctrl_width );
     func->add_arg( "float", "width" );
     func->doc = "Length of duty cycle [0,1).";
@@ -606,6 +615,141 @@ CK_DLL_TICK( pulseosc_tick )
 // sqrosc_tick is pulseosc_tick at width=0.5 -pld;
 
 
+
+
+//-----------------------------------------------------------------------------
+// name: sinosc_tickv()
+// desc: block tick; with an input connected the sync modes need per-sample
+//       control so we fall back to the scalar tick, otherwise free-run
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( sinosc_tickv )
+{
+    // get the data
+    Osc_Data * d = (Osc_Data *)OBJ_MEMBER_UINT(SELF, osc_offset_data );
+    Chuck_UGen * ugen = (Chuck_UGen *)SELF;
+    t_CKUINT i;
+
+    // if input
+    if( ugen->m_num_src )
+    {
+        for( i = 0; i < nframes; i++ )
+            sinosc_tick( SELF, in[i], &out[i], SHRED, API );
+        return TRUE;
+    }
+
+    // local copies
+    t_CKFLOAT phase = d->phase;
+    t_CKFLOAT num = d->num;
+
+    for( i = 0; i < nframes; i++ )
+    {
+        // set output
+        out[i] = (SAMPLE) ::sin( phase * TWO_PI );
+        // next phase
+        phase += num;
+        // keep the phase between 0 and 1
+        if( phase > 1.0 ) phase -= 1.0;
+        else if( phase < 0.0 ) phase += 1.0;
+    }
+
+    // write back
+    d->phase = phase;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: triosc_tickv()
+// desc: block tick (also used by SawOsc)
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( triosc_tickv )
+{
+    // get the data
+    Osc_Data * d = (Osc_Data *)OBJ_MEMBER_UINT(SELF, osc_offset_data );
+    Chuck_UGen * ugen = (Chuck_UGen *)SELF;
+    t_CKUINT i;
+
+    // if input
+    if( ugen->m_num_src )
+    {
+        for( i = 0; i < nframes; i++ )
+            triosc_tick( SELF, in[i], &out[i], SHRED, API );
+        return TRUE;
+    }
+
+    // local copies
+    t_CKFLOAT phase = d->phase;
+    t_CKFLOAT num = d->num;
+    t_CKFLOAT width = d->width;
+    t_CKFLOAT p;
+
+    for( i = 0; i < nframes; i++ )
+    {
+        // compute
+        p = phase + .25; if( p > 1.0 ) p -= 1.0;
+        if( p < width ) out[i] = (SAMPLE)( width == 0.0 ? 1.0 : -1.0 + 2.0 * p / width );
+        else out[i] = (SAMPLE)( width == 1.0 ? 0 : 1.0 - 2.0 * (p - width) / (1.0 - width) );
+        // advance internal phase
+        phase += num;
+        // keep the phase between 0 and 1
+        if( phase > 1.0 ) phase -= 1.0;
+        else if( phase < 0.0 ) phase += 1.0;
+    }
+
+    // write back
+    d->phase = phase;
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: pulseosc_tickv()
+// desc: block tick (also used by SqrOsc)
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( pulseosc_tickv )
+{
+    // get the data
+    Osc_Data * d = (Osc_Data *)OBJ_MEMBER_UINT(SELF, osc_offset_data );
+    Chuck_UGen * ugen = (Chuck_UGen *)SELF;
+    t_CKUINT i;
+
+    // if input
+    if( ugen->m_num_src )
+    {
+        for( i = 0; i < nframes; i++ )
+            pulseosc_tick( SELF, in[i], &out[i], SHRED, API );
+        return TRUE;
+    }
+
+    // local copies
+    t_CKFLOAT phase = d->phase;
+    t_CKFLOAT num = d->num;
+    t_CKFLOAT width = d->width;
+
+    for( i = 0; i < nframes; i++ )
+    {
+        // compute
+        out[i] = phase < width ? 1.0f : -1.0f;
+        // move phase
+        phase += num;
+        // keep the phase between 0 and 1
+        if( phase > 1.0 ) phase -= 1.0;
+        else if( phase < 0.0 ) phase += 1.0;
+    }
+
+    // write back
+    d->phase = phase;
+
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: osc_ctrl_freq()
 // desc: set oscillator frequency
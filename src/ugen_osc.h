@@ -59,12 +59,15 @@ CK_DLL_CGET( osc_cget_sync );
 
 // sinosc
 CK_DLL_TICK( sinosc_tick );
+CK_DLL_TICKV( sinosc_tickv );
 
 // pulseosc
 CK_DLL_TICK( pulseosc_tick );
+CK_DLL_TICKV( pulseosc_tickv );
 
 // triosc
 CK_DLL_TICK( triosc_tick );
+CK_DLL_TICKV( triosc_tickv );
 
 // sawosc 
 CK_DLL_CTOR( sawosc_ctor );
@@ -41,6 +41,7 @@
 #include "chuck_vm.h"
 #include "chuck_lang.h"
 #include "chuck_globals.h"
+#include "util_buffers.h"
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -4392,6 +4393,8 @@ by Perry R. Cook and Gary P. Scavone, 1995 - 2002.";
     if( !type_engine_import_ugen_begin( env, "WvOut", "UGen", env->global(), 
                         WvOut_ctor, WvOut_dtor,
                         WvOut_tick, WvOut_pmsg, doc.c_str() ) ) return FALSE;
+    // writes go through one shared write thread
+    if( !type_engine_import_ugen_serial( env ) ) goto error;
     
     //member variable
     WvOut_offset_data = type_engine_import_mvar ( env, "int", "@WvOut_data", FALSE );
@@ -16232,31 +16235,24 @@ MY_FLOAT Voicer :: lastOutRight() const
 #include <math.h>
 
 WaveLoop :: WaveLoop( const char *fileName, bool raw, bool generate )
-  : WvIn( fileName, raw ), phaseOffset(0.0)
+  : WvIn( ), phaseOffset(0.0)
 {
   m_freq = 0;
-  // If at end of file, redo extra sample frame for looping.
-  if (chunkPointer+bufferSize == fileSize) {
-    for (unsigned int j=0; j<channels; j++)
-      data[bufferSize*channels+j] = data[j];
-  }
-
+  // WvIn keeps the extra sample frame for looping
+  m_loop = true;
+  WvIn::openFile( fileName, raw );
 }
 
 WaveLoop :: WaveLoop( )
   : WvIn( ), phaseOffset(0.0)
-{ m_freq = 0; } 
+{ m_freq = 0; m_loop = true; } 
 
 void
 WaveLoop :: openFile( const char * fileName, bool raw, bool norm )
 {
     m_loaded = FALSE;
+    // (the extra sample frame for looping is written by WvIn)
     WvIn::openFile( fileName, raw, norm );
-    // If at end of file, redo extra sample frame for looping.
-    if (chunkPointer+bufferSize == fileSize) {
-      for (unsigned int j=0; j<channels; j++)
-        data[bufferSize*channels+j] = data[j];
-    }
     m_loaded = TRUE;
 }
 
@@ -16814,7 +16810,9 @@ WvIn :: ~WvIn()
     if (fd)
         fclose(fd);
 
-    if (data)
+    if (m_shared)
+        SampleCache::instance()->release( m_shared );
+    else if (data)
         delete [] data;
 
     if (lastOutput)
@@ -16829,6 +16827,8 @@ void WvIn :: init( void )
     m_loaded = false;
     // strcpy ( m_filename, "" );
     data = 0;
+    m_shared = NULL;
+    m_loop = false;
     lastOutput = 0;
     chunking = false;
     finished = true;
@@ -16845,14 +16845,63 @@ void WvIn :: closeFile( void )
     str_filename.str = "";
 }
 
+// free data handed to the sample cache
+static void wvin_free_data( void * data )
+{
+    delete [] (MY_FLOAT *)data;
+}
+
+// sample cache key: whatever changes the loaded data
+static std::string wvin_cache_key( const char * fileName, bool raw, bool doNormalize,
+                                   bool loop, bool special )
+{
+    char buffer[128];
+    if ( special )
+        sprintf( buffer, ":%d%d%d", raw, doNormalize, loop );
+    else {
+        // a file that changes on disk is a different entry
+        struct stat filestat;
+        if ( stat(fileName, &filestat) == -1 ) return "";
+        sprintf( buffer, ":%d%d%d:%ld:%ld", raw, doNormalize, loop,
+                 (long)filestat.st_size, (long)filestat.st_mtime );
+    }
+    return std::string("WvIn:") + fileName + buffer;
+}
+
 void WvIn :: openFile( const char *fileName, bool raw, bool doNormalize, bool generate )
 {
+    // let go of shared data; never reuse it below
+    if ( m_shared ) {
+        SampleCache::instance()->release( m_shared );
+        m_shared = NULL;
+        data = 0;
+        bufferSize = 0;
+    }
+
     unsigned long lastChannels = channels;
-    unsigned long samples, lastSamples = (bufferSize+1)*channels;
+    unsigned long samples, lastSamples = data ? (bufferSize+1)*channels : 0;
+    bool special = generate && strstr(fileName, "special:");
+    std::string key = wvin_cache_key( fileName, raw, doNormalize, m_loop, special );
     str_filename.str = fileName;
     //strncpy ( m_filename, fileName, 255 );
     //m_filename[255] = '\0';
-    if(!generate || !strstr(fileName, "special:"))
+
+    // already loaded by another reader
+    if ( key.size() && shareData( key ) )
+    {
+        if ( !special ) closeFile();
+        if ( lastChannels < channels ) {
+            if ( lastOutput ) delete [] lastOutput;
+            lastOutput = (MY_FLOAT *) new MY_FLOAT[channels];
+        }
+        reset();
+        m_loaded = true;
+        finished = false;
+        interpolate = ( fmod( rate, 1.0 ) != 0.0 );
+        return;
+    }
+
+    if(!special)
     {
         closeFile();
 
@@ -17041,6 +17090,13 @@ void WvIn :: openFile( const char *fileName, bool raw, bool doNormalize, bool ge
     else readData( 0 );  // Load file data.
 
     if ( doNormalize ) normalize();
+    // extra sample frame for looping
+    if ( m_loop && chunkPointer+bufferSize == fileSize ) {
+      for (unsigned int j=0; j<channels; j++)
+        data[bufferSize*channels+j] = data[j];
+    }
+    // share it from now on (files read in chunks keep reading)
+    if ( key.size() && !chunking ) publishData( key );
     m_loaded = true;
     finished = false;
     interpolate = ( fmod( rate, 1.0 ) != 0.0 );
@@ -17604,6 +17660,45 @@ void WvIn :: readData( unsigned long index )
   handleError(msg, StkError::FILE_ERROR);
 }
 
+bool WvIn :: shareData( const std::string & key )
+{
+  SampleCacheEntry * entry = SampleCache::instance()->acquire( key );
+  if ( !entry ) return false;
+
+  if ( data ) delete [] data;
+  m_shared = entry;
+  data = (MY_FLOAT *)entry->data;
+  channels = entry->channels;
+  fileSize = bufferSize = entry->frames;
+  fileRate = entry->srate;
+  rate = fileRate / Stk::sampleRate();
+  chunking = false;
+  chunkPointer = 0;
+  dataOffset = 0;
+  return true;
+}
+
+void WvIn :: publishData( const std::string & key )
+{
+  unsigned long samples = (bufferSize+1)*channels;
+  m_shared = SampleCache::instance()->insert( key, data, samples * sizeof(MY_FLOAT),
+                                              wvin_free_data, bufferSize, channels, fileRate );
+  // (another reader may have published it first)
+  data = (MY_FLOAT *)m_shared->data;
+}
+
+void WvIn :: unshareData( void )
+{
+  if ( !m_shared ) return;
+
+  unsigned long samples = (bufferSize+1)*channels;
+  MY_FLOAT * copy = (MY_FLOAT *) new MY_FLOAT[samples];
+  memcpy( copy, data, samples * sizeof(MY_FLOAT) );
+  SampleCache::instance()->release( m_shared );
+  m_shared = NULL;
+  data = copy;
+}
+
 void WvIn :: reset(void)
 {
   time = (MY_FLOAT) 0.0;
@@ -17632,6 +17727,9 @@ void WvIn :: normalize(MY_FLOAT peak)
   unsigned long i;
   MY_FLOAT max = (MY_FLOAT) 0.0;
 
+  // scaling shared data would scale it for everyone
+  unshareData();
+
   for (i=0; i<channels*bufferSize; i++) {
     if (fabs(data[i]) > max)
       max = (MY_FLOAT) fabs((double) data[i]);
@@ -17968,8 +18066,9 @@ void WvOut :: init()
   flush = 0;
   fileGain = 1;
     
+    // (enough messages to cover the data buffer in producer-sized writes)
     if(s_writeThread == NULL)
-        s_writeThread = new XWriteThread(2<<20, 32);
+        s_writeThread = new XWriteThread(2<<20, (2<<20)/XWriteThread::PRODUCER_BUFFER_SIZE);
     asyncIO = TRUE;
 }
 
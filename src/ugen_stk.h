@@ -1110,6 +1110,9 @@ class BandedWG : public Instrmnt
 
 #include <stdio.h>
 
+// decoded data shared through the sample cache (util_buffers.h)
+struct SampleCacheEntry;
+
 class WvIn : public Stk
 {
 public:
@@ -1245,6 +1248,15 @@ public: // SWAP formerly protected
   // Get MAT-file header information.
   bool getMatInfo( const char *fileName );
 
+  // Take data from the sample cache, if it has it.
+  bool shareData( const std::string & key );
+
+  // Give loaded data to the sample cache, to share from then on.
+  void publishData( const std::string & key );
+
+  // Make a private copy of shared data, before writing to it.
+  void unshareData( void );
+
   char msg[256];
   // char m_filename[256]; // chuck data
   Chuck_String str_filename; // chuck data
@@ -1265,6 +1277,10 @@ public: // SWAP formerly protected
   MY_FLOAT gain;
   MY_FLOAT time;
   MY_FLOAT rate;
+  // data is the cache's, not ours (never write to it)
+  SampleCacheEntry * m_shared;
+  // keep the extra sample frame for looping (WaveLoop)
+  bool m_loop;
 public:
   bool m_loaded;
 };
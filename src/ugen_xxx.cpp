@@ -53,8 +53,14 @@
 #include "chuck_vm.h"
 #include "chuck_globals.h"
 #include "chuck_instr.h"
+#include "util_buffers.h"
+#include "util_thread.h"
+#ifndef __PLATFORM_WIN32__
+#include <unistd.h> // usleep
+#endif
 
 #include <fstream>
+#include <algorithm>
 using namespace std;
 
 
@@ -65,6 +71,7 @@ CK_DLL_CTOR( subgraph_ctor );
 CK_DLL_CTOR( foogen_ctor );
 CK_DLL_DTOR( foogen_dtor );
 CK_DLL_TICK( foogen_tick );
+CK_DLL_TICKV( foogen_tickv );
 
 
 // LiSa query
@@ -153,8 +160,13 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
     if( !type_engine_import_ugen_begin( env, "Chugen", "UGen", env->global(),
                                         foogen_ctor, foogen_dtor, foogen_tick, NULL, 1, 1, doc.c_str() ) )
         return FALSE;
+    // ticks run chuck code
+    if( !type_engine_import_ugen_serial( env ) ) goto error;
+    // tickv( float in[], float out[] ), if the chugen defines it
+    if( !type_engine_import_ugen_tickv( env, foogen_tickv ) ) goto error;
     
     if( !type_engine_import_add_ex( env, "extend/chugen.ck" ) ) goto error;
+    if( !type_engine_import_add_ex( env, "extend/chugen-block.ck" ) ) goto error;
 
     foogen_offset_data = type_engine_import_mvar( env, "int", "@foogen_data", FALSE );
     if( foogen_offset_data == CK_INVALID_OFFSET ) goto error;
@@ -307,6 +319,9 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
                                         NULL, NULL, NULL, NULL, doc.c_str() ) )
         return FALSE;
     
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, gain_tickv ) ) goto error;
+    
     if( !type_engine_import_add_ex( env, "basic/i-robot.ck" ) ) goto error;
     
     // end import
@@ -332,6 +347,9 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
                                         NULL, NULL, noise_tick, NULL, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, noise_tickv ) ) goto error;
+
     if( !type_engine_import_add_ex( env, "basic/wind.ck" ) ) goto error;
     if( !type_engine_import_add_ex( env, "shred/powerup.ck" ) ) goto error;
 
@@ -637,6 +655,9 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
                                         sndbuf_tick, NULL, 1, 1, doc.c_str() ) )
         return FALSE;
 
+    // block tick
+    if( !type_engine_import_ugen_tickv( env, sndbuf_tickv ) ) goto error;
+
     if( !type_engine_import_add_ex( env, "basic/sndbuf.ck" ) ) goto error;
     
     // add member variable
@@ -760,6 +781,41 @@ DLL_QUERY xxx_query( Chuck_DL_Query * QUERY )
     func->doc = "Chunk size, in frames, for loading the file from disk. 0 indicates that chunking is disabled.";
     if( !type_engine_import_mfun( env, func ) ) goto error;
 
+    // add ctrl: stream
+    func = make_new_mfun( "int", "stream", sndbuf_ctrl_stream );
+    func->add_arg( "int", "stream" );
+    func->doc = "Toggle streaming (set before read). Chunks are then loaded from disk ahead of the play head on a separate thread; requires chunking.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+    // add cget: stream
+    func = make_new_mfun( "int", "stream", sndbuf_cget_stream );
+    func->doc = "Toggle streaming (set before read). Chunks are then loaded from disk ahead of the play head on a separate thread; requires chunking.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add ctrl: streamAhead
+    func = make_new_mfun( "int", "streamAhead", sndbuf_ctrl_stream_ahead );
+    func->add_arg( "int", "chunks" );
+    func->doc = "Number of chunks to load ahead of the play head when streaming (set before read). Default is 2.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+    // add cget: streamAhead
+    func = make_new_mfun( "int", "streamAhead", sndbuf_cget_stream_ahead );
+    func->doc = "Number of chunks to load ahead of the play head when streaming.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add ctrl: streamMax
+    func = make_new_mfun( "int", "streamMax", sndbuf_ctrl_stream_max );
+    func->add_arg( "int", "chunks" );
+    func->doc = "Maximum number of chunks kept in memory when streaming (set before read); the chunks least soon to be played are evicted first. Default is 8.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+    // add cget: streamMax
+    func = make_new_mfun( "int", "streamMax", sndbuf_cget_stream_max );
+    func->doc = "Maximum number of chunks kept in memory when streaming.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
+    // add cget: underruns
+    func = make_new_mfun( "int", "underruns", sndbuf_cget_underruns );
+    func->doc = "Number of samples played as silence because their chunk was not yet loaded when streaming.";
+    if( !type_engine_import_mfun( env, func ) ) goto error;
+
     // add cget: samples
     func = make_new_mfun( "int", "samples", sndbuf_cget_samples );
     func->doc = "Total number of sample frames in the file.";
@@ -983,6 +1039,9 @@ DLL_QUERY lisa_query( Chuck_DL_Query * QUERY )
                                         LiSaMulti_tick, NULL,
                                         LiSaMulti_pmsg, 1, 1 ))
         return FALSE;
+
+    // block tick: all playing voices for a whole block
+    if( !type_engine_import_ugen_tickv( env, LiSaMulti_tickv ) ) goto error;
 	
     // set/get buffer size
     func = make_new_mfun( "dur", "duration", LiSaMulti_size );
@@ -1283,9 +1342,98 @@ struct FooGen_Data
     
     t_CKFLOAT input;
     t_CKFLOAT output;
+
+    // block tick: tickv( float in[], float out[] ), if defined
+    Chuck_VM_Shred * shred_v;
+    Chuck_Array8 * input_v;
+    Chuck_Array8 * output_v;
 };
 
 
+//-----------------------------------------------------------------------------
+// name: foogen_is_float_array()
+// desc: ...
+//-----------------------------------------------------------------------------
+static t_CKBOOL foogen_is_float_array( Chuck_Type * type )
+{
+    return type && type->array_depth == 1 && type->array_type == &t_float;
+}
+
+
+//-----------------------------------------------------------------------------
+// name: foogen_code()
+// desc: code that calls func on SELF, resolved now instead of per tick
+//-----------------------------------------------------------------------------
+static void foogen_code( Chuck_Object * SELF, Chuck_Func * func,
+                         vector<Chuck_Instr *> & instrs )
+{
+    // push this (as func arg)
+    instrs.push_back(new Chuck_Instr_Reg_Push_Imm((t_CKUINT)SELF) ); // 1.3.1.0: changed to t_CKUINT
+    // push the code (was: dup this, dot member func, func to code)
+    instrs.push_back(new Chuck_Instr_Reg_Push_Imm((t_CKUINT)func->code) );
+    // push stack depth
+    instrs.push_back(new Chuck_Instr_Reg_Push_Imm(12));
+    // func call
+    instrs.push_back(new Chuck_Instr_Func_Call());
+}
+
+
+//-----------------------------------------------------------------------------
+// name: foogen_shred()
+// desc: shred to run instrs on, for the life of the chugen
+//-----------------------------------------------------------------------------
+static Chuck_VM_Shred * foogen_shred( vector<Chuck_Instr *> & instrs )
+{
+    // EOC
+    instrs.push_back(new Chuck_Instr_EOC);
+    
+    Chuck_VM_Code * code = new Chuck_VM_Code;
+    
+    code->instr = new Chuck_Instr*[instrs.size()];
+    code->num_instr = instrs.size();
+    for(int i = 0; i < instrs.size(); i++) code->instr[i] = instrs[i];
+    code->stack_depth = 0;
+    code->need_this = 0;
+    
+    Chuck_VM_Shred * shred = new Chuck_VM_Shred;
+    // (the shred holds the code, and frees it when it goes)
+    shred->initialize(code);
+    // held by the chugen
+    shred->add_ref();
+
+    return shred;
+}
+
+
+//-----------------------------------------------------------------------------
+// name: foogen_run()
+// desc: reset a tick shred and run it
+//-----------------------------------------------------------------------------
+static void foogen_run( FooGen_Data * data, Chuck_VM_Shred * shred )
+{
+    // program counter
+    shred->pc = 0;
+    shred->next_pc = 1;
+    // shred in dump (all done)
+    shred->is_dumped = FALSE;
+    // shred done
+    shred->is_done = FALSE;
+    // shred running
+    shred->is_running = FALSE;
+    // shred abort
+    shred->is_abort = FALSE;
+    // set the instr
+    shred->instr = shred->code->instr;
+    // zero out the id
+    shred->xid = 0;
+    // set vmRef
+    shred->vm_ref = data->vm;
+    
+    // run shred
+    shred->run( data->vm );
+}
+
+
 //-----------------------------------------------------------------------------
 // name: foogen_ctor()
 // desc: ...
@@ -1296,17 +1444,24 @@ CK_DLL_CTOR( foogen_ctor )
     
     data->shred = NULL;
     data->vm = SHRED->vm_ref;
+    data->shred_v = NULL;
+    data->input_v = NULL;
+    data->output_v = NULL;
     
     // 1.3.1.0: changed from unsigned int to t_CKUINT
     OBJ_MEMBER_UINT(SELF, foogen_offset_data) = (t_CKUINT)data;
 
     Chuck_UGen * ugen = (Chuck_UGen *)SELF;
-    int tick_fun_index = -1;
+    Chuck_Func * tick_fun = NULL;
+    Chuck_Func * tick_fun_v = NULL;
     
     for(int i = 0; i < ugen->vtable->funcs.size(); i++)
     {
         Chuck_Func * func = ugen->vtable->funcs[i];
-        if(func->name.find("tick") == 0 && 
+        // (compiled before any instance can be made)
+        if( func->name.find("tick") != 0 || !func->code )
+            continue;
+        if(!tick_fun &&
            // ensure has one argument
            func->def->arg_list != NULL &&
            // ensure first argument is float
@@ -1316,49 +1471,64 @@ CK_DLL_CTOR( foogen_ctor )
            // ensure returns float
            func->def->ret_type == &t_float )
         {
-            tick_fun_index = i;
-            break;
+            tick_fun = func;
+        }
+        else if(!tick_fun_v && func->name.find("tickv@") == 0 &&
+           // ensure has two arguments
+           func->def->arg_list != NULL && func->def->arg_list->next != NULL &&
+           func->def->arg_list->next->next == NULL &&
+           // ensure both are float[]
+           foogen_is_float_array( func->def->arg_list->type ) &&
+           foogen_is_float_array( func->def->arg_list->next->type ) &&
+           // ensure returns void
+           func->def->ret_type == &t_void )
+        {
+            tick_fun_v = func;
         }
     }
     
-    if( tick_fun_index != -1 )
+    if( tick_fun )
     {
         vector<Chuck_Instr *> instrs;
         // push arg (float input)
         instrs.push_back(new Chuck_Instr_Reg_Push_Deref2( (t_CKUINT)&data->input ) );
-        // push this (as func arg)
-        instrs.push_back(new Chuck_Instr_Reg_Push_Imm((t_CKUINT)SELF) ); // 1.3.1.0: changed to t_CKUINT
-        // reg dup last (push this again) (for member func resolution)
-        instrs.push_back(new Chuck_Instr_Reg_Dup_Last);
-        // dot member func
-        instrs.push_back(new Chuck_Instr_Dot_Member_Func(tick_fun_index) );
-        // func to code
-        instrs.push_back(new Chuck_Instr_Func_To_Code);
-        // push stack depth
-        instrs.push_back(new Chuck_Instr_Reg_Push_Imm(12));
-        // func call
-        instrs.push_back(new Chuck_Instr_Func_Call());
+        // call tick
+        foogen_code( SELF, tick_fun, instrs );
         // push immediate
         instrs.push_back(new Chuck_Instr_Reg_Push_Imm((t_CKUINT)&data->output) ); // 1.3.1.0: changed to t_CKUINT
         // assign primitive
         instrs.push_back(new Chuck_Instr_Assign_Primitive2);
         // pop
         instrs.push_back(new Chuck_Instr_Reg_Pop_Word2);
-        // EOC
-        instrs.push_back(new Chuck_Instr_EOC);
-        
-        Chuck_VM_Code * code = new Chuck_VM_Code;
         
-        code->instr = new Chuck_Instr*[instrs.size()];
-        code->num_instr = instrs.size();
-        for(int i = 0; i < instrs.size(); i++) code->instr[i] = instrs[i];
-        code->stack_depth = 0;
-        code->need_this = 0;
-        
-        data->shred = new Chuck_VM_Shred;
-        data->shred->initialize(code);
+        data->shred = foogen_shred( instrs );
     }
-    else
+
+    if( tick_fun_v )
+    {
+        // the block arrays, reused every block
+        data->input_v = new Chuck_Array8( 0 );
+        initialize_object( data->input_v, &t_array );
+        data->input_v->add_ref();
+        data->output_v = new Chuck_Array8( 0 );
+        initialize_object( data->output_v, &t_array );
+        data->output_v->add_ref();
+
+        vector<Chuck_Instr *> instrs;
+        // push args (the callee releases them)
+        instrs.push_back(new Chuck_Instr_Reg_Push_Imm((t_CKUINT)data->input_v) );
+        instrs.push_back(new Chuck_Instr_Reg_AddRef_Object3);
+        instrs.push_back(new Chuck_Instr_Reg_Push_Imm((t_CKUINT)data->output_v) );
+        instrs.push_back(new Chuck_Instr_Reg_AddRef_Object3);
+        // call tick
+        foogen_code( SELF, tick_fun_v, instrs );
+
+        data->shred_v = foogen_shred( instrs );
+    }
+    // without a block tick, block processing ticks per sample
+    else ugen->tickv = NULL;
+
+    if( !tick_fun && !tick_fun_v )
     {
         // SPENCERTODO: warn on Chugen definition instead of instantiation?
         EM_log(CK_LOG_WARNING, "ChuGen '%s' does not define a suitable tick function",
@@ -1375,6 +1545,14 @@ CK_DLL_DTOR( foogen_dtor )
 {
     FooGen_Data * data = (FooGen_Data *) OBJ_MEMBER_UINT(SELF, foogen_offset_data);
     OBJ_MEMBER_UINT(SELF, foogen_offset_data) = 0;
+    if( data )
+    {
+        // the tick shreds, their stacks, and their code
+        SAFE_RELEASE( data->shred );
+        SAFE_RELEASE( data->shred_v );
+        SAFE_RELEASE( data->input_v );
+        SAFE_RELEASE( data->output_v );
+    }
     SAFE_DELETE(data);
 }
 
@@ -1391,31 +1569,16 @@ CK_DLL_TICK( foogen_tick )
     
     if(data->shred)
     {
-        // reset shred
-        
-        // program counter
-        data->shred->pc = 0;
-        data->shred->next_pc = 1;
-        // shred in dump (all done)
-        data->shred->is_dumped = FALSE;
-        // shred done
-        data->shred->is_done = FALSE;
-        // shred running
-        data->shred->is_running = FALSE;
-        // shred abort
-        data->shred->is_abort = FALSE;
-        // set the instr
-        data->shred->instr = data->shred->code->instr;
-        // zero out the id
-        data->shred->xid = 0;
-        // set vmRef
-        data->shred->vm_ref = data->vm;
-        
         // set input
         data->input = in;
         
         // run shred
-        data->shred->run( data->vm );
+        foogen_run( data, data->shred );
+    }
+    // only a block tick: a block of one
+    else if(data->shred_v)
+    {
+        return foogen_tickv( SELF, &in, out, 1, SHRED, API );
     }
     
     *out = data->output;
@@ -1423,6 +1586,39 @@ CK_DLL_TICK( foogen_tick )
     return TRUE;
 }
 
+//-----------------------------------------------------------------------------
+// name: foogen_tickv()
+// desc: one call of the block tick per block
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( foogen_tickv )
+{
+    FooGen_Data * data = (FooGen_Data *) OBJ_MEMBER_UINT(SELF, foogen_offset_data);
+    t_CKUINT i, n;
+
+    if( !data->shred_v )
+    {
+        for( i = 0; i < nframes; i++ )
+            foogen_tick( SELF, in[i], &out[i], SHRED, API );
+        return TRUE;
+    }
+
+    // set input; output defaults to passthru
+    data->input_v->set_size( nframes );
+    data->output_v->set_size( nframes );
+    for( i = 0; i < nframes; i++ )
+        data->input_v->m_vector[i] = data->output_v->m_vector[i] = in[i];
+
+    // run shred
+    foogen_run( data, data->shred_v );
+
+    // (tick may have resized out)
+    n = data->output_v->m_vector.size();
+    for( i = 0; i < nframes; i++ )
+        out[i] = i < n ? (SAMPLE)data->output_v->m_vector[i] : 0;
+
+    return TRUE;
+}
+
 
 
 //-----------------------------------------------------------------------------
@@ -1545,6 +1741,19 @@ CK_DLL_TICK( bunghole_tick )
 
 
 
+//-----------------------------------------------------------------------------
+// name: gain_tickv()
+// desc: block tick for Gain; gain is applied by the system tick
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( gain_tickv )
+{
+    memcpy( out, in, nframes * sizeof(SAMPLE) );
+    return TRUE;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: noise_tick()
 // desc: ...
@@ -1556,6 +1765,20 @@ CK_DLL_TICK( noise_tick )
 }
 
 
+
+
+//-----------------------------------------------------------------------------
+// name: noise_tickv()
+// desc: block tick
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( noise_tickv )
+{
+    for( t_CKUINT i = 0; i < nframes; i++ )
+        out[i] = -1.0 + 2.0 * (SAMPLE)rand() / RAND_MAX;
+    return TRUE;
+}
+
+
 enum { NOISE_WHITE=0, NOISE_PINK, NOISE_BROWN, NOISE_FBM, NOISE_FLIP, NOISE_XOR };
 
 class CNoise_Data
@@ -2260,6 +2483,12 @@ processing time is linearly related to this width */
 
 // default chunk size
 #define CK_SNDBUF_DEFAULT_CHUNK_SIZE (32768) // a little less than 1s of 44.1kHz
+// default streaming read-ahead and memory cap, in chunks
+#define CK_SNDBUF_DEFAULT_STREAM_AHEAD (2)
+#define CK_SNDBUF_DEFAULT_STREAM_MAX (8)
+// files up to this many samples are read whole and shared through the
+// sample cache, chunked or not (streaming never is)
+#define CK_SNDBUF_CACHE_MAX_SAMPLES (1 << 20)
 
 #define USE_TABLE TRUE          /* this controls whether a linearly interpolated lookup
 table is used for sinc function calculation, or the
@@ -2455,10 +2684,82 @@ protected:
 };
 #endif /* CK_SNDBUF_MEMORY_BUFFER */
 
+// streamed chunk states
+enum { SNDBUF_CHUNK_EMPTY = 0, SNDBUF_CHUNK_LOADING, SNDBUF_CHUNK_RESIDENT };
+
+// a loaded chunk, handed from the loader thread to the audio thread
+struct sndbuf_chunk
+{
+    t_CKUINT bin;
+    SAMPLE * data;
+};
+
+//-----------------------------------------------------------------------------
+// name: struct sndbuf_stream
+// desc: a sound file being streamed: the loader thread reads chunks ahead of
+//       the play head and hands them over through 'ready'; the audio thread
+//       installs them in the sndbuf's chunk_map, and gives evicted chunks
+//       back through 'spare'.  a chunk's state goes EMPTY -> LOADING in the
+//       loader only, and -> RESIDENT / -> EMPTY in the audio thread only
+//-----------------------------------------------------------------------------
+struct sndbuf_stream
+{
+    // loader side
+    SNDFILE * fd;
+    std::vector<SAMPLE *> free_chunks;
+    t_CKUINT num_allocated;
+
+    // fixed at read()
+    t_CKUINT chunks;
+    t_CKUINT chunk_num;
+    t_CKUINT num_frames;
+    t_CKUINT num_channels;
+    t_CKUINT ahead;
+    t_CKUINT max;
+
+    // shared
+    volatile char * chunk_state;
+    CBufferSimple ready;
+    CBufferSimple spare;
+    // play head chunk and direction (published by the audio thread)
+    volatile t_CKINT pos;
+    volatile t_CKINT dir;
+    volatile t_CKBOOL loop;
+    // evictions asked for by the loader, and answered by the audio thread
+    volatile t_CKUINT evict_asked;
+    volatile t_CKUINT evict_done;
+    // the sndbuf let go of this stream; the loader frees it
+    volatile t_CKBOOL done;
+
+    // audio side
+    std::vector<t_CKUINT> resident;
+    t_CKBOOL missed;
+
+    sndbuf_stream()
+    {
+        fd = NULL;
+        num_allocated = 0;
+        chunks = chunk_num = num_frames = num_channels = 0;
+        ahead = max = 0;
+        chunk_state = NULL;
+        pos = 0;
+        dir = 1;
+        loop = FALSE;
+        evict_asked = evict_done = 0;
+        done = FALSE;
+        missed = FALSE;
+    }
+};
+
+// wake the streaming loader (defined with it, below)
+static void sndbuf_loader_kick();
+
 // data for each sndbuf
 struct sndbuf_data
 {
     SAMPLE * buffer;
+    // buffer is the sample cache's, when not NULL
+    SampleCacheEntry * shared;
     t_CKUINT num_samples;
     t_CKUINT num_channels;
     t_CKUINT num_frames;
@@ -2466,10 +2767,19 @@ struct sndbuf_data
     t_CKUINT chan;
     
     t_CKUINT chunks;
+    // chunks was set by the user (not the default)
+    t_CKBOOL chunks_set;
     t_CKUINT chunks_read;
     t_CKUINT chunk_num;
     SAMPLE ** chunk_map;
 
+    // streaming
+    t_CKBOOL streaming;
+    t_CKUINT stream_ahead;
+    t_CKUINT stream_max;
+    sndbuf_stream * stream;
+    t_CKUINT underruns;
+
     SAMPLE * eob;
     //SAMPLE * curr;
     SAMPLE current_val;
@@ -2500,11 +2810,13 @@ struct sndbuf_data
     sndbuf_data()
     {
         buffer = NULL;
+        shared = NULL;
         interp = SNDBUF_INTERP;
         num_channels = 0;
         num_frames = 0;
         num_samples = 0;
         chunks = CK_SNDBUF_DEFAULT_CHUNK_SIZE;
+        chunks_set = FALSE;
         chunks_read = 0;
         samplerate = 0;
         sampleratio = 1.0;
@@ -2516,6 +2828,11 @@ struct sndbuf_data
         current_val = 0.0;
         chunk_map = NULL;
         chunk_num = 0;
+        streaming = FALSE;
+        stream_ahead = CK_SNDBUF_DEFAULT_STREAM_AHEAD;
+        stream_max = CK_SNDBUF_DEFAULT_STREAM_MAX;
+        stream = NULL;
+        underruns = 0;
         
         sinc_table_built = false;
         sinc_use_table = USE_TABLE;
@@ -2534,7 +2851,10 @@ struct sndbuf_data
 
     ~sndbuf_data()
     {
-        SAFE_DELETE_ARRAY( buffer );
+        free_buffer();
+
+        // the loader frees the rest of the stream
+        if( stream ) { stream->done = TRUE; stream = NULL; sndbuf_loader_kick(); }
         
         if( chunk_map )
         {
@@ -2544,6 +2864,18 @@ struct sndbuf_data
         }
     }
     
+    // let go of buffer, ours or shared
+    void free_buffer()
+    {
+        if( shared )
+        {
+            SampleCache::instance()->release( shared );
+            shared = NULL;
+            buffer = NULL;
+        }
+        else SAFE_DELETE_ARRAY( buffer );
+    }
+
     inline void sampleIndex2FrameIndexAndChannel(t_CKINT sample, t_CKINT *frame, t_CKINT *channel)
     {
         *frame = (t_CKINT) floorf(sample/this->num_channels);
@@ -2634,6 +2966,348 @@ inline t_CKINT sndbuf_load( sndbuf_data * d, t_CKUINT sample )
     return ret;
 }
 
+//-----------------------------------------------------------------------------
+// streaming: chunks are read ahead of the play head on the loader thread,
+// which serves every streaming sndbuf; the audio thread only installs what
+// is ready, and plays silence (counted in .underruns()) where it is not
+//-----------------------------------------------------------------------------
+struct sndbuf_loader
+{
+    XThread thread;
+    XMutex lock;
+    XCondition wake;
+    std::vector<sndbuf_stream *> streams;
+    // bumped (atomically, with no lock) when there may be something new to
+    // read or free
+    volatile t_CKUINT kicks;
+    // stop the thread
+    t_CKBOOL quit;
+    sndbuf_loader() : kicks( 0 ), quit( FALSE ) { }
+};
+
+// the loader (started with the first stream)
+static sndbuf_loader * g_sndbuf_loader = NULL;
+// how often (ms) the loader checks for a kick whose wake-up it missed
+#define CK_SNDBUF_LOADER_POLL 10
+
+// wake the loader: a stream was added, closed, moved on, or gave a chunk
+// back; called from the audio thread, so it never waits for the lock
+static void sndbuf_loader_kick()
+{
+    if( !g_sndbuf_loader ) return;
+    xatomic_add( &g_sndbuf_loader->kicks, 1 );
+    // (if the loader holds the lock, it sees the kick when it next checks)
+    if( g_sndbuf_loader->lock.tryacquire() )
+    {
+        g_sndbuf_loader->wake.signal_all();
+        g_sndbuf_loader->lock.release();
+    }
+}
+
+// how far ahead of the play head chunk 'bin' is, in playing order
+static t_CKUINT sndbuf_stream_distance( sndbuf_stream * s, t_CKINT at, t_CKINT dir,
+                                        t_CKBOOL loop, t_CKUINT bin )
+{
+    t_CKINT n = (t_CKINT)s->chunk_num;
+    t_CKINT delta = ( (t_CKINT)bin - at ) * dir;
+    if( delta >= 0 ) return delta;
+    // behind the play head: played again after looping, or never
+    return loop ? delta + n : n - delta;
+}
+
+// read chunk 'bin' of the file into 'chunk'
+static void sndbuf_stream_read( sndbuf_stream * s, t_CKUINT bin, SAMPLE * chunk )
+{
+    t_CKUINT frame = bin * s->chunks / s->num_channels;
+    t_CKUINT num_frames = s->chunks / s->num_channels;
+    sf_count_t n = 0;
+
+    // prevent overflow
+    if( num_frames > s->num_frames - frame )
+        num_frames = s->num_frames - frame;
+
+    sf_seek( s->fd, frame, SEEK_SET );
+#if defined(__CHUCK_USE_64_BIT_SAMPLE__)
+    n = sf_readf_double( s->fd, chunk, num_frames );
+#else
+    n = sf_readf_float( s->fd, chunk, num_frames );
+#endif
+    if( n < 0 ) n = 0;
+
+    // the rest (end of file, or a short read) is silence
+    memset( chunk + n * s->num_channels, 0,
+            ( s->chunks - n * s->num_channels ) * sizeof(SAMPLE) );
+}
+
+// loader: read what is missing in the window ahead of the play head
+static void sndbuf_stream_fill( sndbuf_stream * s )
+{
+    SAMPLE * chunk = NULL;
+    t_CKINT n = (t_CKINT)s->chunk_num;
+    t_CKINT at = s->pos;
+    t_CKINT dir = s->dir;
+    t_CKBOOL loop = s->loop;
+
+    // take back evicted chunks
+    while( s->spare.get( &chunk, 1 ) )
+        s->free_chunks.push_back( chunk );
+
+    for( t_CKINT k = 0; k <= (t_CKINT)s->ahead; k++ )
+    {
+        t_CKINT bin = at + k * dir;
+        // past either end of the file
+        if( bin < 0 || bin >= n )
+        {
+            if( !loop ) break;
+            bin = ( bin % n + n ) % n;
+        }
+        if( s->chunk_state[bin] != SNDBUF_CHUNK_EMPTY ) continue;
+
+        // memory for it
+        if( s->free_chunks.empty() )
+        {
+            // at the cap: ask the audio thread to evict a cold chunk
+            if( s->num_allocated >= s->max )
+            {
+                if( s->evict_asked == s->evict_done ) s->evict_asked++;
+                break;
+            }
+            s->free_chunks.push_back( new SAMPLE[s->chunks] );
+            s->num_allocated++;
+        }
+        chunk = s->free_chunks.back();
+        s->free_chunks.pop_back();
+
+        // read it, and hand it over
+        sndbuf_stream_read( s, bin, chunk );
+        s->chunk_state[bin] = SNDBUF_CHUNK_LOADING;
+        sndbuf_chunk ready = { (t_CKUINT)bin, chunk };
+        s->ready.put( &ready, 1 );
+    }
+}
+
+// loader: free a stream its sndbuf let go of
+static void sndbuf_stream_free( sndbuf_stream * s )
+{
+    sndbuf_chunk ready;
+    SAMPLE * chunk = NULL;
+
+    // chunks never installed, or given back
+    while( s->ready.get( &ready, 1 ) )
+        SAFE_DELETE_ARRAY( ready.data );
+    while( s->spare.get( &chunk, 1 ) )
+        SAFE_DELETE_ARRAY( chunk );
+    for( t_CKUINT i = 0; i < s->free_chunks.size(); i++ )
+        SAFE_DELETE_ARRAY( s->free_chunks[i] );
+
+    if( s->fd ) sf_close( s->fd );
+    delete [] s->chunk_state;
+    delete s;
+}
+
+// loader thread
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+static void * sndbuf_loader_cb( void * _loader )
+#elif defined(__PLATFORM_WIN32__)
+static unsigned THREAD_TYPE sndbuf_loader_cb( void * _loader )
+#endif
+{
+    sndbuf_loader * loader = (sndbuf_loader *)_loader;
+    std::vector<sndbuf_stream *> streams;
+    t_CKUINT seen = 0;
+
+    while( TRUE )
+    {
+        // wait for streams, and for one of them to need something
+        loader->lock.acquire();
+        while( !loader->quit && ( loader->streams.empty() ||
+                                  xatomic_load( &loader->kicks ) == seen ) )
+        {
+            // (a kick from the audio thread may come without a wake-up)
+            if( loader->streams.empty() ) loader->wake.wait( loader->lock );
+            else loader->wake.wait( loader->lock, CK_SNDBUF_LOADER_POLL );
+        }
+        seen = xatomic_load( &loader->kicks );
+        streams = loader->streams;
+        t_CKBOOL quit = loader->quit;
+        loader->lock.release();
+
+        for( t_CKUINT i = 0; i < streams.size(); i++ )
+        {
+            sndbuf_stream * s = streams[i];
+            if( s->done )
+            {
+                loader->lock.acquire();
+                loader->streams.erase( std::find( loader->streams.begin(),
+                                                  loader->streams.end(), s ) );
+                loader->lock.release();
+                sndbuf_stream_free( s );
+            }
+            else if( !quit ) sndbuf_stream_fill( s );
+        }
+
+        // (the streams let go of are freed)
+        if( quit ) break;
+    }
+
+    return 0;
+}
+
+// open a stream on d's file, in place of loading chunks in the audio thread
+static void sndbuf_stream_open( sndbuf_data * d )
+{
+    sndbuf_stream * s = new sndbuf_stream;
+
+    // the stream reads the file from now on
+    s->fd = d->fd;
+    d->fd = NULL;
+    s->chunks = d->chunks;
+    s->chunk_num = d->chunk_num;
+    s->num_frames = d->num_frames;
+    s->num_channels = d->num_channels;
+    s->ahead = d->stream_ahead;
+    // room for the window ahead, the chunk playing, and one to evict
+    s->max = d->stream_max > s->ahead + 2 ? d->stream_max : s->ahead + 2;
+    s->chunk_state = new char[s->chunk_num];
+    memset( (char *)s->chunk_state, SNDBUF_CHUNK_EMPTY, s->chunk_num );
+    s->ready.initialize( s->max + 1, sizeof(sndbuf_chunk) );
+    s->spare.initialize( s->max + 1, sizeof(SAMPLE *) );
+    s->loop = d->loop;
+    s->resident.reserve( s->max );
+
+    // the first chunk now (read() is blocking anyway)
+    SAMPLE * chunk = new SAMPLE[s->chunks];
+    sndbuf_stream_read( s, 0, chunk );
+    s->num_allocated = 1;
+    d->chunk_map[0] = chunk;
+    s->chunk_state[0] = SNDBUF_CHUNK_RESIDENT;
+    s->resident.push_back( 0 );
+
+    d->stream = s;
+    d->underruns = 0;
+
+    // hand it to the loader
+    if( !g_sndbuf_loader )
+    {
+        g_sndbuf_loader = new sndbuf_loader;
+        g_sndbuf_loader->thread.start( sndbuf_loader_cb, g_sndbuf_loader );
+    }
+    g_sndbuf_loader->lock.acquire();
+    g_sndbuf_loader->streams.push_back( s );
+    xatomic_add( &g_sndbuf_loader->kicks, 1 );
+    g_sndbuf_loader->wake.signal_all();
+    g_sndbuf_loader->lock.release();
+}
+
+// let go of d's stream (the resident chunks stay in d's chunk_map)
+inline void sndbuf_stream_close( sndbuf_data * d )
+{
+    if( !d->stream ) return;
+    d->stream->done = TRUE;
+    d->stream = NULL;
+    // so the loader frees it
+    sndbuf_loader_kick();
+}
+
+//-----------------------------------------------------------------------------
+// name: xxx_shutdown()
+// desc: stop SndBuf's streaming loader, freeing the streams let go of
+//-----------------------------------------------------------------------------
+void xxx_shutdown()
+{
+    if( !g_sndbuf_loader ) return;
+
+    g_sndbuf_loader->lock.acquire();
+    g_sndbuf_loader->quit = TRUE;
+    g_sndbuf_loader->wake.signal_all();
+    g_sndbuf_loader->lock.release();
+
+    g_sndbuf_loader->thread.wait( -1, false );
+    SAFE_DELETE( g_sndbuf_loader );
+}
+
+// audio: evict the coldest chunk outside the window ahead of the play head;
+// FALSE if everything resident is still needed
+static t_CKBOOL sndbuf_stream_evict( sndbuf_data * d )
+{
+    sndbuf_stream * s = d->stream;
+    t_CKUINT coldest = 0, distance = 0;
+
+    for( t_CKUINT i = 0; i < s->resident.size(); i++ )
+    {
+        t_CKUINT dist = sndbuf_stream_distance( s, s->pos, s->dir, s->loop, s->resident[i] );
+        if( dist > distance ) { distance = dist; coldest = i; }
+    }
+    // everything resident is still needed
+    if( distance <= s->ahead ) return FALSE;
+
+    t_CKUINT bin = s->resident[coldest];
+    s->resident[coldest] = s->resident.back();
+    s->resident.pop_back();
+
+    SAMPLE * chunk = d->chunk_map[bin];
+    d->chunk_map[bin] = NULL;
+    s->chunk_state[bin] = SNDBUF_CHUNK_EMPTY;
+    s->spare.put( &chunk, 1 );
+    return TRUE;
+}
+
+// audio: install ready chunks, publish the play head, and make room
+inline void sndbuf_stream_sync( sndbuf_data * d )
+{
+    sndbuf_stream * s = d->stream;
+    sndbuf_chunk ready;
+
+    while( s->ready.get( &ready, 1 ) )
+    {
+        d->chunk_map[ready.bin] = ready.data;
+        s->chunk_state[ready.bin] = SNDBUF_CHUNK_RESIDENT;
+        s->resident.push_back( ready.bin );
+    }
+
+    t_CKINT at = ( (t_CKINT)d->curf * (t_CKINT)d->num_channels + d->chan ) / (t_CKINT)s->chunks;
+    if( at < 0 ) at = 0;
+    else if( at >= (t_CKINT)s->chunk_num ) at = s->chunk_num - 1;
+    t_CKINT dir = d->rate < 0 ? -1 : 1;
+    // the window ahead moves only when one of these does
+    t_CKBOOL moved = at != s->pos || dir != s->dir || (t_CKBOOL)d->loop != s->loop;
+    s->pos = at;
+    s->dir = dir;
+    s->loop = d->loop;
+
+    if( s->evict_done != s->evict_asked )
+    {
+        // a chunk given back: room to read another
+        if( sndbuf_stream_evict( d ) ) moved = TRUE;
+        s->evict_done = s->evict_asked;
+    }
+
+    // (at most once per chunk played, so rarely)
+    if( moved ) sndbuf_loader_kick();
+}
+
+// audio: count a sample played (partly) as silence
+inline void sndbuf_stream_count( sndbuf_data * d )
+{
+    if( d->stream && d->stream->missed )
+    {
+        d->underruns++;
+        d->stream->missed = FALSE;
+    }
+}
+
+// sample at index, in a chunk (if the chunk is loaded, when streaming)
+inline SAMPLE sndbuf_chunk_value( sndbuf_data * d, t_CKUINT index )
+{
+    SAMPLE * chunk = d->chunk_map[index/d->chunks];
+    if( !chunk )
+    {
+        if( d->stream ) d->stream->missed = TRUE;
+        return 0;
+    }
+    return chunk[index%d->chunks];
+}
+
 inline void sndbuf_setpos( sndbuf_data *d, double frame_pos )
 {
     if( !(d->buffer || d->chunk_map) ) return;
@@ -2666,7 +3340,7 @@ inline void sndbuf_setpos( sndbuf_data *d, double frame_pos )
     if(d->buffer)
         d->current_val = d->buffer[index];
     else
-        d->current_val = d->chunk_map[index/d->chunks][index%d->chunks];
+        d->current_val = sndbuf_chunk_value( d, index );
 }
 
 inline SAMPLE sndbuf_sampleAt( sndbuf_data * d, t_CKINT frame_pos, t_CKINT arg_chan = -1 )
@@ -2698,7 +3372,7 @@ inline SAMPLE sndbuf_sampleAt( sndbuf_data * d, t_CKINT frame_pos, t_CKINT arg_c
     if(d->buffer != NULL)
         return d->buffer[index];
     else
-        return d->chunk_map[index/d->chunks][index%d->chunks];
+        return sndbuf_chunk_value( d, index );
 }
 
 inline double sndbuf_getpos( sndbuf_data * d )
@@ -2872,6 +3546,9 @@ CK_DLL_TICK( sndbuf_tick )
         return TRUE;
     }
     
+    // streaming: take what the loader has ready
+    if( d->stream ) sndbuf_stream_sync( d );
+
     // we're ticking once per sample ( system )
     // curf in samples;
     
@@ -2880,6 +3557,13 @@ CK_DLL_TICK( sndbuf_tick )
         *out = 0;
         return TRUE;
     }
+
+    // streaming: current value was missing; it may have arrived since
+    if( d->stream && d->stream->missed )
+    {
+        d->stream->missed = FALSE;
+        sndbuf_setpos( d, d->curf );
+    }
     
     // calculate frame
     if( d->interp == SNDBUF_DROP )
@@ -2898,6 +3582,9 @@ CK_DLL_TICK( sndbuf_tick )
         sndbuf_sinc_interpolate(d, out);
     }
     
+    // streaming: count underrun
+    sndbuf_stream_count( d );
+
     // advance
     d->curf += d->rate;
     sndbuf_setpos(d, d->curf);
@@ -2905,6 +3592,38 @@ CK_DLL_TICK( sndbuf_tick )
     return TRUE;    
 }
 
+/* block tick */
+CK_DLL_TICKV( sndbuf_tickv )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    t_CKBOOL valid = TRUE;
+    t_CKUINT i;
+    
+#ifndef CK_SNDBUF_MEMORY_BUFFER
+    // nothing to play
+    if( !( d->buffer || d->chunk_map ) )
+    {
+        memset( out, 0, nframes * sizeof(SAMPLE) );
+        return TRUE;
+    }
+#endif
+    
+    for( i = 0; i < nframes; i++ )
+    {
+#ifndef CK_SNDBUF_MEMORY_BUFFER
+        // past the end and not looping: rest of the block is silent
+        if( !d->loop && d->curf >= d->num_frames )
+        {
+            memset( out + i, 0, (nframes - i) * sizeof(SAMPLE) );
+            break;
+        }
+#endif
+        valid = sndbuf_tick( SELF, in[i], &out[i], SHRED, API );
+    }
+    
+    return valid;
+}
+
 /* multi-chan tick */
 CK_DLL_TICKF( sndbuf_tickf )
 {
@@ -2913,6 +3632,9 @@ CK_DLL_TICKF( sndbuf_tickf )
     sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
     
     if( !( d->buffer || d->chunk_map ) ) return FALSE;
+
+    // streaming: take what the loader has ready
+    if( d->stream ) sndbuf_stream_sync( d );
     
     // we're ticking once per sample ( system )
     // curf in samples;
@@ -2939,6 +3661,9 @@ CK_DLL_TICKF( sndbuf_tickf )
     unsigned int nchans = ugen->m_num_outs;
     for(frame_idx = 0; frame_idx < nframes && (d->loop || d->curf < d->num_frames); frame_idx++)
     {
+        // streaming: (frames are read directly below)
+        if( d->stream ) d->stream->missed = FALSE;
+
         for(unsigned int chan_idx = 0; chan_idx < nchans; chan_idx++)
         {
             // calculate frame
@@ -2964,6 +3689,9 @@ CK_DLL_TICKF( sndbuf_tickf )
             }
         }
         
+        // streaming: count underrun
+        sndbuf_stream_count( d );
+
         // advance
         sndbuf_setpos(d, d->curf + d->rate);
     }
@@ -2984,6 +3712,55 @@ CK_DLL_TICKF( sndbuf_tickf )
 #include "util_raw.h"
 
 
+// free a buffer handed to the sample cache
+static void sndbuf_free_data( void * data )
+{
+    delete [] (SAMPLE *)data;
+}
+
+// sample cache key for a file or special: wave; "" if not to be shared
+static std::string sndbuf_cache_key( sndbuf_data * d, const char * filename )
+{
+    // streaming reads chunks as it goes
+    if( d->streaming ) return "";
+    if( strstr(filename, "special:") ) return std::string("SndBuf:") + filename;
+
+    // a file that changes on disk is a different entry
+    struct stat s;
+    if( stat( filename, &s ) ) return "";
+    char buffer[64];
+    sprintf( buffer, ":%ld:%ld", (long)s.st_size, (long)s.st_mtime );
+    return std::string("SndBuf:") + filename + buffer;
+}
+
+// take the buffer from the sample cache, if it has it
+static t_CKBOOL sndbuf_share( sndbuf_data * d, const std::string & key )
+{
+    SampleCacheEntry * entry = SampleCache::instance()->acquire( key );
+    if( !entry ) return FALSE;
+
+    d->shared = entry;
+    d->buffer = (SAMPLE *)entry->data;
+    d->chan = 0;
+    d->num_frames = entry->frames;
+    d->num_channels = entry->channels;
+    d->num_samples = entry->frames * entry->channels;
+    d->samplerate = (t_CKUINT)entry->srate;
+    // nothing left to read
+    d->chunks_read = d->num_samples;
+    return TRUE;
+}
+
+// give the buffer just read to the sample cache
+static void sndbuf_publish( sndbuf_data * d, const std::string & key )
+{
+    d->shared = SampleCache::instance()->insert( key, d->buffer,
+        ( d->num_samples + d->num_channels ) * sizeof(SAMPLE), sndbuf_free_data,
+        d->num_frames, d->num_channels, d->samplerate );
+    // (another SndBuf may have published it first)
+    d->buffer = (SAMPLE *)d->shared->data;
+}
+
 CK_DLL_CTRL( sndbuf_ctrl_read )
 {
     sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
@@ -2993,7 +3770,10 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
     // return filename
     RETURN->v_string = ckfilename;
     
-    SAFE_DELETE_ARRAY(d->buffer);
+    d->free_buffer();
+
+    // the loader frees the rest of the stream
+    sndbuf_stream_close( d );
     
     if( d->chunk_map )
     {
@@ -3011,9 +3791,16 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
 
     // log
     EM_log( CK_LOG_INFO, "(sndbuf): reading '%s'...", filename );
-    
+
+    std::string key = sndbuf_cache_key( d, filename );
+
+    // already read by another SndBuf
+    if( key.size() && sndbuf_share( d, key ) )
+    {
+        EM_log( CK_LOG_INFO, "(sndbuf): sharing '%s' (%lu frames)", filename, d->num_frames );
+    }
     // built in
-    if( strstr(filename, "special:") )
+    else if( strstr(filename, "special:") )
     {
         SAMPLE * rawdata = NULL;
         t_CKUINT rawsize = 0;
@@ -3122,6 +3909,9 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
         }
 
         d->buffer[rawsize] = d->buffer[0];
+
+        // share it from now on
+        if( key.size() ) sndbuf_publish( d, key );
     }
     else // read file
     {
@@ -3159,7 +3949,10 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
 
         // allocate
         t_CKINT size = info.channels * info.frames;
-        if(d->chunks)
+        // too big to read whole and share; or chunked on purpose, to keep
+        // from reading it all at once (a copy already shared is still used)
+        if( size > CK_SNDBUF_CACHE_MAX_SAMPLES || ( d->chunks && d->chunks_set ) ) key = "";
+        if( d->chunks && !key.size() )
         {
             // split into small allocations
             d->chunk_num = ceilf(((t_CKFLOAT) size) / ((t_CKFLOAT) d->chunks));
@@ -3194,7 +3987,7 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
         sf_seek( d->fd, 0, SEEK_SET );
 
         // no chunk
-        if( !d->chunks )
+        if( d->buffer )
         {
             // read all
             t_CKUINT f = sndbuf_read( d, 0, d->num_frames );
@@ -3208,6 +4001,14 @@ CK_DLL_CTRL( sndbuf_ctrl_read )
             }
 
             assert( d->fd == NULL );
+
+            // share it from now on
+            if( key.size() ) sndbuf_publish( d, key );
+        }
+        // stream: chunks are read ahead on the loader thread
+        else if( d->streaming )
+        {
+            sndbuf_stream_open( d );
         }
     }
 
@@ -3226,11 +4027,7 @@ CK_DLL_CTRL( sndbuf_ctrl_write )
     sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
     const char * filename = GET_CK_STRING(ARGS)->str.c_str();
     
-    if( d->buffer )
-    {
-        delete [] d->buffer;
-        d->buffer = NULL;
-    }
+    d->free_buffer();
     
     struct stat s;
     if( stat( filename, &s ) )
@@ -3346,6 +4143,7 @@ CK_DLL_CTRL( sndbuf_ctrl_chunks )
     sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
     t_CKINT frames = GET_NEXT_INT(ARGS);
     d->chunks = frames >= 0 ? frames : 0;
+    d->chunks_set = TRUE;
     RETURN->v_int = d->chunks;
 }
 
@@ -3355,6 +4153,53 @@ CK_DLL_CGET( sndbuf_cget_chunks )
     RETURN->v_int = d->chunks;
 }
 
+CK_DLL_CTRL( sndbuf_ctrl_stream )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    d->streaming = GET_NEXT_INT(ARGS) != 0;
+    RETURN->v_int = d->streaming;
+}
+
+CK_DLL_CGET( sndbuf_cget_stream )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    RETURN->v_int = d->streaming;
+}
+
+CK_DLL_CTRL( sndbuf_ctrl_stream_ahead )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    t_CKINT ahead = GET_NEXT_INT(ARGS);
+    d->stream_ahead = ahead >= 1 ? ahead : 1;
+    RETURN->v_int = d->stream_ahead;
+}
+
+CK_DLL_CGET( sndbuf_cget_stream_ahead )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    RETURN->v_int = d->stream_ahead;
+}
+
+CK_DLL_CTRL( sndbuf_ctrl_stream_max )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    t_CKINT max = GET_NEXT_INT(ARGS);
+    d->stream_max = max >= 0 ? max : 0;
+    RETURN->v_int = d->stream_max;
+}
+
+CK_DLL_CGET( sndbuf_cget_stream_max )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    RETURN->v_int = d->stream_max;
+}
+
+CK_DLL_CGET( sndbuf_cget_underruns )
+{
+    sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
+    RETURN->v_int = d->underruns;
+}
+
 CK_DLL_CTRL( sndbuf_ctrl_phase_offset )
 {
     sndbuf_data * d = (sndbuf_data *)OBJ_MEMBER_UINT(SELF, sndbuf_offset_data);
@@ -3732,6 +4577,10 @@ struct LiSaMulti_data
 	
 	t_CKINT num_chans;
 
+    // block rendering: one voice's samples for the current block
+    SAMPLE * vbuf;
+    t_CKINT vbuf_len;
+
     // allocate memory, length in samples
     inline int buffer_alloc(t_CKINT length)
     {
@@ -4000,6 +4849,112 @@ struct LiSaMulti_data
 
         return outsamples;
     }
+
+    // samples left in a ramp from ctr, counting the one it ends on
+    inline t_CKINT ramp_left( t_CKDOUBLE ctr, t_CKDOUBLE len, t_CKINT most )
+    {
+        t_CKDOUBLE left = ceil( len - ctr );
+        if( left >= most ) return most;
+        return left < 1 ? 1 : (t_CKINT)left;
+    }
+
+    // how many samples voice which can render from here with no loop wrap,
+    // turn, end of buffer or end of ramp (0: the next one needs getNextSamp)
+    inline t_CKINT run_length( t_CKINT which, t_CKINT most )
+    {
+        t_CKDOUBLE p = pindex[which], inc = p_inc[which], lo, hi, k;
+        t_CKINT n = most;
+
+        // the reads at p and p+1 must stay inside [lo, hi+1)
+        if( loopplay[which] ) {
+            if( loop_start[which] == loop_end[which] ) return 0;
+            lo = loop_start[which]; hi = loop_end[which] - 1;
+        } else {
+            lo = 0; hi = mdata_len - 1;
+        }
+        if( p < lo || p >= hi ) return 0;
+
+        // positions are p + k*inc; find the first one out
+        if( inc > 0 ) { k = ceil( (hi - p) / inc ); if( k < n ) n = (t_CKINT)k; }
+        else if( inc < 0 ) { k = floor( (p - lo) / -inc ) + 1; if( k < n ) n = (t_CKINT)k; }
+        // (settle rounding at the far end)
+        while( n > 0 && ( p + (n-1) * inc < lo || p + (n-1) * inc >= hi ) ) n--;
+
+        // ramps end on a sample
+        if( rampup[which] ) n = ck_min( n, ramp_left( rampctr[which], rampup_len[which], n ) );
+        else if( rampdown[which] ) n = ck_min( n, ramp_left( rampctr[which], rampdown_len[which], n ) );
+
+        return n;
+    }
+
+    // render count samples of voice which into buf, as getNextSamp would;
+    // positions and ramp are linear in k, so the loop has no branches
+    inline void render_run( t_CKINT which, SAMPLE * buf, t_CKINT count )
+    {
+        const SAMPLE * data = mdata;
+        t_CKDOUBLE p = pindex[which], inc = p_inc[which], g = voiceGain[which];
+        // ramp factor is ( a + s*k ) * r
+        t_CKDOUBLE a = 1., s = 0., r = 1.;
+        if( rampup[which] ) { a = rampctr[which]; s = 1.; r = rampup_len_inv[which]; }
+        else if( rampdown[which] ) { a = rampdown_len[which] - rampctr[which]; s = -1.; r = rampdown_len_inv[which]; }
+
+        for( t_CKINT k = 0; k < count; k++ ) {
+            t_CKDOUBLE where = p + k * inc;
+            t_CKINT whereTrunc = (t_CKINT)where;
+            t_CKDOUBLE whereFrac = where - (t_CKDOUBLE)whereTrunc;
+            t_CKDOUBLE outsample = (t_CKDOUBLE)data[whereTrunc] + (t_CKDOUBLE)(data[whereTrunc+1] - data[whereTrunc]) * whereFrac;
+            buf[k] = (SAMPLE)( outsample * ( (a + s * k) * r ) * g );
+        }
+
+        // advance
+        pindex[which] = p + count * inc;
+        if( rampup[which] ) {
+            rampctr[which] += count;
+            if( rampctr[which] >= rampup_len[which] ) rampup[which] = false;
+        }
+        else if( rampdown[which] ) {
+            rampctr[which] += count;
+            if( rampctr[which] >= rampdown_len[which] ) {
+                rampdown[which] = false;
+                play[which] = false;
+            }
+        }
+    }
+
+    // all playing voices for a block, num_chans interleaved; same result as
+    // tick_multi per sample while not recording and not tracking
+    inline void tick_block( SAMPLE * out, t_CKINT nframes )
+    {
+        memset( out, 0, nframes * num_chans * sizeof(SAMPLE) );
+        if( !mdata ) return;
+
+        // room for a voice
+        if( vbuf_len < nframes ) {
+            SAMPLE * grown = (SAMPLE *)realloc( vbuf, nframes * sizeof(SAMPLE) );
+            if( !grown ) return;
+            vbuf = grown; vbuf_len = nframes;
+        }
+
+        for( t_CKINT i = 0; i < maxvoices; i++ ) {
+            if( !play[i] ) continue;
+
+            // runs, and a sample at a time across wraps, turns and ramp ends
+            t_CKINT done = 0, n;
+            while( done < nframes && play[i] ) {
+                n = run_length( i, nframes - done );
+                if( n > 0 ) { render_run( i, vbuf + done, n ); done += n; }
+                else vbuf[done++] = getNextSamp( i );
+            }
+
+            // mix (a voice that stops is silent for the rest of the block)
+            for( t_CKINT j = 0; j < num_chans; j++ ) {
+                t_CKFLOAT gain = channelGain[i][j];
+                SAMPLE * o = out + j;
+                for( t_CKINT k = 0; k < done; k++ )
+                    o[k*num_chans] += vbuf[k] * gain;
+            }
+        }
+    }
     
     inline void clear_buf()
     {
@@ -4099,6 +5054,8 @@ CK_DLL_DTOR( LiSaMulti_dtor )
 {
     // get data
     LiSaMulti_data * d = (LiSaMulti_data *)OBJ_MEMBER_UINT(SELF, LiSaMulti_offset_data);
+    // block buffer
+    if( d && d->vbuf ) free( d->vbuf );
     // delete
     SAFE_DELETE(d);
     // set
@@ -4125,6 +5082,28 @@ CK_DLL_TICK( LiSaMulti_tick )
 }
 
 
+//-----------------------------------------------------------------------------
+// name: LiSaMulti_tickv()
+// desc: block tick; while recording (a voice may read what was just
+//       recorded) or tracking, falls back to the per-sample tick
+//-----------------------------------------------------------------------------
+CK_DLL_TICKV( LiSaMulti_tickv )
+{
+    LiSaMulti_data * d = (LiSaMulti_data *)OBJ_MEMBER_UINT(SELF, LiSaMulti_offset_data);
+    t_CKUINT i;
+
+    if( d->record || d->track || d->num_chans != 1 )
+    {
+        for( i = 0; i < nframes; i++ )
+            out[i] = d->tick_multi( in[i] )[0];
+        return TRUE;
+    }
+
+    d->tick_block( out, nframes );
+    return TRUE;
+}
+
+
 //-----------------------------------------------------------------------------
 // name: ()
 // desc: TICKF function ...
@@ -4136,6 +5115,14 @@ CK_DLL_TICKF( LiSaMulti_tickf )
     LiSaMulti_data * d = (LiSaMulti_data *)OBJ_MEMBER_UINT(SELF, LiSaMulti_offset_data);
 	
     unsigned int nchans = ugen->m_num_outs;
+
+    // the whole block at once, unless recording or tracking
+    if( !d->record && !d->track && nchans == d->num_chans )
+    {
+        d->tick_block( out, nframes );
+        return TRUE;
+    }
+
     for(unsigned int frame_idx = 0; frame_idx < nframes; frame_idx++)
     {
         SAMPLE * temp_out_samples = d->tick_multi( in[frame_idx*nchans+1] );
@@ -42,6 +42,8 @@
 
 // query
 DLL_QUERY xxx_query( Chuck_DL_Query * query );
+// stop background threads (SndBuf's streaming loader)
+void xxx_shutdown();
 
 // global
 struct Chuck_Type;
@@ -76,6 +78,7 @@ CK_DLL_CGET( mix2_cget_value );
 
 // noise
 CK_DLL_TICK( noise_tick );
+CK_DLL_TICKV( noise_tickv );
 
 // cnoise
 CK_DLL_CTOR( cnoise_ctor );
@@ -102,6 +105,7 @@ CK_DLL_CGET( step_cget_next );
 CK_DLL_CTOR( gain_ctor );
 CK_DLL_DTOR( gain_dtor );
 CK_DLL_TICK( gain_tick );
+CK_DLL_TICKV( gain_tickv );
 CK_DLL_CTRL( gain_ctrl_value );
 CK_DLL_CGET( gain_cget_value );
 
@@ -159,6 +163,7 @@ CK_DLL_CGET( delayp_cget_max );
 CK_DLL_CTOR( sndbuf_ctor );
 CK_DLL_DTOR( sndbuf_dtor );
 CK_DLL_TICK( sndbuf_tick );
+CK_DLL_TICKV( sndbuf_tickv );
 CK_DLL_TICKF( sndbuf_tickf );
 CK_DLL_CTRL( sndbuf_ctrl_read );
 CK_DLL_CGET( sndbuf_cget_read );
@@ -182,6 +187,13 @@ CK_DLL_CTRL( sndbuf_ctrl_channel );
 CK_DLL_CGET( sndbuf_cget_channel );
 CK_DLL_CTRL( sndbuf_ctrl_chunks );
 CK_DLL_CGET( sndbuf_cget_chunks );
+CK_DLL_CTRL( sndbuf_ctrl_stream );
+CK_DLL_CGET( sndbuf_cget_stream );
+CK_DLL_CTRL( sndbuf_ctrl_stream_ahead );
+CK_DLL_CGET( sndbuf_cget_stream_ahead );
+CK_DLL_CTRL( sndbuf_ctrl_stream_max );
+CK_DLL_CGET( sndbuf_cget_stream_max );
+CK_DLL_CGET( sndbuf_cget_underruns );
 CK_DLL_CTRL( sndbuf_ctrl_phase_offset );
 CK_DLL_CGET( sndbuf_cget_samples );
 CK_DLL_CGET( sndbuf_cget_length );
@@ -192,6 +204,7 @@ CK_DLL_CGET( sndbuf_cget_valueAt );
 CK_DLL_CTOR( LiSaMulti_ctor );
 CK_DLL_DTOR( LiSaMulti_dtor );
 CK_DLL_TICK( LiSaMulti_tick );
+CK_DLL_TICKV( LiSaMulti_tickv );
 CK_DLL_TICKF( LiSaMulti_tickf );
 CK_DLL_PMSG( LiSaMulti_pmsg );
 CK_DLL_CTRL( LiSaMulti_size );
@@ -35,6 +35,8 @@
 #include "chuck_errmsg.h"
 #include "chuck_globals.h"
 #include "chuck_instr.h"
+#include "chuck_stats.h"
+#include "util_buffers.h"
 
 
 
@@ -107,6 +109,50 @@ DLL_QUERY machine_query( Chuck_DL_Query * QUERY )
     //! get list of active shreds by id
     QUERY->add_sfun( QUERY, machine_shreds_impl, "int[]", "shreds" );
 
+    // add profile
+    //! turn the cpu profiler on (1) or off (0); returns the previous state
+    //! (see also --profile)
+    QUERY->add_sfun( QUERY, machine_profile_set_impl, "int", "profile" );
+    QUERY->add_arg( QUERY, "int", "on" );
+
+    // add profileReport
+    //! get the profile so far: cpu time per shred, per ugen type,
+    //! and the busiest ugens
+    QUERY->add_sfun( QUERY, machine_profile_get_impl, "string", "profileReport" );
+
+    // add profileShred
+    //! get the cpu time spent running a shred, in seconds, while profiling
+    QUERY->add_sfun( QUERY, machine_profile_shred_impl, "float", "profileShred" );
+    QUERY->add_arg( QUERY, "int", "id" );
+
+    // add profileUGen
+    //! get the cpu time spent computing a ugen, in seconds, while profiling
+    QUERY->add_sfun( QUERY, machine_profile_ugen_impl, "float", "profileUGen" );
+    QUERY->add_arg( QUERY, "UGen", "ugen" );
+
+    // add profileReset
+    //! forget the profile so far
+    QUERY->add_sfun( QUERY, machine_profile_reset_impl, "void", "profileReset" );
+
+    // add sampleCache
+    //! get the sample cache stats: decoded samples shared by WvIn,
+    //! WaveLoop, SndBuf and the STK instruments
+    QUERY->add_sfun( QUERY, machine_sample_cache_impl, "string", "sampleCache" );
+
+    // add sampleCacheHits
+    //! get the number of sample reads served from the cache
+    QUERY->add_sfun( QUERY, machine_sample_cache_hits_impl, "int", "sampleCacheHits" );
+
+    // add sampleCacheMisses
+    //! get the number of sample reads that had to decode
+    QUERY->add_sfun( QUERY, machine_sample_cache_misses_impl, "int", "sampleCacheMisses" );
+
+    // add sampleCacheBudget
+    //! set the bytes of samples kept after their last reader is gone;
+    //! returns the previous budget
+    QUERY->add_sfun( QUERY, machine_sample_cache_budget_impl, "int", "sampleCacheBudget" );
+    QUERY->add_arg( QUERY, "int", "bytes" );
+
     // end class
     QUERY->end_class( QUERY );
 
@@ -220,3 +266,65 @@ CK_DLL_SFUN( machine_shreds_impl )
     
     RETURN->v_object = array;
 }
+
+// profile on/off
+CK_DLL_SFUN( machine_profile_set_impl )
+{
+    t_CKINT on = GET_CK_INT(ARGS);
+    RETURN->v_int = Chuck_Profiler::instance()->enable( on != 0 );
+}
+
+// profile report
+CK_DLL_SFUN( machine_profile_get_impl )
+{
+    Chuck_String * a = (Chuck_String *)instantiate_and_initialize_object( &t_string, SHRED );
+    a->str = Chuck_Profiler::instance()->report();
+    RETURN->v_string = a;
+}
+
+// profile of one shred
+CK_DLL_SFUN( machine_profile_shred_impl )
+{
+    t_CKINT id = GET_CK_INT(ARGS);
+    RETURN->v_float = Chuck_Profiler::instance()->shred_seconds( id );
+}
+
+// profile of one ugen
+CK_DLL_SFUN( machine_profile_ugen_impl )
+{
+    Chuck_UGen * ugen = (Chuck_UGen *)GET_CK_OBJECT(ARGS);
+    RETURN->v_float = ugen ? Chuck_Profiler::instance()->ugen_seconds( ugen ) : 0;
+}
+
+// forget the profile
+CK_DLL_SFUN( machine_profile_reset_impl )
+{
+    Chuck_Profiler::instance()->reset();
+}
+
+// sample cache stats
+CK_DLL_SFUN( machine_sample_cache_impl )
+{
+    Chuck_String * a = (Chuck_String *)instantiate_and_initialize_object( &t_string, SHRED );
+    a->str = SampleCache::instance()->report();
+    RETURN->v_string = a;
+}
+
+// sample cache hits
+CK_DLL_SFUN( machine_sample_cache_hits_impl )
+{
+    RETURN->v_int = SampleCache::instance()->hits();
+}
+
+// sample cache misses
+CK_DLL_SFUN( machine_sample_cache_misses_impl )
+{
+    RETURN->v_int = SampleCache::instance()->misses();
+}
+
+// sample cache idle budget
+CK_DLL_SFUN( machine_sample_cache_budget_impl )
+{
+    t_CKINT bytes = GET_CK_INT(ARGS);
+    RETURN->v_int = SampleCache::instance()->budget( bytes > 0 ? bytes : 0 );
+}
@@ -57,6 +57,15 @@ CK_DLL_SFUN( machine_replace_impl );
 CK_DLL_SFUN( machine_status_impl );
 CK_DLL_SFUN( machine_intsize_impl );
 CK_DLL_SFUN( machine_shreds_impl );
+CK_DLL_SFUN( machine_profile_set_impl );
+CK_DLL_SFUN( machine_profile_get_impl );
+CK_DLL_SFUN( machine_profile_shred_impl );
+CK_DLL_SFUN( machine_profile_ugen_impl );
+CK_DLL_SFUN( machine_profile_reset_impl );
+CK_DLL_SFUN( machine_sample_cache_impl );
+CK_DLL_SFUN( machine_sample_cache_hits_impl );
+CK_DLL_SFUN( machine_sample_cache_misses_impl );
+CK_DLL_SFUN( machine_sample_cache_budget_impl );
 
 
 #endif
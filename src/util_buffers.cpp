@@ -33,6 +33,7 @@
 //       Summer 2005 - allow multiple readers
 //-----------------------------------------------------------------------------
 #include <stdlib.h>
+#include <stdio.h>
 #include "util_buffers.h"
 #include "chuck_errmsg.h"
 
@@ -43,6 +44,21 @@
 
 
 
+//-----------------------------------------------------------------------------
+// name: buffer_capacity()
+// desc: num_elem rounded up to a power of 2, so offsets can run freely
+//       ( and wrap around ) while masking to a slot
+//-----------------------------------------------------------------------------
+static UINT__ buffer_capacity( UINT__ num_elem )
+{
+    UINT__ n = 1;
+    while( n < num_elem ) n <<= 1;
+    return n;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: CBufferAdvance()
 // desc: constructor
@@ -50,7 +66,8 @@
 CBufferAdvance::CBufferAdvance()
 {
     m_data = NULL;
-    m_data_width = m_write_offset = m_max_elem = 0; // = m_read_offset
+    m_data_width = m_write_offset = m_mask = 0;
+    m_event_buffer = NULL;
 }
 
 
@@ -78,14 +95,14 @@ BOOL__ CBufferAdvance::initialize( UINT__ num_elem, UINT__ width, CBufferSimple
     cleanup();
 
     // allocate
+    num_elem = buffer_capacity( num_elem );
     m_data = (BYTE__ *)malloc( num_elem * width );
     if( !m_data )
         return false;
 
     m_data_width = width;
-    //m_read_offset = 0;
     m_write_offset = 0;
-    m_max_elem = (SINT__)num_elem;
+    m_mask = num_elem - 1;
     
     m_event_buffer = event_buffer;
 
@@ -108,7 +125,7 @@ void CBufferAdvance::cleanup()
 
     m_data = NULL;
     m_data_width = 0;
-    m_write_offset = m_max_elem = 0; // = m_read_offset
+    m_write_offset = m_mask = 0;
 }
 
 
@@ -120,29 +137,27 @@ void CBufferAdvance::cleanup()
 //-----------------------------------------------------------------------------
 UINT__ CBufferAdvance::join( Chuck_Event * event )
 {
-    // TODO: necessary?
+    // the writer walks the readers in put()
     m_mutex.acquire();
 
     // index of new pointer that will be pushed back
     UINT__ read_offset_index;
+    // new readers start at what's next to be written
+    UINT__ write_offset = xatomic_load( &m_write_offset );
     
-    // add new pointer pointing (as pointers do) to current write offset
-    // (shreds don't get interrupted, so m_write_offset will always be correct, right?)
-    // (uh, hope so...)
     if( !m_free.empty() )
     {
         read_offset_index = m_free.front();
         m_free.pop();
         //assert( read_offset_index < m_read_offsets.size() );
-        m_read_offsets[read_offset_index] = ReadOffset( m_write_offset, event );
+        m_read_offsets[read_offset_index] = ReadOffset( write_offset, event );
     }
     else
     {
         read_offset_index = m_read_offsets.size();
-        m_read_offsets.push_back( ReadOffset( m_write_offset, event ) );
+        m_read_offsets.push_back( ReadOffset( write_offset, event ) );
     }
 
-    // TODO: necessary?
     m_mutex.release();
 
     // return index
@@ -160,86 +175,47 @@ void CBufferAdvance::resign( UINT__ read_offset_index )
     if( read_offset_index >= m_read_offsets.size() )
         return;
 
-    // TODO: necessary?
+    // after this the writer won't touch the event
     m_mutex.acquire();
 
     // add this index to free queue
     m_free.push( read_offset_index );
 
     // "invalidate" the pointer at that index
-    m_read_offsets[read_offset_index].read_offset = -1;
+    m_read_offsets[read_offset_index].active = FALSE;
     m_read_offsets[read_offset_index].event = NULL;
 
-    // TODO: necessary?
     m_mutex.release();
 }
 
 
 //-----------------------------------------------------------------------------
 // name: put()
-// desc: put
+// desc: put; readers that haven't kept up lose the oldest elements
 //-----------------------------------------------------------------------------
-/*void CBufferAdvance::put( void * data, UINT__ num_elem )
+void CBufferAdvance::put( void * data, UINT__ num_elem )
 {
     UINT__ i, j;
     BYTE__ * d = (BYTE__ *)data;
+    // only this thread writes it
+    UINT__ write_offset = m_write_offset;
 
     // copy
     for( i = 0; i < num_elem; i++ )
     {
-        for( j = 0; j < m_data_width; j++ )
-        {
-            m_data[m_write_offset*m_data_width+j] = d[i*m_data_width+j];
-        }
-
-        // move the write
-        m_write_offset++;
-
-        // wrap
-        if( m_write_offset >= m_max_elem )
-            m_write_offset = 0;
+        memcpy( m_data + ( write_offset & m_mask ) * m_data_width,
+                d + i * m_data_width, m_data_width );
+        // publish the element
+        xatomic_store( &m_write_offset, ++write_offset );
     }
-}*/
-
-
-void CBufferAdvance::put( void * data, UINT__ num_elem )
-{
-    UINT__ i, j;
-    BYTE__ * d = (BYTE__ *)data;
 
-    // TODO: necessary?
+    // notify the readers
     m_mutex.acquire();
-
-    // copy
-    for( i = 0; i < num_elem; i++ )
+    for( j = 0; j < m_read_offsets.size(); j++ )
     {
-        for( j = 0; j < m_data_width; j++ )
-        {
-            m_data[m_write_offset*m_data_width+j] = d[i*m_data_width+j];
-        }
-
-        // move the write
-        m_write_offset++;
-        // wrap
-        if( m_write_offset >= m_max_elem )
-            m_write_offset = 0;
-
-        // possibility of expelling evil shreds
-        for( j = 0; j < m_read_offsets.size(); j++ )
-        {
-            if( m_write_offset == m_read_offsets[j].read_offset )
-            {
-                // inform shred with index j that it has lost its privileges?
-                // invalidate its read_offset
-                // m_read_offsets[j].read_offset = -1;
-            }
-
-            if( m_read_offsets[j].event )
-                m_read_offsets[j].event->queue_broadcast( m_event_buffer );
-        }
+        if( m_read_offsets[j].event )
+            m_read_offsets[j].event->queue_broadcast( m_event_buffer );
     }
-
-    // TODO: necessary?
     m_mutex.release();
 }
 
@@ -247,117 +223,66 @@ void CBufferAdvance::put( void * data, UINT__ num_elem )
 
 
 //-----------------------------------------------------------------------------
-// name: get()
-// desc: get
+// name: empty()
+// desc: is there nothing for this reader
 //-----------------------------------------------------------------------------
-/*UINT__ CBufferAdvance::get( void * data, UINT__ num_elem )
-{
-    UINT__ i, j;
-    BYTE__ * d = (BYTE__ *)data;
-
-    // read catch up with write
-    if( m_read_offset == m_write_offset )
-        return 0;
-
-    // copy
-    for( i = 0; i < num_elem; i++ )
-    {
-        for( j = 0; j < m_data_width; j++ )
-        {
-            d[i*m_data_width+j] = m_data[m_read_offset*m_data_width+j];
-        }
-
-        // move read
-        m_read_offset++;
-        
-        // catch up
-        if( m_read_offset == m_write_offset )
-        {
-            i++;
-            break;
-        }
-
-        // wrap
-        if( m_read_offset >= m_max_elem )
-            m_read_offset = 0;
-    }
-
-    // return number of elems
-    return 1;
-}*/
-
-
 BOOL__ CBufferAdvance::empty( UINT__ read_offset_index )
 {
     // make sure index is valid
     if( read_offset_index >= m_read_offsets.size() )
         return TRUE;
-    if( m_read_offsets[read_offset_index].read_offset < 0 )
+    if( !m_read_offsets[read_offset_index].active )
         return TRUE;
 
-    SINT__ m_read_offset = m_read_offsets[read_offset_index].read_offset;
-
     // see if caught up
-    return m_read_offset == m_write_offset;
+    return m_read_offsets[read_offset_index].read_offset == xatomic_load( &m_write_offset );
 }
 
 
+
+
+//-----------------------------------------------------------------------------
+// name: get()
+// desc: get up to num_elem for a reader; returns how many
+//-----------------------------------------------------------------------------
 UINT__ CBufferAdvance::get( void * data, UINT__ num_elem, UINT__ read_offset_index )
 {
-    UINT__ i, j;
+    UINT__ i, write_offset, read_offset, capacity = m_mask + 1;
     BYTE__ * d = (BYTE__ *)data;
 
-    // TODO: necessary?
-    m_mutex.acquire();
-
     // make sure index is valid
     if( read_offset_index >= m_read_offsets.size() )
-    {
-        m_mutex.release();
         return 0;
-    }
-    if( m_read_offsets[read_offset_index].read_offset < 0 )
-    {
-        m_mutex.release();
+    if( !m_read_offsets[read_offset_index].active )
         return 0;
-    }
 
-    SINT__ m_read_offset = m_read_offsets[read_offset_index].read_offset;
+    // (only the reader's thread writes it)
+    read_offset = m_read_offsets[read_offset_index].read_offset;
 
-    // read catch up with write
-    if( m_read_offset == m_write_offset )
+    while( true )
     {
-        m_mutex.release();
-        return 0;
-    }
+        write_offset = xatomic_load( &m_write_offset );
+        // lapped by the writer: skip well ahead of it, to the newer half
+        if( write_offset - read_offset >= capacity )
+            read_offset = write_offset - ( capacity >> 1 );
 
-    // copy
-    for( i = 0; i < num_elem; i++ )
-    {
-        for( j = 0; j < m_data_width; j++ )
+        // copy
+        for( i = 0; i < num_elem && read_offset + i != write_offset; i++ )
         {
-            d[i*m_data_width+j] = m_data[m_read_offset*m_data_width+j];
+            memcpy( d + i * m_data_width,
+                    m_data + ( ( read_offset + i ) & m_mask ) * m_data_width,
+                    m_data_width );
         }
 
-        // move read
-        m_read_offset++;
-        // wrap
-        if( m_read_offset >= m_max_elem )
-            m_read_offset = 0;
-        
-        // catch up
-        if( m_read_offset == m_write_offset )
-        {
-            i++;
+        // if the writer came around to the first element while we were
+        // copying, it may be torn; try again from further on
+        xatomic_fence();
+        if( xatomic_load( &m_write_offset ) - read_offset < capacity )
             break;
-        }
     }
 
     // update read offset at given index
-    m_read_offsets[read_offset_index].read_offset = m_read_offset;
-
-    // TODO: necessary?
-    m_mutex.release();
+    m_read_offsets[read_offset_index].read_offset = read_offset + i;
 
     // return number of elems
     return i;
@@ -373,7 +298,7 @@ UINT__ CBufferAdvance::get( void * data, UINT__ num_elem, UINT__ read_offset_ind
 CBufferSimple::CBufferSimple()
 {
     m_data = NULL;
-    m_data_width = m_read_offset = m_write_offset = m_max_elem = 0;
+    m_data_width = m_read_offset = m_write_offset = m_mask = 0;
 }
 
 
@@ -401,6 +326,7 @@ BOOL__ CBufferSimple::initialize( UINT__ num_elem, UINT__ width )
     cleanup();
 
     // allocate
+    num_elem = buffer_capacity( num_elem );
     m_data = (BYTE__ *)malloc( num_elem * width );
     if( !m_data )
         return false;
@@ -408,7 +334,7 @@ BOOL__ CBufferSimple::initialize( UINT__ num_elem, UINT__ width )
     m_data_width = width;
     m_read_offset = 0;
     m_write_offset = 0;
-    m_max_elem = num_elem;
+    m_mask = num_elem - 1;
 
     return true;
 }
@@ -428,7 +354,7 @@ void CBufferSimple::cleanup()
     free( m_data );
 
     m_data = NULL;
-    m_data_width = m_read_offset = m_write_offset = m_max_elem = 0;
+    m_data_width = m_read_offset = m_write_offset = m_mask = 0;
 }
 
 
@@ -436,26 +362,28 @@ void CBufferSimple::cleanup()
 
 //-----------------------------------------------------------------------------
 // name: put()
-// desc: put
+// desc: put; returns how many fit
 //-----------------------------------------------------------------------------
-void CBufferSimple::put( void * data, UINT__ num_elem )
+UINT__ CBufferSimple::put( void * data, UINT__ num_elem )
 {
-    UINT__ i, j;
+    UINT__ i;
     BYTE__ * d = (BYTE__ *)data;
+    // the writer's own offset, and how far the reader has got
+    UINT__ write_offset = m_write_offset;
+    UINT__ read_offset = xatomic_load( &m_read_offset );
 
     // copy
-    for( i = 0; i < num_elem; i++ )
+    for( i = 0; i < num_elem && write_offset - read_offset <= m_mask; i++ )
     {
-        for( j = 0; j < m_data_width; j++ )
-        {
-            m_data[m_write_offset*m_data_width+j] = d[i*m_data_width+j];
-        }
-
-        // move the write
-        // Aug 2014 - spencer
-        // change to fully "atomic" increment+wrap
-        m_write_offset = (m_write_offset + 1) % m_max_elem;
+        memcpy( m_data + ( write_offset & m_mask ) * m_data_width,
+                d + i * m_data_width, m_data_width );
+        write_offset++;
     }
+
+    // publish
+    xatomic_store( &m_write_offset, write_offset );
+
+    return i;
 }
 
 
@@ -463,40 +391,179 @@ void CBufferSimple::put( void * data, UINT__ num_elem )
 
 //-----------------------------------------------------------------------------
 // name: get()
-// desc: get
+// desc: get; returns how many
 //-----------------------------------------------------------------------------
 UINT__ CBufferSimple::get( void * data, UINT__ num_elem )
 {
-    UINT__ i, j;
+    UINT__ i;
     BYTE__ * d = (BYTE__ *)data;
-
-    // read catch up with write
-    if( m_read_offset == m_write_offset )
-        return 0;
+    // the reader's own offset, and how far the writer has got
+    UINT__ read_offset = m_read_offset;
+    UINT__ write_offset = xatomic_load( &m_write_offset );
 
     // copy
+    for( i = 0; i < num_elem && read_offset != write_offset; i++ )
+    {
+        memcpy( d + i * m_data_width,
+                m_data + ( read_offset & m_mask ) * m_data_width, m_data_width );
+        read_offset++;
+    }
+
+    // hand the slots back to the writer
+    xatomic_store( &m_read_offset, read_offset );
+
+    // return number of elems
+    return i;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: CBufferMPSC()
+// desc: constructor
+//-----------------------------------------------------------------------------
+CBufferMPSC::CBufferMPSC()
+{
+    m_data = NULL;
+    m_data_width = m_slot_width = m_read_offset = m_write_offset = m_mask = 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~CBufferMPSC()
+// desc: destructor
+//-----------------------------------------------------------------------------
+CBufferMPSC::~CBufferMPSC()
+{
+    this->cleanup();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: initialize()
+// desc: initialize
+//-----------------------------------------------------------------------------
+BOOL__ CBufferMPSC::initialize( UINT__ num_elem, UINT__ width )
+{
+    // cleanup
+    cleanup();
+
+    // allocate: each slot is a sequence number then the element, aligned
+    num_elem = buffer_capacity( num_elem );
+    m_slot_width = ( sizeof(UINT__) + width + sizeof(UINT__) - 1 ) & ~( sizeof(UINT__) - 1 );
+    m_data = (BYTE__ *)malloc( num_elem * m_slot_width );
+    if( !m_data )
+        return false;
+
+    m_data_width = width;
+    m_read_offset = 0;
+    m_write_offset = 0;
+    m_mask = num_elem - 1;
+
+    // slot i is free for the writer of element i
+    for( UINT__ i = 0; i < num_elem; i++ )
+        *(UINT__ *)( m_data + i * m_slot_width ) = i;
+
+    return true;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: cleanup()
+// desc: cleanup
+//-----------------------------------------------------------------------------
+void CBufferMPSC::cleanup()
+{
+    if( !m_data )
+        return;
+
+    free( m_data );
+
+    m_data = NULL;
+    m_data_width = m_slot_width = m_read_offset = m_write_offset = m_mask = 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: put()
+// desc: put; returns how many fit
+//-----------------------------------------------------------------------------
+UINT__ CBufferMPSC::put( void * data, UINT__ num_elem )
+{
+    UINT__ i, pos, seq;
+    BYTE__ * d = (BYTE__ *)data;
+    BYTE__ * slot;
+
     for( i = 0; i < num_elem; i++ )
     {
-        for( j = 0; j < m_data_width; j++ )
+        // claim a slot
+        pos = xatomic_load( &m_write_offset );
+        while( true )
         {
-            d[i*m_data_width+j] = m_data[m_read_offset*m_data_width+j];
+            slot = m_data + ( pos & m_mask ) * m_slot_width;
+            seq = xatomic_load( (volatile UINT__ *)slot );
+            // free for element pos: try to take it
+            if( seq == pos )
+            {
+                if( xatomic_cas( &m_write_offset, pos, pos + 1 ) ) break;
+                pos = xatomic_load( &m_write_offset );
+            }
+            // still holds element pos - capacity: full
+            else if( (SINT__)( seq - pos ) < 0 )
+                return i;
+            // another writer took it
+            else pos = xatomic_load( &m_write_offset );
         }
 
-        // move read
-        // Aug 2014 - spencer
-        // change to fully "atomic" increment+wrap
-        m_read_offset = (m_read_offset + 1) % m_max_elem;
-        
-        // catch up
-        if( m_read_offset == m_write_offset )
-        {
-            i++;
+        // fill it, then hand it to the reader
+        memcpy( slot + sizeof(UINT__), d + i * m_data_width, m_data_width );
+        xatomic_store( (volatile UINT__ *)slot, pos + 1 );
+    }
+
+    return i;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: get()
+// desc: get; returns how many
+//-----------------------------------------------------------------------------
+UINT__ CBufferMPSC::get( void * data, UINT__ num_elem )
+{
+    UINT__ i;
+    BYTE__ * d = (BYTE__ *)data;
+    BYTE__ * slot;
+    // only the reader writes it
+    UINT__ read_offset = m_read_offset;
+
+    for( i = 0; i < num_elem; i++ )
+    {
+        slot = m_data + ( read_offset & m_mask ) * m_slot_width;
+        // not filled yet (or not claimed)
+        if( xatomic_load( (volatile UINT__ *)slot ) != read_offset + 1 )
             break;
-        }
+
+        memcpy( d + i * m_data_width, slot + sizeof(UINT__), m_data_width );
+        // free for the writer of element read_offset + capacity
+        xatomic_store( (volatile UINT__ *)slot, read_offset + m_mask + 1 );
+        read_offset++;
     }
 
+    m_read_offset = read_offset;
+
     // return number of elems
-    return 1; // shouldn't it return i?
+    return i;
 }
 
 
@@ -510,6 +577,8 @@ AccumBuffer::AccumBuffer()
 {
     m_data = NULL;
     m_write_offset = m_max_elem = 0;
+    m_snap = NULL;
+    m_snapped = FALSE;
 }
 
 
@@ -584,6 +653,10 @@ t_CKINT AccumBuffer::resize( t_CKINT size )
 //-----------------------------------------------------------------------------
 void AccumBuffer::cleanup()
 {
+    if( m_snap ) free( m_snap );
+    m_snap = NULL;
+    m_snapped = FALSE;
+
     if( !m_data )
         return;
 
@@ -619,6 +692,17 @@ void AccumBuffer::put( SAMPLE data )
 //-----------------------------------------------------------------------------
 void AccumBuffer::get( SAMPLE * buffer, t_CKINT num_elem )
 {
+    // read the snapshot instead, once
+    if( m_snapped )
+    {
+        t_CKINT amount = ck_min( num_elem, (t_CKINT)m_max_elem );
+        memcpy( buffer, m_snap, amount * sizeof(SAMPLE) );
+        if( num_elem > amount )
+            memset( buffer + amount, 0, (num_elem - amount) * sizeof(SAMPLE) );
+        m_snapped = FALSE;
+        return;
+    }
+
     // left to copy
     t_CKINT left = num_elem;
     // amount
@@ -657,6 +741,26 @@ void AccumBuffer::get( SAMPLE * buffer, t_CKINT num_elem )
 
 
 
+//-----------------------------------------------------------------------------
+// name: snap()
+// desc: copy the window, oldest first, for the next get()
+//-----------------------------------------------------------------------------
+void AccumBuffer::snap()
+{
+    if( !m_data ) return;
+
+    // allocate on first use
+    if( !m_snap ) m_snap = (SAMPLE *)malloc( m_max_elem * sizeof(SAMPLE) );
+    if( !m_snap ) return;
+
+    m_snapped = FALSE;
+    this->get( m_snap, m_max_elem );
+    m_snapped = TRUE;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: DeccumBuffer()
 // desc: constructor
@@ -1020,3 +1124,199 @@ t_CKUINT FastCircularBuffer::get( void * _data, t_CKUINT num_elem )
 }
 
 
+
+
+// the cache
+SampleCache * SampleCache::our_instance = NULL;
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: instance()
+// desc: the process-wide cache
+//-----------------------------------------------------------------------------
+SampleCache * SampleCache::instance()
+{
+    if( !our_instance ) our_instance = new SampleCache;
+    return our_instance;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: SampleCache()
+// desc: constructor
+//-----------------------------------------------------------------------------
+SampleCache::SampleCache()
+{
+    m_idle_bytes = 0;
+    m_budget = CK_SAMPLE_CACHE_BUDGET;
+    m_bytes = 0;
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: acquire()
+// desc: referenced entry for key, or NULL
+//-----------------------------------------------------------------------------
+SampleCacheEntry * SampleCache::acquire( const std::string & key )
+{
+    m_mutex.acquire();
+    std::map<std::string, SampleCacheEntry *>::iterator iter = m_entries.find( key );
+    SampleCacheEntry * entry = iter != m_entries.end() ? iter->second : NULL;
+    if( entry )
+    {
+        // no longer idle
+        if( entry->refs++ == 0 )
+        {
+            m_idle.erase( entry->idle );
+            m_idle_bytes -= entry->bytes;
+        }
+        m_hits++;
+    }
+    else m_misses++;
+    m_mutex.release();
+
+    EM_log( CK_LOG_FINE, "(sample cache): %s '%s'", entry ? "hit" : "miss", key.c_str() );
+    return entry;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: insert()
+// desc: hand over data for key; returns the entry, referenced
+//-----------------------------------------------------------------------------
+SampleCacheEntry * SampleCache::insert( const std::string & key, void * data, t_CKUINT bytes,
+                                        void (* free_data)( void * ), t_CKUINT frames,
+                                        t_CKUINT channels, t_CKFLOAT srate )
+{
+    m_mutex.acquire();
+    SampleCacheEntry * entry = NULL;
+    std::map<std::string, SampleCacheEntry *>::iterator iter = m_entries.find( key );
+    if( iter != m_entries.end() )
+    {
+        // someone got there first: share theirs
+        entry = iter->second;
+        if( entry->refs++ == 0 )
+        {
+            m_idle.erase( entry->idle );
+            m_idle_bytes -= entry->bytes;
+        }
+        free_data( data );
+    }
+    else
+    {
+        entry = new SampleCacheEntry;
+        entry->key = key;
+        entry->data = data;
+        entry->bytes = bytes;
+        entry->free_data = free_data;
+        entry->frames = frames;
+        entry->channels = channels;
+        entry->srate = srate;
+        entry->refs = 1;
+        m_entries[key] = entry;
+        m_bytes += bytes;
+    }
+    m_mutex.release();
+
+    return entry;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: release()
+// desc: done with an entry; the last reader leaves it idle
+//-----------------------------------------------------------------------------
+void SampleCache::release( SampleCacheEntry * entry )
+{
+    if( !entry ) return;
+
+    m_mutex.acquire();
+    assert( entry->refs > 0 );
+    if( --entry->refs == 0 )
+    {
+        m_idle.push_front( entry );
+        entry->idle = m_idle.begin();
+        m_idle_bytes += entry->bytes;
+        evict();
+    }
+    m_mutex.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: budget()
+// desc: set the idle budget; returns the previous
+//-----------------------------------------------------------------------------
+t_CKUINT SampleCache::budget( t_CKUINT bytes )
+{
+    m_mutex.acquire();
+    t_CKUINT previous = m_budget;
+    m_budget = bytes;
+    evict();
+    m_mutex.release();
+
+    return previous;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: evict()
+// desc: free least recently used idle entries until within budget
+//       (call with the mutex held)
+//-----------------------------------------------------------------------------
+void SampleCache::evict()
+{
+    while( m_idle_bytes > m_budget )
+    {
+        SampleCacheEntry * entry = m_idle.back();
+        m_idle.pop_back();
+        m_idle_bytes -= entry->bytes;
+        m_bytes -= entry->bytes;
+        m_entries.erase( entry->key );
+        m_evictions++;
+
+        EM_log( CK_LOG_FINE, "(sample cache): evicting '%s'", entry->key.c_str() );
+        entry->free_data( entry->data );
+        delete entry;
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: report()
+// desc: one line of stats
+//-----------------------------------------------------------------------------
+std::string SampleCache::report()
+{
+    char buffer[256];
+    m_mutex.acquire();
+    t_CKUINT lookups = m_hits + m_misses;
+    sprintf( buffer, "sample cache: %lu entries (%lu idle), %.1f KB (%.1f KB idle, budget %.1f KB); "
+             "%lu hits, %lu misses (%.0f%%), %lu evictions",
+             (unsigned long)m_entries.size(), (unsigned long)m_idle.size(),
+             m_bytes / 1024.0, m_idle_bytes / 1024.0, m_budget / 1024.0,
+             (unsigned long)m_hits, (unsigned long)m_misses,
+             lookups ? 100.0 * m_hits / lookups : 0.0, (unsigned long)m_evictions );
+    m_mutex.release();
+
+    return buffer;
+}
@@ -39,6 +39,9 @@
 #include "util_thread.h"
 #include <vector>
 #include <queue>
+#include <map>
+#include <list>
+#include <string>
 
 #define DWORD__                unsigned long
 #define SINT__                 long
@@ -46,6 +49,9 @@
 #define BOOL__                 DWORD__
 #define BYTE__                 unsigned char
 
+// bytes of samples the cache keeps when no reader holds them
+#define CK_SAMPLE_CACHE_BUDGET  ( 32 * 1024 * 1024 )
+
 #ifndef TRUE
 #define TRUE    1
 #define FALSE   0
@@ -57,7 +63,10 @@ class CBufferSimple;
 
 //-----------------------------------------------------------------------------
 // name: class CBufferAdvance
-// desc: circular buffer
+// desc: circular buffer - one writer, many readers (each joined reader has
+//       its own read offset; a reader that falls a whole buffer behind
+//       skips ahead).  get() and empty() never lock; the writer only locks
+//       to notify readers' events, which join() and resign() also lock.
 //-----------------------------------------------------------------------------
 class CBufferAdvance
 {
@@ -79,27 +88,32 @@ public:
 protected:
     BYTE__ * m_data;
     UINT__   m_data_width;
-    //UINT__   m_read_offset;
+    // capacity (a power of 2) - 1
+    UINT__   m_mask;
 
     // this holds the offset allocated by join(), paired with an optional
-    // Chuck_Event to notify when things are put in the buffer
+    // Chuck_Event to notify when things are put in the buffer; offsets
+    // count elements since initialize() and are never wrapped
     struct ReadOffset
     {
-        SINT__ read_offset;
+        UINT__ read_offset;
+        BOOL__ active;
         Chuck_Event * event;
-        ReadOffset( SINT__ ro, Chuck_Event * e = NULL )
-        { read_offset = ro; event = e; }
+        ReadOffset( UINT__ ro, Chuck_Event * e = NULL )
+        { read_offset = ro; active = TRUE; event = e; }
     };
     std::vector<ReadOffset> m_read_offsets;
     std::queue<UINT__> m_free;
 
-    SINT__   m_write_offset;
-    SINT__   m_max_elem;
-
-    // TODO: necessary?
+    // guards m_read_offsets against the writer
     XMutex m_mutex;
     
     CBufferSimple * m_event_buffer;
+
+    // elements put since initialize()
+    BYTE__ m_pad0[XCACHE_LINE];
+    volatile UINT__ m_write_offset;
+    BYTE__ m_pad1[XCACHE_LINE];
 };
 
 
@@ -107,7 +121,8 @@ protected:
 
 //-----------------------------------------------------------------------------
 // name: class CBufferSimple
-// desc: circular buffer - one reader one writer
+// desc: circular buffer - one reader one writer, lock-free; put() drops
+//       what doesn't fit
 //-----------------------------------------------------------------------------
 class CBufferSimple
 {
@@ -121,14 +136,61 @@ public:
 
 public:
     UINT__ get( void * data, UINT__ num_elem );
-    void put( void * data, UINT__ num_elem );
+    UINT__ put( void * data, UINT__ num_elem );
 
 protected:
     BYTE__ * m_data;
     UINT__   m_data_width;
-    UINT__   m_read_offset;
-    UINT__   m_write_offset;
-    UINT__   m_max_elem;
+    // capacity (a power of 2) - 1
+    UINT__   m_mask;
+
+    // elements taken and put since initialize(); each written by one
+    // side only, on its own cache line
+    BYTE__ m_pad0[XCACHE_LINE];
+    volatile UINT__ m_read_offset;
+    BYTE__ m_pad1[XCACHE_LINE];
+    volatile UINT__ m_write_offset;
+    BYTE__ m_pad2[XCACHE_LINE];
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: class CBufferMPSC
+// desc: circular buffer - many writers one reader, lock-free; each slot
+//       carries a sequence number saying whose turn it is (writer or
+//       reader), so writers only contend on claiming a slot.  put() drops
+//       what doesn't fit
+//-----------------------------------------------------------------------------
+class CBufferMPSC
+{
+public:
+    CBufferMPSC();
+    ~CBufferMPSC();
+
+public:
+    BOOL__ initialize( UINT__ num_elem, UINT__ width );
+    void cleanup();
+
+public:
+    UINT__ get( void * data, UINT__ num_elem );
+    UINT__ put( void * data, UINT__ num_elem );
+
+protected:
+    // slots: a sequence number, then the element
+    BYTE__ * m_data;
+    UINT__   m_data_width;
+    UINT__   m_slot_width;
+    // capacity (a power of 2) - 1
+    UINT__   m_mask;
+
+    // next slot to read (reader only) and to claim (writers)
+    BYTE__ m_pad0[XCACHE_LINE];
+    volatile UINT__ m_read_offset;
+    BYTE__ m_pad1[XCACHE_LINE];
+    volatile UINT__ m_write_offset;
+    BYTE__ m_pad2[XCACHE_LINE];
 };
 
 
@@ -151,11 +213,17 @@ public:
 public:
     void put( SAMPLE next );
     void get( SAMPLE * buffer, t_CKINT num_elem );
+    // copy the window as it is now; the next get() reads the copy, so
+    // put() may go on meanwhile (from another thread)
+    void snap();
 
 protected:
     SAMPLE * m_data;
     t_CKUINT m_write_offset;
     t_CKUINT m_max_elem;
+    // oldest first, valid while m_snapped
+    SAMPLE * m_snap;
+    t_CKBOOL m_snapped;
 };
 
 
@@ -326,5 +394,85 @@ protected:
 
 
 
+//-----------------------------------------------------------------------------
+// name: struct SampleCacheEntry
+// desc: decoded sample data shared by every reader of the same source;
+//       immutable once inserted.  readers that want to write must copy.
+//-----------------------------------------------------------------------------
+struct SampleCacheEntry
+{
+    // path or special name, plus whatever changes the data
+    std::string key;
+    // the samples (any type; freed with free_data)
+    void * data;
+    t_CKUINT bytes;
+    void (* free_data)( void * data );
+    // what the readers need to play it
+    t_CKUINT frames;
+    t_CKUINT channels;
+    t_CKFLOAT srate;
+    // readers holding it
+    t_CKUINT refs;
+    // position in the idle list, when refs is 0
+    std::list<SampleCacheEntry *>::iterator idle;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: class SampleCache
+// desc: process-wide cache of decoded samples (WvIn, WaveLoop, SndBuf), so
+//       that instances reading the same file or special: wave hold one copy
+//       and decode it once.  entries no reader holds are kept, least
+//       recently used first out, up to the idle budget in bytes.
+//-----------------------------------------------------------------------------
+class SampleCache
+{
+public:
+    static SampleCache * instance();
+
+public:
+    // referenced entry for key, or NULL (a miss)
+    SampleCacheEntry * acquire( const std::string & key );
+    // hand over data for key; returns it referenced.  if another reader
+    // inserted key first, data is freed and theirs returned
+    SampleCacheEntry * insert( const std::string & key, void * data, t_CKUINT bytes,
+                               void (* free_data)( void * ), t_CKUINT frames,
+                               t_CKUINT channels, t_CKFLOAT srate );
+    // done with an entry
+    void release( SampleCacheEntry * entry );
+    // set the idle budget in bytes; returns the previous
+    t_CKUINT budget( t_CKUINT bytes );
+
+public:
+    t_CKUINT hits() const { return m_hits; }
+    t_CKUINT misses() const { return m_misses; }
+    t_CKUINT evictions() const { return m_evictions; }
+    t_CKUINT entries() const { return m_entries.size(); }
+    t_CKUINT bytes() const { return m_bytes; }
+    std::string report();
+
+protected:
+    SampleCache();
+    void evict();
+
+protected:
+    std::map<std::string, SampleCacheEntry *> m_entries;
+    // entries nobody holds, most recently released first
+    std::list<SampleCacheEntry *> m_idle;
+    t_CKUINT m_idle_bytes;
+    t_CKUINT m_budget;
+    t_CKUINT m_bytes;
+    t_CKUINT m_hits;
+    t_CKUINT m_misses;
+    t_CKUINT m_evictions;
+    XMutex m_mutex;
+
+    static SampleCache * our_instance;
+};
+
+
+
 
 #endif
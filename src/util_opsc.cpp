@@ -1222,9 +1222,10 @@ THREAD_RETURN (THREAD_TYPE udp_port_listener_thread)( void * data )
 
     EM_log( CK_LOG_INFO, "UDP_Port_Listener:: starting receive loop...\n" );
     int mLen;
+    // recv_mesg() blocks until a packet arrives ( or the socket closes ),
+    // so there is no need to sleep between packets
     do {
         mLen = upl->recv_mesg();
-        usleep( 10 );
     } while( mLen != 0 );
 
     EM_log( CK_LOG_INFO, "UDP_Port_Listener:: receive loop terminated...\n" );
@@ -1614,6 +1615,141 @@ OSC_Transmitter::kickMessage() {
 }
 
 
+// OSC_PAYLOAD
+
+OSC_Payload * OSC_Payload::create( const char * buf, int len )
+{
+    // header and message in one block
+    OSC_Payload * p = (OSC_Payload *)malloc( sizeof(OSC_Payload) + len );
+    p->refs = 1;
+    p->len = len;
+    memcpy( p->data(), buf, len );
+    return p;
+}
+
+void OSC_Payload::add_ref()
+{
+    xatomic_add( &refs, 1 );
+}
+
+void OSC_Payload::release()
+{
+    // the receiver thread adds while shreds release
+    if( xatomic_add( &refs, -1 ) == 0 )
+        free( this );
+}
+
+
+// OSC_ADDRESS_NODE
+
+// one part of an address ( between '/'s ); address spaces are indexed
+// by their parts, so a message only visits the nodes along its own
+// address, and wildcards only scan the children of the part they're in
+struct OSC_Address_Node
+{
+    // next parts
+    map<string, OSC_Address_Node *> children;
+    // address spaces ending here, by type tag ( without the ',' )
+    map<string, vector<OSC_Address_Space *> > spaces;
+
+    ~OSC_Address_Node()
+    {
+        map<string, OSC_Address_Node *>::iterator it;
+        for( it = children.begin(); it != children.end(); it++ )
+            delete it->second;
+    }
+
+    bool empty() { return children.empty() && spaces.empty(); }
+};
+
+// the part starting at addr, and where the next one starts ( NULL at the end )
+static const char * osc_address_part( const char * addr, string & part )
+{
+    const char * end = addr + strcspn( addr, "/" );
+    part.assign( addr, end - addr );
+    return *end ? end + 1 : NULL;
+}
+
+// OSC 1.0 pattern characters
+static bool osc_is_pattern( const string & part )
+{
+    return part.find_first_of( "*?[{" ) != string::npos;
+}
+
+static void osc_index_insert( OSC_Address_Node * node, OSC_Address_Space * space )
+{
+    string part;
+    const char * addr = space->address();
+    while( addr )
+    {
+        addr = osc_address_part( addr, part );
+        OSC_Address_Node *& child = node->children[part];
+        if( !child ) child = new OSC_Address_Node;
+        node = child;
+    }
+
+    node->spaces[space->type()].push_back( space );
+}
+
+// remove every entry of space under node; prunes nodes left empty
+static void osc_index_remove( OSC_Address_Node * node, OSC_Address_Space * space )
+{
+    map<string, vector<OSC_Address_Space *> >::iterator s = node->spaces.begin();
+    while( s != node->spaces.end() )
+    {
+        vector<OSC_Address_Space *> & v = s->second;
+        v.erase( std::remove( v.begin(), v.end(), space ), v.end() );
+        if( v.empty() ) node->spaces.erase( s++ );
+        else s++;
+    }
+
+    map<string, OSC_Address_Node *>::iterator c = node->children.begin();
+    while( c != node->children.end() )
+    {
+        osc_index_remove( c->second, space );
+        if( c->second->empty() ) { delete c->second; node->children.erase( c++ ); }
+        else c++;
+    }
+}
+
+// collect the spaces matching a message address ( which may be a pattern;
+// each part is matched on its own, so '*' never crosses a '/' )
+static void osc_index_match( OSC_Address_Node * node, const char * addr,
+                             const char * types, vector<OSC_Address_Space *> & out )
+{
+    // past the last part: match the type tag
+    if( !addr )
+    {
+        map<string, vector<OSC_Address_Space *> >::iterator s = node->spaces.find( types );
+        if( s != node->spaces.end() )
+            out.insert( out.end(), s->second.begin(), s->second.end() );
+        return;
+    }
+
+    string part;
+    const char * next = osc_address_part( addr, part );
+
+    if( !osc_is_pattern( part ) )
+    {
+        map<string, OSC_Address_Node *>::iterator c = node->children.find( part );
+        if( c != node->children.end() )
+            osc_index_match( c->second, next, types, out );
+        return;
+    }
+
+    map<string, OSC_Address_Node *>::iterator c;
+    for( c = node->children.begin(); c != node->children.end(); c++ )
+        if( PatternMatch( part.c_str(), c->first.c_str() ) )
+            osc_index_match( c->second, next, types, out );
+}
+
+// does any argument point into the message ( strings, blobs )
+static bool osc_needs_payload( const char * types )
+{
+    return strpbrk( types, "sb" ) != NULL;
+}
+
+
 // OSC_RECEIVER
 
 OSC_Receiver::OSC_Receiver():
@@ -1628,9 +1764,7 @@ OSC_Receiver::OSC_Receiver():
     _started(false),
     _in_read(0),
     _in_write(1),
-    _address_space(NULL),
-    _address_size(2),
-    _address_num(0),
+    _address_root(NULL),
     m_event_buffer(NULL)
 {
     // allocate inbox
@@ -1639,8 +1773,8 @@ OSC_Receiver::OSC_Receiver():
     for( int i = 0; i < _inbox_size; i++ )
         _inbox[i].payload = NULL;
 
-    // allocate address space
-    _address_space = (OSC_Address_Space **)realloc( _address_space, _address_size * sizeof(OSC_Address_Space *) );
+    // address index
+    _address_root = new OSC_Address_Node;
 
     _io_mutex = new XMutex();
     _address_mutex = new XMutex();
@@ -1682,6 +1816,7 @@ OSC_Receiver::~OSC_Receiver()
     free( _inbox );
     
     // clean up
+    SAFE_DELETE( _address_root );
     SAFE_DELETE( _io_mutex );
     SAFE_DELETE( _address_mutex );
 
@@ -1971,19 +2106,14 @@ OSC_Receiver::handle_mesg( char * buf, int len )
   
    OSCMesg * mrp = write();
 
-   if( mrp->payload == NULL ) {
-      mrp->payload = (char *)malloc( OSCINBUFSIZE * sizeof(char) );
-      // fprintf(stderr, "oscrecv:mallocing %d bytes\n", OSCINBUFSIZE);
-   }
-
-   memcpy( (void*)mrp->payload, (const void*)buf, len ); // copy data from buffer to message payload
-   set_mesg( mrp, mrp->payload, len ); // set pointers for the message to its own payload
+   set_mesg( mrp, buf, len ); // set pointers for the message into the receive buffer
    mrp->recvtime = 0.000; // GetTime(); // set message time
 
-   distribute_message( mrp );  // copy message to any & all matching address spaces
+   distribute_message( mrp );  // queue message to any & all matching address spaces
 
-   // the distribute message will copy any necessary data into the addr object's private queue.
-   // so we don't need to buffer here.. ( totally wasting the kick-ass expanding buffer i have in this class...drat )  
+   // distribute_message() copies the message once, into a shared payload, if any
+   // address space keeps pointers into it; so we don't need to buffer here.. 
+   // ( totally wasting the kick-ass expanding buffer i have in this class...drat )  
 
    // next_write();
 }
@@ -2031,14 +2161,8 @@ void OSC_Receiver::add_address( OSC_Address_Space * src )
     // lock (added 1.3.1.1)
     _address_mutex->acquire();
 
-    // grow array, in place if possible
-    if( _address_num == _address_size )
-    {
-        _address_size *= 2;
-        _address_space = (OSC_Address_Space **)realloc( _address_space, _address_size * sizeof( OSC_Address_Space **) );
-    }
-    // add the source
-    _address_space[_address_num++] = src;
+    // index the source by its address and type
+    osc_index_insert( _address_root, src );
 
     // set the receiver
     src->setReceiver( this );
@@ -2052,13 +2176,8 @@ void OSC_Receiver::remove_address( OSC_Address_Space *odd )
     // lock (added 1.3.1.1)
     _address_mutex->acquire();
 
-    for( int i = 0 ; i < _address_num ; i++ )
-    {
-        while( _address_space[i] == odd )
-        {
-            _address_space[i] = _address_space[--_address_num];
-        }
-    }
+    // the whole index: the address may have changed since it was added
+    osc_index_remove( _address_root, odd );
     
     // release (added 1.3.1.1)
     _address_mutex->release();
@@ -2071,18 +2190,33 @@ void OSC_Receiver::remove_address( OSC_Address_Space *odd )
 */
 void OSC_Receiver::distribute_message( OSCMesg * msg )
 {
+    // untyped messages match nothing
+    if( msg->types == NULL ) return;
+
     // lock (added 1.3.1.1)
     _address_mutex->acquire();
 
-    // iterate
-    for( int i = 0 ; i < _address_num ; i++ )
+    // look up the matching address spaces
+    _matches.clear();
+    osc_index_match( _address_root, msg->address, msg->types + 1, _matches );
+
+    if( !_matches.empty() )
     {
-        if( _address_space[i]->try_queue_mesg( msg ) )
+        // one copy of the message, shared by all the matches
+        OSC_Payload * payload = osc_needs_payload( msg->types + 1 ) ?
+            OSC_Payload::create( msg->address, msg->len ) : NULL;
+
+        // iterate
+        for( size_t i = 0; i < _matches.size(); i++ )
         {
-            // fprintf ( stderr, "broadcasting %x from %x\n", (uint)_address_space[i]->SELF, (uint)_address_space[i] );
+            _matches[i]->queue_mesg( msg, payload );
+            // fprintf ( stderr, "broadcasting %x from %x\n", (uint)_matches[i]->SELF, (uint)_matches[i] );
             // if the event has any shreds queued, fire them off..
-            ((Chuck_Event *)_address_space[i]->SELF)->queue_broadcast( m_event_buffer );
+            ((Chuck_Event *)_matches[i]->SELF)->queue_broadcast( m_event_buffer );
         }
+
+        // the queues hold their own references
+        if( payload ) payload->release();
     }
     
     // release (added 1.3.1.1)
@@ -2146,7 +2280,9 @@ OSC_Address_Space::init() {
 OSC_Address_Space::~OSC_Address_Space()
 {
     // clean up
+    releaseQueue();
     if( _queue ) free( _queue );
+    if( _current_data ) free( _current_data );
     // added 1.3.1.1
     SAFE_DELETE( _buffer_mutex );
 }
@@ -2158,6 +2294,9 @@ OSC_Address_Space::setReceiver(OSC_Receiver * recv) {
 
 void
 OSC_Address_Space::setSpec( const char *addr, const char * types ) { 
+    // the receiver indexes us by address; take us out while it changes
+    OSC_Receiver * recv = _receiver;
+    if( recv ) recv->remove_address( this );
     if( snprintf( _spec, sizeof _spec, "%s,%s", addr, types ) >= sizeof _spec) {
         // TODO: handle the overflow more gracefully.
         EM_log(CK_LOG_SEVERE, "OSC_Address_Space::setSpec: Not enough space in _spec buffer, data was truncated.");
@@ -2165,14 +2304,18 @@ OSC_Address_Space::setSpec( const char *addr, const char * types ) {
     scanSpec();
     _needparse = true; 
     parseSpec(); 
+    if( recv ) recv->add_address( this );
 }
 
 void   
 OSC_Address_Space::setSpec( const char *c ) { 
+    OSC_Receiver * recv = _receiver;
+    if( recv ) recv->remove_address( this );
     strncpy ( _spec, c, 512); 
     scanSpec();
     _needparse = true; 
     parseSpec(); 
+    if( recv ) recv->add_address( this );
 }
  
 void
@@ -2299,11 +2442,29 @@ OSC_Address_Space::resizeQueue( int n )
 void
 OSC_Address_Space::resizeData( int n ) { 
     if( _dataSize == n ) return;
+    releaseQueue();
     _dataSize = n;
     int queueLen = _queueSize * _dataSize * sizeof( opsc_data );
     _queue = ( opsc_data * ) realloc ( _queue, queueLen );
     memset ( _queue, 0, queueLen );
     _current_data = (opsc_data* ) realloc ( _current_data, _dataSize * sizeof( opsc_data) );
+    for( int i = 0; i < _dataSize; i++ ) _current_data[i] = opsc_data();
+    _cur_mesg = NULL;
+}
+
+// drop the payloads held by queued messages and the current one
+void
+OSC_Address_Space::releaseQueue() { 
+    for( int i = 0; _queue && i < _queueSize; i++ )
+    {
+        OSC_Payload *& p = _queue[i * _dataSize].payload;
+        if( p ) { p->release(); p = NULL; }
+    }
+    if( _current_data && _current_data[0].payload )
+    {
+        _current_data[0].payload->release();
+        _current_data[0].payload = NULL;
+    }
 }
 
 
@@ -2312,10 +2473,18 @@ OSC_Address_Space::message_matches( OSCMesg * m ) {
 
     //this should test for type as well.
    
-    bool addr_match;
-    if( strcmp ( m->address, _address ) == 0 ) addr_match = true;
-    else addr_match = PatternMatch( m->address, _address);
-    if( !addr_match ) return false;
+    // part by part, as the receiver's index does
+    string mpart, part;
+    const char * maddr = m->address;
+    const char * addr = _address;
+    while( maddr && addr )
+    {
+        maddr = osc_address_part( maddr, mpart );
+        addr = osc_address_part( addr, part );
+        if( mpart != part && !( osc_is_pattern( mpart ) && PatternMatch( mpart.c_str(), part.c_str() ) ) )
+            return false;
+    }
+    if( maddr || addr ) return false;
 
     //address AND type must match 
     //but there should be an option for the blank 'information about this' pattern
@@ -2335,7 +2504,9 @@ OSC_Address_Space::message_matches( OSCMesg * m ) {
 bool OSC_Address_Space::try_queue_mesg( OSCMesg * m ) 
 {
     if( !message_matches( m ) ) return false;
-    queue_mesg( m );
+    OSC_Payload * p = osc_needs_payload( _type ) ? OSC_Payload::create( m->address, m->len ) : NULL;
+    queue_mesg( m, p );
+    if( p ) p->release();
     return true;
 }
 
@@ -2359,9 +2530,14 @@ bool OSC_Address_Space::next_mesg()
     // TODO: ge uhhhh should release mutex?
     if( has_mesg() )
     {
+        // done with the current message's payload
+        if( _current_data[0].payload ) _current_data[0].payload->release();
+
         // move qread forward
         _qread = ( _qread + 1 ) % _queueSize;
         memcpy( _current_data, _queue + _qread * _dataSize, _dataSize * sizeof( opsc_data ) );
+        // the current message owns the payload now
+        _queue[_qread * _dataSize].payload = NULL;
         _cur_mesg = _current_data;
         _cur_value = 0;
 
@@ -2447,7 +2623,7 @@ OSC_Address_Space::next_blob() {
 }
 
 void
-OSC_Address_Space::queue_mesg( OSCMesg * m ) 
+OSC_Address_Space::queue_mesg( OSCMesg * m, OSC_Payload * p ) 
 {
     // in the server thread. 
     int nqw = ( _qwrite + 1 ) % _queueSize;
@@ -2471,12 +2647,18 @@ OSC_Address_Space::queue_mesg( OSCMesg * m )
 
     _vals = _queue + _qwrite * _dataSize;
 
+    // a dropped message may still hold a payload
+    if( _vals[0].payload ) _vals[0].payload->release();
+    _vals[0].payload = p;
+    if( p ) p->add_ref();
+
     if( _noArgs ) { // if address takes no arguments, 
         _vals[0].t = OSC_NOARGS;
     }
     else { 
         char * type = m->types+1;
-        char * data = m->data;
+        // strings and blobs point into the shared payload, if there is one
+        char * data = p ? p->data() + ( m->data - m->address ) : m->data;
         
         unsigned int endy;
         int i=0;
@@ -2504,8 +2686,7 @@ OSC_Address_Space::queue_mesg( OSCMesg * m )
                 // string
                 clen = strlen(data) + 1; // terminating!
                 _vals[i].t = OSC_STRING;
-                _vals[i].s = (char *) realloc ( _vals[i].s, clen * sizeof(char) );
-                memcpy ( _vals[i].s, data, clen ); // make a copy of the data...
+                _vals[i].s = data; // in the payload, no copy
                 // fprintf(stderr, "add string |%s| ( %d ) \n", _vals[i].s, clen  );
                 data += (((clen-1) >> 2) + 1) << 2;
                 // data += clen + 4 - clen % 4;
@@ -2515,8 +2696,7 @@ OSC_Address_Space::queue_mesg( OSCMesg * m )
                 endy = ntohl(*((unsigned long*)data));
                 clen = *((int*)(&endy));
                 _vals[i].t = OSC_BLOB;
-                _vals[i].s = (char* ) realloc ( _vals[i].s, clen * sizeof(char) );
-                memcpy ( _vals[i].s, data, clen );
+                _vals[i].s = data; // in the payload, no copy
                 data += clen + 4 - clen % 4;
                 break;
             }
@@ -434,6 +434,19 @@ public:
 //maximum size for the array  ( ~2mb is enough, no )
 #define OSCINBOXMAX 256
 
+// one received message, shared by every address space it was queued to;
+// queued strings and blobs point into it instead of being copied
+struct OSC_Payload
+{
+    static OSC_Payload * create( const char * buf, int len );
+    char * data() { return (char *)( this + 1 ); }
+    void add_ref();
+    void release();
+
+    volatile t_CKUINT refs;
+    int len;
+};
+
 struct OSCMesg { 
     char *address;
     char *types;
@@ -463,6 +476,7 @@ protected:
 
 
 class CBufferSimple;
+struct OSC_Address_Node;
 
 class OSC_Receiver : private UDP_Subscriber
 {
@@ -490,9 +504,10 @@ protected:
     int             _in_read;   // space that is being read
     int             _in_write;  // space that is being written
 
-    OSC_Address_Space **      _address_space;
-    int             _address_size;
-    int             _address_num;
+    // address spaces, indexed by address part, then type tag
+    OSC_Address_Node * _address_root;
+    // spaces matching the message being distributed
+    std::vector<OSC_Address_Space *> _matches;
     
     CBufferSimple * m_event_buffer;
     
@@ -549,10 +564,13 @@ struct opsc_data
 	};
 
     char * s;
+    // the message s points into (set on the first value of each message)
+    OSC_Payload * payload;
 
     opsc_data() { 
         t = OSC_UNTYPED;
         s = NULL;
+        payload = NULL;
     }
     ~opsc_data() { 
         s = NULL;
@@ -587,6 +605,7 @@ protected:
     bool  _noArgs;
     void resizeData(int n);
     void resizeQueue(int n);
+    void releaseQueue();
     void parseSpec();
 	void scanSpec();
 
@@ -603,11 +622,13 @@ public:
     void   setSpec( const char * c );
     void   setSpec( const char * addr, const char * type );
     void   setReceiver( OSC_Receiver * recv );
+    const char * address() const { return _address; }
+    const char * type() const { return _type; }
 
     // distribution
     bool   try_queue_mesg ( OSCMesg * o );
     bool   message_matches ( OSCMesg * o );
-    void   queue_mesg ( OSCMesg * o );
+    void   queue_mesg ( OSCMesg * o, OSC_Payload * p = NULL );
 
     // loop functions
     bool   has_mesg();
@@ -564,5 +564,6 @@ int str_endsin(const char *str, const char *end)
     size_t len = strlen(str);
     size_t endlen = strlen(end);
     
+    if(endlen > len) return 0;
     return strncmp(str+(len-endlen), end, endlen) == 0;
 }
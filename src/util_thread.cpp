@@ -36,6 +36,7 @@
 #include "chuck_errmsg.h"
 #ifndef __PLATFORM_WIN32__
 #include <unistd.h> // usleep
+#include <sys/time.h> // gettimeofday
 #endif
 
 
@@ -113,7 +114,11 @@ bool XThread::wait( long milliseconds, bool cancel )
     
 #if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
     if(cancel) pthread_cancel(thread);
-    pthread_join(thread, NULL);
+    if( pthread_join(thread, NULL) == 0 )
+    {
+        thread = 0;
+        result = true;
+    }
 #elif defined(__PLATFORM_WIN32__)
     DWORD timeout, retval;
     if( milliseconds < 0 ) timeout = INFINITE;
@@ -210,6 +215,362 @@ void XMutex::release( )
 
 
 
+//-----------------------------------------------------------------------------
+// name: tryacquire()
+// desc: acquire if free, without blocking; TRUE if acquired
+//-----------------------------------------------------------------------------
+t_CKBOOL XMutex::tryacquire( )
+{
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    return pthread_mutex_trylock(&mutex) == 0;
+#elif defined(__PLATFORM_WIN32__)
+    return TryEnterCriticalSection(&mutex) != 0;
+#endif 
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: XCondition()
+// desc: ...
+//-----------------------------------------------------------------------------
+XCondition::XCondition( )
+{
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    pthread_cond_init( &cond, NULL );
+#elif defined(__PLATFORM_WIN32__)
+    InitializeConditionVariable( &cond );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~XCondition()
+// desc: ...
+//-----------------------------------------------------------------------------
+XCondition::~XCondition( )
+{
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    pthread_cond_destroy( &cond );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: wait()
+// desc: ...
+//-----------------------------------------------------------------------------
+void XCondition::wait( XMutex & mutex )
+{
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    pthread_cond_wait( &cond, &mutex.mutex );
+#elif defined(__PLATFORM_WIN32__)
+    SleepConditionVariableCS( &cond, &mutex.mutex, INFINITE );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: wait()
+// desc: as wait(), but give up after the specified number of milliseconds
+//-----------------------------------------------------------------------------
+void XCondition::wait( XMutex & mutex, long milliseconds )
+{
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    struct timeval now;
+    struct timespec until;
+    gettimeofday( &now, NULL );
+    long usec = now.tv_usec + ( milliseconds % 1000 ) * 1000;
+    until.tv_sec = now.tv_sec + milliseconds / 1000 + usec / 1000000;
+    until.tv_nsec = ( usec % 1000000 ) * 1000;
+    pthread_cond_timedwait( &cond, &mutex.mutex, &until );
+#elif defined(__PLATFORM_WIN32__)
+    SleepConditionVariableCS( &cond, &mutex.mutex, milliseconds );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: signal_all()
+// desc: ...
+//-----------------------------------------------------------------------------
+void XCondition::signal_all( )
+{
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    pthread_cond_broadcast( &cond );
+#elif defined(__PLATFORM_WIN32__)
+    WakeAllConditionVariable( &cond );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: XWorkPool()
+// desc: constructor
+//-----------------------------------------------------------------------------
+XWorkPool::XWorkPool()
+{
+    m_num_threads = 0;
+    m_queues = NULL;
+    m_workers = NULL;
+    m_func = NULL;
+    m_data = NULL;
+    m_pending = 0;
+    m_batch = 0;
+    m_quit = FALSE;
+    m_steals = 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: ~XWorkPool()
+// desc: destructor
+//-----------------------------------------------------------------------------
+XWorkPool::~XWorkPool()
+{
+    this->shutdown();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: initialize()
+// desc: start num_threads - 1 workers
+//-----------------------------------------------------------------------------
+t_CKBOOL XWorkPool::initialize( t_CKUINT num_threads )
+{
+    // already running
+    if( m_num_threads ) return FALSE;
+    if( num_threads < 1 ) num_threads = 1;
+
+    m_num_threads = num_threads;
+    m_queues = new Queue[num_threads];
+    m_workers = new Worker[num_threads];
+    m_quit = FALSE;
+
+    // thread 0 is the caller of run()
+    for( t_CKUINT i = 1; i < num_threads; i++ )
+    {
+        m_workers[i].pool = this;
+        m_workers[i].index = i;
+        if( !m_workers[i].thread.start( worker_cb, &m_workers[i] ) )
+        {
+            EM_log( CK_LOG_SEVERE, "XWorkPool: cannot start worker thread %lu", i );
+            // run with the threads we have
+            m_num_threads = i;
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: shutdown()
+// desc: stop and join the workers
+//-----------------------------------------------------------------------------
+void XWorkPool::shutdown()
+{
+    if( !m_num_threads ) return;
+
+    // tell the workers
+    m_lock.acquire();
+    m_quit = TRUE;
+    m_wake.signal_all();
+    m_lock.release();
+
+    // join
+    for( t_CKUINT i = 1; i < m_num_threads; i++ )
+    {
+        m_workers[i].thread.wait( -1, false );
+        m_workers[i].thread.clear();
+    }
+
+    SAFE_DELETE_ARRAY( m_workers );
+    SAFE_DELETE_ARRAY( m_queues );
+    m_num_threads = 0;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: run()
+// desc: run a batch of tasks and wait for all of them
+//-----------------------------------------------------------------------------
+void XWorkPool::run( TASK_FUNCTION func, void * data, t_CKUINT num_tasks )
+{
+    t_CKUINT i;
+
+    if( num_tasks == 0 ) return;
+
+    // not started: run everything here
+    if( m_num_threads < 2 )
+    {
+        for( i = 0; i < num_tasks; i++ )
+            func( data, i );
+        return;
+    }
+
+    // the batch, counted before any task can be taken: a worker still
+    // in work() from the last batch may take one as soon as it is dealt
+    m_lock.acquire();
+    m_func = func;
+    m_data = data;
+    m_pending = num_tasks;
+    m_lock.release();
+
+    // deal the tasks out; the queues are empty after the last batch
+    for( i = 0; i < num_tasks; i++ )
+    {
+        Queue & q = m_queues[i % m_num_threads];
+        q.lock.acquire();
+        if( q.head == q.tasks.size() ) { q.tasks.clear(); q.head = 0; }
+        q.tasks.push_back( i );
+        q.lock.release();
+    }
+
+    // wake the workers
+    m_lock.acquire();
+    m_batch++;
+    m_wake.signal_all();
+    m_lock.release();
+
+    // work as thread 0
+    work( 0 );
+
+    // wait for the rest
+    m_lock.acquire();
+    while( m_pending > 0 )
+        m_done.wait( m_lock );
+    m_lock.release();
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: next()
+// desc: pop the newest task of our own queue, else steal the oldest of
+//       another thread's
+//-----------------------------------------------------------------------------
+t_CKBOOL XWorkPool::next( t_CKUINT self, t_CKUINT & task )
+{
+    Queue & own = m_queues[self];
+    t_CKBOOL found = FALSE;
+
+    // own queue, from the back
+    own.lock.acquire();
+    if( own.head < own.tasks.size() )
+    {
+        task = own.tasks.back();
+        own.tasks.pop_back();
+        found = TRUE;
+    }
+    own.lock.release();
+    if( found ) return TRUE;
+
+    // steal, from the front
+    for( t_CKUINT i = 1; i < m_num_threads && !found; i++ )
+    {
+        Queue & victim = m_queues[(self + i) % m_num_threads];
+        victim.lock.acquire();
+        if( victim.head < victim.tasks.size() )
+        {
+            task = victim.tasks[victim.head++];
+            found = TRUE;
+        }
+        victim.lock.release();
+    }
+
+    if( found )
+    {
+        m_lock.acquire();
+        m_steals++;
+        m_lock.release();
+    }
+
+    return found;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: work()
+// desc: run tasks until there are none left to take
+//-----------------------------------------------------------------------------
+void XWorkPool::work( t_CKUINT self )
+{
+    t_CKUINT task;
+
+    while( next( self, task ) )
+    {
+        m_func( m_data, task );
+
+        // count it
+        m_lock.acquire();
+        if( --m_pending == 0 )
+            m_done.signal_all();
+        m_lock.release();
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: worker_cb()
+// desc: thread function
+//-----------------------------------------------------------------------------
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+void * XWorkPool::worker_cb( void * _worker )
+#elif defined(__PLATFORM_WIN32__)
+unsigned XWorkPool::worker_cb( void * _worker )
+#endif
+{
+    Worker * worker = (Worker *)_worker;
+    XWorkPool * pool = worker->pool;
+    t_CKUINT seen = 0;
+
+    pool->m_lock.acquire();
+    while( TRUE )
+    {
+        // wait for a new batch
+        while( !pool->m_quit && pool->m_batch == seen )
+            pool->m_wake.wait( pool->m_lock );
+        if( pool->m_quit ) break;
+        seen = pool->m_batch;
+
+        pool->m_lock.release();
+        pool->work( worker->index );
+        pool->m_lock.acquire();
+    }
+    pool->m_lock.release();
+
+    return 0;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: shared()
 // desc: get XWriteThread shared instance
@@ -240,6 +601,7 @@ XWriteThread::XWriteThread(size_t data_buffer_size, size_t msg_buffer_size)
 {
     m_data_buffer->initialize( data_buffer_size, sizeof(char) );
     m_thread_exit = FALSE;
+    m_block = FALSE;
     m_thread.start( write_cb, this );
     m_stream = NULL;
     m_bytes_in_buffer = 0;
@@ -264,15 +626,19 @@ XWriteThread::~XWriteThread()
 
 //-----------------------------------------------------------------------------
 // name: shutdown()
-// desc: close down writer thread and delete in background
+// desc: close down writer thread (after it finishes what is queued) and delete
 //-----------------------------------------------------------------------------
 void XWriteThread::shutdown()
 {
     Message msg;
     msg.operation = Message::SHUTDOWN;
-    m_msg_buffer->put( msg );
+    // (always wait for room; the writer has to see this one)
+    while( !m_msg_buffer->put( msg ) )
+        usleep( 1000 );
     
     m_thread.wait( -1, false );
+    
+    delete this;
 }
 
 
@@ -288,9 +654,17 @@ size_t XWriteThread::fwrite(const void * ptr, size_t size, size_t nitems, FILE *
         flush_data_buffer();
     
     // TODO: overflow detection
-    if(m_data_buffer->put((char*)ptr, size*nitems) == 0)
+    while(m_data_buffer->put((char*)ptr, size*nitems) == 0)
     {
-        EM_log(CK_LOG_SEVERE, "XWriteThread::fwrite: data buffer overflow");
+        if(!m_block)
+        {
+            EM_log(CK_LOG_SEVERE, "XWriteThread::fwrite: data buffer overflow");
+            break;
+        }
+        
+        // hand over what is pending, and wait for room
+        flush_data_buffer();
+        usleep(1000);
     }
     
     m_bytes_in_buffer += size*nitems;
@@ -318,7 +692,7 @@ int XWriteThread::fseek(FILE *stream, long offset, int whence)
     msg.operation = Message::SEEK;
     msg.seek.offset = offset;
     msg.seek.whence = whence;
-    m_msg_buffer->put(msg);
+    put_msg(msg);
     
     return 0;
 }
@@ -337,7 +711,7 @@ int XWriteThread::fflush(FILE *stream)
     Message msg;
     msg.file = stream;
     msg.operation = Message::FLUSH;
-    m_msg_buffer->put(msg);
+    put_msg(msg);
     
     return 0;
 }
@@ -356,7 +730,7 @@ int XWriteThread::fclose(FILE *stream)
     Message msg;
     msg.file = stream;
     msg.operation = Message::CLOSE;
-    m_msg_buffer->put(msg);
+    put_msg(msg);
     
     return 0;
 }
@@ -376,7 +750,7 @@ void XWriteThread::flush_data_buffer()
         msg.file = m_stream;
         msg.operation = Message::WRITE;
         msg.write.data_size = m_bytes_in_buffer;
-        m_msg_buffer->put(msg);
+        put_msg(msg);
         
         m_bytes_in_buffer = 0;
     }
@@ -385,6 +759,19 @@ void XWriteThread::flush_data_buffer()
 
 
 
+//-----------------------------------------------------------------------------
+// name: put_msg()
+// desc: queue a message; if blocking, wait for room
+//-----------------------------------------------------------------------------
+void XWriteThread::put_msg( const Message & msg )
+{
+    while( !m_msg_buffer->put( msg ) && m_block )
+        usleep( 1000 );
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: write_cb()
 // desc: thread function
@@ -436,8 +823,6 @@ unsigned XWriteThread::write_cb(void * _thiss)
         usleep(1000);
     }
     
-    delete _this;
-    _thiss = _this = NULL;
-    
+    // (shutdown() joins, then deletes)
     return 0;
 }
@@ -36,6 +36,7 @@
 
 #include "chuck_def.h"
 #include <stdio.h>
+#include <vector>
 
 
 // forward declaration to break circular dependencies
@@ -50,6 +51,7 @@ template<typename T> class CircularBuffer;
   typedef void * THREAD_RETURN;
   typedef void * (*THREAD_FUNCTION)(void *);
   typedef pthread_mutex_t MUTEX;
+  typedef pthread_cond_t CONDITION;
   #define CHUCK_THREAD pthread_t
 #elif defined(__PLATFORM_WIN32__)
   #include <windows.h>
@@ -59,12 +61,48 @@ template<typename T> class CircularBuffer;
   typedef unsigned THREAD_RETURN;
   typedef unsigned (__stdcall *THREAD_FUNCTION)(void *);
   typedef CRITICAL_SECTION MUTEX;
+  typedef CONDITION_VARIABLE CONDITION;
   #define CHUCK_THREAD HANDLE
 #endif
 
 
 
 
+//-----------------------------------------------------------------------------
+// atomics on a t_CKUINT, for the lock-free buffers: loads acquire, stores
+// release, add and compare-and-swap are full barriers
+//-----------------------------------------------------------------------------
+// keep indices written by different threads on different cache lines
+#define XCACHE_LINE 64
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+  // (volatile accesses have acquire / release semantics on msvc)
+  inline t_CKUINT xatomic_load( const volatile t_CKUINT * p )
+  { t_CKUINT v = *p; _ReadWriteBarrier(); return v; }
+  inline void xatomic_store( volatile t_CKUINT * p, t_CKUINT v )
+  { _ReadWriteBarrier(); *p = v; }
+  inline t_CKUINT xatomic_add( volatile t_CKUINT * p, t_CKINT n )
+  { return (t_CKUINT)_InterlockedExchangeAdd( (volatile long *)p, n ) + n; }
+  inline t_CKBOOL xatomic_cas( volatile t_CKUINT * p, t_CKUINT expect, t_CKUINT value )
+  { return (t_CKUINT)_InterlockedCompareExchange( (volatile long *)p, value, expect ) == expect; }
+  inline void xatomic_fence() { MemoryBarrier(); }
+#else
+  inline t_CKUINT xatomic_load( const volatile t_CKUINT * p )
+  { return __atomic_load_n( p, __ATOMIC_ACQUIRE ); }
+  inline void xatomic_store( volatile t_CKUINT * p, t_CKUINT v )
+  { __atomic_store_n( p, v, __ATOMIC_RELEASE ); }
+  inline t_CKUINT xatomic_add( volatile t_CKUINT * p, t_CKINT n )
+  { return __atomic_add_fetch( p, n, __ATOMIC_SEQ_CST ); }
+  inline t_CKBOOL xatomic_cas( volatile t_CKUINT * p, t_CKUINT expect, t_CKUINT value )
+  { return __atomic_compare_exchange_n( p, &expect, value, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED ); }
+  inline void xatomic_fence() { __atomic_thread_fence( __ATOMIC_SEQ_CST ); }
+#endif
+
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: struct XThread
 // desc: ...
@@ -110,9 +148,125 @@ public:
 public:
     void acquire( );
     void release(void);
+    // acquire if free, without blocking; TRUE if acquired
+    t_CKBOOL tryacquire( );
 
 protected:
     MUTEX mutex;
+
+    friend struct XCondition;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct XCondition
+// desc: condition variable, used with an XMutex
+//-----------------------------------------------------------------------------
+struct XCondition
+{
+public:
+    XCondition();
+    ~XCondition();
+
+public:
+    // release the (acquired) mutex, wait for a signal, re-acquire
+    void wait( XMutex & mutex );
+    // as wait(), but give up after the specified number of milliseconds
+    void wait( XMutex & mutex, long milliseconds );
+    // wake all waiters
+    void signal_all();
+
+protected:
+    CONDITION cond;
+};
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: struct XWorkPool
+// desc: fixed set of threads running batches of independent tasks.  each
+//       thread has its own queue, works from the back of it, and steals
+//       from the front of the others' when it runs dry.  the caller of
+//       run() works as thread 0 and returns once the whole batch is done.
+//-----------------------------------------------------------------------------
+struct XWorkPool
+{
+public:
+    // runs one task of a batch
+    typedef void (* TASK_FUNCTION)( void * data, t_CKUINT task );
+
+public:
+    XWorkPool();
+    ~XWorkPool();
+
+public:
+    // start num_threads - 1 workers (the caller of run() is the last one)
+    t_CKBOOL initialize( t_CKUINT num_threads );
+    // stop and join the workers
+    void shutdown();
+    // run tasks 0 .. num_tasks-1; task i is first queued on thread
+    // (i % num_threads), so callers should list the largest tasks first
+    void run( TASK_FUNCTION func, void * data, t_CKUINT num_tasks );
+
+public:
+    // number of threads, including the caller of run()
+    t_CKUINT num_threads() const { return m_num_threads; }
+    // tasks that ran on a thread other than the one they were queued on
+    t_CKUINT steals() const { return m_steals; }
+
+protected:
+    // get the next task for thread self: its own newest, else steal
+    t_CKBOOL next( t_CKUINT self, t_CKUINT & task );
+    // run tasks until none are left
+    void work( t_CKUINT self );
+
+    // thread function
+#if ( defined(__PLATFORM_MACOSX__) || defined(__PLATFORM_LINUX__) || defined(__WINDOWS_PTHREAD__) )
+    static void * worker_cb( void * _worker );
+#elif defined(__PLATFORM_WIN32__)
+    static unsigned THREAD_TYPE worker_cb( void * _worker );
+#endif
+
+protected:
+    // one queue per thread
+    struct Queue
+    {
+        std::vector<t_CKUINT> tasks;
+        t_CKUINT head;
+        XMutex lock;
+        Queue() : head( 0 ) { }
+    };
+
+    // one worker per thread except the caller's
+    struct Worker
+    {
+        XWorkPool * pool;
+        t_CKUINT index;
+        XThread thread;
+        Worker() : pool( NULL ), index( 0 ) { }
+    };
+
+    t_CKUINT m_num_threads;
+    Queue * m_queues;
+    Worker * m_workers;
+
+    // the current batch
+    TASK_FUNCTION m_func;
+    void * m_data;
+    // guards everything below
+    XMutex m_lock;
+    // tasks not yet finished
+    t_CKUINT m_pending;
+    // batch counter; workers wake when it changes
+    t_CKUINT m_batch;
+    t_CKBOOL m_quit;
+    t_CKUINT m_steals;
+    // wakes workers / the caller of run()
+    XCondition m_wake;
+    XCondition m_done;
 };
 
 
@@ -140,14 +294,18 @@ public:
     int fseek( FILE * stream, long offset, int whence );
     int fflush( FILE * stream );
     int fclose( FILE * stream );
+
+    // blocking: wait for the writer when the buffers are full, instead of
+    // dropping data (for offline use; never from the audio thread)
+    void set_blocking( t_CKBOOL block ) { m_block = block; }
     
     // DO NOT DELETE INSTANCES OF XWriteThread
-    // instead call shutdown and they will be cleaned up in the background
+    // instead call shutdown, which finishes queued writes and cleans up
     void shutdown();
 
 private:    
     // DO NOT DELETE INSTANCES OF XWriteThread
-    // instead call shutdown and they will be cleaned up in the background
+    // instead call shutdown, which finishes queued writes and cleans up
     ~XWriteThread();
 
 	// flush
@@ -165,6 +323,7 @@ private:
 
 private:
     t_CKBOOL m_thread_exit;
+    t_CKBOOL m_block;
     XThread m_thread;
     FastCircularBuffer * m_data_buffer;
     size_t m_bytes_in_buffer;
@@ -203,6 +362,9 @@ private:
         };
     };
 
+	// queue a message
+    void put_msg( const Message & msg );
+
 	// circular buffer
     CircularBuffer<Message> * m_msg_buffer;
 };
@@ -34,6 +34,7 @@
 #include "util_xforms.h"
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 
 
 
@@ -326,6 +327,381 @@ void bit_reverse( FLOAT * x, long N )
 
 
 
+//-----------------------------------------------------------------------------
+// planned fft
+//
+//   same transforms (layout, sign, and scaling) as cfft() and rfft(), with
+//   the bit-reversal swaps and all twiddles computed once per size.  the
+//   complex transform runs the stages two at a time as radix-4 passes
+//   (plus one radix-2 pass for odd powers of 2), with an SSE2 path for
+//   single-precision samples.
+//-----------------------------------------------------------------------------
+#if defined(__SSE2__) && !defined(__CHUCK_USE_64_BIT_SAMPLE__)
+  #define __XFORMS_SSE2__
+  #include <emmintrin.h>
+#endif
+
+// plans, by log2 of the number of complex points; each is published once,
+// by compare-and-swap, as analysis threads may ask for one at the same time
+static fft_plan * volatile g_fft_plans[32];
+
+#if defined(_MSC_VER)
+  #include <windows.h>
+#endif
+
+// load a published plan (or NULL)
+static fft_plan * fft_plan_load( fft_plan * volatile * slot )
+{
+#if defined(_MSC_VER)
+    // (volatile reads have acquire semantics on msvc)
+    return *slot;
+#else
+    return __atomic_load_n( slot, __ATOMIC_ACQUIRE );
+#endif
+}
+
+// publish plan in an empty slot; 0 if the slot was taken
+static int fft_plan_publish( fft_plan * volatile * slot, fft_plan * plan )
+{
+#if defined(_MSC_VER)
+    return InterlockedCompareExchangePointer( (PVOID volatile *)slot, plan, NULL ) == NULL;
+#else
+    fft_plan * none = NULL;
+    return __atomic_compare_exchange_n( slot, &none, plan, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+#endif
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: fft_plan_make()
+// desc: make a plan for NC complex points
+//-----------------------------------------------------------------------------
+static fft_plan * fft_plan_make( long NC )
+{
+    fft_plan * plan = (fft_plan *)calloc( 1, sizeof(fft_plan) );
+    FLOAT * w;
+    long i, j, m, h, size;
+
+    plan->NC = NC;
+
+    // bit-reversal swaps (same order as bit_reverse())
+    plan->swaps = (long *)malloc( NC * sizeof(long) );
+    for( i = j = 0 ; i < NC ; i++, j += m )
+    {
+        if( j > i )
+        {
+            plan->swaps[plan->num_swaps++] = i;
+            plan->swaps[plan->num_swaps++] = j;
+        }
+
+        for( m = NC>>1 ; m >= 1 && j >= m ; m >>= 1 )
+            j -= m ;
+    }
+
+    // radix-4 twiddles, forward: w1[h], w2[h], w3[h] per pass
+    plan->first = 1;
+    for( m = NC; m > 1; m >>= 2 )
+        if( m == 2 ) plan->first = 2;
+    size = 0;
+    for( h = plan->first; 4*h <= NC; h <<= 2 )
+        size += 3 * h;
+    plan->twiddles = w = (FLOAT *)malloc( (2*size + 1) * sizeof(FLOAT) );
+    for( h = plan->first; 4*h <= NC; h <<= 2 )
+    {
+        for( m = 1; m <= 3; m++ )
+        {
+            for( j = 0; j < h; j++ )
+            {
+                double theta = 2.0 * ONE_PI * m * j / (4.0 * h);
+                *w++ = (FLOAT)cos( theta );
+                *w++ = (FLOAT)sin( theta );
+            }
+        }
+    }
+
+    // real transform twiddles: angle i*pi/NC, 0 <= i <= NC/2
+    plan->rtwiddles = w = (FLOAT *)malloc( (NC + 2) * sizeof(FLOAT) );
+    for( i = 0; i <= NC>>1; i++ )
+    {
+        *w++ = (FLOAT)cos( ONE_PI * i / NC );
+        *w++ = (FLOAT)sin( ONE_PI * i / NC );
+    }
+
+    // dct twiddles: angle i*pi/(2N) for N = 2*NC reals, 0 <= i <= NC
+    plan->dtwiddles = w = (FLOAT *)malloc( (2*NC + 2) * sizeof(FLOAT) );
+    for( i = 0; i <= NC; i++ )
+    {
+        *w++ = (FLOAT)cos( ONE_PI * i / (4.0 * NC) );
+        *w++ = (FLOAT)sin( ONE_PI * i / (4.0 * NC) );
+    }
+
+    return plan;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: fft_plan_free()
+// desc: free a plan that lost the race to be published
+//-----------------------------------------------------------------------------
+static void fft_plan_free( fft_plan * plan )
+{
+    free( plan->swaps );
+    free( plan->twiddles );
+    free( plan->rtwiddles );
+    free( plan->dtwiddles );
+    free( plan );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: fft_plan_get()
+// desc: get the plan for NC complex points (NC must be a power of 2); plans
+//       are made on first use and kept; safe to call from any thread
+//-----------------------------------------------------------------------------
+fft_plan * fft_plan_get( long NC )
+{
+    fft_plan * plan;
+    long n = 0;
+    while( (1L << n) < NC ) n++;
+
+    plan = fft_plan_load( &g_fft_plans[n] );
+    if( plan ) return plan;
+
+    // make one; if another thread got there first, use theirs
+    plan = fft_plan_make( 1L << n );
+    if( !fft_plan_publish( &g_fft_plans[n], plan ) )
+    {
+        fft_plan_free( plan );
+        plan = fft_plan_load( &g_fft_plans[n] );
+    }
+
+    return plan;
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: cfft_radix4()
+// desc: one radix-4 pass over blocks of 4h complex values; s is 1 (forward)
+//       or -1 (inverse), conjugating the twiddles
+//-----------------------------------------------------------------------------
+static void cfft_radix4( FLOAT * x, long NC, long h, const FLOAT * w, FLOAT s )
+{
+    const FLOAT * w1 = w;
+    const FLOAT * w2 = w + 2*h;
+    const FLOAT * w3 = w + 4*h;
+    long b, j;
+
+    for( b = 0; b < NC; b += 4*h )
+    {
+        FLOAT * x0 = x + 2*b;
+        FLOAT * x1 = x0 + 2*h;
+        FLOAT * x2 = x1 + 2*h;
+        FLOAT * x3 = x2 + 2*h;
+
+        j = 0;
+#ifdef __XFORMS_SSE2__
+        if( h >= 2 )
+        {
+            // two butterflies at a time: [re, im, re, im]
+            const __m128 conj = _mm_set_ps( s < 0 ? -0.f : 0.f, 0.f, s < 0 ? -0.f : 0.f, 0.f );
+            // multiply by s*i: (re, im) -> (-s*im, s*re)
+            const __m128 rot = _mm_set_ps( s < 0 ? -0.f : 0.f, s < 0 ? 0.f : -0.f,
+                                           s < 0 ? -0.f : 0.f, s < 0 ? 0.f : -0.f );
+            for( ; j < h; j += 2 )
+            {
+                __m128 a0 = _mm_loadu_ps( x0 + 2*j );
+                __m128 a1 = _mm_loadu_ps( x1 + 2*j );
+                __m128 a2 = _mm_loadu_ps( x2 + 2*j );
+                __m128 a3 = _mm_loadu_ps( x3 + 2*j );
+                __m128 t1 = _mm_xor_ps( _mm_loadu_ps( w1 + 2*j ), conj );
+                __m128 t2 = _mm_xor_ps( _mm_loadu_ps( w2 + 2*j ), conj );
+                __m128 t3 = _mm_xor_ps( _mm_loadu_ps( w3 + 2*j ), conj );
+                __m128 b1, b2, b3, s02, d02, s13, d13;
+
+                // complex multiplies: b = t * a
+                #define XFORMS_CMUL(t, a) _mm_add_ps( \
+                    _mm_mul_ps( _mm_shuffle_ps( t, t, _MM_SHUFFLE(2,2,0,0) ), a ), \
+                    _mm_mul_ps( _mm_shuffle_ps( t, t, _MM_SHUFFLE(3,3,1,1) ), \
+                                _mm_xor_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2,3,0,1) ), \
+                                            _mm_set_ps( 0.f, -0.f, 0.f, -0.f ) ) ) )
+                b1 = XFORMS_CMUL( t1, a2 );
+                b2 = XFORMS_CMUL( t2, a1 );
+                b3 = XFORMS_CMUL( t3, a3 );
+                #undef XFORMS_CMUL
+
+                s02 = _mm_add_ps( a0, b2 );
+                d02 = _mm_sub_ps( a0, b2 );
+                s13 = _mm_add_ps( b1, b3 );
+                d13 = _mm_sub_ps( b1, b3 );
+                d13 = _mm_xor_ps( _mm_shuffle_ps( d13, d13, _MM_SHUFFLE(2,3,0,1) ), rot );
+
+                _mm_storeu_ps( x0 + 2*j, _mm_add_ps( s02, s13 ) );
+                _mm_storeu_ps( x2 + 2*j, _mm_sub_ps( s02, s13 ) );
+                _mm_storeu_ps( x1 + 2*j, _mm_add_ps( d02, d13 ) );
+                _mm_storeu_ps( x3 + 2*j, _mm_sub_ps( d02, d13 ) );
+            }
+        }
+#endif
+        for( ; j < h; j++ )
+        {
+            FLOAT w1r = w1[2*j], w1i = s*w1[2*j+1];
+            FLOAT w2r = w2[2*j], w2i = s*w2[2*j+1];
+            FLOAT w3r = w3[2*j], w3i = s*w3[2*j+1];
+            FLOAT a0r = x0[2*j], a0i = x0[2*j+1];
+            FLOAT a1r = x1[2*j], a1i = x1[2*j+1];
+            FLOAT a2r = x2[2*j], a2i = x2[2*j+1];
+            FLOAT a3r = x3[2*j], a3i = x3[2*j+1];
+
+            // blocks h apart hold the sub-transforms of residues 0, 2, 1, 3
+            FLOAT b1r = w1r*a2r - w1i*a2i, b1i = w1r*a2i + w1i*a2r;
+            FLOAT b2r = w2r*a1r - w2i*a1i, b2i = w2r*a1i + w2i*a1r;
+            FLOAT b3r = w3r*a3r - w3i*a3i, b3i = w3r*a3i + w3i*a3r;
+
+            FLOAT s02r = a0r + b2r, s02i = a0i + b2i;
+            FLOAT d02r = a0r - b2r, d02i = a0i - b2i;
+            FLOAT s13r = b1r + b3r, s13i = b1i + b3i;
+            // times s*i
+            FLOAT d13r = -s*(b1i - b3i), d13i = s*(b1r - b3r);
+
+            x0[2*j] = s02r + s13r; x0[2*j+1] = s02i + s13i;
+            x2[2*j] = s02r - s13r; x2[2*j+1] = s02i - s13i;
+            x1[2*j] = d02r + d13r; x1[2*j+1] = d02i + d13i;
+            x3[2*j] = d02r - d13r; x3[2*j+1] = d02i - d13i;
+        }
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: cfft_plan()
+// desc: complex fft, as cfft(), with plan for NC complex values
+//-----------------------------------------------------------------------------
+void cfft_plan( fft_plan * plan, FLOAT * x, unsigned int forward )
+{
+    long NC = plan->NC;
+    long ND = NC<<1;
+    const FLOAT * w = plan->twiddles;
+    FLOAT s = forward ? 1 : -1;
+    FLOAT scale;
+    long i, h;
+
+    // bit reverse
+    for( i = 0; i < plan->num_swaps; i += 2 )
+    {
+        FLOAT * a = x + 2*plan->swaps[i];
+        FLOAT * b = x + 2*plan->swaps[i+1];
+        FLOAT rtemp = a[0], itemp = a[1];
+        a[0] = b[0]; a[1] = b[1];
+        b[0] = rtemp; b[1] = itemp;
+    }
+
+    // odd power of 2: one radix-2 pass first
+    if( plan->first == 2 )
+    {
+        for( i = 0; i < ND; i += 4 )
+        {
+            FLOAT rtemp = x[i+2], itemp = x[i+3];
+            x[i+2] = x[i] - rtemp; x[i+3] = x[i+1] - itemp;
+            x[i] += rtemp; x[i+1] += itemp;
+        }
+    }
+
+    // radix-4 passes
+    for( h = plan->first; 4*h <= NC; h <<= 2 )
+    {
+        cfft_radix4( x, NC, h, w, s );
+        w += 6*h;
+    }
+
+    // scale output
+    scale = (FLOAT)(forward ? 1./ND : 2.) ;
+    {
+        register FLOAT *xi=x, *xe=x+ND ;
+        while( xi < xe )
+            *xi++ *= scale ;
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: rfft_plan()
+// desc: real fft, as rfft() (x holds 2*NC reals), with plan for NC
+//-----------------------------------------------------------------------------
+void rfft_plan( fft_plan * plan, FLOAT * x, unsigned int forward )
+{
+    long N = plan->NC;
+    const FLOAT * w = plan->rtwiddles;
+    FLOAT c1 = 0.5, c2, s, h1r, h1i, h2r, h2i, wr, wi, xr, xi;
+    long i, i1, i2, i3, i4, N2p1;
+
+    if( forward )
+    {
+        c2 = -0.5 ;
+        s = 1 ;
+        cfft_plan( plan, x, forward ) ;
+        xr = x[0] ;
+        xi = x[1] ;
+    }
+    else
+    {
+        c2 = 0.5 ;
+        s = -1 ;
+        xr = x[1] ;
+        xi = 0. ;
+        x[1] = 0. ;
+    }
+
+    N2p1 = (N<<1) + 1 ;
+
+    // i == 0 pairs with the nyquist value
+    h1r =  c1*(x[0] + xr ) ;
+    h1i =  c1*(x[1] - xi ) ;
+    h2r = -c2*(x[1] + xi ) ;
+    h2i =  c2*(x[0] - xr ) ;
+    x[0] =  h1r + h2r ;
+    x[1] =  h1i + h2i ;
+    xr =  h1r - h2r ;
+    xi = -h1i + h2i ;
+
+    for( i = 1 ; i <= N>>1 ; i++ )
+    {
+        i1 = i<<1 ;
+        i2 = i1 + 1 ;
+        i3 = N2p1 - i2 ;
+        i4 = i3 + 1 ;
+        wr = w[i1] ;
+        wi = s*w[i2] ;
+        h1r =  c1*(x[i1] + x[i3] ) ;
+        h1i =  c1*(x[i2] - x[i4] ) ;
+        h2r = -c2*(x[i2] + x[i4] ) ;
+        h2i =  c2*(x[i1] - x[i3] ) ;
+        x[i1] =  h1r + wr*h2r - wi*h2i ;
+        x[i2] =  h1i + wr*h2i + wi*h2r ;
+        x[i3] =  h1r - wr*h2r + wi*h2i ;
+        x[i4] = -h1i + wr*h2i + wi*h2r ;
+    }
+
+    if( forward )
+        x[1] = xr ;
+    else
+        cfft_plan( plan, x, forward ) ;
+}
+
+
+
+
 //-----------------------------------------------------------------------------
 // name: the_dct()
 // desc: type ii dct on N reals
@@ -391,7 +767,7 @@ void the_dct_now( FLOAT * x, FLOAT ** matrix, unsigned long N,
     {
         for( n = 0; n < N; n++ )
         {
-            out[k] = x[n] * matrix[k][n];
+            out[k] += x[n] * matrix[k][n];
         }
     }
 }
@@ -405,6 +781,21 @@ void the_dct_now( FLOAT * x, FLOAT ** matrix, unsigned long N,
 //-----------------------------------------------------------------------------
 void the_inverse_dct( FLOAT * x, unsigned long N, FLOAT * out, unsigned long Nout )
 {
+    unsigned long k, n;
+
+    // sanity check
+    assert( Nout <= N );
+
+    // go for it (scaled by 2/N, so that this inverts the_dct())
+    for( k = 0; k < Nout; k++ )
+    {
+        out[k] = x[0] / 2;
+        for( n = 1; n < N; n++ )
+        {
+            out[k] += x[n] * cos( ONE_PI / N * n * (k + .5) );
+        }
+        out[k] *= 2.0 / N;
+    }
 }
 
 
@@ -443,12 +834,107 @@ void the_inverse_dct_now( FLOAT * x, FLOAT ** matrix, unsigned long N,
     // zero out
     memset( out, 0, sizeof(FLOAT)*Nout );
 
-    // go for it
+    // go for it (scaled by 2/N, so that this inverts the_dct_now())
     for( k = 0; k < Nout; k++ )
     {
-        for( n = 0; n < N; n++ )
+        out[k] = x[0] / 2;
+        for( n = 1; n < N; n++ )
         {
-            out[k] = x[0] / 2 + x[n] * matrix[k][n];
+            out[k] += x[n] * matrix[k][n];
         }
+        out[k] *= 2.0 / N;
+    }
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: the_dct_plan()
+// desc: type ii dct on N = 2*plan->NC reals, through one real fft of the
+//       reordered input (even samples up, odd samples down); same result
+//       as the_dct().  x is used as scratch.
+//-----------------------------------------------------------------------------
+void the_dct_plan( fft_plan * plan, FLOAT * x, unsigned long N,
+                   FLOAT * out, unsigned long Nout )
+{
+    const FLOAT * w = plan->dtwiddles;
+    unsigned long n, k, h = N >> 1;
+    FLOAT scale = (FLOAT)N, vr, vi, wr, wi;
+
+    // sanity check
+    assert( Nout <= N && N == 2 * plan->NC );
+
+    // reorder into out
+    for( n = 0; n < h; n++ )
+    {
+        out[n] = x[2*n];
+        out[N-1-n] = x[2*n+1];
+    }
+
+    // fft (rfft() scales by 1/N and conjugates)
+    rfft_plan( plan, out, FFT_FORWARD );
+
+    // rotate by e^(-i*pi*k/2N): real part gives k, -imaginary gives N-k
+    x[0] = scale * out[0];
+    x[h] = scale * out[1] * w[2*h];
+    for( k = 1; k < h; k++ )
+    {
+        vr = scale * out[2*k];
+        vi = -scale * out[2*k+1];
+        wr = w[2*k];
+        wi = w[2*k+1];
+        x[k] = wr * vr + wi * vi;
+        x[N-k] = wi * vr - wr * vi;
+    }
+
+    // copy out
+    memcpy( out, x, Nout * sizeof(FLOAT) );
+}
+
+
+
+
+//-----------------------------------------------------------------------------
+// name: the_inverse_dct_plan()
+// desc: type iii dct on N = 2*plan->NC reals, scaled to invert
+//       the_dct_plan(); same result as the_inverse_dct().  x is used as
+//       scratch.
+//-----------------------------------------------------------------------------
+void the_inverse_dct_plan( fft_plan * plan, FLOAT * x, unsigned long N,
+                           FLOAT * out, unsigned long Nout )
+{
+    const FLOAT * w = plan->dtwiddles;
+    unsigned long n, k, h = N >> 1;
+    FLOAT a, b, wr, wi;
+
+    // sanity check
+    assert( Nout <= N && N == 2 * plan->NC );
+
+    // spectrum of the reordered signal: e^(i*pi*k/2N) * (X[k] - i*X[N-k]),
+    // conjugated and scaled by 1/N for rfft()
+    out[0] = x[0] / N;
+    out[1] = x[h] * 2 * w[2*h] / N;
+    for( k = 1; k < h; k++ )
+    {
+        a = x[k];
+        b = -x[N-k];
+        wr = w[2*k];
+        wi = w[2*k+1];
+        out[2*k] = (wr * a - wi * b) / N;
+        out[2*k+1] = -(wr * b + wi * a) / N;
+    }
+
+    // inverse fft
+    rfft_plan( plan, out, FFT_INVERSE );
+
+    // undo the reordering
+    for( n = 0; n < h; n++ )
+    {
+        x[2*n] = out[n];
+        x[2*n+1] = out[N-1-n];
     }
+
+    // copy out
+    memcpy( out, x, Nout * sizeof(FLOAT) );
 }
@@ -67,6 +67,31 @@ void rfft( FLOAT * x, long N, unsigned int forward );
 // complex fft, NC must be power of 2
 void cfft( FLOAT * x, long NC, unsigned int forward );
 
+// planned fft: bit-reversal and twiddle tables for one size
+typedef struct fft_plan
+{
+    // number of complex points
+    long NC;
+    // bit-reversal swaps, as index pairs
+    long * swaps;
+    long num_swaps;
+    // span of the first radix-4 pass (2 after a radix-2 pass, else 1)
+    long first;
+    // radix-4 pass twiddles
+    FLOAT * twiddles;
+    // real transform twiddles
+    FLOAT * rtwiddles;
+    // dct twiddles (for 2*NC reals)
+    FLOAT * dtwiddles;
+} fft_plan;
+
+// get the (cached) plan for NC complex points, NC must be power of 2
+fft_plan * fft_plan_get( long NC );
+// real fft, as rfft(), with the plan for N
+void rfft_plan( fft_plan * plan, FLOAT * x, unsigned int forward );
+// complex fft, as cfft(), with the plan for NC
+void cfft_plan( fft_plan * plan, FLOAT * x, unsigned int forward );
+
 // type II dct, often referred to as "the dct"
 void the_dct( FLOAT * x, unsigned long N, FLOAT * out, unsigned long Nout );
 // generates NxN type II dct matrix
@@ -81,6 +106,11 @@ void the_dct_now( FLOAT * x, FLOAT ** matrix, unsigned long N, FLOAT * out, unsi
 // apply inverse dct from matrix
 void the_inverse_dct_now( FLOAT * x, FLOAT ** matrix, unsigned long N, FLOAT * out, unsigned long Nout );
 
+// dct via fft, N == 2*plan->NC; x is used as scratch
+void the_dct_plan( fft_plan * plan, FLOAT * x, unsigned long N, FLOAT * out, unsigned long Nout );
+// inverse dct via fft, N == 2*plan->NC; x is used as scratch
+void the_inverse_dct_plan( fft_plan * plan, FLOAT * x, unsigned long N, FLOAT * out, unsigned long Nout );
+
 // c linkage
 #if ( defined( __cplusplus ) || defined( _cplusplus ) )
 }